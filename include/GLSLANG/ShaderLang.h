@@ -26,7 +26,7 @@
 
 // Version number for shader translation API.
 // It is incremented every time the API changes.
-#define ANGLE_SH_VERSION 217
+#define ANGLE_SH_VERSION 219
 
 enum ShShaderSpec
 {
@@ -318,6 +318,14 @@ const ShCompileOptions SH_METAL_EMULATE_LINEAR_DEPTH_RANGE_MAP = UINT64_C(1) <<
 // implemented for the Vulkan backend.
 const ShCompileOptions SH_ADD_BRESENHAM_LINE_RASTER_EMULATION = UINT64_C(1) << 50;
 
+// This flag makes the translated source as short as possible, to cut the time the driver spends
+// parsing it. Variables that are not part of the shader interface, function parameters and
+// functions other than main get short names, and parentheses are only kept where operator
+// precedence requires them. For GLSL and ESSL output, comments and whitespace that isn't needed to
+// separate tokens are removed as well. The number of bytes saved can be queried with
+// sh::GetObjectCodeSizeReduction().
+const ShCompileOptions SH_MINIFY_OUTPUT = UINT64_C(1) << 51;
+
 // Defines alternate strategies for implementing array index clamping.
 enum ShArrayIndexClampingStrategy
 {
@@ -571,6 +579,18 @@ ShHandle ConstructCompiler(sh::GLenum type,
                            const ShBuiltInResources *resources);
 void Destruct(ShHandle handle);
 
+//
+// Updates the built-in resources of a compiler so it can be reused after the resources have
+// changed, e.g. because an extension was enabled. This is much cheaper than constructing a new
+// compiler. Nothing is done if the resources are unchanged.
+// If the function succeeds, the return value is true, else false. The compiler keeps its old
+// resources on failure.
+// Parameters:
+// handle: Specifies the handle of the compiler to be updated.
+// resources: Specifies the new built-in resources.
+//
+bool UpdateResources(const ShHandle handle, const ShBuiltInResources *resources);
+
 //
 // Compiles the given shader source.
 // If the function succeeds, the return value is true, else false.
@@ -619,6 +639,11 @@ const std::string &GetInfoLog(const ShHandle handle);
 // handle: Specifies the compiler
 const std::string &GetObjectCode(const ShHandle handle);
 
+// Returns how many bytes SH_MINIFY_OUTPUT removed from the object code of the last compile.
+// Parameters:
+// handle: Specifies the compiler
+size_t GetObjectCodeSizeReduction(const ShHandle handle);
+
 // Returns a (original_name, hash) map containing all the user defined names in the shader,
 // including variable names, function names, struct names, and struct field names.
 // Parameters:
@@ -355,6 +355,13 @@ struct FeaturesGL : FeatureSetBase
         "Mac incorrectly executes both sides of && and || expressions when they should "
         "short-circuit.",
         &members, "http://anglebug.com/482"};
+
+    // Drivers spend less time parsing shorter shaders. Off by default since minified shaders are
+    // hard to read in graphics debuggers.
+    Feature minifyTranslatedShaders = {
+        "minify_translated_shaders", FeatureCategory::OpenGLWorkarounds,
+        "Shorten names and remove whitespace in translated shaders to reduce driver compile time.",
+        &members};
 };
 
 inline FeaturesGL::FeaturesGL()  = default;
@@ -49,6 +49,13 @@ struct FrontendFeatures : angle::FeatureSetBase
         "scalarize_vec_and_mat_constructor_args", angle::FeatureCategory::FrontendWorkarounds,
         "Always rewrite vec/mat constructors to be consistent", &members,
         "http://crbug.com/398694"};
+
+    // Program binaries repeat variable names, translated sources and SPIR-V a lot. Compressing
+    // them lets many more programs fit in the program cache, at the cost of a decompression on
+    // every cache hit.
+    angle::Feature enableProgramBinaryCompression = {
+        "enable_program_binary_compression", angle::FeatureCategory::FrontendWorkarounds,
+        "Compress program binaries stored in the program cache", &members};
 };
 
 inline FrontendFeatures::FrontendFeatures()  = default;
@@ -32,9 +32,10 @@ PoolAllocator::PoolAllocator(int growthIncrement, int allocationAlignment)
       mPageSize(growthIncrement),
       mFreeList(0),
       mInUseList(0),
+#endif
       mNumCalls(0),
+      mNumPageAllocations(0),
       mTotalBytes(0),
-#endif
       mLocked(false)
 {
 #if !defined(ANGLE_DISABLE_POOL_ALLOC)
@@ -210,13 +211,10 @@ void *PoolAllocator::allocate(size_t numBytes)
 {
     ASSERT(!mLocked);
 
-#if !defined(ANGLE_DISABLE_POOL_ALLOC)
-    //
-    // Just keep some interesting statistics.
-    //
     ++mNumCalls;
     mTotalBytes += numBytes;
 
+#if !defined(ANGLE_DISABLE_POOL_ALLOC)
     // If we are using guard blocks, all allocations are bracketed by
     // them: [guardblock][allocation][guardblock].  numBytes is how
     // much memory the caller asked for.  allocationSize is the total
@@ -257,6 +255,7 @@ void *PoolAllocator::allocate(size_t numBytes)
         Header *memory = reinterpret_cast<Header *>(::new char[numBytesToAlloc]);
         if (memory == 0)
             return 0;
+        ++mNumPageAllocations;
 
         // Use placement-new to initialize header
         new (memory) Header(mInUseList, (numBytesToAlloc + mPageSize - 1) / mPageSize);
@@ -275,6 +274,7 @@ void *PoolAllocator::allocate(size_t numBytes)
 #else  // !defined(ANGLE_DISABLE_POOL_ALLOC)
     void *alloc = malloc(numBytes + mAlignmentMask);
     mStack.back().push_back(alloc);
+    ++mNumPageAllocations;
 
     intptr_t intAlloc = reinterpret_cast<intptr_t>(alloc);
     intAlloc          = (intAlloc + mAlignmentMask) & ~mAlignmentMask;
@@ -299,6 +299,7 @@ void *PoolAllocator::allocateNewPage(size_t numBytes, size_t allocationSize)
         memory = reinterpret_cast<Header *>(::new char[mPageSize]);
         if (memory == 0)
             return 0;
+        ++mNumPageAllocations;
     }
     // Use placement-new to initialize header
     new (memory) Header(mInUseList, 1);
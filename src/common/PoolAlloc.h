@@ -197,6 +197,12 @@ class PoolAllocator : angle::NonCopyable
     void lock();
     void unlock();
 
+    // Statistics, e.g. for benchmarks. Pages that are reused from the free list don't count as
+    // page allocations.
+    size_t getNumAllocations() const { return mNumCalls; }
+    size_t getNumPageAllocations() const { return mNumPageAllocations; }
+    size_t getTotalBytes() const { return mTotalBytes; }
+
   private:
     size_t mAlignment;  // all returned allocations will be aligned at
                         // this granularity, which will be a power of 2
@@ -261,13 +267,14 @@ class PoolAllocator : angle::NonCopyable
     Header *mInUseList;         // list of all memory currently being used
     AllocStack mStack;          // stack of where to allocate from, to partition pool
 
-    int mNumCalls;       // just an interesting statistic
-    size_t mTotalBytes;  // just an interesting statistic
-
 #else  // !defined(ANGLE_DISABLE_POOL_ALLOC)
     std::vector<std::vector<void *>> mStack;
 #endif
 
+    size_t mNumCalls;
+    size_t mNumPageAllocations;
+    size_t mTotalBytes;
+
     bool mLocked;
 };
 
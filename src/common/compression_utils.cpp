@@ -0,0 +1,289 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// compression_utils.cpp: Implements the LZ77 blob codec.
+//
+// A compressed blob is a header followed by sequences. The header is a magic number and the
+// uncompressed size. Each sequence is a token byte, whose high nibble is the literal length and
+// low nibble the match length minus kMinMatch, the literals, a 16-bit offset back into the output
+// and the match to copy from there. A nibble of 15 is followed by more length bytes, each adding up
+// to 255. The last sequence has no offset or match; it ends at the end of the blob.
+
+#include "common/compression_utils.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+#include "common/debug.h"
+
+namespace angle
+{
+namespace
+{
+constexpr uint8_t kMagic[]   = {'A', 'L', 'Z', '1'};
+constexpr size_t kHeaderSize = sizeof(kMagic) + sizeof(uint32_t);
+
+constexpr size_t kMinMatch        = 4;
+constexpr size_t kMaxOffset       = 0xFFFF;
+constexpr uint8_t kMaxNibble      = 15;
+constexpr unsigned int kHashBits  = 12;
+constexpr unsigned int kSkipShift = 6;
+
+// No byte of a sequence adds more than 255 bytes of output, so a blob can't expand further.
+constexpr uint64_t kMaxExpansion = 255;
+
+uint32_t Read32(const uint8_t *data)
+{
+    uint32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint64_t Read64(const uint8_t *data)
+{
+    uint64_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+uint32_t HashSequence(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+uint8_t *WriteExtraLength(uint8_t *out, size_t length)
+{
+    for (; length >= 255; length -= 255)
+    {
+        *out++ = 255;
+    }
+    *out++ = static_cast<uint8_t>(length);
+    return out;
+}
+
+// Writes a sequence. A match length of zero ends the blob.
+uint8_t *WriteSequence(uint8_t *out,
+                       const uint8_t *literals,
+                       size_t literalLength,
+                       size_t offset,
+                       size_t matchLength)
+{
+    size_t matchNibble = matchLength > 0 ? matchLength - kMinMatch : 0;
+
+    uint8_t *token = out++;
+    *token         = static_cast<uint8_t>(std::min<size_t>(literalLength, kMaxNibble) << 4 |
+                                  std::min<size_t>(matchNibble, kMaxNibble));
+
+    if (literalLength >= kMaxNibble)
+    {
+        out = WriteExtraLength(out, literalLength - kMaxNibble);
+    }
+    memcpy(out, literals, literalLength);
+    out += literalLength;
+
+    if (matchLength == 0)
+    {
+        return out;
+    }
+
+    *out++ = static_cast<uint8_t>(offset);
+    *out++ = static_cast<uint8_t>(offset >> 8);
+    if (matchNibble >= kMaxNibble)
+    {
+        out = WriteExtraLength(out, matchNibble - kMaxNibble);
+    }
+    return out;
+}
+
+bool ReadLength(const uint8_t **in, const uint8_t *end, size_t *lengthInOut)
+{
+    if (*lengthInOut < kMaxNibble)
+    {
+        return true;
+    }
+
+    uint8_t extra;
+    do
+    {
+        if (*in == end)
+        {
+            return false;
+        }
+        extra = *(*in)++;
+        *lengthInOut += extra;
+    } while (extra == 255);
+    return true;
+}
+}  // anonymous namespace
+
+bool CompressBlob(const uint8_t *data, size_t size, MemoryBuffer *compressedOut)
+{
+    if (size > std::numeric_limits<uint32_t>::max())
+    {
+        return false;
+    }
+
+    // Incompressible input grows by one length byte per 255 literals, plus the token.
+    size_t maxCompressedSize = kHeaderSize + size + size / 255 + 16;
+    if (!compressedOut->resize(maxCompressedSize))
+    {
+        return false;
+    }
+
+    uint8_t *out = compressedOut->data();
+    memcpy(out, kMagic, sizeof(kMagic));
+    out += sizeof(kMagic);
+    for (size_t byte = 0; byte < sizeof(uint32_t); ++byte)
+    {
+        *out++ = static_cast<uint8_t>(size >> (byte * 8));
+    }
+
+    // Last position of every hashed 4-byte sequence, plus one so zero means none.
+    std::array<uint32_t, 1 << kHashBits> positions = {};
+
+    size_t anchor = 0;
+    size_t pos    = 0;
+    while (size >= kMinMatch && pos <= size - kMinMatch)
+    {
+        uint32_t sequence  = Read32(data + pos);
+        uint32_t &position = positions[HashSequence(sequence)];
+        size_t candidate   = position;
+        position           = static_cast<uint32_t>(pos + 1);
+
+        if (candidate == 0 || pos - (candidate - 1) > kMaxOffset ||
+            Read32(data + candidate - 1) != sequence)
+        {
+            // Step faster through data that doesn't compress.
+            pos += 1 + ((pos - anchor) >> kSkipShift);
+            continue;
+        }
+        candidate--;
+
+        // Compare eight bytes at a time, then find the first difference.
+        size_t matchLength = kMinMatch;
+        while (pos + matchLength + sizeof(uint64_t) <= size &&
+               Read64(data + candidate + matchLength) == Read64(data + pos + matchLength))
+        {
+            matchLength += sizeof(uint64_t);
+        }
+        while (pos + matchLength < size && data[candidate + matchLength] == data[pos + matchLength])
+        {
+            matchLength++;
+        }
+
+        out = WriteSequence(out, data + anchor, pos - anchor, pos - candidate, matchLength);
+        pos += matchLength;
+        anchor = pos;
+    }
+
+    out = WriteSequence(out, data + anchor, size - anchor, 0, 0);
+
+    size_t compressedSize = out - compressedOut->data();
+    ASSERT(compressedSize <= maxCompressedSize);
+    return compressedOut->resize(compressedSize);
+}
+
+bool DecompressBlob(const uint8_t *compressedData,
+                    size_t compressedSize,
+                    MemoryBuffer *uncompressedOut)
+{
+    if (compressedSize < kHeaderSize || memcmp(compressedData, kMagic, sizeof(kMagic)) != 0)
+    {
+        return false;
+    }
+
+    const uint8_t *in  = compressedData + sizeof(kMagic);
+    const uint8_t *end = compressedData + compressedSize;
+
+    size_t size = 0;
+    for (size_t byte = 0; byte < sizeof(uint32_t); ++byte)
+    {
+        size |= static_cast<size_t>(*in++) << (byte * 8);
+    }
+
+    // The size isn't trusted, so it's checked against the input before anything is allocated.
+    if (size > static_cast<uint64_t>(end - in) * kMaxExpansion)
+    {
+        return false;
+    }
+
+    if (!uncompressedOut->resize(size))
+    {
+        return false;
+    }
+    if (size == 0)
+    {
+        return end - in == 1 && *in == 0;
+    }
+
+    uint8_t *outStart = uncompressedOut->data();
+    uint8_t *out      = outStart;
+    uint8_t *outEnd   = outStart + size;
+
+    // The blob must end with the last sequence, so a truncated blob never decompresses.
+    bool lastSequence = false;
+    while (in < end)
+    {
+        uint8_t token = *in++;
+
+        size_t literalLength = token >> 4;
+        if (!ReadLength(&in, end, &literalLength) ||
+            literalLength > static_cast<size_t>(end - in) ||
+            literalLength > static_cast<size_t>(outEnd - out))
+        {
+            return false;
+        }
+        memcpy(out, in, literalLength);
+        in += literalLength;
+        out += literalLength;
+
+        if (in == end)
+        {
+            lastSequence = true;
+            break;
+        }
+
+        if (end - in < 2)
+        {
+            return false;
+        }
+        size_t offset = in[0] | in[1] << 8;
+        in += 2;
+
+        size_t matchLength = token & kMaxNibble;
+        if (!ReadLength(&in, end, &matchLength))
+        {
+            return false;
+        }
+        matchLength += kMinMatch;
+
+        if (offset == 0 || offset > static_cast<size_t>(out - outStart) ||
+            matchLength > static_cast<size_t>(outEnd - out))
+        {
+            return false;
+        }
+
+        // A match that overlaps the bytes it produces repeats them, so it's copied forward one
+        // byte at a time.
+        const uint8_t *match = out - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(out, match, matchLength);
+        }
+        else
+        {
+            for (size_t index = 0; index < matchLength; ++index)
+            {
+                out[index] = match[index];
+            }
+        }
+        out += matchLength;
+    }
+
+    return lastSequence && out == outEnd;
+}
+}  // namespace angle
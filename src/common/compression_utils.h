@@ -0,0 +1,33 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// compression_utils.h: A small LZ77 codec for blobs such as program binaries. It favors speed
+// over ratio, which suits serialized programs: they repeat long variable names, translated
+// sources and SPIR-V words a lot, and are decompressed on every program cache hit.
+
+#ifndef COMMON_COMPRESSION_UTILS_H_
+#define COMMON_COMPRESSION_UTILS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/MemoryBuffer.h"
+#include "common/angleutils.h"
+
+namespace angle
+{
+// Compresses |size| bytes at |data| into |compressedOut|. Returns false if memory can't be
+// allocated. The output records the uncompressed size, so it can be decompressed on its own.
+ANGLE_NO_DISCARD bool CompressBlob(const uint8_t *data, size_t size, MemoryBuffer *compressedOut);
+
+// Decompresses the output of CompressBlob into |uncompressedOut|. Returns false if the input is
+// not a valid compressed blob, e.g. one stored by an older version, or if memory can't be
+// allocated.
+ANGLE_NO_DISCARD bool DecompressBlob(const uint8_t *compressedData,
+                                     size_t compressedSize,
+                                     MemoryBuffer *uncompressedOut);
+}  // namespace angle
+
+#endif  // COMMON_COMPRESSION_UTILS_H_
@@ -0,0 +1,111 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// compression_utils_unittest:
+//   Tests for the LZ77 blob codec.
+//
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "common/compression_utils.h"
+
+namespace angle
+{
+namespace
+{
+void ExpectRoundTrip(const std::vector<uint8_t> &data, size_t *compressedSizeOut = nullptr)
+{
+    MemoryBuffer compressed;
+    ASSERT_TRUE(CompressBlob(data.data(), data.size(), &compressed));
+
+    MemoryBuffer uncompressed;
+    ASSERT_TRUE(DecompressBlob(compressed.data(), compressed.size(), &uncompressed));
+    ASSERT_EQ(data.size(), uncompressed.size());
+    EXPECT_TRUE(data.empty() || memcmp(data.data(), uncompressed.data(), data.size()) == 0);
+
+    if (compressedSizeOut)
+    {
+        *compressedSizeOut = compressed.size();
+    }
+}
+
+// Test that small inputs, which are too short for any match, round trip.
+TEST(CompressionUtilsTest, SmallInputs)
+{
+    for (size_t size = 0; size < 32; ++size)
+    {
+        std::vector<uint8_t> data(size);
+        for (size_t index = 0; index < size; ++index)
+        {
+            data[index] = static_cast<uint8_t>(index * 37);
+        }
+        ExpectRoundTrip(data);
+    }
+}
+
+// Test that repetitive input shrinks, including runs longer than the length nibbles and matches
+// that overlap the bytes they produce.
+TEST(CompressionUtilsTest, Repetitive)
+{
+    std::string text;
+    for (int index = 0; index < 2000; ++index)
+    {
+        text += "uniform highp vec4 _uLongVariableName" + std::to_string(index % 17) + ";\n";
+    }
+    text.append(5000, 'x');
+
+    std::vector<uint8_t> data(text.begin(), text.end());
+    size_t compressedSize = 0;
+    ExpectRoundTrip(data, &compressedSize);
+    EXPECT_LT(compressedSize, data.size() / 10);
+}
+
+// Test that incompressible input round trips and stays within the expected bound.
+TEST(CompressionUtilsTest, Incompressible)
+{
+    std::vector<uint8_t> data(100000);
+    uint32_t state = 1;
+    for (uint8_t &byte : data)
+    {
+        state = state * 1664525u + 1013904223u;
+        byte  = static_cast<uint8_t>(state >> 24);
+    }
+
+    size_t compressedSize = 0;
+    ExpectRoundTrip(data, &compressedSize);
+    EXPECT_LE(compressedSize, data.size() + data.size() / 255 + 32);
+}
+
+// Test that blobs which weren't compressed, or were cut short, are rejected.
+TEST(CompressionUtilsTest, InvalidInput)
+{
+    std::vector<uint8_t> data(1000);
+    for (size_t index = 0; index < data.size(); ++index)
+    {
+        data[index] = static_cast<uint8_t>(index % 13);
+    }
+
+    MemoryBuffer uncompressed;
+    EXPECT_FALSE(DecompressBlob(data.data(), data.size(), &uncompressed));
+
+    MemoryBuffer compressed;
+    ASSERT_TRUE(CompressBlob(data.data(), data.size(), &compressed));
+    for (size_t size = 0; size < compressed.size(); ++size)
+    {
+        EXPECT_FALSE(DecompressBlob(compressed.data(), size, &uncompressed));
+    }
+
+    // A size in the header that the rest of the blob can't expand to is rejected before the output
+    // is allocated.
+    constexpr uint8_t kOversizedBlob[] = {'A', 'L', 'Z', '1', 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+    MemoryBuffer oversized;
+    EXPECT_FALSE(DecompressBlob(kOversizedBlob, sizeof(kOversizedBlob), &oversized));
+    EXPECT_TRUE(oversized.empty());
+}
+}  // anonymous namespace
+}  // namespace angle
@@ -89,6 +89,13 @@ bool DebugAnnotationsInitialized()
     return g_debugAnnotator != nullptr;
 }
 
+bool IsLogMessageConsumed(LogSeverity severity)
+{
+    // Matches ~LogMessage: the annotator gets everything from INFO up, and FATAL always crashes.
+    return (DebugAnnotationsInitialized() && severity >= LOG_INFO) || severity == LOG_FATAL ||
+           ShouldCreateLogMessage(severity);
+}
+
 void InitializeDebugAnnotations(DebugAnnotator *debugAnnotator)
 {
     UninitializeDebugAnnotations();
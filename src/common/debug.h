@@ -100,6 +100,10 @@ void UninitializeDebugAnnotations();
 bool DebugAnnotationsActive();
 bool DebugAnnotationsInitialized();
 
+// Returns whether a message of this severity would reach the debug annotator or a log, so callers
+// can skip formatting messages nobody reads.
+bool IsLogMessageConsumed(LogSeverity severity);
+
 void InitializeDebugMutexIfNeeded();
 
 namespace priv
@@ -5,6 +5,7 @@
 #include "common/event_tracer.h"
 
 #include "common/debug.h"
+#include "common/trace_recorder.h"
 
 namespace angle
 {
@@ -20,8 +21,8 @@ const unsigned char *GetTraceCategoryEnabledFlag(PlatformMethods *platform, cons
         return categoryEnabledFlag;
     }
 
-    static unsigned char disabled = 0;
-    return &disabled;
+    // The embedder doesn't trace, fall back to the built-in recorder.
+    return TraceRecorder::Get()->getCategoryEnabledFlag(name);
 }
 
 angle::TraceEventHandle AddTraceEvent(PlatformMethods *platform,
@@ -37,6 +38,13 @@ angle::TraceEventHandle AddTraceEvent(PlatformMethods *platform,
 {
     ASSERT(platform);
 
+    TraceRecorder *recorder = TraceRecorder::Get();
+    if (recorder->ownsCategoryFlag(categoryGroupEnabled))
+    {
+        recorder->addEvent(phase, categoryGroupEnabled, name, recorder->currentTime());
+        return static_cast<angle::TraceEventHandle>(0);
+    }
+
     double timestamp = platform->monotonicallyIncreasingTime(platform);
 
     if (timestamp != 0)
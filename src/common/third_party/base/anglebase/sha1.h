@@ -6,6 +6,7 @@
 #define ANGLEBASE_SHA1_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <string>
 
@@ -29,6 +30,48 @@ ANGLEBASE_EXPORT std::string SHA1HashString(const std::string &str);
 // in |hash|. |hash| must be kSHA1Length bytes long.
 ANGLEBASE_EXPORT void SHA1HashBytes(const unsigned char *data, size_t len, unsigned char *hash);
 
+// Incremental SHA-1, for hashing data that is not in one contiguous buffer.
+//
+// Usage example:
+//
+// SecureHashAlgorithm sha;
+// while(there is data to hash)
+//   sha.Update(moredata, size of data);
+// sha.Final();
+// memcpy(somewhere, sha.Digest(), 20);
+//
+// to reuse the instance of sha, call sha.Init();
+class ANGLEBASE_EXPORT SecureHashAlgorithm
+{
+  public:
+    SecureHashAlgorithm() { Init(); }
+
+    static const int kDigestSizeBytes;
+
+    void Init();
+    void Update(const void *data, size_t nbytes);
+    void Final();
+
+    // 20 bytes of message digest.
+    const unsigned char *Digest() const { return reinterpret_cast<const unsigned char *>(H); }
+
+  private:
+    void Pad();
+    void Process();
+
+    uint32_t A, B, C, D, E;
+
+    uint32_t H[5];
+
+    union {
+        uint32_t W[80];
+        uint8_t M[64];
+    };
+
+    uint32_t cursor;
+    uint64_t l;
+};
+
 }  // namespace base
 
 }  // namespace angle
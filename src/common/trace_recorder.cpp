@@ -0,0 +1,290 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// trace_recorder.cpp: Implements the built-in trace event recorder.
+
+#include "common/trace_recorder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/debug.h"
+#include "common/string_utils.h"
+#include "common/system_utils.h"
+
+namespace angle
+{
+namespace
+{
+// How many events a thread records between checks of the flush interval.
+constexpr uint32_t kFlushCheckEventCount = 256;
+
+// Events of this category carry GPU timestamps and are shown on their own track.
+constexpr char kGpuCategoryName[] = "gpu.angle.gpu";
+
+unsigned char gDisabledCategoryFlag = 0;
+}  // anonymous namespace
+
+TraceRecorder::TraceRecorder()
+    : mStartTime(GetCurrentTime()),
+      mRecording(false),
+      mCategoryFlags{},
+      mCategoryCount(0),
+      mThreadBufferIndex(CreateTLSIndex()),
+      mOutputFile(nullptr),
+      mFirstEventWritten(false),
+      mNextFlushTime(0.0)
+{}
+
+TraceRecorder::~TraceRecorder()
+{
+    stop();
+    DestroyTLSIndex(mThreadBufferIndex);
+}
+
+// static
+TraceRecorder *TraceRecorder::Get()
+{
+    // Intentionally leaked so that threads that are still running at exit can keep tracing.
+    static TraceRecorder *recorder = []() {
+        TraceRecorder *newRecorder = new TraceRecorder();
+
+        std::string outputFileName = GetEnvironmentVar("ANGLE_TRACE_FILE");
+        if (!outputFileName.empty() &&
+            newRecorder->start(outputFileName, GetEnvironmentVar("ANGLE_TRACE_CATEGORIES")))
+        {
+            std::atexit([]() { Get()->stop(); });
+        }
+
+        return newRecorder;
+    }();
+    return recorder;
+}
+
+bool TraceRecorder::start(const std::string &outputFileName, const std::string &categories)
+{
+    stop();
+
+    std::lock_guard<std::mutex> flushLock(mFlushMutex);
+
+    mOutputFile = fopen(outputFileName.c_str(), "w");
+    if (!mOutputFile)
+    {
+        WARN() << "Could not open trace file " << outputFileName;
+        return false;
+    }
+
+    // Chrome's JSON array format doesn't require the closing bracket, so the file stays usable
+    // if the process exits without stopping the recorder.
+    fputs("[\n", mOutputFile);
+    mFirstEventWritten = false;
+    mNextFlushTime     = currentTime() + kFlushIntervalSeconds;
+
+    // Discard whatever was recorded after the last stop.
+    {
+        std::lock_guard<std::mutex> bufferLock(mThreadBufferMutex);
+        for (std::unique_ptr<ThreadBuffer> &buffer : mThreadBuffers)
+        {
+            buffer->readIndex.store(buffer->writeIndex.load(std::memory_order_acquire),
+                                    std::memory_order_release);
+        }
+    }
+
+    std::lock_guard<std::mutex> categoryLock(mCategoryMutex);
+    mCategoryFilter = SplitString(categories, ",", TRIM_WHITESPACE, SPLIT_WANT_NONEMPTY);
+
+    mRecording = true;
+    for (size_t index = 0; index < mCategoryCount; ++index)
+    {
+        mCategoryFlags[index] = isCategoryRecorded(mCategoryNames[index]);
+    }
+
+    return true;
+}
+
+void TraceRecorder::stop()
+{
+    {
+        std::lock_guard<std::mutex> categoryLock(mCategoryMutex);
+        if (!mRecording)
+        {
+            return;
+        }
+
+        mRecording = false;
+        mCategoryFlags.fill(0);
+    }
+
+    std::lock_guard<std::mutex> flushLock(mFlushMutex);
+    flushLocked();
+
+    fputs("\n]\n", mOutputFile);
+    fclose(mOutputFile);
+    mOutputFile = nullptr;
+}
+
+const unsigned char *TraceRecorder::getCategoryEnabledFlag(const char *categoryName)
+{
+    std::lock_guard<std::mutex> lock(mCategoryMutex);
+
+    for (size_t index = 0; index < mCategoryCount; ++index)
+    {
+        if (mCategoryNames[index] == categoryName)
+        {
+            return &mCategoryFlags[index];
+        }
+    }
+
+    if (mCategoryCount == kMaxCategories)
+    {
+        return &gDisabledCategoryFlag;
+    }
+
+    size_t index          = mCategoryCount++;
+    mCategoryNames[index] = categoryName;
+    mCategoryFlags[index] = mRecording && isCategoryRecorded(mCategoryNames[index]);
+    return &mCategoryFlags[index];
+}
+
+bool TraceRecorder::ownsCategoryFlag(const unsigned char *categoryEnabledFlag) const
+{
+    return categoryEnabledFlag >= mCategoryFlags.data() &&
+           categoryEnabledFlag < mCategoryFlags.data() + kMaxCategories;
+}
+
+void TraceRecorder::addEvent(char phase,
+                             const unsigned char *categoryEnabledFlag,
+                             const char *name,
+                             double timestamp)
+{
+    ASSERT(ownsCategoryFlag(categoryEnabledFlag));
+
+    ThreadBuffer *buffer = getThreadBuffer();
+    if (!buffer)
+    {
+        return;
+    }
+
+    // A full buffer is rare enough that it's better to wait for a flush than to lose events.
+    size_t writeIndex = buffer->writeIndex.load(std::memory_order_relaxed);
+    if (writeIndex - buffer->readIndex.load(std::memory_order_acquire) == ThreadBuffer::kCapacity)
+    {
+        flush();
+    }
+
+    Event &event        = buffer->events[writeIndex % ThreadBuffer::kCapacity];
+    event.timestamp     = timestamp;
+    event.name          = name;
+    event.categoryIndex = static_cast<uint16_t>(categoryEnabledFlag - mCategoryFlags.data());
+    event.phase         = phase;
+    buffer->writeIndex.store(writeIndex + 1, std::memory_order_release);
+
+    if (++buffer->eventsSinceFlushCheck == kFlushCheckEventCount)
+    {
+        buffer->eventsSinceFlushCheck = 0;
+        if (currentTime() >= mNextFlushTime.load(std::memory_order_relaxed))
+        {
+            tryFlush();
+        }
+    }
+}
+
+double TraceRecorder::currentTime() const
+{
+    return GetCurrentTime() - mStartTime;
+}
+
+void TraceRecorder::flush()
+{
+    std::lock_guard<std::mutex> lock(mFlushMutex);
+    flushLocked();
+}
+
+TraceRecorder::ThreadBuffer *TraceRecorder::getThreadBuffer()
+{
+    ThreadBuffer *buffer = static_cast<ThreadBuffer *>(GetTLSValue(mThreadBufferIndex));
+    if (buffer)
+    {
+        return buffer;
+    }
+
+    // First event on this thread. Buffers are kept until the recorder is destroyed since the
+    // thread may exit before its events are flushed.
+    std::lock_guard<std::mutex> lock(mThreadBufferMutex);
+
+    std::unique_ptr<ThreadBuffer> newBuffer(new ThreadBuffer());
+    newBuffer->writeIndex            = 0;
+    newBuffer->readIndex             = 0;
+    newBuffer->threadIndex           = static_cast<uint32_t>(mThreadBuffers.size()) + 1;
+    newBuffer->eventsSinceFlushCheck = 0;
+
+    if (!SetTLSValue(mThreadBufferIndex, newBuffer.get()))
+    {
+        return nullptr;
+    }
+
+    mThreadBuffers.push_back(std::move(newBuffer));
+    return mThreadBuffers.back().get();
+}
+
+bool TraceRecorder::isCategoryRecorded(const std::string &categoryName) const
+{
+    return mCategoryFilter.empty() || std::find(mCategoryFilter.begin(), mCategoryFilter.end(),
+                                                categoryName) != mCategoryFilter.end();
+}
+
+void TraceRecorder::tryFlush()
+{
+    // Another thread is already flushing, which is as good.
+    std::unique_lock<std::mutex> lock(mFlushMutex, std::try_to_lock);
+    if (lock.owns_lock())
+    {
+        flushLocked();
+    }
+}
+
+void TraceRecorder::flushLocked()
+{
+    if (!mOutputFile)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> bufferLock(mThreadBufferMutex);
+
+    for (std::unique_ptr<ThreadBuffer> &buffer : mThreadBuffers)
+    {
+        size_t readIndex  = buffer->readIndex.load(std::memory_order_relaxed);
+        size_t writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+
+        for (; readIndex != writeIndex; ++readIndex)
+        {
+            const Event &event              = buffer->events[readIndex % ThreadBuffer::kCapacity];
+            const std::string &categoryName = mCategoryNames[event.categoryIndex];
+
+            fputs(mFirstEventWritten ? ",\n" : "", mOutputFile);
+            mFirstEventWritten = true;
+
+            // Timestamps are in microseconds.
+            fprintf(mOutputFile, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,",
+                    event.name, categoryName.c_str(), event.phase, event.timestamp * 1e6);
+            if (categoryName == kGpuCategoryName)
+            {
+                fputs("\"pid\":\"ANGLE\",\"tid\":\"GPU\"}", mOutputFile);
+            }
+            else
+            {
+                fprintf(mOutputFile, "\"pid\":\"ANGLE\",\"tid\":%u}", buffer->threadIndex);
+            }
+        }
+
+        buffer->readIndex.store(writeIndex, std::memory_order_release);
+    }
+
+    fflush(mOutputFile);
+    mNextFlushTime = currentTime() + kFlushIntervalSeconds;
+}
+}  // namespace angle
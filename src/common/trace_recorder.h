@@ -0,0 +1,113 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// trace_recorder.h: Built-in recorder for ANGLE trace events. Used when the embedder does not
+// provide tracing platform methods. Writes the Chrome JSON trace format, which can be loaded in
+// chrome://tracing or the Perfetto UI.
+//
+// Recording is enabled by setting ANGLE_TRACE_FILE to the output path. ANGLE_TRACE_CATEGORIES
+// optionally holds a comma separated list of categories to record; all categories are recorded
+// by default.
+
+#ifndef COMMON_TRACE_RECORDER_H_
+#define COMMON_TRACE_RECORDER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/angleutils.h"
+#include "common/tls.h"
+
+namespace angle
+{
+class TraceRecorder final : angle::NonCopyable
+{
+  public:
+    TraceRecorder();
+    ~TraceRecorder();
+
+    // The process-wide recorder. Starts recording on first use if ANGLE_TRACE_FILE is set.
+    static TraceRecorder *Get();
+
+    // |categories| is a comma separated list of categories to record. An empty list records all
+    // categories. Returns false if the output file can't be opened.
+    bool start(const std::string &outputFileName, const std::string &categories);
+    void stop();
+    bool isRecording() const { return mRecording; }
+
+    // Returns a flag that is non-zero while the category is being recorded. The flag stays valid
+    // for the lifetime of the recorder, so it can be cached by the trace event macros.
+    const unsigned char *getCategoryEnabledFlag(const char *categoryName);
+    bool ownsCategoryFlag(const unsigned char *categoryEnabledFlag) const;
+
+    // Records an event with a timestamp in seconds. Only takes a lock when the calling thread's
+    // buffer is full or the periodic flush is due.
+    void addEvent(char phase,
+                  const unsigned char *categoryEnabledFlag,
+                  const char *name,
+                  double timestamp);
+
+    // Seconds since the recorder was created.
+    double currentTime() const;
+
+    // Writes the buffered events of all threads to the output file.
+    void flush();
+
+  private:
+    struct Event
+    {
+        double timestamp;
+        const char *name;
+        uint16_t categoryIndex;
+        char phase;
+    };
+
+    // Single producer (the owning thread), single consumer (whoever holds mFlushMutex).
+    struct ThreadBuffer
+    {
+        static constexpr size_t kCapacity = 4096;
+
+        std::array<Event, kCapacity> events;
+        std::atomic<size_t> writeIndex;
+        std::atomic<size_t> readIndex;
+        uint32_t threadIndex;
+        uint32_t eventsSinceFlushCheck;
+    };
+
+    static constexpr size_t kMaxCategories        = 64;
+    static constexpr double kFlushIntervalSeconds = 1.0;
+
+    ThreadBuffer *getThreadBuffer();
+    bool isCategoryRecorded(const std::string &categoryName) const;
+    void tryFlush();
+    void flushLocked();
+
+    const double mStartTime;
+    std::atomic<bool> mRecording;
+
+    // Categories are never removed, so the flags and names stay valid while recording.
+    std::mutex mCategoryMutex;
+    std::array<unsigned char, kMaxCategories> mCategoryFlags;
+    std::array<std::string, kMaxCategories> mCategoryNames;
+    size_t mCategoryCount;
+    std::vector<std::string> mCategoryFilter;
+
+    TLSIndex mThreadBufferIndex;
+    std::mutex mThreadBufferMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> mThreadBuffers;
+
+    std::mutex mFlushMutex;
+    FILE *mOutputFile;
+    bool mFirstEventWritten;
+    std::atomic<double> mNextFlushTime;
+};
+}  // namespace angle
+
+#endif  // COMMON_TRACE_RECORDER_H_
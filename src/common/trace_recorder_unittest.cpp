@@ -0,0 +1,113 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// trace_recorder_unittest:
+//   Tests for the built-in trace event recorder.
+//
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "common/trace_recorder.h"
+
+namespace angle
+{
+namespace
+{
+constexpr char kTraceFileName[] = "angle_trace_recorder_unittest.json";
+
+std::string ReadTraceFile()
+{
+    std::ifstream file(kTraceFileName);
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+// Test that category flags follow the recording state.
+TEST(TraceRecorderTest, CategoryFlags)
+{
+    TraceRecorder recorder;
+
+    const unsigned char *flag = recorder.getCategoryEnabledFlag("gpu.angle");
+    EXPECT_TRUE(recorder.ownsCategoryFlag(flag));
+    EXPECT_EQ(0, *flag);
+
+    ASSERT_TRUE(recorder.start(kTraceFileName, ""));
+    EXPECT_NE(0, *flag);
+    EXPECT_EQ(flag, recorder.getCategoryEnabledFlag("gpu.angle"));
+
+    recorder.stop();
+    EXPECT_EQ(0, *flag);
+
+    std::remove(kTraceFileName);
+}
+
+// Test that only the categories in the filter are enabled.
+TEST(TraceRecorderTest, CategoryFilter)
+{
+    TraceRecorder recorder;
+
+    const unsigned char *includedFlag = recorder.getCategoryEnabledFlag("gpu.angle");
+    ASSERT_TRUE(recorder.start(kTraceFileName, "gpu.angle, gpu.angle.gpu"));
+
+    const unsigned char *excludedFlag = recorder.getCategoryEnabledFlag("other");
+    const unsigned char *gpuFlag      = recorder.getCategoryEnabledFlag("gpu.angle.gpu");
+
+    EXPECT_NE(0, *includedFlag);
+    EXPECT_NE(0, *gpuFlag);
+    EXPECT_EQ(0, *excludedFlag);
+
+    recorder.stop();
+    std::remove(kTraceFileName);
+}
+
+// Test that events recorded on several threads end up in the trace file.
+TEST(TraceRecorderTest, RecordEvents)
+{
+    TraceRecorder recorder;
+    ASSERT_TRUE(recorder.start(kTraceFileName, ""));
+
+    const unsigned char *flag = recorder.getCategoryEnabledFlag("gpu.angle");
+
+    auto recordEvents = [&recorder, flag](const char *name) {
+        for (int i = 0; i < 10000; ++i)
+        {
+            recorder.addEvent('B', flag, name, recorder.currentTime());
+            recorder.addEvent('E', flag, name, recorder.currentTime());
+        }
+    };
+
+    std::thread otherThread(recordEvents, "OtherThreadEvent");
+    recordEvents("MainThreadEvent");
+    otherThread.join();
+
+    recorder.stop();
+
+    std::string trace = ReadTraceFile();
+    EXPECT_EQ('[', trace.front());
+    EXPECT_EQ("]\n", trace.substr(trace.size() - 2));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"MainThreadEvent\""));
+    EXPECT_NE(std::string::npos, trace.find("\"name\":\"OtherThreadEvent\""));
+    EXPECT_NE(std::string::npos, trace.find("\"cat\":\"gpu.angle\""));
+
+    // Full buffers are flushed rather than dropped.
+    size_t eventCount = 0;
+    size_t pos        = trace.find("\"ph\":");
+    while (pos != std::string::npos)
+    {
+        ++eventCount;
+        pos = trace.find("\"ph\":", pos + 1);
+    }
+    EXPECT_EQ(40000u, eventCount);
+
+    std::remove(kTraceFileName);
+}
+}  // anonymous namespace
+}  // namespace angle
@@ -6,6 +6,8 @@
 
 #include "compiler/preprocessor/Macro.h"
 
+#include <algorithm>
+
 #include "common/angleutils.h"
 #include "compiler/preprocessor/Token.h"
 
@@ -25,6 +27,36 @@ bool Macro::equals(const Macro &other) const
            (replacements == other.replacements);
 }
 
+void Macro::resolveReplacementParameters()
+{
+    replacementParameters.assign(replacements.size(), ReplacementParameter{-1, false});
+    if (parameters.empty())
+    {
+        return;
+    }
+
+    std::vector<bool> seen(parameters.size(), false);
+    for (size_t i = replacements.size(); i-- > 0;)
+    {
+        const Token &repl = replacements[i];
+        if (repl.type != Token::IDENTIFIER)
+        {
+            continue;
+        }
+
+        auto iter = std::find(parameters.begin(), parameters.end(), repl.text);
+        if (iter == parameters.end())
+        {
+            continue;
+        }
+
+        size_t index                     = std::distance(parameters.begin(), iter);
+        replacementParameters[i].index   = static_cast<int>(index);
+        replacementParameters[i].lastUse = !seen[index];
+        seen[index]                      = true;
+    }
+}
+
 void PredefineMacro(MacroSet *macroSet, const char *name, int value)
 {
     Token token;
@@ -36,6 +68,7 @@ void PredefineMacro(MacroSet *macroSet, const char *name, int value)
     macro->type                  = Macro::kTypeObj;
     macro->name                  = name;
     macro->replacements.push_back(token);
+    macro->resolveReplacementParameters();
 
     (*macroSet)[name] = macro;
 }
@@ -30,10 +30,25 @@ struct Macro
     typedef std::vector<std::string> Parameters;
     typedef std::vector<Token> Replacements;
 
+    // Parameter substitution info for a replacement token, precomputed when the macro is defined
+    // so that expansion doesn't need to search the parameter list.
+    struct ReplacementParameter
+    {
+        // Index into parameters, or -1 if the replacement token is not a parameter.
+        int index;
+        // True if no later replacement token refers to the same parameter, so the argument can
+        // be moved instead of copied.
+        bool lastUse;
+    };
+    typedef std::vector<ReplacementParameter> ReplacementParameters;
+
     Macro();
     ~Macro();
     bool equals(const Macro &other) const;
 
+    // Fills replacementParameters. Must be called once parameters and replacements are final.
+    void resolveReplacementParameters();
+
     bool predefined;
     mutable bool disabled;
     mutable int expansionCount;
@@ -42,6 +57,7 @@ struct Macro
     std::string name;
     Parameters parameters;
     Replacements replacements;
+    ReplacementParameters replacementParameters;
 };
 
 typedef std::map<std::string, std::shared_ptr<Macro>> MacroSet;
@@ -7,7 +7,7 @@
 #include "compiler/preprocessor/MacroExpander.h"
 
 #include <GLSLANG/ShaderLang.h>
-#include <algorithm>
+#include <iterator>
 
 #include "common/debug.h"
 #include "compiler/preprocessor/DiagnosticsBase.h"
@@ -24,33 +24,28 @@ namespace
 
 const size_t kMaxContextTokens = 10000;
 
+// Lexes a range of tokens. The tokens are moved out of the range as they are lexed.
 class TokenLexer : public Lexer
 {
   public:
-    typedef std::vector<Token> TokenVector;
-
-    TokenLexer(TokenVector *tokens)
-    {
-        tokens->swap(mTokens);
-        mIter = mTokens.begin();
-    }
+    TokenLexer(Token *begin, Token *end) : mIter(begin), mEnd(end) {}
 
     void lex(Token *token) override
     {
-        if (mIter == mTokens.end())
+        if (mIter == mEnd)
         {
             token->reset();
             token->type = Token::LAST;
         }
         else
         {
-            *token = *mIter++;
+            *token = std::move(*mIter++);
         }
     }
 
   private:
-    TokenVector mTokens;
-    TokenVector::const_iterator mIter;
+    Token *mIter;
+    Token *mEnd;
 };
 
 }  // anonymous namespace
@@ -195,7 +190,7 @@ void MacroExpander::getToken(Token *token)
 {
     if (mReserveToken.get())
     {
-        *token = *mReserveToken;
+        *token = std::move(*mReserveToken);
         mReserveToken.reset();
         return;
     }
@@ -208,7 +203,7 @@ void MacroExpander::getToken(Token *token)
 
     if (!mContextStack.empty())
     {
-        *token = mContextStack.back()->get();
+        mContextStack.back()->get(token);
     }
     else
     {
@@ -223,7 +218,7 @@ void MacroExpander::ungetToken(const Token &token)
     {
         MacroContext *context = mContextStack.back();
         context->unget();
-        ASSERT(context->replacements[context->index] == token);
+        ASSERT(context->peek().type == token.type && context->peek().text == token.text);
     }
     else
     {
@@ -250,18 +245,16 @@ bool MacroExpander::pushMacro(std::shared_ptr<Macro> macro, const Token &identif
     ASSERT(identifier.type == Token::IDENTIFIER);
     ASSERT(identifier.text == macro->name);
 
-    std::vector<Token> replacements;
-    if (!expandMacro(*macro, identifier, &replacements))
+    std::unique_ptr<MacroContext> context(new MacroContext);
+    if (!expandMacro(*macro, identifier, context.get()))
         return false;
 
     // Macro is disabled for expansion until it is popped off the stack.
     macro->disabled = true;
 
-    MacroContext *context = new MacroContext;
-    context->macro        = macro;
-    context->replacements.swap(replacements);
-    mContextStack.push_back(context);
-    mTotalTokensInContexts += context->replacements.size();
+    context->macro = macro;
+    mTotalTokensInContexts += context->size();
+    mContextStack.push_back(context.release());
     return true;
 }
 
@@ -284,78 +277,73 @@ void MacroExpander::popMacro()
         context->macro->disabled = false;
     }
     context->macro->expansionCount--;
-    mTotalTokensInContexts -= context->replacements.size();
+    mTotalTokensInContexts -= context->size();
     delete context;
 }
 
 bool MacroExpander::expandMacro(const Macro &macro,
                                 const Token &identifier,
-                                std::vector<Token> *replacements)
+                                MacroContext *context)
 {
-    replacements->clear();
+    // The first token in the replacement list inherits the padding properties of the identifier
+    // token.
+    context->atStartOfLine   = identifier.atStartOfLine();
+    context->hasLeadingSpace = identifier.hasLeadingSpace();
 
     // In the case of an object-like macro, the replacement list gets its location
     // from the identifier, but in the case of a function-like macro, the replacement
     // list gets its location from the closing parenthesis of the macro invocation.
     // This is tested by dEQP-GLES3.functional.shaders.preprocessor.predefined_macros.*
-    SourceLocation replacementLocation = identifier.location;
+    context->location = identifier.location;
     if (macro.type == Macro::kTypeObj)
     {
-        replacements->assign(macro.replacements.begin(), macro.replacements.end());
-
-        if (macro.predefined)
+        if (!macro.predefined)
         {
-            const char kLine[] = "__LINE__";
-            const char kFile[] = "__FILE__";
+            context->tokens = &macro.replacements;
+            return true;
+        }
 
-            ASSERT(replacements->size() == 1);
-            Token &repl = replacements->front();
-            if (macro.name == kLine)
-            {
-                repl.text = ToString(identifier.location.line);
-            }
-            else if (macro.name == kFile)
-            {
-                repl.text = ToString(identifier.location.file);
-            }
+        const char kLine[] = "__LINE__";
+        const char kFile[] = "__FILE__";
+
+        context->replacements = macro.replacements;
+        ASSERT(context->replacements.size() == 1);
+        Token &repl = context->replacements.front();
+        if (macro.name == kLine)
+        {
+            repl.text = ToString(identifier.location.line);
+        }
+        else if (macro.name == kFile)
+        {
+            repl.text = ToString(identifier.location.file);
         }
     }
     else
     {
         ASSERT(macro.type == Macro::kTypeFunc);
-        std::vector<MacroArg> args;
-        args.reserve(macro.parameters.size());
-        if (!collectMacroArgs(macro, identifier, &args, &replacementLocation))
+        MacroArgs args;
+        args.ends.reserve(macro.parameters.size());
+        if (!collectMacroArgs(macro, identifier, &args, &context->location))
             return false;
 
-        replaceMacroParams(macro, args, replacements);
+        replaceMacroParams(macro, &args, &context->replacements);
     }
 
-    for (std::size_t i = 0; i < replacements->size(); ++i)
-    {
-        Token &repl = replacements->at(i);
-        if (i == 0)
-        {
-            // The first token in the replacement list inherits the padding
-            // properties of the identifier token.
-            repl.setAtStartOfLine(identifier.atStartOfLine());
-            repl.setHasLeadingSpace(identifier.hasLeadingSpace());
-        }
-        repl.location = replacementLocation;
-    }
+    context->tokens = &context->replacements;
     return true;
 }
 
 bool MacroExpander::collectMacroArgs(const Macro &macro,
                                      const Token &identifier,
-                                     std::vector<MacroArg> *args,
+                                     MacroArgs *args,
                                      SourceLocation *closingParenthesisLocation)
 {
     Token token;
     getToken(&token);
     ASSERT(token.type == '(');
 
-    args->push_back(MacroArg());
+    MacroArgs rawArgs;
+    rawArgs.ends.reserve(macro.parameters.size());
 
     // Defer reenabling macros until args collection is finished to avoid the possibility of
     // infinite recursion. Otherwise infinite recursion might happen when expanding the args after
@@ -393,7 +381,7 @@ bool MacroExpander::collectMacroArgs(const Macro &macro,
                 // the comma tokens between matching inner parentheses do not
                 // seperate arguments.
                 if (openParens == 1)
-                    args->push_back(MacroArg());
+                    rawArgs.ends.push_back(rawArgs.tokens.size());
                 isArg = openParens != 1;
                 break;
             default:
@@ -402,24 +390,24 @@ bool MacroExpander::collectMacroArgs(const Macro &macro,
         }
         if (isArg)
         {
-            MacroArg &arg = args->back();
             // Initial whitespace is not part of the argument.
-            if (arg.empty())
+            if (rawArgs.begin(rawArgs.count()) == rawArgs.tokens.size())
                 token.setHasLeadingSpace(false);
-            arg.push_back(token);
+            rawArgs.tokens.push_back(std::move(token));
         }
     }
+    rawArgs.ends.push_back(rawArgs.tokens.size());
 
     const Macro::Parameters &params = macro.parameters;
     // If there is only one empty argument, it is equivalent to no argument.
-    if (params.empty() && (args->size() == 1) && args->front().empty())
+    if (params.empty() && (rawArgs.count() == 1) && rawArgs.tokens.empty())
     {
-        args->clear();
+        rawArgs.ends.clear();
     }
     // Validate the number of arguments.
-    if (args->size() != params.size())
+    if (rawArgs.count() != params.size())
     {
-        Diagnostics::ID id = args->size() < macro.parameters.size()
+        Diagnostics::ID id = rawArgs.count() < macro.parameters.size()
                                  ? Diagnostics::PP_MACRO_TOO_FEW_ARGS
                                  : Diagnostics::PP_MACRO_TOO_MANY_ARGS;
         mDiagnostics->report(id, identifier.location, identifier.text);
@@ -429,10 +417,12 @@ bool MacroExpander::collectMacroArgs(const Macro &macro,
     // Pre-expand each argument before substitution.
     // This step expands each argument individually before they are
     // inserted into the macro body.
+    args->tokens.reserve(rawArgs.tokens.size());
     size_t numTokens = 0;
-    for (auto &arg : *args)
+    for (size_t index = 0; index < rawArgs.count(); ++index)
     {
-        TokenLexer lexer(&arg);
+        TokenLexer lexer(rawArgs.tokens.data() + rawArgs.begin(index),
+                         rawArgs.tokens.data() + rawArgs.end(index));
         if (mSettings.maxMacroExpansionDepth < 1)
         {
             mDiagnostics->report(Diagnostics::PP_MACRO_INVOCATION_CHAIN_TOO_DEEP, token.location,
@@ -443,11 +433,10 @@ bool MacroExpander::collectMacroArgs(const Macro &macro,
         nestedSettings.maxMacroExpansionDepth = mSettings.maxMacroExpansionDepth - 1;
         MacroExpander expander(&lexer, mMacroSet, mDiagnostics, nestedSettings, mParseDefined);
 
-        arg.clear();
         expander.lex(&token);
         while (token.type != Token::LAST)
         {
-            arg.push_back(token);
+            args->tokens.push_back(std::move(token));
             expander.lex(&token);
             numTokens++;
             if (numTokens + mTotalTokensInContexts > kMaxContextTokens)
@@ -456,14 +445,18 @@ bool MacroExpander::collectMacroArgs(const Macro &macro,
                 return false;
             }
         }
+        args->ends.push_back(args->tokens.size());
     }
     return true;
 }
 
 void MacroExpander::replaceMacroParams(const Macro &macro,
-                                       const std::vector<MacroArg> &args,
+                                       MacroArgs *args,
                                        std::vector<Token> *replacements)
 {
+    ASSERT(macro.replacementParameters.size() == macro.replacements.size());
+    replacements->reserve(macro.replacements.size() + args->tokens.size());
+
     for (std::size_t i = 0; i < macro.replacements.size(); ++i)
     {
         if (!replacements->empty() &&
@@ -474,50 +467,67 @@ void MacroExpander::replaceMacroParams(const Macro &macro,
             return;
         }
 
-        const Token &repl = macro.replacements[i];
-        if (repl.type != Token::IDENTIFIER)
+        const Token &repl                          = macro.replacements[i];
+        const Macro::ReplacementParameter &param = macro.replacementParameters[i];
+        if (param.index < 0)
         {
             replacements->push_back(repl);
             continue;
         }
 
-        // TODO(alokp): Optimize this.
-        // There is no need to search for macro params every time.
-        // The param index can be cached with the replacement token.
-        Macro::Parameters::const_iterator iter =
-            std::find(macro.parameters.begin(), macro.parameters.end(), repl.text);
-        if (iter == macro.parameters.end())
+        auto argBegin = args->tokens.begin() + args->begin(param.index);
+        auto argEnd   = args->tokens.begin() + args->end(param.index);
+        if (argBegin == argEnd)
         {
-            replacements->push_back(repl);
             continue;
         }
-
-        std::size_t iArg    = std::distance(macro.parameters.begin(), iter);
-        const MacroArg &arg = args[iArg];
-        if (arg.empty())
+        std::size_t iRepl = replacements->size();
+        if (param.lastUse)
         {
-            continue;
+            replacements->insert(replacements->end(), std::make_move_iterator(argBegin),
+                                 std::make_move_iterator(argEnd));
+        }
+        else
+        {
+            replacements->insert(replacements->end(), argBegin, argEnd);
         }
-        std::size_t iRepl = replacements->size();
-        replacements->insert(replacements->end(), arg.begin(), arg.end());
         // The replacement token inherits padding properties from
         // macro replacement token.
         replacements->at(iRepl).setHasLeadingSpace(repl.hasLeadingSpace());
     }
 }
 
-MacroExpander::MacroContext::MacroContext() : macro(0), index(0) {}
+MacroExpander::MacroContext::MacroContext()
+    : macro(0), index(0), tokens(nullptr), atStartOfLine(false), hasLeadingSpace(false)
+{}
 
 MacroExpander::MacroContext::~MacroContext() {}
 
 bool MacroExpander::MacroContext::empty() const
 {
-    return index == replacements.size();
+    return index == tokens->size();
+}
+
+std::size_t MacroExpander::MacroContext::size() const
+{
+    return tokens->size();
+}
+
+void MacroExpander::MacroContext::get(Token *token)
+{
+    *token          = (*tokens)[index];
+    token->location = location;
+    if (index == 0)
+    {
+        token->setAtStartOfLine(atStartOfLine);
+        token->setHasLeadingSpace(hasLeadingSpace);
+    }
+    ++index;
 }
 
-const Token &MacroExpander::MacroContext::get()
+const Token &MacroExpander::MacroContext::peek() const
 {
-    return replacements[index++];
+    return (*tokens)[index];
 }
 
 void MacroExpander::MacroContext::unget()
@@ -13,6 +13,7 @@
 #include "compiler/preprocessor/Lexer.h"
 #include "compiler/preprocessor/Macro.h"
 #include "compiler/preprocessor/Preprocessor.h"
+#include "compiler/preprocessor/SourceLocation.h"
 
 namespace angle
 {
@@ -21,7 +22,6 @@ namespace pp
 {
 
 class Diagnostics;
-struct SourceLocation;
 
 class MacroExpander : public Lexer
 {
@@ -43,30 +43,53 @@ class MacroExpander : public Lexer
     bool pushMacro(std::shared_ptr<Macro> macro, const Token &identifier);
     void popMacro();
 
-    bool expandMacro(const Macro &macro, const Token &identifier, std::vector<Token> *replacements);
-
-    typedef std::vector<Token> MacroArg;
-    bool collectMacroArgs(const Macro &macro,
-                          const Token &identifier,
-                          std::vector<MacroArg> *args,
-                          SourceLocation *closingParenthesisLocation);
-    void replaceMacroParams(const Macro &macro,
-                            const std::vector<MacroArg> &args,
-                            std::vector<Token> *replacements);
-
     struct MacroContext
     {
         MacroContext();
         ~MacroContext();
         bool empty() const;
-        const Token &get();
+        std::size_t size() const;
+        void get(Token *token);
         void unget();
+        const Token &peek() const;
 
         std::shared_ptr<Macro> macro;
         std::size_t index;
+
+        // Object-like macros read their tokens straight from the macro's replacement list.
+        // Function-like and predefined macros build their expansion in |replacements|.
+        const std::vector<Token> *tokens;
         std::vector<Token> replacements;
+
+        // Applied to the tokens as they are read, so that the replacement list doesn't need to
+        // be copied just to update these.
+        SourceLocation location;
+        bool atStartOfLine;
+        bool hasLeadingSpace;
     };
 
+    bool expandMacro(const Macro &macro, const Token &identifier, MacroContext *context);
+
+    // The arguments of a function-like macro invocation. They are stored back to back so that
+    // collecting and pre-expanding them doesn't allocate a token list per argument.
+    struct MacroArgs
+    {
+        std::size_t count() const { return ends.size(); }
+        // Index of the first token of the argument. Passing count() gives the start of the
+        // argument that is being collected.
+        std::size_t begin(std::size_t index) const { return index == 0 ? 0 : ends[index - 1]; }
+        std::size_t end(std::size_t index) const { return ends[index]; }
+
+        std::vector<Token> tokens;
+        std::vector<std::size_t> ends;
+    };
+
+    bool collectMacroArgs(const Macro &macro,
+                          const Token &identifier,
+                          MacroArgs *args,
+                          SourceLocation *closingParenthesisLocation);
+    void replaceMacroParams(const Macro &macro, MacroArgs *args, std::vector<Token> *replacements);
+
     Lexer *mLexer;
     MacroSet *mMacroSet;
     Diagnostics *mDiagnostics;
@@ -6,6 +6,7 @@
 
 #include "compiler/translator/Compiler.h"
 
+#include <chrono>
 #include <sstream>
 
 #include "angle_gl.h"
@@ -14,6 +15,7 @@
 #include "compiler/translator/CollectVariables.h"
 #include "compiler/translator/Initialize.h"
 #include "compiler/translator/IsASTDepthBelowLimit.h"
+#include "compiler/translator/MinifyWhitespace.h"
 #include "compiler/translator/OutputTree.h"
 #include "compiler/translator/ParseContext.h"
 #include "compiler/translator/ValidateLimitations.h"
@@ -185,6 +187,28 @@ class TScopedPoolAllocator
     angle::PoolAllocator *mAllocator;
 };
 
+class ScopedPhaseTimer : angle::NonCopyable
+{
+  public:
+    ScopedPhaseTimer(double *phaseTime)
+        : mPhaseTime(phaseTime),
+          mStartTime(phaseTime ? std::chrono::steady_clock::now()
+                               : std::chrono::steady_clock::time_point())
+    {}
+    ~ScopedPhaseTimer()
+    {
+        if (mPhaseTime)
+        {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStartTime;
+            *mPhaseTime += elapsed.count();
+        }
+    }
+
+  private:
+    double *mPhaseTime;
+    std::chrono::steady_clock::time_point mStartTime;
+};
+
 class TScopedSymbolTableLevel
 {
   public:
@@ -225,6 +249,19 @@ int GetMaxShaderVersionForSpec(ShShaderSpec spec)
     }
 }
 
+bool ValidateBuiltInResources(const ShBuiltInResources &resources)
+{
+    if (resources.MaxDrawBuffers < 1)
+    {
+        return false;
+    }
+    if (resources.EXT_blend_func_extended && resources.MaxDualSourceDrawBuffers < 1)
+    {
+        return false;
+    }
+    return true;
+}
+
 bool ValidateFragColorAndFragData(GLenum shaderType,
                                   int shaderVersion,
                                   const TSymbolTable &symbolTable,
@@ -292,6 +329,8 @@ TCompiler::TCompiler(sh::GLenum type, ShShaderSpec spec, ShShaderOutput output)
       mOutputType(output),
       mBuiltInFunctionEmulator(),
       mDiagnostics(mInfoSink.info),
+      mObjectCodeSizeReduction(0),
+      mMeasurePhaseTimes(false),
       mSourcePath(nullptr),
       mComputeShaderLocalSizeDeclared(false),
       mComputeShaderLocalSize(1),
@@ -329,6 +368,36 @@ bool TCompiler::Init(const ShBuiltInResources &resources)
     return true;
 }
 
+bool TCompiler::updateResources(const ShBuiltInResources &resources)
+{
+    // The resources are memset before they are filled in, so they can be compared as memory.
+    if (memcmp(&resources, &mResources, sizeof(ShBuiltInResources)) == 0)
+    {
+        return true;
+    }
+
+    if (!ValidateBuiltInResources(resources))
+    {
+        return false;
+    }
+
+    // The built-in symbols live in the base level of the pool. Release them and rebuild the
+    // symbol table in its place, keeping the pool pages for the new symbols.
+    mSymbolTable.releaseBuiltIns();
+    allocator.pop();
+    allocator.push();
+    SetGlobalPoolAllocator(&allocator);
+    mSymbolTable.initializeBuiltIns(mShaderType, mShaderSpec, resources);
+
+    mResources = resources;
+    setResourceString();
+
+    mExtensionBehavior.clear();
+    InitExtensionBehavior(resources, mExtensionBehavior);
+    mArrayBoundsClamper.SetClampingStrategy(resources.ArrayIndexClampingStrategy);
+    return true;
+}
+
 TIntermBlock *TCompiler::compileTreeForTesting(const char *const shaderStrings[],
                                                size_t numStrings,
                                                ShCompileOptions compileOptions)
@@ -349,30 +418,7 @@ TIntermBlock *TCompiler::compileTreeImpl(const char *const shaderStrings[],
     ASSERT(GetGlobalPoolAllocator());
 
     // Reset the extension behavior for each compilation unit.
-    ResetExtensionBehavior(mExtensionBehavior);
-
-    // If gl_DrawID is not supported, remove it from the available extensions
-    // Currently we only allow emulation of gl_DrawID
-    const bool glDrawIDSupported = (compileOptions & SH_EMULATE_GL_DRAW_ID) != 0u;
-    if (!glDrawIDSupported)
-    {
-        auto it = mExtensionBehavior.find(TExtension::ANGLE_multi_draw);
-        if (it != mExtensionBehavior.end())
-        {
-            mExtensionBehavior.erase(it);
-        }
-    }
-
-    const bool glBaseVertexBaseInstanceSupported =
-        (compileOptions & SH_EMULATE_GL_BASE_VERTEX_BASE_INSTANCE) != 0u;
-    if (!glBaseVertexBaseInstanceSupported)
-    {
-        auto it = mExtensionBehavior.find(TExtension::ANGLE_base_vertex_base_instance);
-        if (it != mExtensionBehavior.end())
-        {
-            mExtensionBehavior.erase(it);
-        }
-    }
+    ResetExtensionBehavior(mResources, mExtensionBehavior, compileOptions);
 
     // First string is path of source file if flag is set. The actual source follows.
     size_t firstSource = 0;
@@ -394,12 +440,17 @@ TIntermBlock *TCompiler::compileTreeImpl(const char *const shaderStrings[],
     ASSERT(mSymbolTable.atGlobalLevel());
 
     // Parse shader.
-    if (PaParseStrings(numStrings - firstSource, &shaderStrings[firstSource], nullptr,
-                       &parseContext) != 0)
     {
-        return nullptr;
+        ScopedPhaseTimer parseTimer(mMeasurePhaseTimes ? &mPhaseTimes.parse : nullptr);
+        if (PaParseStrings(numStrings - firstSource, &shaderStrings[firstSource], nullptr,
+                           &parseContext) != 0)
+        {
+            return nullptr;
+        }
     }
 
+    ScopedPhaseTimer astPassesTimer(mMeasurePhaseTimes ? &mPhaseTimes.astPasses : nullptr);
+
     if (parseContext.getTreeRoot() == nullptr)
     {
         return nullptr;
@@ -929,11 +980,35 @@ bool TCompiler::compile(const char *const shaderStrings[],
 
         if (compileOptions & SH_OBJECT_CODE)
         {
+            // The translated shader is typically larger than the source. Reserving up front
+            // avoids growing the output string over and over for very large shaders.
+            size_t sourceLength = 0;
+            for (size_t stringIndex = 0; stringIndex < numStrings; ++stringIndex)
+            {
+                sourceLength += strlen(shaderStrings[stringIndex]);
+            }
+            mInfoSink.obj.reserve(sourceLength * 2);
+
+            ScopedPhaseTimer outputTimer(mMeasurePhaseTimes ? &mPhaseTimes.output : nullptr);
             PerformanceDiagnostics perfDiagnostics(&mDiagnostics);
             if (!translate(root, compileOptions, &perfDiagnostics))
             {
                 return false;
             }
+
+            // Vulkan GLSL output is still patched textually before it's compiled to SPIR-V, so
+            // only GLSL and ESSL output are compacted.
+            if ((compileOptions & SH_MINIFY_OUTPUT) != 0 &&
+                (IsOutputGLSL(mOutputType) || IsOutputESSL(mOutputType)))
+            {
+                std::string minified = MinifyWhitespace(mInfoSink.obj.str());
+                if (minified.size() < mInfoSink.obj.str().size())
+                {
+                    addObjectCodeSizeReduction(mInfoSink.obj.str().size() - minified.size());
+                    mInfoSink.obj.erase();
+                    mInfoSink.obj << minified;
+                }
+            }
         }
 
         if (mShaderType == GL_VERTEX_SHADER)
@@ -979,11 +1054,7 @@ bool TCompiler::compile(const char *const shaderStrings[],
 
 bool TCompiler::initBuiltInSymbolTable(const ShBuiltInResources &resources)
 {
-    if (resources.MaxDrawBuffers < 1)
-    {
-        return false;
-    }
-    if (resources.EXT_blend_func_extended && resources.MaxDualSourceDrawBuffers < 1)
+    if (!ValidateBuiltInResources(resources))
     {
         return false;
     }
@@ -1099,6 +1170,8 @@ void TCompiler::clearResults()
     mInfoSink.info.erase();
     mInfoSink.obj.erase();
     mInfoSink.debug.erase();
+    mObjectCodeSizeReduction = 0;
+    mPhaseTimes              = CompilePhaseTimes();
     mDiagnostics.resetErrorCount();
 
     mAttributes.clear();
@@ -64,12 +64,23 @@ class TShHandleBase
     virtual TranslatorHLSL *getAsTranslatorHLSL() { return 0; }
 #endif  // ANGLE_ENABLE_HLSL
 
+    const angle::PoolAllocator &getAllocator() const { return allocator; }
+
   protected:
     // Memory allocator. Allocates and tracks memory required by the compiler.
     // Deallocates all memory when compiler is destructed.
     angle::PoolAllocator allocator;
 };
 
+// Time spent in the phases of a compilation, in seconds.
+struct CompilePhaseTimes
+{
+    // Preprocessing is driven by the parser, so it's included in the parse time.
+    double parse     = 0.0;
+    double astPasses = 0.0;
+    double output    = 0.0;
+};
+
 //
 // The base class for the machine dependent compiler to derive from
 // for managing object code from the compile.
@@ -83,6 +94,10 @@ class TCompiler : public TShHandleBase
 
     bool Init(const ShBuiltInResources &resources);
 
+    // Rebuilds the built-in symbol table and extension behavior for new resources, unless they
+    // are unchanged. Returns false if the resources are invalid, leaving the old ones in place.
+    bool updateResources(const ShBuiltInResources &resources);
+
     // compileTreeForTesting should be used only when tests require access to
     // the AST. Users of this function need to manually manage the global pool
     // allocator. Returns nullptr whenever there are compilation errors.
@@ -97,6 +112,11 @@ class TCompiler : public TShHandleBase
     // Get results of the last compilation.
     int getShaderVersion() const { return mShaderVersion; }
     TInfoSink &getInfoSink() { return mInfoSink; }
+    size_t getObjectCodeSizeReduction() const { return mObjectCodeSizeReduction; }
+
+    // Phase times are only measured when enabled, for benchmarking.
+    void setMeasurePhaseTimes(bool measure) { mMeasurePhaseTimes = measure; }
+    const CompilePhaseTimes &getPhaseTimes() const { return mPhaseTimes; }
 
     bool isComputeShaderLocalSizeDeclared() const { return mComputeShaderLocalSizeDeclared; }
     const sh::WorkGroupSize &getComputeShaderLocalSize() const { return mComputeShaderLocalSize; }
@@ -161,6 +181,8 @@ class TCompiler : public TShHandleBase
     void writePragma(ShCompileOptions compileOptions);
     // Relies on collectVariables having been called.
     bool isVaryingDefined(const char *varyingName);
+    // Accounts for bytes that SH_MINIFY_OUTPUT saved while writing the object code.
+    void addObjectCodeSizeReduction(size_t bytes) { mObjectCodeSizeReduction += bytes; }
 
     const ArrayBoundsClamper &getArrayBoundsClamper() const;
     ShArrayIndexClampingStrategy getArrayIndexClampingStrategy() const;
@@ -262,6 +284,9 @@ class TCompiler : public TShHandleBase
     int mShaderVersion;
     TInfoSink mInfoSink;  // Output sink.
     TDiagnostics mDiagnostics;
+    size_t mObjectCodeSizeReduction;
+    bool mMeasurePhaseTimes;
+    CompilePhaseTimes mPhaseTimes;
     const char *mSourcePath;  // Path of source file or NULL
 
     // compute shader local group size
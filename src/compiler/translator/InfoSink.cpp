@@ -6,6 +6,9 @@
 
 #include "compiler/translator/InfoSink.h"
 
+#include <ctype.h>
+#include <stdio.h>
+
 #include "compiler/translator/ImmutableString.h"
 #include "compiler/translator/Types.h"
 
@@ -30,7 +33,33 @@ void TInfoSinkBase::prefix(Severity severity)
 
 TInfoSinkBase &TInfoSinkBase::operator<<(const ImmutableString &str)
 {
-    sink.append(str.data());
+    sink.append(str.data(), str.length());
+    return *this;
+}
+
+TInfoSinkBase &TInfoSinkBase::operator<<(float f)
+{
+    // Make sure that at least one decimal point is written. If a number does not have a
+    // fractional part, the default precision format does not write the decimal portion which gets
+    // interpreted as integer by the compiler. The formats match what a stream produces with
+    // std::fixed/precision(1) and the default float field/precision(8) respectively.
+    char buffer[64];
+    int length = fractionalPart(f) == 0.0f ? snprintf(buffer, sizeof(buffer), "%.1f", f)
+                                           : snprintf(buffer, sizeof(buffer), "%.8g", f);
+    ASSERT(length > 0 && static_cast<size_t>(length) < sizeof(buffer));
+
+    // Unlike the stream, which is imbued with the classic locale, snprintf uses the global
+    // locale. The only character that can differ is the decimal point.
+    for (int index = 0; index < length; ++index)
+    {
+        char c = buffer[index];
+        if (!isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '+')
+        {
+            buffer[index] = '.';
+        }
+    }
+
+    sink.append(buffer, length);
     return *this;
 }
 
@@ -69,14 +98,11 @@ TInfoSinkBase &TInfoSinkBase::operator<<(const TType &type)
 
 void TInfoSinkBase::location(int file, int line)
 {
-    TPersistStringStream stream = sh::InitializeStream<TPersistStringStream>();
     if (line)
-        stream << file << ":" << line;
+        *this << file << ":" << line;
     else
-        stream << file << ":? ";
-    stream << ": ";
-
-    sink.append(stream.str());
+        *this << file << ":? ";
+    sink.append(": ");
 }
 
 }  // namespace sh
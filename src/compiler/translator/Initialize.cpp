@@ -103,7 +103,9 @@ void InitExtensionBehavior(const ShBuiltInResources &resources, TExtensionBehavi
     }
 }
 
-void ResetExtensionBehavior(TExtensionBehavior &extBehavior)
+void ResetExtensionBehavior(const ShBuiltInResources &resources,
+                            TExtensionBehavior &extBehavior,
+                            const ShCompileOptions compileOptions)
 {
     for (auto &ext : extBehavior)
     {
@@ -116,6 +118,32 @@ void ResetExtensionBehavior(TExtensionBehavior &extBehavior)
             ext.second = EBhUndefined;
         }
     }
+
+    // gl_DrawID and gl_BaseVertex/gl_BaseInstance are only available through emulation, so these
+    // extensions depend on the compile options as well. They are added back here in case a
+    // previous compilation with different options has removed them.
+    if (resources.ANGLE_multi_draw)
+    {
+        if ((compileOptions & SH_EMULATE_GL_DRAW_ID) != 0u)
+        {
+            extBehavior[TExtension::ANGLE_multi_draw] = EBhUndefined;
+        }
+        else
+        {
+            extBehavior.erase(TExtension::ANGLE_multi_draw);
+        }
+    }
+    if (resources.ANGLE_base_vertex_base_instance)
+    {
+        if ((compileOptions & SH_EMULATE_GL_BASE_VERTEX_BASE_INSTANCE) != 0u)
+        {
+            extBehavior[TExtension::ANGLE_base_vertex_base_instance] = EBhUndefined;
+        }
+        else
+        {
+            extBehavior.erase(TExtension::ANGLE_base_vertex_base_instance);
+        }
+    }
 }
 
 }  // namespace sh
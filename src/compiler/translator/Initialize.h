@@ -18,10 +18,12 @@ void InitExtensionBehavior(const ShBuiltInResources &resources,
                            TExtensionBehavior &extensionBehavior);
 
 // Resets the behavior of the extensions listed in |extensionBehavior| to the
-// undefined state. These extensions will only be those initially supported in
-// the ShBuiltInResources object for this compiler instance. All other
-// extensions will remain unsupported.
-void ResetExtensionBehavior(TExtensionBehavior &extensionBehavior);
+// undefined state. These extensions will only be those supported in |resources|,
+// minus the ones that require compile options that are not set in |compileOptions|.
+// All other extensions will remain unsupported.
+void ResetExtensionBehavior(const ShBuiltInResources &resources,
+                            TExtensionBehavior &extensionBehavior,
+                            const ShCompileOptions compileOptions);
 
 }  // namespace sh
 
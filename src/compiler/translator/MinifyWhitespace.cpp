@@ -0,0 +1,159 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// MinifyWhitespace.cpp: Implements MinifyWhitespace.
+//
+
+#include "compiler/translator/MinifyWhitespace.h"
+
+#include <cstring>
+
+namespace sh
+{
+
+namespace
+{
+
+bool IsWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+bool IsIdentifierOrNumberChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '.';
+}
+
+// Whether removing the whitespace between |before| and |after| would merge two tokens into one.
+bool NeedsSeparator(char before, char after)
+{
+    if (IsIdentifierOrNumberChar(before) && IsIdentifierOrNumberChar(after))
+    {
+        return true;
+    }
+
+    static constexpr const char *kOperators[] = {"++", "--", "+=", "-=", "*=", "/=", "%=", "<<",
+                                                 ">>", "<=", ">=", "==", "!=", "&&", "||", "^^",
+                                                 "&=", "|=", "^=", "//", "/*", "*/"};
+    for (const char *op : kOperators)
+    {
+        if (op[0] == before && op[1] == after)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Statements and blocks may still end lines, which keeps the line length in check for drivers
+// that don't cope well with very long lines.
+bool EndsLine(char c)
+{
+    return c == ';' || c == '{' || c == '}';
+}
+
+}  // anonymous namespace
+
+std::string MinifyWhitespace(const std::string &source)
+{
+    std::string minified;
+    minified.reserve(source.size());
+
+    const size_t length = source.size();
+    bool atLineStart    = true;
+    bool skippedSpace   = false;
+    bool skippedNewline = false;
+    size_t pos          = 0;
+
+    while (pos < length)
+    {
+        const char c = source[pos];
+
+        if (IsWhitespace(c))
+        {
+            skippedSpace = true;
+            if (c == '\n')
+            {
+                skippedNewline = true;
+                atLineStart    = true;
+            }
+            ++pos;
+            continue;
+        }
+
+        if (c == '/' && pos + 1 < length && source[pos + 1] == '/')
+        {
+            // Line comment. The newline that ends it is handled as whitespace.
+            while (pos < length && source[pos] != '\n')
+            {
+                ++pos;
+            }
+            skippedSpace = true;
+            continue;
+        }
+
+        if (c == '/' && pos + 1 < length && source[pos + 1] == '*')
+        {
+            size_t end = source.find("*/", pos + 2);
+            end        = end == std::string::npos ? length : end + 2;
+            if (memchr(source.data() + pos, '\n', end - pos) != nullptr)
+            {
+                skippedNewline = true;
+                atLineStart    = true;
+            }
+            skippedSpace = true;
+            pos          = end;
+            continue;
+        }
+
+        if (c == '#' && atLineStart)
+        {
+            // Preprocessor directives are copied as they are, including line continuations.
+            if (!minified.empty() && minified.back() != '\n')
+            {
+                minified.push_back('\n');
+            }
+            size_t end = pos;
+            while (end < length && source[end] != '\n')
+            {
+                end += (source[end] == '\\' && end + 1 < length) ? 2 : 1;
+            }
+            minified.append(source, pos, end - pos);
+            minified.push_back('\n');
+
+            pos            = end;
+            skippedSpace   = false;
+            skippedNewline = false;
+            continue;
+        }
+
+        if (skippedSpace && !minified.empty() && minified.back() != '\n')
+        {
+            if (skippedNewline && EndsLine(minified.back()))
+            {
+                minified.push_back('\n');
+            }
+            else if (NeedsSeparator(minified.back(), c))
+            {
+                minified.push_back(' ');
+            }
+        }
+
+        minified.push_back(c);
+        skippedSpace   = false;
+        skippedNewline = false;
+        atLineStart    = false;
+        ++pos;
+    }
+
+    if (!minified.empty() && minified.back() != '\n')
+    {
+        minified.push_back('\n');
+    }
+    return minified;
+}
+
+}  // namespace sh
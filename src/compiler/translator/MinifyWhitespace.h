@@ -0,0 +1,22 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// MinifyWhitespace: Removes comments and the whitespace that isn't needed to separate tokens from
+// translated GLSL or ESSL source. Preprocessor directives are kept on lines of their own.
+//
+
+#ifndef COMPILER_TRANSLATOR_MINIFYWHITESPACE_H_
+#define COMPILER_TRANSLATOR_MINIFYWHITESPACE_H_
+
+#include <string>
+
+namespace sh
+{
+
+std::string MinifyWhitespace(const std::string &source);
+
+}  // namespace sh
+
+#endif  // COMPILER_TRANSLATOR_MINIFYWHITESPACE_H_
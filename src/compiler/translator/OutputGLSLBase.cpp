@@ -10,6 +10,7 @@
 #include "common/debug.h"
 #include "common/mathutil.h"
 #include "compiler/translator/Compiler.h"
+#include "compiler/translator/ImmutableStringBuilder.h"
 #include "compiler/translator/util.h"
 
 #include <cfloat>
@@ -79,6 +80,166 @@ Stream &operator<<(Stream &out, CommaSeparatedListItemPrefixGenerator &gen)
     return out;
 }
 
+// Operator precedence levels of ESSL 3.00.6 section 5.1, from the highest to the lowest.
+enum class Precedence
+{
+    Primary,
+    Postfix,
+    Prefix,
+    Multiplicative,
+    Additive,
+    Shift,
+    Relational,
+    Equality,
+    BitwiseAnd,
+    BitwiseXor,
+    BitwiseOr,
+    LogicalAnd,
+    LogicalXor,
+    LogicalOr,
+    Ternary,
+    Assignment,
+    Sequence,
+};
+
+Precedence GetBinaryPrecedence(TOperator op)
+{
+    switch (op)
+    {
+        case EOpIndexDirect:
+        case EOpIndexIndirect:
+        case EOpIndexDirectStruct:
+        case EOpIndexDirectInterfaceBlock:
+            return Precedence::Postfix;
+        case EOpMul:
+        case EOpDiv:
+        case EOpIMod:
+        case EOpVectorTimesScalar:
+        case EOpVectorTimesMatrix:
+        case EOpMatrixTimesVector:
+        case EOpMatrixTimesScalar:
+        case EOpMatrixTimesMatrix:
+            return Precedence::Multiplicative;
+        case EOpAdd:
+        case EOpSub:
+            return Precedence::Additive;
+        case EOpBitShiftLeft:
+        case EOpBitShiftRight:
+            return Precedence::Shift;
+        case EOpLessThan:
+        case EOpGreaterThan:
+        case EOpLessThanEqual:
+        case EOpGreaterThanEqual:
+            return Precedence::Relational;
+        case EOpEqual:
+        case EOpNotEqual:
+            return Precedence::Equality;
+        case EOpBitwiseAnd:
+            return Precedence::BitwiseAnd;
+        case EOpBitwiseXor:
+            return Precedence::BitwiseXor;
+        case EOpBitwiseOr:
+            return Precedence::BitwiseOr;
+        case EOpLogicalAnd:
+            return Precedence::LogicalAnd;
+        case EOpLogicalXor:
+            return Precedence::LogicalXor;
+        case EOpLogicalOr:
+            return Precedence::LogicalOr;
+        case EOpComma:
+            return Precedence::Sequence;
+        default:
+            // Initialization and all the assignment operators.
+            return Precedence::Assignment;
+    }
+}
+
+bool IsPrefixUnaryOperator(TOperator op)
+{
+    switch (op)
+    {
+        case EOpNegative:
+        case EOpPositive:
+        case EOpLogicalNot:
+        case EOpBitwiseNot:
+        case EOpPreIncrement:
+        case EOpPreDecrement:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool IsPostfixUnaryOperator(TOperator op)
+{
+    return op == EOpPostIncrement || op == EOpPostDecrement;
+}
+
+Precedence GetPrecedence(TIntermTyped *node)
+{
+    if (TIntermBinary *binary = node->getAsBinaryNode())
+    {
+        return GetBinaryPrecedence(binary->getOp());
+    }
+    if (TIntermUnary *unary = node->getAsUnaryNode())
+    {
+        if (IsPrefixUnaryOperator(unary->getOp()))
+        {
+            return Precedence::Prefix;
+        }
+        // .length() is written as a postfix expression, the other unary operators as calls.
+        return IsPostfixUnaryOperator(unary->getOp()) || unary->getOp() == EOpArrayLength
+                   ? Precedence::Postfix
+                   : Precedence::Primary;
+    }
+    if (node->getAsTernaryNode())
+    {
+        return Precedence::Ternary;
+    }
+    if (node->getAsSwizzleNode())
+    {
+        return Precedence::Postfix;
+    }
+    if (node->getAsConstantUnion() && node->getType().isScalar())
+    {
+        // Scalar constants may be written with a sign, and "1." followed by a postfix operator
+        // doesn't parse, so they are treated like prefix expressions.
+        return Precedence::Prefix;
+    }
+    return Precedence::Primary;
+}
+
+// Local names are not visible outside of the shader, so they can be shortened freely. Structs and
+// their fields keep their names, since those need to match between shader stages.
+bool IsMinifiableSymbol(const TSymbol *symbol)
+{
+    if (symbol->symbolType() != SymbolType::UserDefined)
+    {
+        return false;
+    }
+    if (symbol->isFunction())
+    {
+        return !static_cast<const TFunction *>(symbol)->isMain();
+    }
+    if (!symbol->isVariable())
+    {
+        return false;
+    }
+    switch (static_cast<const TVariable *>(symbol)->getType().getQualifier())
+    {
+        case EvqTemporary:
+        case EvqGlobal:
+        case EvqConst:
+        case EvqIn:
+        case EvqOut:
+        case EvqInOut:
+        case EvqConstReadOnly:
+            return true;
+        default:
+            return false;
+    }
+}
+
 }  // namespace
 
 TOutputGLSLBase::TOutputGLSLBase(TInfoSinkBase &objSink,
@@ -99,7 +260,9 @@ TOutputGLSLBase::TOutputGLSLBase(TInfoSinkBase &objSink,
       mShaderType(shaderType),
       mShaderVersion(shaderVersion),
       mOutput(output),
-      mCompileOptions(compileOptions)
+      mCompileOptions(compileOptions),
+      mMinify((compileOptions & SH_MINIFY_OUTPUT) != 0),
+      mOutputSizeReduction(0)
 {}
 
 void TOutputGLSLBase::writeInvariantQualifier(const TType &type)
@@ -137,6 +300,123 @@ void TOutputGLSLBase::writeTriplet(Visit visit,
         out << postStr;
 }
 
+void TOutputGLSLBase::writeOperatorTriplet(Visit visit,
+                                           TIntermTyped *node,
+                                           const char *preStr,
+                                           const char *inStr,
+                                           const char *postStr)
+{
+    TInfoSinkBase &out = objSink();
+    if (visit == InVisit)
+    {
+        if (inStr)
+            out << inStr;
+        return;
+    }
+
+    bool parentheses = needsParentheses(node, getParentNode());
+    if (visit == PreVisit)
+    {
+        if (parentheses)
+            out << "(";
+        else
+            mOutputSizeReduction += 2;
+        if (preStr)
+            out << preStr;
+    }
+    else
+    {
+        if (postStr)
+            out << postStr;
+        if (parentheses)
+            out << ")";
+    }
+}
+
+bool TOutputGLSLBase::needsParentheses(TIntermTyped *node, TIntermNode *parent)
+{
+    if (!mMinify)
+    {
+        return true;
+    }
+
+    const Precedence precedence = GetPrecedence(node);
+    if (precedence == Precedence::Sequence)
+    {
+        // Keeps commas from being taken as argument separators.
+        return true;
+    }
+
+    if (parent == nullptr)
+    {
+        return true;
+    }
+
+    if (TIntermBinary *binaryParent = parent->getAsBinaryNode())
+    {
+        const bool isLeft = binaryParent->getLeft() == node;
+        switch (binaryParent->getOp())
+        {
+            case EOpIndexDirect:
+            case EOpIndexIndirect:
+                return isLeft && precedence > Precedence::Postfix;
+            case EOpIndexDirectStruct:
+            case EOpIndexDirectInterfaceBlock:
+                return precedence > Precedence::Postfix;
+            case EOpInitialize:
+                return false;
+            default:
+                break;
+        }
+
+        const Precedence parentPrecedence = GetBinaryPrecedence(binaryParent->getOp());
+        if (precedence != parentPrecedence)
+        {
+            return precedence > parentPrecedence;
+        }
+        // Assignments are right-associative, the other binary operators left-associative.
+        return parentPrecedence == Precedence::Assignment ? isLeft : !isLeft;
+    }
+
+    if (TIntermUnary *unaryParent = parent->getAsUnaryNode())
+    {
+        if (IsPrefixUnaryOperator(unaryParent->getOp()))
+        {
+            // Nested prefix operators are kept apart so that "- -x" doesn't become "--x".
+            return precedence >= Precedence::Prefix;
+        }
+        if (IsPostfixUnaryOperator(unaryParent->getOp()))
+        {
+            return precedence > Precedence::Postfix;
+        }
+        // The operand of a built-in function or of .length() is already in parentheses.
+        return false;
+    }
+
+    if (parent->getAsSwizzleNode())
+    {
+        return precedence > Precedence::Postfix;
+    }
+
+    if (TIntermTernary *ternaryParent = parent->getAsTernaryNode())
+    {
+        if (ternaryParent->getCondition() == node)
+        {
+            return precedence >= Precedence::Ternary;
+        }
+        if (ternaryParent->getTrueExpression() == node)
+        {
+            return false;
+        }
+        return precedence > Precedence::Ternary;
+    }
+
+    // Function call arguments, statements, conditions and initializers are delimited already.
+    return !(parent->getAsAggregate() || parent->getAsBlock() || parent->getAsDeclarationNode() ||
+             parent->getAsIfElseNode() || parent->getAsLoopNode() || parent->getAsBranchNode() ||
+             parent->getAsSwitchNode() || parent->getAsCaseNode());
+}
+
 void TOutputGLSLBase::writeBuiltInFunctionTriplet(Visit visit,
                                                   TOperator op,
                                                   bool useEmulatedFunction)
@@ -535,7 +815,7 @@ bool TOutputGLSLBase::visitBinary(Visit visit, TIntermBinary *node)
     switch (node->getOp())
     {
         case EOpComma:
-            writeTriplet(visit, "(", ", ", ")");
+            writeOperatorTriplet(visit, node, nullptr, ", ", nullptr);
             break;
         case EOpInitialize:
             if (visit == InVisit)
@@ -546,19 +826,19 @@ bool TOutputGLSLBase::visitBinary(Visit visit, TIntermBinary *node)
             }
             break;
         case EOpAssign:
-            writeTriplet(visit, "(", " = ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " = ", nullptr);
             break;
         case EOpAddAssign:
-            writeTriplet(visit, "(", " += ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " += ", nullptr);
             break;
         case EOpSubAssign:
-            writeTriplet(visit, "(", " -= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " -= ", nullptr);
             break;
         case EOpDivAssign:
-            writeTriplet(visit, "(", " /= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " /= ", nullptr);
             break;
         case EOpIModAssign:
-            writeTriplet(visit, "(", " %= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " %= ", nullptr);
             break;
         // Notice the fall-through.
         case EOpMulAssign:
@@ -566,22 +846,22 @@ bool TOutputGLSLBase::visitBinary(Visit visit, TIntermBinary *node)
         case EOpVectorTimesScalarAssign:
         case EOpMatrixTimesScalarAssign:
         case EOpMatrixTimesMatrixAssign:
-            writeTriplet(visit, "(", " *= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " *= ", nullptr);
             break;
         case EOpBitShiftLeftAssign:
-            writeTriplet(visit, "(", " <<= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " <<= ", nullptr);
             break;
         case EOpBitShiftRightAssign:
-            writeTriplet(visit, "(", " >>= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " >>= ", nullptr);
             break;
         case EOpBitwiseAndAssign:
-            writeTriplet(visit, "(", " &= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " &= ", nullptr);
             break;
         case EOpBitwiseXorAssign:
-            writeTriplet(visit, "(", " ^= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " ^= ", nullptr);
             break;
         case EOpBitwiseOrAssign:
-            writeTriplet(visit, "(", " |= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " |= ", nullptr);
             break;
 
         case EOpIndexDirect:
@@ -673,53 +953,53 @@ bool TOutputGLSLBase::visitBinary(Visit visit, TIntermBinary *node)
             break;
 
         case EOpAdd:
-            writeTriplet(visit, "(", " + ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " + ", nullptr);
             break;
         case EOpSub:
-            writeTriplet(visit, "(", " - ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " - ", nullptr);
             break;
         case EOpMul:
-            writeTriplet(visit, "(", " * ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " * ", nullptr);
             break;
         case EOpDiv:
-            writeTriplet(visit, "(", " / ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " / ", nullptr);
             break;
         case EOpIMod:
-            writeTriplet(visit, "(", " % ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " % ", nullptr);
             break;
         case EOpBitShiftLeft:
-            writeTriplet(visit, "(", " << ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " << ", nullptr);
             break;
         case EOpBitShiftRight:
-            writeTriplet(visit, "(", " >> ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " >> ", nullptr);
             break;
         case EOpBitwiseAnd:
-            writeTriplet(visit, "(", " & ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " & ", nullptr);
             break;
         case EOpBitwiseXor:
-            writeTriplet(visit, "(", " ^ ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " ^ ", nullptr);
             break;
         case EOpBitwiseOr:
-            writeTriplet(visit, "(", " | ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " | ", nullptr);
             break;
 
         case EOpEqual:
-            writeTriplet(visit, "(", " == ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " == ", nullptr);
             break;
         case EOpNotEqual:
-            writeTriplet(visit, "(", " != ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " != ", nullptr);
             break;
         case EOpLessThan:
-            writeTriplet(visit, "(", " < ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " < ", nullptr);
             break;
         case EOpGreaterThan:
-            writeTriplet(visit, "(", " > ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " > ", nullptr);
             break;
         case EOpLessThanEqual:
-            writeTriplet(visit, "(", " <= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " <= ", nullptr);
             break;
         case EOpGreaterThanEqual:
-            writeTriplet(visit, "(", " >= ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " >= ", nullptr);
             break;
 
         // Notice the fall-through.
@@ -728,17 +1008,17 @@ bool TOutputGLSLBase::visitBinary(Visit visit, TIntermBinary *node)
         case EOpMatrixTimesVector:
         case EOpMatrixTimesScalar:
         case EOpMatrixTimesMatrix:
-            writeTriplet(visit, "(", " * ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " * ", nullptr);
             break;
 
         case EOpLogicalOr:
-            writeTriplet(visit, "(", " || ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " || ", nullptr);
             break;
         case EOpLogicalXor:
-            writeTriplet(visit, "(", " ^^ ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " ^^ ", nullptr);
             break;
         case EOpLogicalAnd:
-            writeTriplet(visit, "(", " && ", ")");
+            writeOperatorTriplet(visit, node, nullptr, " && ", nullptr);
             break;
         default:
             UNREACHABLE();
@@ -750,40 +1030,38 @@ bool TOutputGLSLBase::visitBinary(Visit visit, TIntermBinary *node)
 bool TOutputGLSLBase::visitUnary(Visit visit, TIntermUnary *node)
 {
     const char *preString  = "";
-    const char *postString = ")";
+    const char *postString = "";
 
     switch (node->getOp())
     {
         case EOpNegative:
-            preString = "(-";
+            preString = "-";
             break;
         case EOpPositive:
-            preString = "(+";
+            preString = "+";
             break;
         case EOpLogicalNot:
-            preString = "(!";
+            preString = "!";
             break;
         case EOpBitwiseNot:
-            preString = "(~";
+            preString = "~";
             break;
 
         case EOpPostIncrement:
-            preString  = "(";
-            postString = "++)";
+            postString = "++";
             break;
         case EOpPostDecrement:
-            preString  = "(";
-            postString = "--)";
+            postString = "--";
             break;
         case EOpPreIncrement:
-            preString = "(++";
+            preString = "++";
             break;
         case EOpPreDecrement:
-            preString = "(--";
+            preString = "--";
             break;
         case EOpArrayLength:
-            preString  = "((";
-            postString = ").length())";
+            preString  = "(";
+            postString = ").length()";
             break;
 
         case EOpRadians:
@@ -851,7 +1129,7 @@ bool TOutputGLSLBase::visitUnary(Visit visit, TIntermUnary *node)
             UNREACHABLE();
     }
 
-    writeTriplet(visit, preString, nullptr, postString);
+    writeOperatorTriplet(visit, node, preString, nullptr, postString);
 
     return true;
 }
@@ -859,20 +1137,40 @@ bool TOutputGLSLBase::visitUnary(Visit visit, TIntermUnary *node)
 bool TOutputGLSLBase::visitTernary(Visit visit, TIntermTernary *node)
 {
     TInfoSinkBase &out = objSink();
-    // Notice two brackets at the beginning and end. The outer ones
-    // encapsulate the whole ternary expression. This preserves the
-    // order of precedence when ternary expressions are used in a
-    // compound expression, i.e., c = 2 * (a < b ? 1 : 2).
-    out << "((";
-    node->getCondition()->traverse(this);
-    out << ") ? (";
-    node->getTrueExpression()->traverse(this);
-    out << ") : (";
-    node->getFalseExpression()->traverse(this);
-    out << "))";
+    // Notice the brackets around the whole expression and around each operand. The outer ones
+    // encapsulate the whole ternary expression. This preserves the order of precedence when
+    // ternary expressions are used in a compound expression, i.e., c = 2 * (a < b ? 1 : 2).
+    // Minified output only keeps the brackets that are needed.
+    writeOperatorTriplet(PreVisit, node, nullptr, nullptr, nullptr);
+    writeTernaryOperand(node, node->getCondition());
+    out << " ? ";
+    writeTernaryOperand(node, node->getTrueExpression());
+    out << " : ";
+    writeTernaryOperand(node, node->getFalseExpression());
+    writeOperatorTriplet(PostVisit, node, nullptr, nullptr, nullptr);
     return false;
 }
 
+void TOutputGLSLBase::writeTernaryOperand(TIntermTernary *node, TIntermTyped *operand)
+{
+    // When minifying, operands that need parentheses write them themselves.
+    TInfoSinkBase &out = objSink();
+    bool parentheses   = !mMinify;
+    if (parentheses)
+    {
+        out << "(";
+    }
+    else
+    {
+        mOutputSizeReduction += 2;
+    }
+    operand->traverse(this);
+    if (parentheses)
+    {
+        out << ")";
+    }
+}
+
 bool TOutputGLSLBase::visitIfElse(Visit visit, TIntermIfElse *node)
 {
     TInfoSinkBase &out = objSink();
@@ -1230,7 +1528,30 @@ ImmutableString TOutputGLSLBase::getTypeName(const TType &type)
 
 ImmutableString TOutputGLSLBase::hashName(const TSymbol *symbol)
 {
-    return HashName(symbol, mHashFunction, &mNameMap);
+    ImmutableString name = HashName(symbol, mHashFunction, &mNameMap);
+    if (!mMinify || !IsMinifiableSymbol(symbol))
+    {
+        return name;
+    }
+
+    auto iter = mMinifiedNames.find(symbol->uniqueId().get());
+    if (iter == mMinifiedNames.end())
+    {
+        ImmutableStringBuilder minifiedNameBuilder(
+            2u + ImmutableStringBuilder::GetHexCharCount<uint32_t>());
+        minifiedNameBuilder << "_m";
+        minifiedNameBuilder.appendHex(static_cast<uint32_t>(mMinifiedNames.size()));
+        ImmutableString minifiedName(minifiedNameBuilder);
+
+        // Names that are already short are kept.
+        iter = mMinifiedNames
+                   .emplace(symbol->uniqueId().get(),
+                            minifiedName.length() < name.length() ? minifiedName : name)
+                   .first;
+    }
+
+    mOutputSizeReduction += name.length() - iter->second.length();
+    return iter->second;
 }
 
 ImmutableString TOutputGLSLBase::hashFieldName(const TField *field)
@@ -8,6 +8,7 @@
 #define COMPILER_TRANSLATOR_OUTPUTGLSLBASE_H_
 
 #include <set>
+#include <unordered_map>
 
 #include "compiler/translator/HashNames.h"
 #include "compiler/translator/InfoSink.h"
@@ -36,10 +37,22 @@ class TOutputGLSLBase : public TIntermTraverser
     // which are not hashed.
     ImmutableString hashName(const TSymbol *symbol);
 
+    // Number of bytes SH_MINIFY_OUTPUT saved by shortening names and dropping parentheses.
+    size_t getOutputSizeReduction() const { return mOutputSizeReduction; }
+
   protected:
     TInfoSinkBase &objSink() { return mObjSink; }
     void writeFloat(TInfoSinkBase &out, float f);
     void writeTriplet(Visit visit, const char *preStr, const char *inStr, const char *postStr);
+    // Like writeTriplet(), but also writes the parentheses around the operator expression unless
+    // the output is minified and they are not needed.
+    void writeOperatorTriplet(Visit visit,
+                              TIntermTyped *node,
+                              const char *preStr,
+                              const char *inStr,
+                              const char *postStr);
+    // Whether |node| needs to be enclosed in parentheses as a child of |parent|.
+    bool needsParentheses(TIntermTyped *node, TIntermNode *parent);
     std::string getCommonLayoutQualifiers(TIntermTyped *variable);
     std::string getMemoryQualifiers(const TType &type);
     virtual void writeLayoutQualifier(TIntermTyped *variable);
@@ -88,6 +101,7 @@ class TOutputGLSLBase : public TIntermTraverser
     void declareInterfaceBlock(const TInterfaceBlock *interfaceBlock);
 
     void writeBuiltInFunctionTriplet(Visit visit, TOperator op, bool useEmulatedFunction);
+    void writeTernaryOperand(TIntermTernary *node, TIntermTyped *operand);
 
     const char *mapQualifierToString(TQualifier qualifier);
 
@@ -111,6 +125,11 @@ class TOutputGLSLBase : public TIntermTraverser
     ShShaderOutput mOutput;
 
     ShCompileOptions mCompileOptions;
+
+    // SH_MINIFY_OUTPUT state. Minified names are keyed by symbol unique id.
+    bool mMinify;
+    std::unordered_map<int, ImmutableString> mMinifiedNames;
+    size_t mOutputSizeReduction;
 };
 
 void WriteGeometryShaderLayoutQualifiers(TInfoSinkBase &out,
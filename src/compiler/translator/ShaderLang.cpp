@@ -299,6 +299,13 @@ void Destruct(ShHandle handle)
         DeleteCompiler(base->getAsCompiler());
 }
 
+bool UpdateResources(const ShHandle handle, const ShBuiltInResources *resources)
+{
+    TCompiler *compiler = GetCompilerFromHandle(handle);
+    ASSERT(compiler);
+    return compiler->updateResources(*resources);
+}
+
 const std::string &GetBuiltInResourcesString(const ShHandle handle)
 {
     TCompiler *compiler = GetCompilerFromHandle(handle);
@@ -369,6 +376,13 @@ const std::string &GetObjectCode(const ShHandle handle)
     return infoSink.obj.str();
 }
 
+size_t GetObjectCodeSizeReduction(const ShHandle handle)
+{
+    TCompiler *compiler = GetCompilerFromHandle(handle);
+    ASSERT(compiler);
+    return compiler->getObjectCodeSizeReduction();
+}
+
 const std::map<std::string, std::string> *GetNameHashingMap(const ShHandle handle)
 {
     TCompiler *compiler = GetCompilerFromHandle(handle);
@@ -396,6 +396,7 @@ void TSymbolTable::initializeBuiltIns(sh::GLenum type,
     mResources  = resources;
 
     // We need just one precision stack level for predefined precisions.
+    ASSERT(mPrecisionStack.empty());
     mPrecisionStack.emplace_back(new PrecisionStackLevel);
 
     if (IsDesktopGLSpec(spec))
@@ -439,6 +440,13 @@ void TSymbolTable::initializeBuiltIns(sh::GLenum type,
     mUniqueIdCounter = kLastBuiltInId + 1;
 }
 
+void TSymbolTable::releaseBuiltIns()
+{
+    ASSERT(mTable.empty());
+    mPrecisionStack.clear();
+    mGlInVariableWithArraySize = nullptr;
+}
+
 void TSymbolTable::initSamplerDefaultPrecision(TBasicType samplerType)
 {
     ASSERT(samplerType >= EbtGuardSamplerBegin && samplerType <= EbtGuardSamplerEnd);
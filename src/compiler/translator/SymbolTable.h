@@ -293,6 +293,9 @@ class TSymbolTable : angle::NonCopyable, TSymbolTableBase
     void initializeBuiltIns(sh::GLenum type,
                             ShShaderSpec spec,
                             const ShBuiltInResources &resources);
+    // Frees the state set up by initializeBuiltIns() that isn't pool allocated, so that the pool
+    // level holding the built-ins can be popped before initializeBuiltIns() is called again.
+    void releaseBuiltIns();
     void clearCompilationResults();
 
   private:
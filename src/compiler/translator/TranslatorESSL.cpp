@@ -108,6 +108,7 @@ bool TranslatorESSL::translate(TIntermBlock *root,
                            compileOptions);
 
     root->traverse(&outputESSL);
+    addObjectCodeSizeReduction(outputESSL.getOutputSizeReduction());
 
     return true;
 }
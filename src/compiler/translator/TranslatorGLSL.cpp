@@ -221,6 +221,7 @@ bool TranslatorGLSL::translate(TIntermBlock *root,
                            compileOptions);
 
     root->traverse(&outputGLSL);
+    addObjectCodeSizeReduction(outputGLSL.getOutputSizeReduction());
 
     return true;
 }
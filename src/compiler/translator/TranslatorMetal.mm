@@ -285,6 +285,7 @@ bool TranslatorMetal::translate(TIntermBlock *root,
 
     // Write translated shader.
     root->traverse(&outputGLSL);
+    addObjectCodeSizeReduction(outputGLSL.getOutputSizeReduction());
 
     return true;
 }
@@ -990,6 +990,7 @@ bool TranslatorVulkan::translate(TIntermBlock *root,
 
     // Write translated shader.
     root->traverse(&outputGLSL);
+    addObjectCodeSizeReduction(outputGLSL.getOutputSizeReduction());
 
     return true;
 }
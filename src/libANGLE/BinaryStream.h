@@ -50,6 +50,15 @@ class BinaryInputStream : angle::NonCopyable
     void readIntVector(std::vector<VectorElementT> *param)
     {
         unsigned int size = readInt<unsigned int>();
+
+        // Each element is stored as an int. Reject sizes that can't fit before reserving memory.
+        if (mError || static_cast<size_t>(size) > remainingSize() / sizeof(int))
+        {
+            mError = true;
+            return;
+        }
+
+        param->reserve(param->size() + size);
         for (unsigned int index = 0; index < size; ++index)
         {
             param->push_back(readInt<IntT>());
@@ -182,6 +191,10 @@ class BinaryOutputStream : angle::NonCopyable
     BinaryOutputStream();
     ~BinaryOutputStream();
 
+    // Pre-sizes the stream, e.g. from the length of a previous serialization, so that writing
+    // doesn't repeatedly grow the underlying storage.
+    void reserve(size_t size) { mData.reserve(size); }
+
     // writeInt also handles bool types
     template <class IntT>
     void writeInt(IntT param)
@@ -206,7 +219,7 @@ class BinaryOutputStream : angle::NonCopyable
     }
 
     template <class IntT>
-    void writeIntVector(std::vector<IntT> param)
+    void writeIntVector(const std::vector<IntT> &param)
     {
         writeInt(param.size());
         for (IntT element : param)
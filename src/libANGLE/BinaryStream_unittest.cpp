@@ -65,4 +65,33 @@ TEST(BinaryInputStream, Overflow)
         stream.readBytes(outputData.data(), std::numeric_limits<size_t>::max() - dataSize - 2);
     }
 }
+
+// Test that int vectors round-trip and that a corrupt vector size generates an error.
+TEST(BinaryInputStream, IntVector)
+{
+    const std::vector<unsigned int> values = {1, 2, 3, 100};
+
+    gl::BinaryOutputStream outputStream;
+    outputStream.reserve(64);
+    outputStream.writeIntVector(values);
+    outputStream.writeInt(0x10000000u);
+
+    {
+        gl::BinaryInputStream stream(outputStream.data(), outputStream.length());
+        std::vector<unsigned int> readValues;
+        stream.readIntVector<unsigned int>(&readValues);
+        ASSERT_FALSE(stream.error());
+        ASSERT_EQ(values, readValues);
+    }
+
+    {
+        // Skip the valid vector and read the large int as a vector size.
+        gl::BinaryInputStream stream(outputStream.data(), outputStream.length());
+        stream.skip(sizeof(int) * (values.size() + 1));
+        std::vector<unsigned int> readValues;
+        stream.readIntVector<unsigned int>(&readValues);
+        ASSERT_TRUE(stream.error());
+        ASSERT_TRUE(readValues.empty());
+    }
+}
 }  // namespace angle
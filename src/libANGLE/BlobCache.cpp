@@ -8,6 +8,9 @@
 // disk.  MemoryProgramCache uses this to handle caching of compiled programs.
 
 #include "libANGLE/BlobCache.h"
+
+#include <limits>
+
 #include "common/utilities.h"
 #include "common/version.h"
 #include "libANGLE/Context.h"
@@ -31,8 +34,17 @@ enum CacheResult
 }  // anonymous namespace
 
 BlobCache::BlobCache(size_t maxCacheSizeBytes)
-    : mBlobCache(maxCacheSizeBytes), mSetBlobFunc(nullptr), mGetBlobFunc(nullptr)
-{}
+    : mSize(0),
+      mMaxSize(maxCacheSizeBytes),
+      mUseCounter(0),
+      mSetBlobFunc(nullptr),
+      mGetBlobFunc(nullptr)
+{
+    for (Shard &shard : mShards)
+    {
+        shard.cache.resize(maxCacheSizeBytes);
+    }
+}
 
 BlobCache::~BlobCache() {}
 
@@ -59,12 +71,24 @@ void BlobCache::putApplication(const BlobCache::Key &key, const angle::MemoryBuf
 
 void BlobCache::populate(const BlobCache::Key &key, angle::MemoryBuffer &&value, CacheSource source)
 {
+    size_t valueSize = value.size();
+
     CacheEntry newEntry;
-    newEntry.first  = std::move(value);
-    newEntry.second = source;
+    newEntry.blob    = std::move(value);
+    newEntry.source  = source;
+    newEntry.lastUse = ++mUseCounter;
 
     // Cache it inside blob cache only if caching inside the application is not possible.
-    mBlobCache.put(key, std::move(newEntry), newEntry.first.size());
+    Shard &shard = getShard(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        size_t oldShardSize = shard.cache.size();
+        shard.cache.put(key, std::move(newEntry), valueSize);
+        mSize += shard.cache.size();
+        mSize -= oldShardSize;
+    }
+
+    evictToSize(mMaxSize);
 }
 
 bool BlobCache::get(angle::ScratchBuffer *scratchBuffer,
@@ -107,12 +131,15 @@ bool BlobCache::get(angle::ScratchBuffer *scratchBuffer,
     }
 
     // Otherwise we are doing caching internally, so try to find it there
+    Shard &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
     const CacheEntry *entry;
-    bool result = mBlobCache.get(key, &entry);
+    bool result = shard.cache.get(key, &entry);
 
     if (result)
     {
-        if (entry->second == CacheSource::Memory)
+        if (entry->source == CacheSource::Memory)
         {
             ANGLE_HISTOGRAM_ENUMERATION("GPU.ANGLE.ProgramCache.CacheResult", kCacheHitMemory,
                                         kCacheResultMax);
@@ -123,7 +150,23 @@ bool BlobCache::get(angle::ScratchBuffer *scratchBuffer,
                                         kCacheResultMax);
         }
 
-        *valueOut = BlobCache::Value(entry->first.data(), entry->first.size());
+        entry->lastUse = ++mUseCounter;
+
+        if (entry->blob.empty())
+        {
+            *valueOut = BlobCache::Value();
+            return true;
+        }
+
+        angle::MemoryBuffer *scratchMemory;
+        if (!scratchBuffer->get(entry->blob.size(), &scratchMemory))
+        {
+            ERR() << "Failed to allocate memory for binary blob";
+            return false;
+        }
+
+        memcpy(scratchMemory->data(), entry->blob.data(), entry->blob.size());
+        *valueOut = BlobCache::Value(scratchMemory->data(), entry->blob.size());
     }
     else
     {
@@ -134,21 +177,123 @@ bool BlobCache::get(angle::ScratchBuffer *scratchBuffer,
     return result;
 }
 
-bool BlobCache::getAt(size_t index, const BlobCache::Key **keyOut, BlobCache::Value *valueOut)
+bool BlobCache::getAt(size_t index, BlobCache::Key *keyOut, angle::MemoryBuffer *valueOut)
 {
-    const CacheEntry *valueBuf;
-    bool result = mBlobCache.getAt(index, keyOut, &valueBuf);
-    if (result)
+    for (Shard &shard : mShards)
     {
-        *valueOut = BlobCache::Value(valueBuf->first.data(), valueBuf->first.size());
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        size_t shardEntryCount = shard.cache.entryCount();
+        if (index >= shardEntryCount)
+        {
+            index -= shardEntryCount;
+            continue;
+        }
+
+        const BlobCache::Key *key;
+        const CacheEntry *entry;
+        bool result = shard.cache.getAt(index, &key, &entry);
+        ASSERT(result);
+
+        if (!valueOut->resize(entry->blob.size()))
+        {
+            return false;
+        }
+        if (!entry->blob.empty())
+        {
+            memcpy(valueOut->data(), entry->blob.data(), entry->blob.size());
+        }
+        *keyOut = *key;
+        return true;
     }
-    return result;
+
+    return false;
 }
 
 void BlobCache::remove(const BlobCache::Key &key)
 {
-    bool result = mBlobCache.eraseByKey(key);
-    ASSERT(result);
+    Shard &shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    size_t oldShardSize = shard.cache.size();
+    shard.cache.eraseByKey(key);
+    mSize -= oldShardSize - shard.cache.size();
+}
+
+void BlobCache::clear()
+{
+    for (Shard &shard : mShards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        mSize -= shard.cache.size();
+        shard.cache.clear();
+    }
+}
+
+void BlobCache::resize(size_t maxCacheSizeBytes)
+{
+    mMaxSize = maxCacheSizeBytes;
+    for (Shard &shard : mShards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        mSize -= shard.cache.size();
+        shard.cache.resize(maxCacheSizeBytes);
+    }
+}
+
+size_t BlobCache::entryCount() const
+{
+    size_t count = 0;
+    for (const Shard &shard : mShards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.cache.entryCount();
+    }
+    return count;
+}
+
+BlobCache::Shard &BlobCache::getShard(const BlobCache::Key &key)
+{
+    // Keys are SHA-1 hashes, so any byte spreads them evenly.
+    return mShards[key[0] % kShardCount];
+}
+
+size_t BlobCache::evictToSize(size_t limit)
+{
+    size_t freedBytes = 0;
+
+    while (mSize > limit)
+    {
+        Shard *oldestShard = nullptr;
+        uint64_t oldestUse = std::numeric_limits<uint64_t>::max();
+        for (Shard &shard : mShards)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            const CacheEntry *entry;
+            if (shard.cache.peekLeastRecentlyUsed(&entry) && entry->lastUse < oldestUse)
+            {
+                oldestShard = &shard;
+                oldestUse   = entry->lastUse;
+            }
+        }
+
+        if (oldestShard == nullptr)
+        {
+            break;
+        }
+
+        // The shard may have changed since it was looked at, in which case a more recently used
+        // entry is evicted, or none if another thread emptied the shard.
+        std::lock_guard<std::mutex> lock(oldestShard->mutex);
+        if (oldestShard->cache.entryCount() > 0)
+        {
+            size_t entrySize = oldestShard->cache.evictLeastRecentlyUsed();
+            mSize -= entrySize;
+            freedBytes += entrySize;
+        }
+    }
+
+    return freedBytes;
 }
 
 void BlobCache::setBlobCacheFuncs(EGLSetBlobFuncANDROID set, EGLGetBlobFuncANDROID get)
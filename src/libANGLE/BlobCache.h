@@ -11,7 +11,9 @@
 #define LIBANGLE_BLOB_CACHE_H_
 
 #include <array>
+#include <atomic>
 #include <cstring>
+#include <mutex>
 
 #include <anglebase/sha1.h>
 #include "common/MemoryBuffer.h"
@@ -48,6 +50,8 @@ struct hash<egl::BlobCacheKey>
 namespace egl
 {
 
+// The cache is split into shards by key, each with its own lock, so contexts on different threads
+// can look up and store blobs concurrently.
 class BlobCache final : angle::NonCopyable
 {
   public:
@@ -99,39 +103,41 @@ class BlobCache final : angle::NonCopyable
                   CacheSource source = CacheSource::Disk);
 
     // Check if the cache contains the blob corresponding to this key.  If application callbacks are
-    // set, those will be used.  Otherwise they key is looked up in this object's cache.
+    // set, those will be used.  Otherwise they key is looked up in this object's cache.  Either way
+    // the blob is copied into |scratchBuffer|, as another thread may evict it at any time.
     ANGLE_NO_DISCARD bool get(angle::ScratchBuffer *scratchBuffer,
                               const BlobCache::Key &key,
                               BlobCache::Value *valueOut);
 
-    // For querying the contents of the cache.
+    // For querying the contents of the cache.  Entries are ordered by shard, not by use.  The
+    // blob is copied, so it stays valid if the entry is evicted.
     ANGLE_NO_DISCARD bool getAt(size_t index,
-                                const BlobCache::Key **keyOut,
-                                BlobCache::Value *valueOut);
+                                BlobCache::Key *keyOut,
+                                angle::MemoryBuffer *valueOut);
 
-    // Evict a blob from the binary cache.
+    // Evict a blob from the binary cache, if it's still there.
     void remove(const BlobCache::Key &key);
 
     // Empty the cache.
-    void clear() { mBlobCache.clear(); }
+    void clear();
 
     // Resize the cache. Discards current contents.
-    void resize(size_t maxCacheSizeBytes) { mBlobCache.resize(maxCacheSizeBytes); }
+    void resize(size_t maxCacheSizeBytes);
 
     // Returns the number of entries in the cache.
-    size_t entryCount() const { return mBlobCache.entryCount(); }
+    size_t entryCount() const;
 
     // Reduces the current cache size and returns the number of bytes freed.
-    size_t trim(size_t limit) { return mBlobCache.shrinkToSize(limit); }
+    size_t trim(size_t limit) { return evictToSize(limit); }
 
-    // Returns the current cache size in bytes.
-    size_t size() const { return mBlobCache.size(); }
+    // Returns the current cache size in bytes.  Only approximate while other threads use the cache.
+    size_t size() const { return mSize; }
 
     // Returns whether the cache is empty
-    bool empty() const { return mBlobCache.empty(); }
+    bool empty() const { return entryCount() == 0; }
 
     // Returns the maximum cache size in bytes.
-    size_t maxSize() const { return mBlobCache.maxSize(); }
+    size_t maxSize() const { return mMaxSize; }
 
     void setBlobCacheFuncs(EGLSetBlobFuncANDROID set, EGLGetBlobFuncANDROID get);
 
@@ -140,9 +146,38 @@ class BlobCache final : angle::NonCopyable
     bool isCachingEnabled() const { return areBlobCacheFuncsSet() || maxSize() > 0; }
 
   private:
-    // This internal cache is used only if the application is not providing caching callbacks
-    using CacheEntry = std::pair<angle::MemoryBuffer, CacheSource>;
-    angle::SizedMRUCache<BlobCache::Key, CacheEntry> mBlobCache;
+    static constexpr size_t kShardCount = 8;
+
+    struct CacheEntry
+    {
+        angle::MemoryBuffer blob;
+        CacheSource source = CacheSource::Memory;
+        // When the entry was last put or read, from mUseCounter.  Guarded by the shard's mutex.
+        mutable uint64_t lastUse = 0;
+    };
+
+    // This internal cache is used only if the application is not providing caching callbacks.
+    // Each shard keeps its own MRU order and is limited only by the total size; the size is
+    // tracked across shards and enforced by evictToSize.
+    struct Shard
+    {
+        Shard() : cache(0) {}
+
+        mutable std::mutex mutex;
+        angle::SizedMRUCache<BlobCache::Key, CacheEntry> cache;
+    };
+
+    Shard &getShard(const BlobCache::Key &key);
+
+    // Evicts entries until the cache fits in |limit| bytes and returns the number of bytes freed.
+    // Each eviction takes the oldest of the shards' least recently used entries, which is the
+    // least recently used entry overall unless other threads race with it.
+    size_t evictToSize(size_t limit);
+
+    std::array<Shard, kShardCount> mShards;
+    std::atomic<size_t> mSize;
+    std::atomic<size_t> mMaxSize;
+    std::atomic<uint64_t> mUseCounter;
 
     EGLSetBlobFuncANDROID mSetBlobFunc;
     EGLGetBlobFuncANDROID mGetBlobFunc;
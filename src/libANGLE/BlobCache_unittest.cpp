@@ -7,6 +7,9 @@
 
 #include <gtest/gtest.h>
 
+#include <thread>
+#include <vector>
+
 #include "libANGLE/BlobCache.h"
 
 namespace egl
@@ -48,6 +51,7 @@ TEST(BlobCacheTest, MaxSizedValue)
 {
     constexpr size_t kSize = 32;
     BlobCache blobCache(kSize);
+    angle::ScratchBuffer scratchBuffer(1);
 
     blobCache.populate(MakeKey(0), MakeBlob(kSize));
     EXPECT_EQ(32u, blobCache.size());
@@ -58,7 +62,7 @@ TEST(BlobCacheTest, MaxSizedValue)
     EXPECT_FALSE(blobCache.empty());
 
     Blob blob;
-    EXPECT_FALSE(blobCache.get(nullptr, MakeKey(0), &blob));
+    EXPECT_FALSE(blobCache.get(&scratchBuffer, MakeKey(0), &blob));
 
     blobCache.clear();
     EXPECT_TRUE(blobCache.empty());
@@ -69,13 +73,14 @@ TEST(BlobCacheTest, ManySmallValues)
 {
     constexpr size_t kSize = 32;
     BlobCache blobCache(kSize);
+    angle::ScratchBuffer scratchBuffer(1);
 
     for (size_t value = 0; value < kSize; ++value)
     {
         blobCache.populate(MakeKey(value), MakeBlob(1, value));
 
         Blob qvalue;
-        EXPECT_TRUE(blobCache.get(nullptr, MakeKey(value), &qvalue));
+        EXPECT_TRUE(blobCache.get(&scratchBuffer, MakeKey(value), &qvalue));
         if (qvalue.size() > 0)
         {
             EXPECT_EQ(value, qvalue[0]);
@@ -89,7 +94,7 @@ TEST(BlobCacheTest, ManySmallValues)
     blobCache.populate(MakeKey(kSize), MakeBlob(1, kSize));
 
     Blob qvalue;
-    EXPECT_FALSE(blobCache.get(nullptr, MakeKey(0), &qvalue));
+    EXPECT_FALSE(blobCache.get(&scratchBuffer, MakeKey(0), &qvalue));
 
     // Putting one large element cleans out the whole stack.
     blobCache.populate(MakeKey(kSize + 1), MakeBlob(kSize, kSize + 1));
@@ -98,9 +103,9 @@ TEST(BlobCacheTest, ManySmallValues)
 
     for (size_t value = 0; value <= kSize; ++value)
     {
-        EXPECT_FALSE(blobCache.get(nullptr, MakeKey(value), &qvalue));
+        EXPECT_FALSE(blobCache.get(&scratchBuffer, MakeKey(value), &qvalue));
     }
-    EXPECT_TRUE(blobCache.get(nullptr, MakeKey(kSize + 1), &qvalue));
+    EXPECT_TRUE(blobCache.get(&scratchBuffer, MakeKey(kSize + 1), &qvalue));
     if (qvalue.size() > 0)
     {
         EXPECT_EQ(kSize + 1, qvalue[0]);
@@ -120,11 +125,126 @@ TEST(BlobCacheTest, OversizeValue)
 {
     constexpr size_t kSize = 32;
     BlobCache blobCache(kSize);
+    angle::ScratchBuffer scratchBuffer(1);
 
     blobCache.populate(MakeKey(5), MakeBlob(100));
 
     Blob qvalue;
-    EXPECT_FALSE(blobCache.get(nullptr, MakeKey(5), &qvalue));
+    EXPECT_FALSE(blobCache.get(&scratchBuffer, MakeKey(5), &qvalue));
+}
+
+// Tests that least recently used entries are evicted first, across shards.
+TEST(BlobCacheTest, EvictsLeastRecentlyUsed)
+{
+    constexpr size_t kSize = 32;
+    BlobCache blobCache(kSize);
+    angle::ScratchBuffer scratchBuffer(1);
+
+    for (size_t value = 0; value < kSize; ++value)
+    {
+        blobCache.populate(MakeKey(value), MakeBlob(1, value));
+    }
+
+    // Use the first half of the entries, so the second half is evicted first.
+    Blob qvalue;
+    for (size_t value = 0; value < kSize / 2; ++value)
+    {
+        EXPECT_TRUE(blobCache.get(&scratchBuffer, MakeKey(value), &qvalue));
+    }
+
+    for (size_t value = kSize; value < kSize + kSize / 2; ++value)
+    {
+        blobCache.populate(MakeKey(value), MakeBlob(1, value));
+    }
+
+    EXPECT_EQ(kSize, blobCache.size());
+    EXPECT_EQ(kSize, blobCache.entryCount());
+    for (size_t value = 0; value < kSize / 2; ++value)
+    {
+        EXPECT_TRUE(blobCache.get(&scratchBuffer, MakeKey(value), &qvalue));
+    }
+    for (size_t value = kSize / 2; value < kSize; ++value)
+    {
+        EXPECT_FALSE(blobCache.get(&scratchBuffer, MakeKey(value), &qvalue));
+    }
+}
+
+// Tests that getAt visits every entry once and returns copies of the blobs.
+TEST(BlobCacheTest, GetAt)
+{
+    constexpr size_t kCount = 20;
+    BlobCache blobCache(1024);
+
+    for (size_t value = 0; value < kCount; ++value)
+    {
+        blobCache.populate(MakeKey(value), MakeBlob(value + 1, value));
+    }
+    ASSERT_EQ(kCount, blobCache.entryCount());
+
+    std::vector<bool> found(kCount, false);
+    Key key;
+    BlobPut blob;
+    for (size_t index = 0; index < kCount; ++index)
+    {
+        ASSERT_TRUE(blobCache.getAt(index, &key, &blob));
+        size_t value = key[0];
+        ASSERT_LT(value, kCount);
+        EXPECT_FALSE(found[value]);
+        found[value] = true;
+
+        EXPECT_EQ(value + 1, blob.size());
+        EXPECT_EQ(value, blob[0]);
+    }
+    EXPECT_FALSE(blobCache.getAt(kCount, &key, &blob));
+
+    blobCache.remove(MakeKey(0));
+    EXPECT_EQ(kCount - 1, blobCache.entryCount());
+    EXPECT_EQ(kCount * (kCount + 1) / 2 - 1, blobCache.size());
+}
+
+// Tests that threads can use the cache concurrently, and that it stays within its size.
+TEST(BlobCacheTest, ConcurrentGetPut)
+{
+    constexpr size_t kSize         = 256;
+    constexpr size_t kThreadCount  = 4;
+    constexpr size_t kOpsPerThread = 2000;
+    constexpr size_t kKeyCount     = 64;
+    constexpr size_t kValueSize    = 8;
+    BlobCache blobCache(kSize);
+
+    std::vector<std::thread> threads;
+    for (size_t threadIndex = 0; threadIndex < kThreadCount; ++threadIndex)
+    {
+        threads.emplace_back([&, threadIndex]() {
+            angle::ScratchBuffer scratchBuffer(1);
+            for (size_t op = 0; op < kOpsPerThread; ++op)
+            {
+                uint8_t value = static_cast<uint8_t>((op * 7 + threadIndex * 13) % kKeyCount);
+                Blob qvalue;
+                if (blobCache.get(&scratchBuffer, MakeKey(value), &qvalue))
+                {
+                    // Every blob stored under a key is the same, so a hit must match it.
+                    ASSERT_EQ(kValueSize, qvalue.size());
+                    ASSERT_EQ(value, qvalue[0]);
+                }
+                else
+                {
+                    blobCache.populate(MakeKey(value), MakeBlob(kValueSize, value));
+                }
+            }
+        });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_LE(blobCache.size(), kSize);
+    EXPECT_EQ(blobCache.size(), blobCache.entryCount() * kValueSize);
+
+    blobCache.clear();
+    EXPECT_TRUE(blobCache.empty());
+    EXPECT_EQ(0u, blobCache.size());
 }
 
 }  // namespace egl
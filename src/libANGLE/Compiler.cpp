@@ -54,143 +54,154 @@ ShShaderSpec SelectShaderSpec(GLint majorVersion,
     return isWebGL ? SH_WEBGL_SPEC : SH_GLES2_SPEC;
 }
 
-}  // anonymous namespace
-
-Compiler::Compiler(rx::GLImplFactory *implFactory, const State &state)
-    : mImplementation(implFactory->createCompiler()),
-      mSpec(SelectShaderSpec(state.getClientMajorVersion(),
-                             state.getClientMinorVersion(),
-                             state.getExtensions().webglCompatibility,
-                             state.getClientType())),
-      mOutputType(mImplementation->getTranslatorOutputType()),
-      mResources()
+void InitResources(const State &state, ShBuiltInResources *resources)
 {
-    // TODO(http://anglebug.com/3819): Update for GL version specific validation
-    ASSERT(state.getClientMajorVersion() == 1 || state.getClientMajorVersion() == 2 ||
-           state.getClientMajorVersion() == 3 || state.getClientMajorVersion() == 4);
-
     const gl::Caps &caps             = state.getCaps();
     const gl::Extensions &extensions = state.getExtensions();
 
-    if (gActiveCompilers == 0)
-    {
-        sh::Initialize();
-    }
-    ++gActiveCompilers;
-
-    sh::InitBuiltInResources(&mResources);
-    mResources.MaxVertexAttribs             = caps.maxVertexAttributes;
-    mResources.MaxVertexUniformVectors      = caps.maxVertexUniformVectors;
-    mResources.MaxVaryingVectors            = caps.maxVaryingVectors;
-    mResources.MaxVertexTextureImageUnits   = caps.maxShaderTextureImageUnits[ShaderType::Vertex];
-    mResources.MaxCombinedTextureImageUnits = caps.maxCombinedTextureImageUnits;
-    mResources.MaxTextureImageUnits         = caps.maxShaderTextureImageUnits[ShaderType::Fragment];
-    mResources.MaxFragmentUniformVectors    = caps.maxFragmentUniformVectors;
-    mResources.MaxDrawBuffers               = caps.maxDrawBuffers;
-    mResources.OES_standard_derivatives     = extensions.standardDerivatives;
-    mResources.EXT_draw_buffers             = extensions.drawBuffers;
-    mResources.EXT_shader_texture_lod       = extensions.shaderTextureLOD;
-    mResources.OES_EGL_image_external       = extensions.eglImageExternal;
-    mResources.OES_EGL_image_external_essl3 = extensions.eglImageExternalEssl3;
-    mResources.NV_EGL_stream_consumer_external = extensions.eglStreamConsumerExternal;
-    mResources.ARB_texture_rectangle           = extensions.textureRectangle;
-    mResources.OES_texture_storage_multisample_2d_array =
+    sh::InitBuiltInResources(resources);
+    resources->MaxVertexAttribs             = caps.maxVertexAttributes;
+    resources->MaxVertexUniformVectors      = caps.maxVertexUniformVectors;
+    resources->MaxVaryingVectors            = caps.maxVaryingVectors;
+    resources->MaxVertexTextureImageUnits   = caps.maxShaderTextureImageUnits[ShaderType::Vertex];
+    resources->MaxCombinedTextureImageUnits = caps.maxCombinedTextureImageUnits;
+    resources->MaxTextureImageUnits         = caps.maxShaderTextureImageUnits[ShaderType::Fragment];
+    resources->MaxFragmentUniformVectors    = caps.maxFragmentUniformVectors;
+    resources->MaxDrawBuffers               = caps.maxDrawBuffers;
+    resources->OES_standard_derivatives     = extensions.standardDerivatives;
+    resources->EXT_draw_buffers             = extensions.drawBuffers;
+    resources->EXT_shader_texture_lod       = extensions.shaderTextureLOD;
+    resources->OES_EGL_image_external       = extensions.eglImageExternal;
+    resources->OES_EGL_image_external_essl3 = extensions.eglImageExternalEssl3;
+    resources->NV_EGL_stream_consumer_external = extensions.eglStreamConsumerExternal;
+    resources->ARB_texture_rectangle           = extensions.textureRectangle;
+    resources->OES_texture_storage_multisample_2d_array =
         extensions.textureStorageMultisample2DArray;
-    mResources.OES_texture_3D                  = extensions.texture3DOES;
-    mResources.ANGLE_texture_multisample       = extensions.textureMultisample;
-    mResources.ANGLE_multi_draw                = extensions.multiDraw;
-    mResources.ANGLE_base_vertex_base_instance = extensions.baseVertexBaseInstance;
-    mResources.APPLE_clip_distance             = extensions.clipDistanceAPPLE;
+    resources->OES_texture_3D                  = extensions.texture3DOES;
+    resources->ANGLE_texture_multisample       = extensions.textureMultisample;
+    resources->ANGLE_multi_draw                = extensions.multiDraw;
+    resources->ANGLE_base_vertex_base_instance = extensions.baseVertexBaseInstance;
+    resources->APPLE_clip_distance             = extensions.clipDistanceAPPLE;
 
     // TODO: use shader precision caps to determine if high precision is supported?
-    mResources.FragmentPrecisionHigh = 1;
-    mResources.EXT_frag_depth        = extensions.fragDepth;
+    resources->FragmentPrecisionHigh = 1;
+    resources->EXT_frag_depth        = extensions.fragDepth;
 
     // OVR_multiview state
-    mResources.OVR_multiview = extensions.multiview;
+    resources->OVR_multiview = extensions.multiview;
 
     // OVR_multiview2 state
-    mResources.OVR_multiview2 = extensions.multiview2;
-    mResources.MaxViewsOVR    = extensions.maxViews;
+    resources->OVR_multiview2 = extensions.multiview2;
+    resources->MaxViewsOVR    = extensions.maxViews;
 
     // EXT_multisampled_render_to_texture
-    mResources.EXT_multisampled_render_to_texture = extensions.multisampledRenderToTexture;
+    resources->EXT_multisampled_render_to_texture = extensions.multisampledRenderToTexture;
 
     // GLSL ES 3.0 constants
-    mResources.MaxVertexOutputVectors  = caps.maxVertexOutputComponents / 4;
-    mResources.MaxFragmentInputVectors = caps.maxFragmentInputComponents / 4;
-    mResources.MinProgramTexelOffset   = caps.minProgramTexelOffset;
-    mResources.MaxProgramTexelOffset   = caps.maxProgramTexelOffset;
+    resources->MaxVertexOutputVectors  = caps.maxVertexOutputComponents / 4;
+    resources->MaxFragmentInputVectors = caps.maxFragmentInputComponents / 4;
+    resources->MinProgramTexelOffset   = caps.minProgramTexelOffset;
+    resources->MaxProgramTexelOffset   = caps.maxProgramTexelOffset;
 
     // EXT_blend_func_extended
-    mResources.EXT_blend_func_extended  = extensions.blendFuncExtended;
-    mResources.MaxDualSourceDrawBuffers = extensions.maxDualSourceDrawBuffers;
+    resources->EXT_blend_func_extended  = extensions.blendFuncExtended;
+    resources->MaxDualSourceDrawBuffers = extensions.maxDualSourceDrawBuffers;
 
     // APPLE_clip_distance/EXT_clip_cull_distance
-    mResources.MaxClipDistances = caps.maxClipDistances;
+    resources->MaxClipDistances = caps.maxClipDistances;
 
     // GLSL ES 3.1 constants
-    mResources.MaxProgramTextureGatherOffset    = caps.maxProgramTextureGatherOffset;
-    mResources.MinProgramTextureGatherOffset    = caps.minProgramTextureGatherOffset;
-    mResources.MaxImageUnits                    = caps.maxImageUnits;
-    mResources.MaxVertexImageUniforms           = caps.maxShaderImageUniforms[ShaderType::Vertex];
-    mResources.MaxFragmentImageUniforms         = caps.maxShaderImageUniforms[ShaderType::Fragment];
-    mResources.MaxComputeImageUniforms          = caps.maxShaderImageUniforms[ShaderType::Compute];
-    mResources.MaxCombinedImageUniforms         = caps.maxCombinedImageUniforms;
-    mResources.MaxCombinedShaderOutputResources = caps.maxCombinedShaderOutputResources;
-    mResources.MaxUniformLocations              = caps.maxUniformLocations;
+    resources->MaxProgramTextureGatherOffset    = caps.maxProgramTextureGatherOffset;
+    resources->MinProgramTextureGatherOffset    = caps.minProgramTextureGatherOffset;
+    resources->MaxImageUnits                    = caps.maxImageUnits;
+    resources->MaxVertexImageUniforms           = caps.maxShaderImageUniforms[ShaderType::Vertex];
+    resources->MaxFragmentImageUniforms         = caps.maxShaderImageUniforms[ShaderType::Fragment];
+    resources->MaxComputeImageUniforms          = caps.maxShaderImageUniforms[ShaderType::Compute];
+    resources->MaxCombinedImageUniforms         = caps.maxCombinedImageUniforms;
+    resources->MaxCombinedShaderOutputResources = caps.maxCombinedShaderOutputResources;
+    resources->MaxUniformLocations              = caps.maxUniformLocations;
 
     for (size_t index = 0u; index < 3u; ++index)
     {
-        mResources.MaxComputeWorkGroupCount[index] = caps.maxComputeWorkGroupCount[index];
-        mResources.MaxComputeWorkGroupSize[index]  = caps.maxComputeWorkGroupSize[index];
+        resources->MaxComputeWorkGroupCount[index] = caps.maxComputeWorkGroupCount[index];
+        resources->MaxComputeWorkGroupSize[index]  = caps.maxComputeWorkGroupSize[index];
     }
 
-    mResources.MaxComputeUniformComponents = caps.maxShaderUniformComponents[ShaderType::Compute];
-    mResources.MaxComputeTextureImageUnits = caps.maxShaderTextureImageUnits[ShaderType::Compute];
+    resources->MaxComputeUniformComponents = caps.maxShaderUniformComponents[ShaderType::Compute];
+    resources->MaxComputeTextureImageUnits = caps.maxShaderTextureImageUnits[ShaderType::Compute];
 
-    mResources.MaxComputeAtomicCounters = caps.maxShaderAtomicCounters[ShaderType::Compute];
-    mResources.MaxComputeAtomicCounterBuffers =
+    resources->MaxComputeAtomicCounters = caps.maxShaderAtomicCounters[ShaderType::Compute];
+    resources->MaxComputeAtomicCounterBuffers =
         caps.maxShaderAtomicCounterBuffers[ShaderType::Compute];
 
-    mResources.MaxVertexAtomicCounters   = caps.maxShaderAtomicCounters[ShaderType::Vertex];
-    mResources.MaxFragmentAtomicCounters = caps.maxShaderAtomicCounters[ShaderType::Fragment];
-    mResources.MaxCombinedAtomicCounters = caps.maxCombinedAtomicCounters;
-    mResources.MaxAtomicCounterBindings  = caps.maxAtomicCounterBufferBindings;
-    mResources.MaxVertexAtomicCounterBuffers =
+    resources->MaxVertexAtomicCounters   = caps.maxShaderAtomicCounters[ShaderType::Vertex];
+    resources->MaxFragmentAtomicCounters = caps.maxShaderAtomicCounters[ShaderType::Fragment];
+    resources->MaxCombinedAtomicCounters = caps.maxCombinedAtomicCounters;
+    resources->MaxAtomicCounterBindings  = caps.maxAtomicCounterBufferBindings;
+    resources->MaxVertexAtomicCounterBuffers =
         caps.maxShaderAtomicCounterBuffers[ShaderType::Vertex];
-    mResources.MaxFragmentAtomicCounterBuffers =
+    resources->MaxFragmentAtomicCounterBuffers =
         caps.maxShaderAtomicCounterBuffers[ShaderType::Fragment];
-    mResources.MaxCombinedAtomicCounterBuffers = caps.maxCombinedAtomicCounterBuffers;
-    mResources.MaxAtomicCounterBufferSize      = caps.maxAtomicCounterBufferSize;
+    resources->MaxCombinedAtomicCounterBuffers = caps.maxCombinedAtomicCounterBuffers;
+    resources->MaxAtomicCounterBufferSize      = caps.maxAtomicCounterBufferSize;
 
-    mResources.MaxUniformBufferBindings       = caps.maxUniformBufferBindings;
-    mResources.MaxShaderStorageBufferBindings = caps.maxShaderStorageBufferBindings;
+    resources->MaxUniformBufferBindings       = caps.maxUniformBufferBindings;
+    resources->MaxShaderStorageBufferBindings = caps.maxShaderStorageBufferBindings;
 
     // Needed by point size clamping workaround
-    mResources.MaxPointSize = caps.maxAliasedPointSize;
+    resources->MaxPointSize = caps.maxAliasedPointSize;
 
     if (state.getClientMajorVersion() == 2 && !extensions.drawBuffers)
     {
-        mResources.MaxDrawBuffers = 1;
+        resources->MaxDrawBuffers = 1;
     }
 
     // Geometry Shader constants
-    mResources.EXT_geometry_shader          = extensions.geometryShader;
-    mResources.MaxGeometryUniformComponents = caps.maxShaderUniformComponents[ShaderType::Geometry];
-    mResources.MaxGeometryUniformBlocks     = caps.maxShaderUniformBlocks[ShaderType::Geometry];
-    mResources.MaxGeometryInputComponents   = caps.maxGeometryInputComponents;
-    mResources.MaxGeometryOutputComponents  = caps.maxGeometryOutputComponents;
-    mResources.MaxGeometryOutputVertices    = caps.maxGeometryOutputVertices;
-    mResources.MaxGeometryTotalOutputComponents = caps.maxGeometryTotalOutputComponents;
-    mResources.MaxGeometryTextureImageUnits = caps.maxShaderTextureImageUnits[ShaderType::Geometry];
-
-    mResources.MaxGeometryAtomicCounterBuffers =
+    resources->EXT_geometry_shader          = extensions.geometryShader;
+    resources->MaxGeometryUniformComponents = caps.maxShaderUniformComponents[ShaderType::Geometry];
+    resources->MaxGeometryUniformBlocks     = caps.maxShaderUniformBlocks[ShaderType::Geometry];
+    resources->MaxGeometryInputComponents   = caps.maxGeometryInputComponents;
+    resources->MaxGeometryOutputComponents  = caps.maxGeometryOutputComponents;
+    resources->MaxGeometryOutputVertices    = caps.maxGeometryOutputVertices;
+    resources->MaxGeometryTotalOutputComponents = caps.maxGeometryTotalOutputComponents;
+    resources->MaxGeometryTextureImageUnits = caps.maxShaderTextureImageUnits[ShaderType::Geometry];
+
+    resources->MaxGeometryAtomicCounterBuffers =
         caps.maxShaderAtomicCounterBuffers[ShaderType::Geometry];
-    mResources.MaxGeometryAtomicCounters      = caps.maxShaderAtomicCounters[ShaderType::Geometry];
-    mResources.MaxGeometryShaderStorageBlocks = caps.maxShaderStorageBlocks[ShaderType::Geometry];
-    mResources.MaxGeometryShaderInvocations   = caps.maxGeometryShaderInvocations;
-    mResources.MaxGeometryImageUniforms       = caps.maxShaderImageUniforms[ShaderType::Geometry];
+    resources->MaxGeometryAtomicCounters      = caps.maxShaderAtomicCounters[ShaderType::Geometry];
+    resources->MaxGeometryShaderStorageBlocks = caps.maxShaderStorageBlocks[ShaderType::Geometry];
+    resources->MaxGeometryShaderInvocations   = caps.maxGeometryShaderInvocations;
+    resources->MaxGeometryImageUniforms       = caps.maxShaderImageUniforms[ShaderType::Geometry];
+}
+
+}  // anonymous namespace
+
+Compiler::Compiler(rx::GLImplFactory *implFactory, const State &state)
+    : mImplementation(implFactory->createCompiler()),
+      mSpec(SelectShaderSpec(state.getClientMajorVersion(),
+                             state.getClientMinorVersion(),
+                             state.getExtensions().webglCompatibility,
+                             state.getClientType())),
+      mOutputType(mImplementation->getTranslatorOutputType()),
+      mResources()
+{
+    // TODO(http://anglebug.com/3819): Update for GL version specific validation
+    ASSERT(state.getClientMajorVersion() == 1 || state.getClientMajorVersion() == 2 ||
+           state.getClientMajorVersion() == 3 || state.getClientMajorVersion() == 4);
+
+    if (gActiveCompilers == 0)
+    {
+        sh::Initialize();
+    }
+    ++gActiveCompilers;
+
+    InitResources(state, &mResources);
+}
+
+void Compiler::updateResources(const State &state)
+{
+    // The pooled instances are updated when they are reused.
+    InitResources(state, &mResources);
 }
 
 Compiler::~Compiler()
@@ -223,6 +234,11 @@ ShCompilerInstance Compiler::getInstance(ShaderType type)
     {
         ShCompilerInstance instance = std::move(pool.back());
         pool.pop_back();
+
+        // This is only a comparison if the resources haven't changed since the instance was
+        // created.
+        bool updated = sh::UpdateResources(instance.getHandle(), &mResources);
+        ASSERT(updated);
         return instance;
     }
 }
@@ -33,6 +33,9 @@ class Compiler final : public RefCountObjectNoID
   public:
     Compiler(rx::GLImplFactory *implFactory, const State &data);
 
+    // Picks up new caps and extensions without throwing away the pooled compiler instances.
+    void updateResources(const State &state);
+
     ShCompilerInstance getInstance(ShaderType shaderType);
     void putInstance(ShCompilerInstance &&instance);
     ShShaderOutput getShaderOutputType() const { return mOutputType; }
@@ -11,6 +11,7 @@
 #include "libANGLE/Context.inl.h"
 
 #include <string.h>
+#include <array>
 #include <iterator>
 #include <sstream>
 #include <vector>
@@ -2677,14 +2678,7 @@ void Context::validationError(GLenum errorCode, const char *message)
 // [OpenGL ES 2.0.24] section 2.5 page 13.
 GLenum Context::getError()
 {
-    if (mErrors.empty())
-    {
-        return GL_NO_ERROR;
-    }
-    else
-    {
-        return mErrors.popError();
-    }
+    return mErrors.popError();
 }
 
 // NOTE: this function should not assume that this context is current!
@@ -3222,8 +3216,12 @@ void Context::requestExtension(const char *name)
     updateCaps();
     initExtensionStrings();
 
-    // Release the shader compiler so it will be re-created with the requested extensions enabled.
-    releaseShaderCompiler();
+    // Update the shader compiler so that shaders compiled from now on can use the requested
+    // extension. The compiler instances are kept, as creating them is expensive.
+    if (mCompiler.get() != nullptr)
+    {
+        mCompiler->updateResources(mState);
+    }
 
     // Invalidate all textures and framebuffer. Some extensions make new formats renderable or
     // sampleable.
@@ -5232,8 +5230,15 @@ void Context::debugMessageInsert(GLenum source,
                                  GLsizei length,
                                  const GLchar *buf)
 {
-    std::string msg(buf, (length > 0) ? static_cast<size_t>(length) : strlen(buf));
-    mState.getDebug().insertMessage(source, type, id, severity, std::move(msg), gl::LOG_INFO);
+    if (length <= 0)
+    {
+        mState.getDebug().insertMessage(source, type, id, severity, buf, strlen(buf), gl::LOG_INFO);
+        return;
+    }
+
+    // Only a message whose length is computed is known to be null-terminated there.
+    std::string msg(buf, static_cast<size_t>(length));
+    mState.getDebug().insertMessage(source, type, id, severity, msg, gl::LOG_INFO);
 }
 
 void Context::debugMessageCallback(GLDEBUGPROCKHR callback, const void *userParam)
@@ -9050,7 +9055,27 @@ void Context::onPostSwap() const
 }
 
 // ErrorSet implementation.
-ErrorSet::ErrorSet(Context *context) : mContext(context) {}
+namespace
+{
+constexpr size_t kErrorCodeCount = GL_CONTEXT_LOST - GL_INVALID_ENUM + 1;
+
+// popError finds this bit when no error is set, and maps it to GL_NO_ERROR.
+constexpr uint32_t kNoErrorBit = 1u << kErrorCodeCount;
+
+constexpr std::array<GLenum, kErrorCodeCount + 1> kPoppedErrors = {{
+    GL_INVALID_ENUM,
+    GL_INVALID_VALUE,
+    GL_INVALID_OPERATION,
+    GL_STACK_OVERFLOW,
+    GL_STACK_UNDERFLOW,
+    GL_OUT_OF_MEMORY,
+    GL_INVALID_FRAMEBUFFER_OPERATION,
+    GL_CONTEXT_LOST,
+    GL_NO_ERROR,
+}};
+}  // anonymous namespace
+
+ErrorSet::ErrorSet(Context *context) : mContext(context), mErrors(0) {}
 
 ErrorSet::~ErrorSet() = default;
 
@@ -9067,42 +9092,44 @@ void ErrorSet::handleError(GLenum errorCode,
         mContext->markContextLost(GraphicsResetStatus::UnknownContextReset);
     }
 
-    std::stringstream errorStream;
-    errorStream << "Error: " << gl::FmtHex(errorCode) << ", in " << file << ", " << function << ":"
-                << line << ". " << message;
-
-    std::string formattedMessage = errorStream.str();
-
     // Process the error, but log it with WARN severity so it shows up in logs.
-    ASSERT(errorCode != GL_NO_ERROR);
-    mErrors.insert(errorCode);
+    insert(errorCode);
 
     mContext->getState().getDebug().insertMessage(GL_DEBUG_SOURCE_API, GL_DEBUG_TYPE_ERROR,
                                                   errorCode, GL_DEBUG_SEVERITY_HIGH, message,
-                                                  gl::LOG_WARN);
+                                                  strlen(message), gl::LOG_WARN);
 }
 
 void ErrorSet::validationError(GLenum errorCode, const char *message)
 {
-    ASSERT(errorCode != GL_NO_ERROR);
-    mErrors.insert(errorCode);
+    insert(errorCode);
 
     mContext->getState().getDebug().insertMessage(GL_DEBUG_SOURCE_API, GL_DEBUG_TYPE_ERROR,
                                                   errorCode, GL_DEBUG_SEVERITY_HIGH, message,
-                                                  gl::LOG_INFO);
+                                                  strlen(message), gl::LOG_INFO);
 }
 
-bool ErrorSet::empty() const
+GLenum ErrorSet::popError()
 {
-    return mErrors.empty();
+    size_t errorIndex = gl::ScanForward(mErrors | kNoErrorBit);
+    // Clears the lowest bit, and leaves an empty set empty.
+    mErrors &= mErrors - 1;
+    return kPoppedErrors[errorIndex];
 }
 
-GLenum ErrorSet::popError()
+void ErrorSet::insert(GLenum errorCode)
 {
-    ASSERT(!empty());
-    GLenum error = *mErrors.begin();
-    mErrors.erase(mErrors.begin());
-    return error;
+    ASSERT(errorCode != GL_NO_ERROR);
+
+    size_t errorIndex = errorCode - GL_INVALID_ENUM;
+    if (ANGLE_UNLIKELY(errorIndex >= kErrorCodeCount))
+    {
+        // Only a driver could report another error, which GL ES doesn't define.
+        WARN() << "Unexpected GL error " << gl::FmtHex(errorCode)
+               << ", reporting GL_INVALID_OPERATION.";
+        errorIndex = GL_INVALID_OPERATION - GL_INVALID_ENUM;
+    }
+    mErrors |= 1u << errorIndex;
 }
 
 // StateCache implementation.
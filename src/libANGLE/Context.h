@@ -101,7 +101,8 @@ class ErrorSet : angle::NonCopyable
     explicit ErrorSet(Context *context);
     ~ErrorSet();
 
-    bool empty() const;
+    bool empty() const { return mErrors == 0; }
+    // Returns the error with the lowest code and clears it, or GL_NO_ERROR if there is none.
     GLenum popError();
 
     void handleError(GLenum errorCode,
@@ -113,8 +114,11 @@ class ErrorSet : angle::NonCopyable
     void validationError(GLenum errorCode, const char *message);
 
   private:
+    void insert(GLenum errorCode);
+
     Context *mContext;
-    std::set<GLenum> mErrors;
+    // One bit per error code, GL_INVALID_ENUM being bit 0. The GL error codes are consecutive.
+    uint32_t mErrors;
 };
 
 enum class VertexAttribTypeCase
@@ -9,6 +9,8 @@
 #include "libANGLE/Debug.h"
 
 #include "common/debug.h"
+#include "common/system_utils.h"
+#include "common/third_party/xxhash/xxhash.h"
 
 #include <algorithm>
 #include <tuple>
@@ -47,6 +49,11 @@ const char *EGLMessageTypeToString(egl::MessageType messageType)
     }
 }
 
+// Kinds of messages that the log rate limiter tracks before it forgets the ones it is done with.
+// Messages that aren't string constants are each a kind of their own.
+constexpr size_t kMaxTrackedMessageKinds = 256;
+constexpr unsigned int kMessageHashSeed   = 0xABCDEF98;
+
 const char *GLMessageTypeToString(GLenum type)
 {
     switch (type)
@@ -77,6 +84,70 @@ const char *GLMessageTypeToString(GLenum type)
 namespace gl
 {
 
+constexpr uint32_t LogRateLimiter::kMaxMessagesPerWindow;
+constexpr double LogRateLimiter::kWindowSeconds;
+
+LogRateLimiter::LogRateLimiter() = default;
+
+LogRateLimiter::~LogRateLimiter() = default;
+
+bool LogRateLimiter::shouldLog(GLenum source,
+                               GLenum type,
+                               GLuint id,
+                               const char *message,
+                               size_t length,
+                               double time,
+                               uint32_t *suppressedCountOut,
+                               bool *lastLogOut)
+{
+    auto key  = std::make_tuple(source, type, id, XXH64(message, length, kMessageHashSeed));
+    auto iter = mKinds.find(key);
+    if (iter == mKinds.end())
+    {
+        if (mKinds.size() >= kMaxTrackedMessageKinds)
+        {
+            pruneExpiredKinds(time);
+        }
+        iter = mKinds.emplace(key, KindState{time, 0, 0}).first;
+    }
+
+    KindState &state = iter->second;
+    if (time - state.windowStart >= kWindowSeconds)
+    {
+        state.windowStart = time;
+        state.loggedCount = 0;
+    }
+
+    if (state.loggedCount >= kMaxMessagesPerWindow)
+    {
+        state.suppressedCount++;
+        return false;
+    }
+
+    state.loggedCount++;
+    *suppressedCountOut   = state.suppressedCount;
+    *lastLogOut           = state.loggedCount == kMaxMessagesPerWindow;
+    state.suppressedCount = 0;
+    return true;
+}
+
+void LogRateLimiter::pruneExpiredKinds(double time)
+{
+    // Kinds with dropped messages are kept, so the count is reported when logging resumes.
+    for (auto iter = mKinds.begin(); iter != mKinds.end();)
+    {
+        const KindState &state = iter->second;
+        if (time - state.windowStart >= kWindowSeconds && state.suppressedCount == 0)
+        {
+            iter = mKinds.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
 Debug::Control::Control() {}
 
 Debug::Control::~Control() {}
@@ -94,6 +165,8 @@ Debug::Debug(bool initialDebugState)
       mCallbackFunction(nullptr),
       mCallbackUserParam(nullptr),
       mMessages(),
+      mFirstMessage(0),
+      mMessageCount(0),
       mMaxLoggedMessages(0),
       mOutputSynchronous(false),
       mGroups()
@@ -106,6 +179,11 @@ Debug::~Debug() {}
 void Debug::setMaxLoggedMessages(GLuint maxLoggedMessages)
 {
     mMaxLoggedMessages = maxLoggedMessages;
+
+    while (mMessageCount > mMaxLoggedMessages)
+    {
+        popMessage();
+    }
 }
 
 void Debug::setOutputEnabled(bool enabled)
@@ -151,23 +229,39 @@ void Debug::insertMessage(GLenum source,
                           const std::string &message,
                           gl::LogSeverity logSeverity) const
 {
-    std::string messageCopy(message);
-    insertMessage(source, type, id, severity, std::move(messageCopy), logSeverity);
+    insertMessage(source, type, id, severity, message.c_str(), message.length(), logSeverity);
 }
 
 void Debug::insertMessage(GLenum source,
                           GLenum type,
                           GLuint id,
                           GLenum severity,
-                          std::string &&message,
+                          const char *message,
+                          size_t length,
                           gl::LogSeverity logSeverity) const
 {
+    ASSERT(message[length] == '\0');
+
+    uint32_t suppressedCount = 0;
+    bool lastLog             = false;
+    if (gl::IsLogMessageConsumed(logSeverity) &&
+        mLogRateLimiter.shouldLog(source, type, id, message, length, angle::GetCurrentTime(),
+                                  &suppressedCount, &lastLog))
     {
-        // output all messages to the debug log
+        // output the message to the debug log
         const char *messageTypeString = GLMessageTypeToString(type);
         const char *severityString    = GLSeverityToString(severity);
         std::ostringstream messageStream;
         messageStream << "GL " << messageTypeString << ": " << severityString << ": " << message;
+        if (suppressedCount > 0)
+        {
+            messageStream << " (" << suppressedCount
+                          << " earlier messages of this kind were not logged)";
+        }
+        if (lastLog)
+        {
+            messageStream << " (further messages of this kind are not logged for a while)";
+        }
         switch (logSeverity)
         {
             case gl::LOG_FATAL:
@@ -197,25 +291,23 @@ void Debug::insertMessage(GLenum source,
     {
         // TODO(geofflang) Check the synchronous flag and potentially flush messages from another
         // thread.
-        mCallbackFunction(source, type, id, severity, static_cast<GLsizei>(message.length()),
-                          message.c_str(), mCallbackUserParam);
+        mCallbackFunction(source, type, id, severity, static_cast<GLsizei>(length), message,
+                          mCallbackUserParam);
     }
     else
     {
-        if (mMessages.size() >= mMaxLoggedMessages)
+        Message *m = pushMessage();
+        if (m == nullptr)
         {
             // Drop messages over the limit
             return;
         }
 
-        Message m;
-        m.source   = source;
-        m.type     = type;
-        m.id       = id;
-        m.severity = severity;
-        m.message  = std::move(message);
-
-        mMessages.push_back(std::move(m));
+        m->source   = source;
+        m->type     = type;
+        m->id       = id;
+        m->severity = severity;
+        m->message.assign(message, length);
     }
 }
 
@@ -230,9 +322,9 @@ size_t Debug::getMessages(GLuint count,
 {
     size_t messageCount       = 0;
     size_t messageStringIndex = 0;
-    while (messageCount <= count && !mMessages.empty())
+    while (messageCount < count && mMessageCount > 0)
     {
-        const Message &m = mMessages.front();
+        const Message &m = mMessages[mFirstMessage];
 
         if (messageLog != nullptr)
         {
@@ -274,7 +366,7 @@ size_t Debug::getMessages(GLuint count,
             lengths[messageCount] = static_cast<GLsizei>(m.message.length());
         }
 
-        mMessages.pop_front();
+        popMessage();
 
         messageCount++;
     }
@@ -284,12 +376,12 @@ size_t Debug::getMessages(GLuint count,
 
 size_t Debug::getNextMessageLength() const
 {
-    return mMessages.empty() ? 0 : mMessages.front().message.length();
+    return mMessageCount == 0 ? 0 : mMessages[mFirstMessage].message.length();
 }
 
 size_t Debug::getMessageCount() const
 {
-    return mMessages.size();
+    return mMessageCount;
 }
 
 void Debug::setMessageControl(GLenum source,
@@ -380,6 +472,33 @@ bool Debug::isMessageEnabled(GLenum source, GLenum type, GLuint id, GLenum sever
     return true;
 }
 
+Debug::Message *Debug::pushMessage() const
+{
+    if (mMessageCount >= mMaxLoggedMessages)
+    {
+        return nullptr;
+    }
+
+    if (mMessageCount == mMessages.size())
+    {
+        // Unwrap the ring so the new slot goes right after the newest message.
+        std::rotate(mMessages.begin(), mMessages.begin() + mFirstMessage, mMessages.end());
+        mFirstMessage = 0;
+        mMessages.emplace_back();
+    }
+
+    size_t index = (mFirstMessage + mMessageCount) % mMessages.size();
+    mMessageCount++;
+    return &mMessages[index];
+}
+
+void Debug::popMessage()
+{
+    ASSERT(mMessageCount > 0);
+    mFirstMessage = (mFirstMessage + 1) % mMessages.size();
+    mMessageCount--;
+}
+
 void Debug::pushDefaultGroup()
 {
     Group g;
@@ -14,8 +14,9 @@
 #include "common/angleutils.h"
 #include "libANGLE/AttributeMap.h"
 
-#include <deque>
+#include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace gl
@@ -30,6 +31,45 @@ class LabeledObject
     virtual const std::string &getLabel() const                             = 0;
 };
 
+// Limits how often messages of one kind go to the ANGLE log, so content that hits the same error
+// every frame doesn't flood it. Messages are of the same kind if they have the same source, type,
+// id and text. The id of an API error is the error code, and the text tells the errors apart.
+// Kinds are tracked by a hash of the text, since backend messages are built in temporary strings.
+class LogRateLimiter final : angle::NonCopyable
+{
+  public:
+    LogRateLimiter();
+    ~LogRateLimiter();
+
+    // Returns whether a message sent at |time|, in seconds, should be logged. If so,
+    // |suppressedCountOut| is set to the number of messages of its kind that were dropped since the
+    // last one logged, and |lastLogOut| to whether the next ones in its window will be dropped.
+    bool shouldLog(GLenum source,
+                   GLenum type,
+                   GLuint id,
+                   const char *message,
+                   size_t length,
+                   double time,
+                   uint32_t *suppressedCountOut,
+                   bool *lastLogOut);
+
+    // Each kind of message is logged this many times in a window.
+    static constexpr uint32_t kMaxMessagesPerWindow = 8;
+    static constexpr double kWindowSeconds          = 10.0;
+
+  private:
+    struct KindState
+    {
+        double windowStart;
+        uint32_t loggedCount;
+        uint32_t suppressedCount;
+    };
+
+    void pruneExpiredKinds(double time);
+
+    std::map<std::tuple<GLenum, GLenum, GLuint, uint64_t>, KindState> mKinds;
+};
+
 class Debug : angle::NonCopyable
 {
   public:
@@ -48,17 +88,21 @@ class Debug : angle::NonCopyable
     GLDEBUGPROCKHR getCallback() const;
     const void *getUserParam() const;
 
+    // Messages are only copied and formatted for the consumers that take them: the callback or
+    // message log if the message is enabled, and the ANGLE log if anything reads it.
     void insertMessage(GLenum source,
                        GLenum type,
                        GLuint id,
                        GLenum severity,
                        const std::string &message,
                        gl::LogSeverity logSeverity) const;
+    // |message| must be null-terminated at |length|.
     void insertMessage(GLenum source,
                        GLenum type,
                        GLuint id,
                        GLenum severity,
-                       std::string &&message,
+                       const char *message,
+                       size_t length,
                        gl::LogSeverity logSeverity) const;
 
     void setMessageControl(GLenum source,
@@ -124,8 +168,16 @@ class Debug : angle::NonCopyable
     bool mOutputEnabled;
     GLDEBUGPROCKHR mCallbackFunction;
     const void *mCallbackUserParam;
-    mutable std::deque<Message> mMessages;
+    Message *pushMessage() const;
+    void popMessage();
+
+    // Ring of up to mMaxLoggedMessages messages, oldest first from mFirstMessage. The storage
+    // grows on demand and is then reused, along with the capacity of the message strings.
+    mutable std::vector<Message> mMessages;
+    mutable size_t mFirstMessage;
+    mutable size_t mMessageCount;
     GLuint mMaxLoggedMessages;
+    mutable LogRateLimiter mLogRateLimiter;
     bool mOutputSynchronous;
     std::vector<Group> mGroups;
 };
@@ -0,0 +1,167 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// Debug_unittest.cpp: Unit tests for the GL_KHR_debug message log.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "libANGLE/Debug.h"
+
+namespace gl
+{
+namespace
+{
+void InsertMessage(Debug *debug, GLuint id)
+{
+    std::string message = "message " + std::to_string(id);
+    debug->insertMessage(GL_DEBUG_SOURCE_APPLICATION, GL_DEBUG_TYPE_OTHER, id,
+                         GL_DEBUG_SEVERITY_HIGH, message, LOG_EVENT);
+}
+
+// Reads |count| messages and checks that they have ids |firstId| and up.
+void ExpectMessages(Debug *debug, GLuint count, GLuint firstId)
+{
+    std::vector<GLuint> ids(count, 0);
+    std::vector<GLsizei> lengths(count, 0);
+    std::vector<GLchar> messageLog(1024);
+    ASSERT_EQ(count, debug->getMessages(count, static_cast<GLsizei>(messageLog.size()), nullptr,
+                                        nullptr, ids.data(), nullptr, lengths.data(),
+                                        messageLog.data()));
+
+    const GLchar *message = messageLog.data();
+    for (GLuint index = 0; index < count; ++index)
+    {
+        std::string expected = "message " + std::to_string(firstId + index);
+        EXPECT_EQ(firstId + index, ids[index]);
+        EXPECT_EQ(static_cast<GLsizei>(expected.length()), lengths[index]);
+        EXPECT_EQ(expected, message);
+        message += lengths[index] + 1;
+    }
+}
+
+// Tests that the message log keeps messages in order as it wraps around, and drops the messages
+// that don't fit.
+TEST(DebugTest, MessageLogWrapsAround)
+{
+    Debug debug(true);
+    debug.setMaxLoggedMessages(4);
+
+    for (GLuint id = 0; id < 3; ++id)
+    {
+        InsertMessage(&debug, id);
+    }
+    ExpectMessages(&debug, 2, 0);
+    EXPECT_EQ(1u, debug.getMessageCount());
+
+    for (GLuint id = 3; id < 8; ++id)
+    {
+        InsertMessage(&debug, id);
+    }
+    EXPECT_EQ(4u, debug.getMessageCount());
+    EXPECT_EQ(std::string("message 2").length(), debug.getNextMessageLength());
+    ExpectMessages(&debug, 4, 2);
+
+    EXPECT_EQ(0u, debug.getMessageCount());
+    EXPECT_EQ(0u, debug.getNextMessageLength());
+
+    // The log keeps working after being drained.
+    InsertMessage(&debug, 8);
+    ExpectMessages(&debug, 1, 8);
+}
+
+// Tests that disabled messages don't reach the message log.
+TEST(DebugTest, DisabledMessagesAreNotLogged)
+{
+    Debug debug(true);
+    debug.setMaxLoggedMessages(4);
+    debug.setMessageControl(GL_DEBUG_SOURCE_APPLICATION, GL_DONT_CARE, GL_DONT_CARE, {1}, false);
+
+    InsertMessage(&debug, 0);
+    InsertMessage(&debug, 1);
+    InsertMessage(&debug, 2);
+    EXPECT_EQ(2u, debug.getMessageCount());
+
+    debug.setOutputEnabled(false);
+    InsertMessage(&debug, 3);
+    EXPECT_EQ(2u, debug.getMessageCount());
+}
+
+// Tests that each kind of message is logged a limited number of times per window, and that the
+// count of dropped messages is reported when logging resumes.
+TEST(DebugTest, LogRateLimiter)
+{
+    constexpr uint32_t kMaxMessages = LogRateLimiter::kMaxMessagesPerWindow;
+    constexpr double kWindow        = LogRateLimiter::kWindowSeconds;
+    constexpr char kMessage[]       = "message";
+    constexpr char kOtherMessage[]  = "other message";
+
+    LogRateLimiter limiter;
+    uint32_t suppressedCount = 0;
+    bool lastLog             = false;
+
+    auto shouldLog = [&](const char *message, double time) {
+        return limiter.shouldLog(GL_DEBUG_SOURCE_API, GL_DEBUG_TYPE_ERROR, GL_INVALID_ENUM,
+                                 message, strlen(message), time, &suppressedCount, &lastLog);
+    };
+
+    for (uint32_t index = 0; index < kMaxMessages; ++index)
+    {
+        EXPECT_TRUE(shouldLog(kMessage, 0.0));
+        EXPECT_EQ(0u, suppressedCount);
+        EXPECT_EQ(index + 1 == kMaxMessages, lastLog);
+    }
+    EXPECT_FALSE(shouldLog(kMessage, 0.0));
+    EXPECT_FALSE(shouldLog(kMessage, kWindow / 2));
+
+    // A different message with the same id is limited on its own.
+    EXPECT_TRUE(shouldLog(kOtherMessage, kWindow / 2));
+    EXPECT_EQ(0u, suppressedCount);
+
+    // Logging resumes in the next window, and reports the messages dropped in the last one.
+    EXPECT_TRUE(shouldLog(kMessage, kWindow));
+    EXPECT_EQ(2u, suppressedCount);
+    EXPECT_FALSE(lastLog);
+
+    EXPECT_TRUE(shouldLog(kMessage, kWindow));
+    EXPECT_EQ(0u, suppressedCount);
+}
+
+// Tests that messages built in separate strings with the same text are limited together.
+TEST(DebugTest, LogRateLimiterSameTextInSeparateStrings)
+{
+    constexpr uint32_t kMaxMessages = LogRateLimiter::kMaxMessagesPerWindow;
+
+    LogRateLimiter limiter;
+    uint32_t suppressedCount = 0;
+    bool lastLog             = false;
+
+    auto shouldLog = [&](const std::string &message) {
+        return limiter.shouldLog(GL_DEBUG_SOURCE_API, GL_DEBUG_TYPE_ERROR, GL_OUT_OF_MEMORY,
+                                 message.c_str(), message.length(), 0.0, &suppressedCount,
+                                 &lastLog);
+    };
+
+    // Long enough not to fit in the small string buffer, so each copy has its own allocation.
+    std::string message(64, 'a');
+    std::string messageCopy(message.begin(), message.end());
+    ASSERT_NE(message.c_str(), messageCopy.c_str());
+
+    for (uint32_t index = 0; index < kMaxMessages; ++index)
+    {
+        EXPECT_TRUE(shouldLog(index % 2 == 0 ? message : messageCopy));
+    }
+    EXPECT_FALSE(shouldLog(message));
+    EXPECT_FALSE(shouldLog(messageCopy));
+
+    // Different text is still limited on its own.
+    std::string otherMessage(64, 'b');
+    EXPECT_TRUE(shouldLog(otherMessage));
+}
+}  // anonymous namespace
+}  // namespace gl
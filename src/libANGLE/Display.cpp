@@ -629,6 +629,8 @@ Error Display::initialize()
     }
 
     initializeFrontendFeatures();
+    mMemoryProgramCache.setCompressionEnabled(
+        mFrontendFeatures.enableProgramBinaryCompression.enabled);
 
     mFeatures.clear();
     mFrontendFeatures.populateFeatureList(&mFeatures);
@@ -678,6 +680,9 @@ Error Display::terminate(const Thread *thread)
         return NoError();
     }
 
+    // Store the programs still queued for the application's blob cache before its functions are
+    // dropped.
+    mMemoryProgramCache.flush();
     mMemoryProgramCache.clear();
     mBlobCache.setBlobCacheFuncs(nullptr, nullptr);
 
@@ -1182,6 +1187,7 @@ void Display::notifyDeviceLost()
 
 void Display::setBlobCacheFuncs(EGLSetBlobFuncANDROID set, EGLGetBlobFuncANDROID get)
 {
+    mMemoryProgramCache.flush();
     mBlobCache.setBlobCacheFuncs(set, get);
     mImplementation->setBlobCacheFuncs(set, get);
 }
@@ -1435,6 +1441,7 @@ void Display::initializeFrontendFeatures()
     // Enable on all Impls
     ANGLE_FEATURE_CONDITION((&mFrontendFeatures), loseContextOnOutOfMemory, true)
     ANGLE_FEATURE_CONDITION((&mFrontendFeatures), scalarizeVecAndMatConstructorArgs, true)
+    ANGLE_FEATURE_CONDITION((&mFrontendFeatures), enableProgramBinaryCompression, true)
 
     mImplementation->initializeFrontendFeatures(&mFrontendFeatures);
 
@@ -1495,9 +1502,8 @@ Error Display::programCacheQuery(EGLint index,
 {
     ASSERT(index >= 0 && index < static_cast<EGLint>(mMemoryProgramCache.entryCount()));
 
-    const BlobCache::Key *programHash = nullptr;
-    BlobCache::Value programBinary;
-    // TODO(jmadill): Make this thread-safe.
+    BlobCache::Key programHash;
+    angle::MemoryBuffer programBinary;
     bool result =
         mMemoryProgramCache.getAt(static_cast<size_t>(index), &programHash, &programBinary);
     if (!result)
@@ -1510,7 +1516,7 @@ Error Display::programCacheQuery(EGLint index,
     if (key)
     {
         ASSERT(*keysize == static_cast<EGLint>(BlobCache::kKeyLength));
-        memcpy(key, programHash->data(), BlobCache::kKeyLength);
+        memcpy(key, programHash.data(), BlobCache::kKeyLength);
     }
 
     if (binary)
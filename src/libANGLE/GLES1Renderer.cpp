@@ -24,12 +24,104 @@
 namespace
 {
 #include "libANGLE/GLES1Shaders.inc"
+
+// Layout of GLES1Renderer::ShaderKey. Fields that have no effect in the current state (e.g. the
+// fog mode while fog is disabled) are left zero so that equivalent states share a variant.
+constexpr uint32_t kKeyTexture2DShift      = 0;  // 1 bit per unit
+constexpr uint32_t kKeyTextureCubeMapShift = 4;  // 1 bit per unit
+constexpr uint32_t kKeyTextureEnvModeShift = 8;  // 4 bits per unit
+constexpr uint32_t kKeyTextureEnvModeBits  = 4;
+constexpr uint32_t kKeyShadeModelFlatShift = 24;
+constexpr uint32_t kKeyLightingShift       = 25;
+constexpr uint32_t kKeyColorMaterialShift  = 26;
+constexpr uint32_t kKeyFogShift            = 27;
+constexpr uint32_t kKeyFogModeShift        = 28;  // 2 bits
+constexpr uint32_t kKeyAlphaTestShift      = 30;
+constexpr uint32_t kKeyAlphaFuncShift      = 31;  // 4 bits
+constexpr uint32_t kKeyClipPlanesShift     = 35;
+constexpr uint32_t kKeyTexUnitCount        = 4;
+
+static_assert(static_cast<uint32_t>(gl::TextureEnvMode::EnumCount) <=
+                  (1u << kKeyTextureEnvModeBits),
+              "TextureEnvMode does not fit in the shader key");
+static_assert(static_cast<uint32_t>(gl::FogMode::EnumCount) <= 4u,
+              "FogMode does not fit in the shader key");
+static_assert(static_cast<uint32_t>(gl::AlphaTestFunc::EnumCount) <= 16u,
+              "AlphaTestFunc does not fit in the shader key");
+
+uint64_t GetKeyField(uint64_t key, uint32_t shift, uint32_t bits)
+{
+    return (key >> shift) & ((uint64_t(1) << bits) - 1);
+}
+
+const char *GetBoolString(uint64_t value)
+{
+    return value ? "true" : "false";
+}
+
+// Generates the defines that turn the keyed uniforms of the fragment shader into constants.
+std::string GetSpecializedShaderDefines(uint64_t key)
+{
+    std::stringstream defines;
+    defines << std::showbase << std::hex;
+
+    defines << "\n#define GLES1_SPECIALIZED\n";
+
+    defines << "#define GLES1_ENABLE_TEXTURE_2D ";
+    for (uint32_t unit = 0; unit < kKeyTexUnitCount; ++unit)
+    {
+        defines << (unit > 0 ? ", " : "")
+                << GetBoolString(GetKeyField(key, kKeyTexture2DShift + unit, 1));
+    }
+    defines << "\n#define GLES1_ENABLE_TEXTURE_CUBE_MAP ";
+    for (uint32_t unit = 0; unit < kKeyTexUnitCount; ++unit)
+    {
+        defines << (unit > 0 ? ", " : "")
+                << GetBoolString(GetKeyField(key, kKeyTextureCubeMapShift + unit, 1));
+    }
+    defines << "\n#define GLES1_TEXTURE_ENV_MODE ";
+    for (uint32_t unit = 0; unit < kKeyTexUnitCount; ++unit)
+    {
+        uint64_t mode = GetKeyField(key, kKeyTextureEnvModeShift + unit * kKeyTextureEnvModeBits,
+                                    kKeyTextureEnvModeBits);
+        defines << (unit > 0 ? ", " : "")
+                << gl::ToGLenum(static_cast<gl::TextureEnvMode>(mode));
+    }
+    defines << "\n";
+
+    uint64_t alphaFunc = GetKeyField(key, kKeyAlphaFuncShift, 4);
+    uint64_t fogMode   = GetKeyField(key, kKeyFogModeShift, 2);
+
+    defines << "#define GLES1_ENABLE_ALPHA_TEST "
+            << GetBoolString(GetKeyField(key, kKeyAlphaTestShift, 1)) << "\n";
+    defines << "#define GLES1_ALPHA_FUNC "
+            << gl::ToGLenum(static_cast<gl::AlphaTestFunc>(alphaFunc)) << "\n";
+    defines << "#define GLES1_SHADE_MODEL_FLAT "
+            << GetBoolString(GetKeyField(key, kKeyShadeModelFlatShift, 1)) << "\n";
+    defines << "#define GLES1_ENABLE_LIGHTING "
+            << GetBoolString(GetKeyField(key, kKeyLightingShift, 1)) << "\n";
+    defines << "#define GLES1_ENABLE_COLOR_MATERIAL "
+            << GetBoolString(GetKeyField(key, kKeyColorMaterialShift, 1)) << "\n";
+    defines << "#define GLES1_ENABLE_FOG " << GetBoolString(GetKeyField(key, kKeyFogShift, 1))
+            << "\n";
+    defines << "#define GLES1_FOG_MODE " << gl::ToGLenum(static_cast<gl::FogMode>(fogMode))
+            << "\n";
+    defines << "#define GLES1_ENABLE_CLIP_PLANES "
+            << GetBoolString(GetKeyField(key, kKeyClipPlanesShift, 1)) << "\n";
+
+    return defines.str();
+}
 }  // anonymous namespace
 
 namespace gl
 {
 
-GLES1Renderer::GLES1Renderer() : mRendererProgramInitialized(false) {}
+GLES1Renderer::GLES1Renderer()
+    : mRendererProgramInitialized(false),
+      mVertexShader{0},
+      mProgramVariants(kMaxProgramVariants),
+      mCurrentProgram{0}
+{}
 
 void GLES1Renderer::onDestroy(Context *context, State *state)
 {
@@ -37,7 +129,9 @@ void GLES1Renderer::onDestroy(Context *context, State *state)
     {
         (void)state->setProgram(context, 0);
 
+        deleteProgramVariants(context);
         mShaderPrograms->deleteProgram(context, {mProgramState.program});
+        mShaderPrograms->deleteShader(context, mVertexShader);
         mShaderPrograms->release(context);
         mShaderPrograms             = nullptr;
         mRendererProgramInitialized = false;
@@ -50,9 +144,12 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
 {
     ANGLE_TRY(initializeRendererProgram(context, glState));
 
+    GLES1ProgramState *programState = nullptr;
+    ANGLE_TRY(selectProgram(context, glState, &programState));
+
     GLES1State &gles1State = glState->gles1();
 
-    Program *programObject = getProgram(mProgramState.program);
+    Program *programObject = getProgram(programState->program);
 
     GLES1UniformBuffers &uniformBuffers = mUniformBuffers;
 
@@ -61,17 +158,17 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
 
     // Feature enables
     {
-        setUniform1i(context, programObject, mProgramState.enableAlphaTestLoc,
+        setUniform1i(context, programObject, programState->enableAlphaTestLoc,
                      glState->getEnableFeature(GL_ALPHA_TEST));
-        setUniform1i(context, programObject, mProgramState.enableLightingLoc,
+        setUniform1i(context, programObject, programState->enableLightingLoc,
                      glState->getEnableFeature(GL_LIGHTING));
-        setUniform1i(context, programObject, mProgramState.enableRescaleNormalLoc,
+        setUniform1i(context, programObject, programState->enableRescaleNormalLoc,
                      glState->getEnableFeature(GL_RESCALE_NORMAL));
-        setUniform1i(context, programObject, mProgramState.enableNormalizeLoc,
+        setUniform1i(context, programObject, programState->enableNormalizeLoc,
                      glState->getEnableFeature(GL_NORMALIZE));
-        setUniform1i(context, programObject, mProgramState.enableColorMaterialLoc,
+        setUniform1i(context, programObject, programState->enableColorMaterialLoc,
                      glState->getEnableFeature(GL_COLOR_MATERIAL));
-        setUniform1i(context, programObject, mProgramState.fogEnableLoc,
+        setUniform1i(context, programObject, programState->fogEnableLoc,
                      glState->getEnableFeature(GL_FOG));
 
         bool enableClipPlanes = false;
@@ -81,7 +178,7 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
             enableClipPlanes = enableClipPlanes || uniformBuffers.clipPlaneEnables[i];
         }
 
-        setUniform1i(context, programObject, mProgramState.enableClipPlanesLoc, enableClipPlanes);
+        setUniform1i(context, programObject, programState->enableClipPlanesLoc, enableClipPlanes);
     }
 
     // Texture unit enables and format info
@@ -140,15 +237,15 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
             }
         }
 
-        setUniform1iv(context, programObject, mProgramState.enableTexture2DLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->enableTexture2DLoc, kTexUnitCount,
                       tex2DEnables.data());
-        setUniform1iv(context, programObject, mProgramState.enableTextureCubeMapLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->enableTextureCubeMapLoc, kTexUnitCount,
                       texCubeEnables.data());
 
-        setUniform1iv(context, programObject, mProgramState.textureFormatLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->textureFormatLoc, kTexUnitCount,
                       tex2DFormats.data());
 
-        setUniform4fv(programObject, mProgramState.drawTextureNormalizedCropRectLoc, kTexUnitCount,
+        setUniform4fv(programObject, programState->drawTextureNormalizedCropRectLoc, kTexUnitCount,
                       reinterpret_cast<GLfloat *>(cropRectBuffer));
     }
 
@@ -190,14 +287,14 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
     if (gles1State.isDirty(GLES1State::DIRTY_GLES1_MATRICES))
     {
         angle::Mat4 proj = gles1State.mProjectionMatrices.back();
-        setUniformMatrix4fv(programObject, mProgramState.projMatrixLoc, 1, GL_FALSE, proj.data());
+        setUniformMatrix4fv(programObject, programState->projMatrixLoc, 1, GL_FALSE, proj.data());
 
         angle::Mat4 modelview = gles1State.mModelviewMatrices.back();
-        setUniformMatrix4fv(programObject, mProgramState.modelviewMatrixLoc, 1, GL_FALSE,
+        setUniformMatrix4fv(programObject, programState->modelviewMatrixLoc, 1, GL_FALSE,
                             modelview.data());
 
         angle::Mat4 modelviewInvTr = modelview.transpose().inverse();
-        setUniformMatrix4fv(programObject, mProgramState.modelviewInvTrLoc, 1, GL_FALSE,
+        setUniformMatrix4fv(programObject, programState->modelviewInvTrLoc, 1, GL_FALSE,
                             modelviewInvTr.data());
 
         Mat4Uniform *textureMatrixBuffer = uniformBuffers.textureMatrices.data();
@@ -208,7 +305,7 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
             memcpy(textureMatrixBuffer + i, textureMatrix.data(), sizeof(Mat4Uniform));
         }
 
-        setUniformMatrix4fv(programObject, mProgramState.textureMatrixLoc, kTexUnitCount, GL_FALSE,
+        setUniformMatrix4fv(programObject, programState->textureMatrixLoc, kTexUnitCount, GL_FALSE,
                             reinterpret_cast<float *>(uniformBuffers.textureMatrices.data()));
     }
 
@@ -247,62 +344,62 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
             uniformBuffers.pointSpriteCoordReplaces[i] = env.pointSpriteCoordReplace;
         }
 
-        setUniform1iv(context, programObject, mProgramState.textureEnvModeLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->textureEnvModeLoc, kTexUnitCount,
                       uniformBuffers.texEnvModes.data());
-        setUniform1iv(context, programObject, mProgramState.combineRgbLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->combineRgbLoc, kTexUnitCount,
                       uniformBuffers.texCombineRgbs.data());
-        setUniform1iv(context, programObject, mProgramState.combineAlphaLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->combineAlphaLoc, kTexUnitCount,
                       uniformBuffers.texCombineAlphas.data());
 
-        setUniform1iv(context, programObject, mProgramState.src0rgbLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->src0rgbLoc, kTexUnitCount,
                       uniformBuffers.texCombineSrc0Rgbs.data());
-        setUniform1iv(context, programObject, mProgramState.src0alphaLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->src0alphaLoc, kTexUnitCount,
                       uniformBuffers.texCombineSrc0Alphas.data());
-        setUniform1iv(context, programObject, mProgramState.src1rgbLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->src1rgbLoc, kTexUnitCount,
                       uniformBuffers.texCombineSrc1Rgbs.data());
-        setUniform1iv(context, programObject, mProgramState.src1alphaLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->src1alphaLoc, kTexUnitCount,
                       uniformBuffers.texCombineSrc1Alphas.data());
-        setUniform1iv(context, programObject, mProgramState.src2rgbLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->src2rgbLoc, kTexUnitCount,
                       uniformBuffers.texCombineSrc2Rgbs.data());
-        setUniform1iv(context, programObject, mProgramState.src2alphaLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->src2alphaLoc, kTexUnitCount,
                       uniformBuffers.texCombineSrc2Alphas.data());
 
-        setUniform1iv(context, programObject, mProgramState.op0rgbLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->op0rgbLoc, kTexUnitCount,
                       uniformBuffers.texCombineOp0Rgbs.data());
-        setUniform1iv(context, programObject, mProgramState.op0alphaLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->op0alphaLoc, kTexUnitCount,
                       uniformBuffers.texCombineOp0Alphas.data());
-        setUniform1iv(context, programObject, mProgramState.op1rgbLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->op1rgbLoc, kTexUnitCount,
                       uniformBuffers.texCombineOp1Rgbs.data());
-        setUniform1iv(context, programObject, mProgramState.op1alphaLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->op1alphaLoc, kTexUnitCount,
                       uniformBuffers.texCombineOp1Alphas.data());
-        setUniform1iv(context, programObject, mProgramState.op2rgbLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->op2rgbLoc, kTexUnitCount,
                       uniformBuffers.texCombineOp2Rgbs.data());
-        setUniform1iv(context, programObject, mProgramState.op2alphaLoc, kTexUnitCount,
+        setUniform1iv(context, programObject, programState->op2alphaLoc, kTexUnitCount,
                       uniformBuffers.texCombineOp2Alphas.data());
 
-        setUniform4fv(programObject, mProgramState.textureEnvColorLoc, kTexUnitCount,
+        setUniform4fv(programObject, programState->textureEnvColorLoc, kTexUnitCount,
                       reinterpret_cast<float *>(uniformBuffers.texEnvColors.data()));
-        setUniform1fv(programObject, mProgramState.rgbScaleLoc, kTexUnitCount,
+        setUniform1fv(programObject, programState->rgbScaleLoc, kTexUnitCount,
                       uniformBuffers.texEnvRgbScales.data());
-        setUniform1fv(programObject, mProgramState.alphaScaleLoc, kTexUnitCount,
+        setUniform1fv(programObject, programState->alphaScaleLoc, kTexUnitCount,
                       uniformBuffers.texEnvAlphaScales.data());
 
-        setUniform1iv(context, programObject, mProgramState.pointSpriteCoordReplaceLoc,
+        setUniform1iv(context, programObject, programState->pointSpriteCoordReplaceLoc,
                       kTexUnitCount, uniformBuffers.pointSpriteCoordReplaces.data());
     }
 
     // Alpha test
     if (gles1State.isDirty(GLES1State::DIRTY_GLES1_ALPHA_TEST))
     {
-        setUniform1i(context, programObject, mProgramState.alphaFuncLoc,
+        setUniform1i(context, programObject, programState->alphaFuncLoc,
                      ToGLenum(gles1State.mAlphaTestFunc));
-        setUniform1f(programObject, mProgramState.alphaTestRefLoc, gles1State.mAlphaTestRef);
+        setUniform1f(programObject, programState->alphaTestRefLoc, gles1State.mAlphaTestRef);
     }
 
     // Shading, materials, and lighting
     if (gles1State.isDirty(GLES1State::DIRTY_GLES1_SHADE_MODEL))
     {
-        setUniform1i(context, programObject, mProgramState.shadeModelFlatLoc,
+        setUniform1i(context, programObject, programState->shadeModelFlatLoc,
                      gles1State.mShadeModel == ShadingModel::Flat);
     }
 
@@ -310,13 +407,13 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
     {
         const auto &material = gles1State.mMaterial;
 
-        setUniform4fv(programObject, mProgramState.materialAmbientLoc, 1, material.ambient.data());
-        setUniform4fv(programObject, mProgramState.materialDiffuseLoc, 1, material.diffuse.data());
-        setUniform4fv(programObject, mProgramState.materialSpecularLoc, 1,
+        setUniform4fv(programObject, programState->materialAmbientLoc, 1, material.ambient.data());
+        setUniform4fv(programObject, programState->materialDiffuseLoc, 1, material.diffuse.data());
+        setUniform4fv(programObject, programState->materialSpecularLoc, 1,
                       material.specular.data());
-        setUniform4fv(programObject, mProgramState.materialEmissiveLoc, 1,
+        setUniform4fv(programObject, programState->materialEmissiveLoc, 1,
                       material.emissive.data());
-        setUniform1f(programObject, mProgramState.materialSpecularExponentLoc,
+        setUniform1f(programObject, programState->materialSpecularExponentLoc,
                      material.specularExponent);
     }
 
@@ -324,11 +421,11 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
     {
         const auto &lightModel = gles1State.mLightModel;
 
-        setUniform4fv(programObject, mProgramState.lightModelSceneAmbientLoc, 1,
+        setUniform4fv(programObject, programState->lightModelSceneAmbientLoc, 1,
                       lightModel.color.data());
 
         // TODO (lfy@google.com): Implement two-sided lighting model
-        // gl->uniform1i(mProgramState.lightModelTwoSidedLoc, lightModel.twoSided);
+        // gl->uniform1i(programState->lightModelTwoSidedLoc, lightModel.twoSided);
 
         for (int i = 0; i < kLightCount; i++)
         {
@@ -351,38 +448,38 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
             uniformBuffers.attenuationQuadratics[i] = light.attenuationQuadratic;
         }
 
-        setUniform1iv(context, programObject, mProgramState.lightEnablesLoc, kLightCount,
+        setUniform1iv(context, programObject, programState->lightEnablesLoc, kLightCount,
                       uniformBuffers.lightEnables.data());
-        setUniform4fv(programObject, mProgramState.lightAmbientsLoc, kLightCount,
+        setUniform4fv(programObject, programState->lightAmbientsLoc, kLightCount,
                       reinterpret_cast<float *>(uniformBuffers.lightAmbients.data()));
-        setUniform4fv(programObject, mProgramState.lightDiffusesLoc, kLightCount,
+        setUniform4fv(programObject, programState->lightDiffusesLoc, kLightCount,
                       reinterpret_cast<float *>(uniformBuffers.lightDiffuses.data()));
-        setUniform4fv(programObject, mProgramState.lightSpecularsLoc, kLightCount,
+        setUniform4fv(programObject, programState->lightSpecularsLoc, kLightCount,
                       reinterpret_cast<float *>(uniformBuffers.lightSpeculars.data()));
-        setUniform4fv(programObject, mProgramState.lightPositionsLoc, kLightCount,
+        setUniform4fv(programObject, programState->lightPositionsLoc, kLightCount,
                       reinterpret_cast<float *>(uniformBuffers.lightPositions.data()));
-        setUniform3fv(programObject, mProgramState.lightDirectionsLoc, kLightCount,
+        setUniform3fv(programObject, programState->lightDirectionsLoc, kLightCount,
                       reinterpret_cast<float *>(uniformBuffers.lightDirections.data()));
-        setUniform1fv(programObject, mProgramState.lightSpotlightExponentsLoc, kLightCount,
+        setUniform1fv(programObject, programState->lightSpotlightExponentsLoc, kLightCount,
                       reinterpret_cast<float *>(uniformBuffers.spotlightExponents.data()));
-        setUniform1fv(programObject, mProgramState.lightSpotlightCutoffAnglesLoc, kLightCount,
+        setUniform1fv(programObject, programState->lightSpotlightCutoffAnglesLoc, kLightCount,
                       reinterpret_cast<float *>(uniformBuffers.spotlightCutoffAngles.data()));
-        setUniform1fv(programObject, mProgramState.lightAttenuationConstsLoc, kLightCount,
+        setUniform1fv(programObject, programState->lightAttenuationConstsLoc, kLightCount,
                       reinterpret_cast<float *>(uniformBuffers.attenuationConsts.data()));
-        setUniform1fv(programObject, mProgramState.lightAttenuationLinearsLoc, kLightCount,
+        setUniform1fv(programObject, programState->lightAttenuationLinearsLoc, kLightCount,
                       reinterpret_cast<float *>(uniformBuffers.attenuationLinears.data()));
-        setUniform1fv(programObject, mProgramState.lightAttenuationQuadraticsLoc, kLightCount,
+        setUniform1fv(programObject, programState->lightAttenuationQuadraticsLoc, kLightCount,
                       reinterpret_cast<float *>(uniformBuffers.attenuationQuadratics.data()));
     }
 
     if (gles1State.isDirty(GLES1State::DIRTY_GLES1_FOG))
     {
         const FogParameters &fog = gles1State.fogParameters();
-        setUniform1i(context, programObject, mProgramState.fogModeLoc, ToGLenum(fog.mode));
-        setUniform1f(programObject, mProgramState.fogDensityLoc, fog.density);
-        setUniform1f(programObject, mProgramState.fogStartLoc, fog.start);
-        setUniform1f(programObject, mProgramState.fogEndLoc, fog.end);
-        setUniform4fv(programObject, mProgramState.fogColorLoc, 1, fog.color.data());
+        setUniform1i(context, programObject, programState->fogModeLoc, ToGLenum(fog.mode));
+        setUniform1f(programObject, programState->fogDensityLoc, fog.density);
+        setUniform1f(programObject, programState->fogStartLoc, fog.start);
+        setUniform1f(programObject, programState->fogEndLoc, fog.end);
+        setUniform4fv(programObject, programState->fogColorLoc, 1, fog.color.data());
     }
 
     // Clip planes
@@ -397,10 +494,10 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
                 i, reinterpret_cast<float *>(uniformBuffers.clipPlanes.data() + i));
         }
 
-        setUniform1i(context, programObject, mProgramState.enableClipPlanesLoc, enableClipPlanes);
-        setUniform1iv(context, programObject, mProgramState.clipPlaneEnablesLoc, kClipPlaneCount,
+        setUniform1i(context, programObject, programState->enableClipPlanesLoc, enableClipPlanes);
+        setUniform1iv(context, programObject, programState->clipPlaneEnablesLoc, kClipPlaneCount,
                       uniformBuffers.clipPlaneEnables.data());
-        setUniform4fv(programObject, mProgramState.clipPlanesLoc, kClipPlaneCount,
+        setUniform4fv(programObject, programState->clipPlanesLoc, kClipPlaneCount,
                       reinterpret_cast<float *>(uniformBuffers.clipPlanes.data()));
     }
 
@@ -408,22 +505,22 @@ angle::Result GLES1Renderer::prepareForDraw(PrimitiveMode mode, Context *context
     {
         const PointParameters &pointParams = gles1State.mPointParameters;
 
-        setUniform1i(context, programObject, mProgramState.pointRasterizationLoc,
+        setUniform1i(context, programObject, programState->pointRasterizationLoc,
                      mode == PrimitiveMode::Points);
-        setUniform1i(context, programObject, mProgramState.pointSpriteEnabledLoc,
+        setUniform1i(context, programObject, programState->pointSpriteEnabledLoc,
                      glState->getEnableFeature(GL_POINT_SPRITE_OES));
-        setUniform1f(programObject, mProgramState.pointSizeMinLoc, pointParams.pointSizeMin);
-        setUniform1f(programObject, mProgramState.pointSizeMaxLoc, pointParams.pointSizeMax);
-        setUniform3fv(programObject, mProgramState.pointDistanceAttenuationLoc, 1,
+        setUniform1f(programObject, programState->pointSizeMinLoc, pointParams.pointSizeMin);
+        setUniform1f(programObject, programState->pointSizeMaxLoc, pointParams.pointSizeMax);
+        setUniform3fv(programObject, programState->pointDistanceAttenuationLoc, 1,
                       pointParams.pointDistanceAttenuation.data());
     }
 
     // Draw texture
     {
-        setUniform1i(context, programObject, mProgramState.enableDrawTextureLoc,
+        setUniform1i(context, programObject, programState->enableDrawTextureLoc,
                      mDrawTextureEnabled ? 1 : 0);
-        setUniform4fv(programObject, mProgramState.drawTextureCoordsLoc, 1, mDrawTextureCoords);
-        setUniform2fv(programObject, mProgramState.drawTextureDimsLoc, 1, mDrawTextureDims);
+        setUniform4fv(programObject, programState->drawTextureCoordsLoc, 1, mDrawTextureCoords);
+        setUniform2fv(programObject, programState->drawTextureDimsLoc, 1, mDrawTextureDims);
     }
 
     gles1State.clearDirty();
@@ -600,10 +697,9 @@ angle::Result GLES1Renderer::initializeRendererProgram(Context *context, State *
 
     mShaderPrograms = new ShaderProgramManager();
 
-    ShaderProgramID vertexShader;
     ShaderProgramID fragmentShader;
 
-    ANGLE_TRY(compileShader(context, ShaderType::Vertex, kGLES1DrawVShader, &vertexShader));
+    ANGLE_TRY(compileShader(context, ShaderType::Vertex, kGLES1DrawVShader, &mVertexShader));
 
     std::stringstream fragmentStream;
     fragmentStream << kGLES1DrawFShaderHeader;
@@ -615,32 +711,44 @@ angle::Result GLES1Renderer::initializeRendererProgram(Context *context, State *
     ANGLE_TRY(compileShader(context, ShaderType::Fragment, fragmentStream.str().c_str(),
                             &fragmentShader));
 
-    std::unordered_map<GLint, std::string> attribLocs;
-
-    attribLocs[(GLint)kVertexAttribIndex]    = "pos";
-    attribLocs[(GLint)kNormalAttribIndex]    = "normal";
-    attribLocs[(GLint)kColorAttribIndex]     = "color";
-    attribLocs[(GLint)kPointSizeAttribIndex] = "pointsize";
+    mAttribLocations[(GLint)kVertexAttribIndex]    = "pos";
+    mAttribLocations[(GLint)kNormalAttribIndex]    = "normal";
+    mAttribLocations[(GLint)kColorAttribIndex]     = "color";
+    mAttribLocations[(GLint)kPointSizeAttribIndex] = "pointsize";
 
     for (int i = 0; i < kTexUnitCount; i++)
     {
         std::stringstream ss;
         ss << "texcoord" << i;
-        attribLocs[kTextureCoordAttribIndexBase + i] = ss.str();
+        mAttribLocations[kTextureCoordAttribIndexBase + i] = ss.str();
     }
 
-    ANGLE_TRY(linkProgram(context, glState, vertexShader, fragmentShader, attribLocs,
+    ANGLE_TRY(linkProgram(context, glState, mVertexShader, fragmentShader, mAttribLocations,
                           &mProgramState.program));
 
-    mShaderPrograms->deleteShader(context, vertexShader);
+    // The vertex shader is kept around for the specialized programs.
     mShaderPrograms->deleteShader(context, fragmentShader);
 
     Program *programObject = getProgram(mProgramState.program);
+    initializeProgramState(context, programObject, &mProgramState);
+
+    ANGLE_TRY(glState->setProgram(context, programObject));
+    mCurrentProgram = mProgramState.program;
+
+    glState->setObjectDirty(GL_PROGRAM);
+
+    mRendererProgramInitialized = true;
+    return angle::Result::Continue;
+}
 
-    mProgramState.projMatrixLoc      = programObject->getUniformLocation("projection");
-    mProgramState.modelviewMatrixLoc = programObject->getUniformLocation("modelview");
-    mProgramState.textureMatrixLoc   = programObject->getUniformLocation("texture_matrix");
-    mProgramState.modelviewInvTrLoc  = programObject->getUniformLocation("modelview_invtr");
+void GLES1Renderer::initializeProgramState(Context *context,
+                                           Program *programObject,
+                                           GLES1ProgramState *programState)
+{
+    programState->projMatrixLoc      = programObject->getUniformLocation("projection");
+    programState->modelviewMatrixLoc = programObject->getUniformLocation("modelview");
+    programState->textureMatrixLoc   = programObject->getUniformLocation("texture_matrix");
+    programState->modelviewInvTrLoc  = programObject->getUniformLocation("modelview_invtr");
 
     for (int i = 0; i < kTexUnitCount; i++)
     {
@@ -650,117 +758,339 @@ angle::Result GLES1Renderer::initializeRendererProgram(Context *context, State *
         ss2d << "tex_sampler" << i;
         sscube << "tex_cube_sampler" << i;
 
-        mProgramState.tex2DSamplerLocs[i] = programObject->getUniformLocation(ss2d.str().c_str());
-        mProgramState.texCubeSamplerLocs[i] =
+        programState->tex2DSamplerLocs[i] = programObject->getUniformLocation(ss2d.str().c_str());
+        programState->texCubeSamplerLocs[i] =
             programObject->getUniformLocation(sscube.str().c_str());
     }
 
-    mProgramState.enableTexture2DLoc = programObject->getUniformLocation("enable_texture_2d");
-    mProgramState.enableTextureCubeMapLoc =
+    programState->enableTexture2DLoc = programObject->getUniformLocation("enable_texture_2d");
+    programState->enableTextureCubeMapLoc =
         programObject->getUniformLocation("enable_texture_cube_map");
 
-    mProgramState.textureFormatLoc   = programObject->getUniformLocation("texture_format");
-    mProgramState.textureEnvModeLoc  = programObject->getUniformLocation("texture_env_mode");
-    mProgramState.combineRgbLoc      = programObject->getUniformLocation("combine_rgb");
-    mProgramState.combineAlphaLoc    = programObject->getUniformLocation("combine_alpha");
-    mProgramState.src0rgbLoc         = programObject->getUniformLocation("src0_rgb");
-    mProgramState.src0alphaLoc       = programObject->getUniformLocation("src0_alpha");
-    mProgramState.src1rgbLoc         = programObject->getUniformLocation("src1_rgb");
-    mProgramState.src1alphaLoc       = programObject->getUniformLocation("src1_alpha");
-    mProgramState.src2rgbLoc         = programObject->getUniformLocation("src2_rgb");
-    mProgramState.src2alphaLoc       = programObject->getUniformLocation("src2_alpha");
-    mProgramState.op0rgbLoc          = programObject->getUniformLocation("op0_rgb");
-    mProgramState.op0alphaLoc        = programObject->getUniformLocation("op0_alpha");
-    mProgramState.op1rgbLoc          = programObject->getUniformLocation("op1_rgb");
-    mProgramState.op1alphaLoc        = programObject->getUniformLocation("op1_alpha");
-    mProgramState.op2rgbLoc          = programObject->getUniformLocation("op2_rgb");
-    mProgramState.op2alphaLoc        = programObject->getUniformLocation("op2_alpha");
-    mProgramState.textureEnvColorLoc = programObject->getUniformLocation("texture_env_color");
-    mProgramState.rgbScaleLoc        = programObject->getUniformLocation("texture_env_rgb_scale");
-    mProgramState.alphaScaleLoc      = programObject->getUniformLocation("texture_env_alpha_scale");
-    mProgramState.pointSpriteCoordReplaceLoc =
+    programState->textureFormatLoc   = programObject->getUniformLocation("texture_format");
+    programState->textureEnvModeLoc  = programObject->getUniformLocation("texture_env_mode");
+    programState->combineRgbLoc      = programObject->getUniformLocation("combine_rgb");
+    programState->combineAlphaLoc    = programObject->getUniformLocation("combine_alpha");
+    programState->src0rgbLoc         = programObject->getUniformLocation("src0_rgb");
+    programState->src0alphaLoc       = programObject->getUniformLocation("src0_alpha");
+    programState->src1rgbLoc         = programObject->getUniformLocation("src1_rgb");
+    programState->src1alphaLoc       = programObject->getUniformLocation("src1_alpha");
+    programState->src2rgbLoc         = programObject->getUniformLocation("src2_rgb");
+    programState->src2alphaLoc       = programObject->getUniformLocation("src2_alpha");
+    programState->op0rgbLoc          = programObject->getUniformLocation("op0_rgb");
+    programState->op0alphaLoc        = programObject->getUniformLocation("op0_alpha");
+    programState->op1rgbLoc          = programObject->getUniformLocation("op1_rgb");
+    programState->op1alphaLoc        = programObject->getUniformLocation("op1_alpha");
+    programState->op2rgbLoc          = programObject->getUniformLocation("op2_rgb");
+    programState->op2alphaLoc        = programObject->getUniformLocation("op2_alpha");
+    programState->textureEnvColorLoc = programObject->getUniformLocation("texture_env_color");
+    programState->rgbScaleLoc        = programObject->getUniformLocation("texture_env_rgb_scale");
+    programState->alphaScaleLoc      = programObject->getUniformLocation("texture_env_alpha_scale");
+    programState->pointSpriteCoordReplaceLoc =
         programObject->getUniformLocation("point_sprite_coord_replace");
 
-    mProgramState.enableAlphaTestLoc = programObject->getUniformLocation("enable_alpha_test");
-    mProgramState.alphaFuncLoc       = programObject->getUniformLocation("alpha_func");
-    mProgramState.alphaTestRefLoc    = programObject->getUniformLocation("alpha_test_ref");
+    programState->enableAlphaTestLoc = programObject->getUniformLocation("enable_alpha_test");
+    programState->alphaFuncLoc       = programObject->getUniformLocation("alpha_func");
+    programState->alphaTestRefLoc    = programObject->getUniformLocation("alpha_test_ref");
 
-    mProgramState.shadeModelFlatLoc = programObject->getUniformLocation("shade_model_flat");
-    mProgramState.enableLightingLoc = programObject->getUniformLocation("enable_lighting");
-    mProgramState.enableRescaleNormalLoc =
+    programState->shadeModelFlatLoc = programObject->getUniformLocation("shade_model_flat");
+    programState->enableLightingLoc = programObject->getUniformLocation("enable_lighting");
+    programState->enableRescaleNormalLoc =
         programObject->getUniformLocation("enable_rescale_normal");
-    mProgramState.enableNormalizeLoc = programObject->getUniformLocation("enable_normalize");
-    mProgramState.enableColorMaterialLoc =
+    programState->enableNormalizeLoc = programObject->getUniformLocation("enable_normalize");
+    programState->enableColorMaterialLoc =
         programObject->getUniformLocation("enable_color_material");
 
-    mProgramState.materialAmbientLoc  = programObject->getUniformLocation("material_ambient");
-    mProgramState.materialDiffuseLoc  = programObject->getUniformLocation("material_diffuse");
-    mProgramState.materialSpecularLoc = programObject->getUniformLocation("material_specular");
-    mProgramState.materialEmissiveLoc = programObject->getUniformLocation("material_emissive");
-    mProgramState.materialSpecularExponentLoc =
+    programState->materialAmbientLoc  = programObject->getUniformLocation("material_ambient");
+    programState->materialDiffuseLoc  = programObject->getUniformLocation("material_diffuse");
+    programState->materialSpecularLoc = programObject->getUniformLocation("material_specular");
+    programState->materialEmissiveLoc = programObject->getUniformLocation("material_emissive");
+    programState->materialSpecularExponentLoc =
         programObject->getUniformLocation("material_specular_exponent");
 
-    mProgramState.lightModelSceneAmbientLoc =
+    programState->lightModelSceneAmbientLoc =
         programObject->getUniformLocation("light_model_scene_ambient");
-    mProgramState.lightModelTwoSidedLoc =
+    programState->lightModelTwoSidedLoc =
         programObject->getUniformLocation("light_model_two_sided");
 
-    mProgramState.lightEnablesLoc    = programObject->getUniformLocation("light_enables");
-    mProgramState.lightAmbientsLoc   = programObject->getUniformLocation("light_ambients");
-    mProgramState.lightDiffusesLoc   = programObject->getUniformLocation("light_diffuses");
-    mProgramState.lightSpecularsLoc  = programObject->getUniformLocation("light_speculars");
-    mProgramState.lightPositionsLoc  = programObject->getUniformLocation("light_positions");
-    mProgramState.lightDirectionsLoc = programObject->getUniformLocation("light_directions");
-    mProgramState.lightSpotlightExponentsLoc =
+    programState->lightEnablesLoc    = programObject->getUniformLocation("light_enables");
+    programState->lightAmbientsLoc   = programObject->getUniformLocation("light_ambients");
+    programState->lightDiffusesLoc   = programObject->getUniformLocation("light_diffuses");
+    programState->lightSpecularsLoc  = programObject->getUniformLocation("light_speculars");
+    programState->lightPositionsLoc  = programObject->getUniformLocation("light_positions");
+    programState->lightDirectionsLoc = programObject->getUniformLocation("light_directions");
+    programState->lightSpotlightExponentsLoc =
         programObject->getUniformLocation("light_spotlight_exponents");
-    mProgramState.lightSpotlightCutoffAnglesLoc =
+    programState->lightSpotlightCutoffAnglesLoc =
         programObject->getUniformLocation("light_spotlight_cutoff_angles");
-    mProgramState.lightAttenuationConstsLoc =
+    programState->lightAttenuationConstsLoc =
         programObject->getUniformLocation("light_attenuation_consts");
-    mProgramState.lightAttenuationLinearsLoc =
+    programState->lightAttenuationLinearsLoc =
         programObject->getUniformLocation("light_attenuation_linears");
-    mProgramState.lightAttenuationQuadraticsLoc =
+    programState->lightAttenuationQuadraticsLoc =
         programObject->getUniformLocation("light_attenuation_quadratics");
 
-    mProgramState.fogEnableLoc  = programObject->getUniformLocation("enable_fog");
-    mProgramState.fogModeLoc    = programObject->getUniformLocation("fog_mode");
-    mProgramState.fogDensityLoc = programObject->getUniformLocation("fog_density");
-    mProgramState.fogStartLoc   = programObject->getUniformLocation("fog_start");
-    mProgramState.fogEndLoc     = programObject->getUniformLocation("fog_end");
-    mProgramState.fogColorLoc   = programObject->getUniformLocation("fog_color");
-
-    mProgramState.enableClipPlanesLoc = programObject->getUniformLocation("enable_clip_planes");
-    mProgramState.clipPlaneEnablesLoc = programObject->getUniformLocation("clip_plane_enables");
-    mProgramState.clipPlanesLoc       = programObject->getUniformLocation("clip_planes");
-
-    mProgramState.pointRasterizationLoc = programObject->getUniformLocation("point_rasterization");
-    mProgramState.pointSizeMinLoc       = programObject->getUniformLocation("point_size_min");
-    mProgramState.pointSizeMaxLoc       = programObject->getUniformLocation("point_size_max");
-    mProgramState.pointDistanceAttenuationLoc =
+    programState->fogEnableLoc  = programObject->getUniformLocation("enable_fog");
+    programState->fogModeLoc    = programObject->getUniformLocation("fog_mode");
+    programState->fogDensityLoc = programObject->getUniformLocation("fog_density");
+    programState->fogStartLoc   = programObject->getUniformLocation("fog_start");
+    programState->fogEndLoc     = programObject->getUniformLocation("fog_end");
+    programState->fogColorLoc   = programObject->getUniformLocation("fog_color");
+
+    programState->enableClipPlanesLoc = programObject->getUniformLocation("enable_clip_planes");
+    programState->clipPlaneEnablesLoc = programObject->getUniformLocation("clip_plane_enables");
+    programState->clipPlanesLoc       = programObject->getUniformLocation("clip_planes");
+
+    programState->pointRasterizationLoc = programObject->getUniformLocation("point_rasterization");
+    programState->pointSizeMinLoc       = programObject->getUniformLocation("point_size_min");
+    programState->pointSizeMaxLoc       = programObject->getUniformLocation("point_size_max");
+    programState->pointDistanceAttenuationLoc =
         programObject->getUniformLocation("point_distance_attenuation");
-    mProgramState.pointSpriteEnabledLoc = programObject->getUniformLocation("point_sprite_enabled");
+    programState->pointSpriteEnabledLoc = programObject->getUniformLocation("point_sprite_enabled");
 
-    mProgramState.enableDrawTextureLoc = programObject->getUniformLocation("enable_draw_texture");
-    mProgramState.drawTextureCoordsLoc = programObject->getUniformLocation("draw_texture_coords");
-    mProgramState.drawTextureDimsLoc   = programObject->getUniformLocation("draw_texture_dims");
-    mProgramState.drawTextureNormalizedCropRectLoc =
+    programState->enableDrawTextureLoc = programObject->getUniformLocation("enable_draw_texture");
+    programState->drawTextureCoordsLoc = programObject->getUniformLocation("draw_texture_coords");
+    programState->drawTextureDimsLoc   = programObject->getUniformLocation("draw_texture_dims");
+    programState->drawTextureNormalizedCropRectLoc =
         programObject->getUniformLocation("draw_texture_normalized_crop_rect");
 
-    ANGLE_TRY(glState->setProgram(context, programObject));
-
     for (int i = 0; i < kTexUnitCount; i++)
     {
-        setUniform1i(context, programObject, mProgramState.tex2DSamplerLocs[i], i);
-        setUniform1i(context, programObject, mProgramState.texCubeSamplerLocs[i],
+        setUniform1i(context, programObject, programState->tex2DSamplerLocs[i], i);
+        setUniform1i(context, programObject, programState->texCubeSamplerLocs[i],
                      i + kTexUnitCount);
     }
+}
 
-    glState->setObjectDirty(GL_PROGRAM);
+GLES1Renderer::ShaderKey GLES1Renderer::computeShaderKey(const State *glState) const
+{
+    const GLES1State &gles1State = glState->gles1();
+
+    ShaderKey key = 0;
+
+    for (uint32_t unit = 0; unit < kKeyTexUnitCount; ++unit)
+    {
+        // Cube map texturing takes precedence over 2D texturing, see prepareForDraw.
+        bool cubeEnabled = gles1State.isTextureTargetEnabled(unit, TextureType::CubeMap);
+        bool tex2DEnabled =
+            !cubeEnabled && gles1State.isTextureTargetEnabled(unit, TextureType::_2D);
+
+        if (!cubeEnabled && !tex2DEnabled)
+        {
+            continue;
+        }
+
+        TextureEnvMode mode = gles1State.textureEnvironment(unit).mode;
+
+        key |= ShaderKey(tex2DEnabled) << (kKeyTexture2DShift + unit);
+        key |= ShaderKey(cubeEnabled) << (kKeyTextureCubeMapShift + unit);
+        key |= ShaderKey(mode) << (kKeyTextureEnvModeShift + unit * kKeyTextureEnvModeBits);
+    }
+
+    key |= ShaderKey(gles1State.mShadeModel == ShadingModel::Flat) << kKeyShadeModelFlatShift;
+
+    if (glState->getEnableFeature(GL_LIGHTING))
+    {
+        key |= ShaderKey(1) << kKeyLightingShift;
+        key |= ShaderKey(glState->getEnableFeature(GL_COLOR_MATERIAL)) << kKeyColorMaterialShift;
+    }
+
+    if (glState->getEnableFeature(GL_FOG))
+    {
+        key |= ShaderKey(1) << kKeyFogShift;
+        key |= ShaderKey(gles1State.fogParameters().mode) << kKeyFogModeShift;
+    }
+
+    if (glState->getEnableFeature(GL_ALPHA_TEST))
+    {
+        key |= ShaderKey(1) << kKeyAlphaTestShift;
+        key |= ShaderKey(gles1State.mAlphaTestFunc) << kKeyAlphaFuncShift;
+    }
+
+    for (int i = 0; i < kClipPlaneCount; i++)
+    {
+        if (glState->getEnableFeature(GL_CLIP_PLANE0 + i))
+        {
+            key |= ShaderKey(1) << kKeyClipPlanesShift;
+            break;
+        }
+    }
+
+    return key;
+}
+
+angle::Result GLES1Renderer::selectProgram(Context *context,
+                                           State *glState,
+                                           GLES1ProgramState **stateOut)
+{
+    GLES1ProgramState *variantState = nullptr;
+    ANGLE_TRY(updateProgramVariant(context, computeShaderKey(glState), &variantState));
+
+    *stateOut = variantState ? variantState : &mProgramState;
+
+    ShaderProgramID program = (*stateOut)->program;
+    if (program != mCurrentProgram)
+    {
+        ANGLE_TRY(glState->setProgram(context, getProgram(program)));
+        glState->setObjectDirty(GL_PROGRAM);
+
+        // Each program has its own copy of the uniforms, so everything has to be uploaded again.
+        glState->gles1().setAllDirty();
+        mCurrentProgram = program;
+    }
+
+    return angle::Result::Continue;
+}
+
+angle::Result GLES1Renderer::updateProgramVariant(Context *context,
+                                                  ShaderKey key,
+                                                  GLES1ProgramState **readyStateOut)
+{
+    *readyStateOut = nullptr;
+
+    auto iter = mProgramVariants.Get(key);
+    if (iter == mProgramVariants.end())
+    {
+        // Evict the least recently used variant by hand so that its GL objects are released.
+        if (mProgramVariants.size() >= kMaxProgramVariants)
+        {
+            auto oldest = mProgramVariants.rbegin();
+            deleteProgramVariant(context, &oldest->second);
+            mProgramVariants.Erase(oldest);
+        }
+
+        std::stringstream fragmentStream;
+        fragmentStream << kGLES1DrawFShaderHeader;
+        fragmentStream << GetSpecializedShaderDefines(key);
+        fragmentStream << kGLES1DrawFShaderUniformDefs;
+        fragmentStream << kGLES1DrawFShaderFunctions;
+        fragmentStream << kGLES1DrawFShaderMultitexturing;
+        fragmentStream << kGLES1DrawFShaderMain;
+
+        std::string fragmentSource    = fragmentStream.str();
+        const char *fragmentSourcePtr = fragmentSource.c_str();
+
+        rx::ContextImpl *implementation = context->getImplementation();
+        const Limitations &limitations  = implementation->getNativeLimitations();
+
+        ProgramVariant variant;
+        variant.status               = ProgramVariantStatus::Compiling;
+        variant.programState.program = {0};
+
+        variant.fragmentShader =
+            mShaderPrograms->createShader(implementation, limitations, ShaderType::Fragment);
+
+        // Don't wait for the compilation; the uber program is used in the meantime.
+        Shader *shaderObject = getShader(variant.fragmentShader);
+        ANGLE_CHECK(context, shaderObject, "Missing shader object", GL_INVALID_OPERATION);
+        shaderObject->setSource(1, &fragmentSourcePtr, nullptr);
+        shaderObject->compile(context);
+
+        mProgramVariants.Put(key, std::move(variant));
+        return angle::Result::Continue;
+    }
+
+    ProgramVariant &variant = iter->second;
+
+    if (variant.status == ProgramVariantStatus::Compiling)
+    {
+        Shader *shaderObject = getShader(variant.fragmentShader);
+        if (!shaderObject->isCompleted())
+        {
+            return angle::Result::Continue;
+        }
+
+        if (!shaderObject->isCompiled())
+        {
+            WARN() << "Specialized GLES 1 shader compile failed, using the uber shader.";
+            deleteProgramVariant(context, &variant);
+            variant.status = ProgramVariantStatus::Failed;
+            return angle::Result::Continue;
+        }
+
+        variant.programState.program = mShaderPrograms->createProgram(context->getImplementation());
+
+        Program *programObject = getProgram(variant.programState.program);
+        ANGLE_CHECK(context, programObject, "Missing program object", GL_INVALID_OPERATION);
+
+        programObject->attachShader(getShader(mVertexShader));
+        programObject->attachShader(shaderObject);
+
+        for (const auto &attribLocation : mAttribLocations)
+        {
+            programObject->bindAttributeLocation(attribLocation.first,
+                                                 attribLocation.second.c_str());
+        }
+
+        ANGLE_TRY(programObject->link(context));
+        variant.status = ProgramVariantStatus::Linking;
+    }
+
+    if (variant.status == ProgramVariantStatus::Linking)
+    {
+        Program *programObject = getProgram(variant.programState.program);
+        if (programObject->isLinking())
+        {
+            return angle::Result::Continue;
+        }
+
+        programObject->resolveLink(context);
+        programObject->detachShader(context, getShader(mVertexShader));
+        programObject->detachShader(context, getShader(variant.fragmentShader));
+
+        mShaderPrograms->deleteShader(context, variant.fragmentShader);
+        variant.fragmentShader = {0};
+
+        if (!programObject->isLinked())
+        {
+            WARN() << "Specialized GLES 1 program link failed, using the uber shader.";
+            deleteProgramVariant(context, &variant);
+            variant.status = ProgramVariantStatus::Failed;
+            return angle::Result::Continue;
+        }
+
+        initializeProgramState(context, programObject, &variant.programState);
+        variant.status = ProgramVariantStatus::Ready;
+    }
+
+    if (variant.status == ProgramVariantStatus::Ready)
+    {
+        *readyStateOut = &variant.programState;
+    }
 
-    mRendererProgramInitialized = true;
     return angle::Result::Continue;
 }
 
+void GLES1Renderer::deleteProgramVariant(Context *context, ProgramVariant *variant)
+{
+    if (variant->programState.program.value != 0)
+    {
+        // The State keeps its own reference, so only forget that the program was current.
+        if (variant->programState.program == mCurrentProgram)
+        {
+            mCurrentProgram = {0};
+        }
+
+        mShaderPrograms->deleteProgram(context, variant->programState.program);
+        variant->programState.program = {0};
+    }
+
+    if (variant->fragmentShader.value != 0)
+    {
+        mShaderPrograms->deleteShader(context, variant->fragmentShader);
+        variant->fragmentShader = {0};
+    }
+}
+
+void GLES1Renderer::deleteProgramVariants(Context *context)
+{
+    for (auto &entry : mProgramVariants)
+    {
+        deleteProgramVariant(context, &entry.second);
+    }
+    mProgramVariants.Clear();
+}
+
 void GLES1Renderer::setUniform1i(Context *context, Program *programObject, GLint loc, GLint value)
 {
     if (loc == -1)
@@ -12,6 +12,7 @@
 
 #include "angle_gl.h"
 #include "common/angleutils.h"
+#include "common/third_party/base/anglebase/containers/mru_cache.h"
 #include "libANGLE/angletypes.h"
 
 #include <memory>
@@ -70,6 +71,25 @@ class GLES1Renderer final : angle::NonCopyable
                               ShaderProgramID *programOut);
     angle::Result initializeRendererProgram(Context *context, State *glState);
 
+    // Identifies the fixed-function state that a specialized fragment shader is built for.
+    using ShaderKey = uint64_t;
+    ShaderKey computeShaderKey(const State *glState) const;
+
+    struct GLES1ProgramState;
+    struct ProgramVariant;
+    void initializeProgramState(Context *context,
+                                Program *programObject,
+                                GLES1ProgramState *programState);
+
+    // Returns the program to draw with. Specialized programs are compiled and linked in the
+    // background; the uber program is used until the one for the current state is ready.
+    angle::Result selectProgram(Context *context, State *glState, GLES1ProgramState **stateOut);
+    angle::Result updateProgramVariant(Context *context,
+                                       ShaderKey key,
+                                       GLES1ProgramState **readyStateOut);
+    void deleteProgramVariant(Context *context, ProgramVariant *variant);
+    void deleteProgramVariants(Context *context);
+
     void setUniform1i(Context *context, Program *programObject, GLint loc, GLint value);
     void setUniform1iv(Context *context,
                        Program *programObject,
@@ -101,6 +121,10 @@ class GLES1Renderer final : angle::NonCopyable
     bool mRendererProgramInitialized;
     ShaderProgramManager *mShaderPrograms;
 
+    // Shared by the uber program and all specialized programs.
+    ShaderProgramID mVertexShader;
+    std::unordered_map<GLint, std::string> mAttribLocations;
+
     struct GLES1ProgramState
     {
         ShaderProgramID program;
@@ -249,6 +273,27 @@ class GLES1Renderer final : angle::NonCopyable
     GLES1UniformBuffers mUniformBuffers;
     GLES1ProgramState mProgramState;
 
+    enum class ProgramVariantStatus
+    {
+        Compiling,
+        Linking,
+        Ready,
+        Failed,
+    };
+
+    struct ProgramVariant
+    {
+        ProgramVariantStatus status;
+        ShaderProgramID fragmentShader;
+        GLES1ProgramState programState;
+    };
+
+    static constexpr size_t kMaxProgramVariants = 32;
+    angle::base::HashingMRUCache<ShaderKey, ProgramVariant> mProgramVariants;
+
+    // The program whose uniforms were last updated. Switching programs requires a full update.
+    ShaderProgramID mCurrentProgram;
+
     bool mDrawTextureEnabled      = false;
     GLfloat mDrawTextureCoords[4] = {0.0f, 0.0f, 0.0f, 0.0f};
     GLfloat mDrawTextureDims[2]   = {0.0f, 0.0f};
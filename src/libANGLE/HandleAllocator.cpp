@@ -16,6 +16,37 @@
 
 namespace gl
 {
+namespace
+{
+bool GetBit(const std::vector<uint64_t> &bitmap, GLuint index)
+{
+    size_t word = index / 64;
+    return word < bitmap.size() && (bitmap[word] >> (index % 64) & 1) != 0;
+}
+
+void SetBit(std::vector<uint64_t> *bitmap, GLuint index, bool value)
+{
+    size_t word = index / 64;
+    if (word >= bitmap->size())
+    {
+        if (!value)
+        {
+            return;
+        }
+        bitmap->resize(word + 1, 0);
+    }
+
+    uint64_t mask = uint64_t(1) << (index % 64);
+    if (value)
+    {
+        (*bitmap)[word] |= mask;
+    }
+    else
+    {
+        (*bitmap)[word] &= ~mask;
+    }
+}
+}  // anonymous namespace
 
 struct HandleAllocator::HandleRangeComparator
 {
@@ -47,11 +78,19 @@ GLuint HandleAllocator::allocate()
     ASSERT(!mUnallocatedList.empty() || !mReleasedList.empty());
 
     // Allocate from released list, logarithmic time for pop_heap.
-    if (!mReleasedList.empty())
+    while (!mReleasedList.empty())
     {
         std::pop_heap(mReleasedList.begin(), mReleasedList.end(), std::greater<GLuint>());
         GLuint reusedHandle = mReleasedList.back();
         mReleasedList.pop_back();
+        setQueued(reusedHandle, false);
+
+        // Skip entries that were reserved after being released.
+        if (!isReleased(reusedHandle))
+        {
+            continue;
+        }
+        setReleased(reusedHandle, false);
 
         if (mLoggingEnabled)
         {
@@ -91,9 +130,18 @@ void HandleAllocator::release(GLuint handle)
         WARN() << "HandleAllocator::release releasing " << handle << std::endl;
     }
 
+    setReleased(handle, true);
+
+    // A handle that was reserved after being released may still have its entry in the heap.
+    if (isQueued(handle))
+    {
+        return;
+    }
+
     // Add to released list, logarithmic time for push_heap.
     mReleasedList.push_back(handle);
     std::push_heap(mReleasedList.begin(), mReleasedList.end(), std::greater<GLuint>());
+    setQueued(handle, true);
 }
 
 void HandleAllocator::reserve(GLuint handle)
@@ -103,9 +151,19 @@ void HandleAllocator::reserve(GLuint handle)
         WARN() << "HandleAllocator::reserve reserving " << handle << std::endl;
     }
 
-    // Clear from released list -- might be a slow operation.
-    if (!mReleasedList.empty())
+    // Released handles tracked by the bitmap are cleared in constant time. Their heap entries are
+    // discarded lazily in allocate().
+    if (handle < kReleasedBitmapLimit)
+    {
+        if (isReleased(handle))
+        {
+            setReleased(handle, false);
+            return;
+        }
+    }
+    else if (!mReleasedList.empty())
     {
+        // Clear from released list -- might be a slow operation.
         auto releasedIt = std::find(mReleasedList.begin(), mReleasedList.end(), handle);
         if (releasedIt != mReleasedList.end())
         {
@@ -155,6 +213,8 @@ void HandleAllocator::reset()
     mUnallocatedList.clear();
     mUnallocatedList.push_back(HandleRange(1, std::numeric_limits<GLuint>::max()));
     mReleasedList.clear();
+    mReleasedBitmap.clear();
+    mQueuedBitmap.clear();
     mBaseValue = 1;
     mNextValue = 1;
 }
@@ -164,4 +224,33 @@ void HandleAllocator::enableLogging(bool enabled)
     mLoggingEnabled = enabled;
 }
 
+bool HandleAllocator::isReleased(GLuint handle) const
+{
+    // Handles outside of the bitmap are only in the heap while they are released.
+    return handle >= kReleasedBitmapLimit || GetBit(mReleasedBitmap, handle);
+}
+
+void HandleAllocator::setReleased(GLuint handle, bool released)
+{
+    if (handle < kReleasedBitmapLimit)
+    {
+        SetBit(&mReleasedBitmap, handle, released);
+    }
+}
+
+bool HandleAllocator::isQueued(GLuint handle) const
+{
+    // Handles outside of the bitmap are removed from the heap when reserved, so they are never
+    // queued when released.
+    return handle < kReleasedBitmapLimit && GetBit(mQueuedBitmap, handle);
+}
+
+void HandleAllocator::setQueued(GLuint handle, bool queued)
+{
+    if (handle < kReleasedBitmapLimit)
+    {
+        SetBit(&mQueuedBitmap, handle, queued);
+    }
+}
+
 }  // namespace gl
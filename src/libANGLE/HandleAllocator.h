@@ -36,6 +36,8 @@ class HandleAllocator final : angle::NonCopyable
 
     void enableLogging(bool enabled);
 
+    size_t getReleasedListSizeForTesting() const { return mReleasedList.size(); }
+
   private:
     GLuint mBaseValue;
     GLuint mNextValue;
@@ -53,12 +55,26 @@ class HandleAllocator final : angle::NonCopyable
 
     struct HandleRangeComparator;
 
+    bool isReleased(GLuint handle) const;
+    void setReleased(GLuint handle, bool released);
+    bool isQueued(GLuint handle) const;
+    void setQueued(GLuint handle, bool queued);
+
     // The freelist consists of never-allocated handles, stored
     // as ranges, and handles that were previously allocated and
     // released, stored in a heap.
     std::vector<HandleRange> mUnallocatedList;
     std::vector<GLuint> mReleasedList;
 
+    // Bitmap of the released handles below kReleasedBitmapLimit. Reserving one of those handles
+    // only clears its bit, and the stale heap entry is skipped when it reaches the top. This keeps
+    // reserve() from searching and rebuilding the heap when many objects are deleted.
+    static constexpr GLuint kReleasedBitmapLimit = 0x1000000;
+    std::vector<uint64_t> mReleasedBitmap;
+    // Bitmap of the handles below kReleasedBitmapLimit that have an entry in mReleasedList, stale
+    // or not. Releasing a handle that is still queued reuses its entry instead of adding another.
+    std::vector<uint64_t> mQueuedBitmap;
+
     bool mLoggingEnabled;
 };
 
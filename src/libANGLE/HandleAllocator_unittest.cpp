@@ -193,4 +193,71 @@ TEST(HandleAllocatorTest, ReserveAfterReleaseBug)
     allocator.allocate();
 }
 
+// Tests that released handles that get reserved again are never handed out by allocate.
+TEST(HandleAllocatorTest, ReserveManyReleased)
+{
+    constexpr GLuint kCount = 1000;
+    gl::HandleAllocator allocator;
+
+    for (GLuint handle = 1; handle <= kCount; ++handle)
+    {
+        EXPECT_EQ(handle, allocator.allocate());
+    }
+
+    for (GLuint handle = 1; handle <= kCount; ++handle)
+    {
+        allocator.release(handle);
+    }
+
+    // Reserve every even handle, as when binding a deleted name without generating it.
+    for (GLuint handle = 2; handle <= kCount; handle += 2)
+    {
+        allocator.reserve(handle);
+    }
+
+    // Only the odd handles are available, in ascending order.
+    for (GLuint handle = 1; handle <= kCount; handle += 2)
+    {
+        EXPECT_EQ(handle, allocator.allocate());
+    }
+    EXPECT_EQ(kCount + 1, allocator.allocate());
+
+    // Releasing a reserved handle makes it available again.
+    allocator.release(4);
+    EXPECT_EQ(4u, allocator.allocate());
+}
+
+// Tests that repeatedly releasing and reserving the same handles doesn't grow the released list.
+TEST(HandleAllocatorTest, ReleaseReserveChurn)
+{
+    constexpr GLuint kCount = 100;
+    gl::HandleAllocator allocator;
+
+    for (GLuint handle = 1; handle <= kCount; ++handle)
+    {
+        EXPECT_EQ(handle, allocator.allocate());
+    }
+
+    for (int iteration = 0; iteration < 1000; ++iteration)
+    {
+        for (GLuint handle = 1; handle <= kCount; ++handle)
+        {
+            allocator.release(handle);
+        }
+        for (GLuint handle = 1; handle <= kCount; ++handle)
+        {
+            allocator.reserve(handle);
+        }
+    }
+    EXPECT_EQ(kCount, allocator.getReleasedListSizeForTesting());
+
+    // Released handles are still handed out once each, in ascending order.
+    allocator.release(7);
+    allocator.release(3);
+    EXPECT_EQ(kCount, allocator.getReleasedListSizeForTesting());
+    EXPECT_EQ(3u, allocator.allocate());
+    EXPECT_EQ(7u, allocator.allocate());
+    EXPECT_EQ(kCount + 1, allocator.allocate());
+}
+
 }  // anonymous namespace
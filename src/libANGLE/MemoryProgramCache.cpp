@@ -12,11 +12,13 @@
 #include <GLSLANG/ShaderVars.h>
 #include <anglebase/sha1.h>
 
+#include "common/compression_utils.h"
 #include "common/utilities.h"
 #include "common/version.h"
 #include "libANGLE/BinaryStream.h"
 #include "libANGLE/Context.h"
 #include "libANGLE/Uniform.h"
+#include "libANGLE/WorkerThread.h"
 #include "libANGLE/histogram_macros.h"
 #include "libANGLE/renderer/ProgramImpl.h"
 #include "platform/Platform.h"
@@ -28,35 +30,54 @@ namespace
 {
 constexpr unsigned int kWarningLimit = 3;
 
+// Feeds the program key to SHA-1 as it's built. Strings are prefixed with their length and all
+// other values are fixed size, so no intermediate string is needed to keep the key unambiguous.
 class HashStream final : angle::NonCopyable
 {
   public:
-    std::string str() { return mStringStream.str(); }
+    void getDigest(egl::BlobCache::Key *hashOut)
+    {
+        mSha1.Final();
+        memcpy(hashOut->data(), mSha1.Digest(), hashOut->size());
+    }
 
     template <typename T>
     HashStream &operator<<(T value)
     {
-        mStringStream << value << kSeparator;
+        static_assert(std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value,
+                      "Only values with a fixed size can be hashed directly");
+        mSha1.Update(&value, sizeof(T));
         return *this;
     }
 
+    HashStream &operator<<(const char *str) { return write(str, strlen(str)); }
+    HashStream &operator<<(const std::string &str) { return write(str.data(), str.length()); }
+
   private:
-    static constexpr char kSeparator = ':';
-    std::ostringstream mStringStream;
+    HashStream &write(const char *data, size_t length)
+    {
+        *this << length;
+        mSha1.Update(data, length);
+        return *this;
+    }
+
+    angle::base::SecureHashAlgorithm mSha1;
 };
 
 HashStream &operator<<(HashStream &stream, const Shader *shader)
 {
+    // The source was hashed when the shader was compiled.
+    stream << (shader != nullptr);
     if (shader)
     {
-        stream << shader->getSourceString().c_str() << shader->getSourceString().length()
-               << shader->getCompilerResourcesString().c_str();
+        stream << shader->getShaderHash();
     }
     return stream;
 }
 
 HashStream &operator<<(HashStream &stream, const ProgramBindings &bindings)
 {
+    stream << std::distance(bindings.begin(), bindings.end());
     for (const auto &binding : bindings)
     {
         stream << binding.first << binding.second;
@@ -66,6 +87,7 @@ HashStream &operator<<(HashStream &stream, const ProgramBindings &bindings)
 
 HashStream &operator<<(HashStream &stream, const ProgramAliasedBindings &bindings)
 {
+    stream << std::distance(bindings.begin(), bindings.end());
     for (const auto &binding : bindings)
     {
         stream << binding.first << binding.second.location;
@@ -75,6 +97,7 @@ HashStream &operator<<(HashStream &stream, const ProgramAliasedBindings &binding
 
 HashStream &operator<<(HashStream &stream, const std::vector<std::string> &strings)
 {
+    stream << strings.size();
     for (const auto &str : strings)
     {
         stream << str;
@@ -84,6 +107,7 @@ HashStream &operator<<(HashStream &stream, const std::vector<std::string> &strin
 
 HashStream &operator<<(HashStream &stream, const std::vector<gl::VariableLocation> &locations)
 {
+    stream << locations.size();
     for (const auto &loc : locations)
     {
         stream << loc.index << loc.arrayIndex << loc.ignored;
@@ -93,17 +117,39 @@ HashStream &operator<<(HashStream &stream, const std::vector<gl::VariableLocatio
 
 }  // anonymous namespace
 
+class MemoryProgramCache::WriteBackTask final : public angle::Closure
+{
+  public:
+    WriteBackTask(MemoryProgramCache *cache) : mCache(cache) {}
+
+    void operator()() override { mCache->writeBackPendingPrograms(); }
+
+  private:
+    MemoryProgramCache *mCache;
+};
+
 MemoryProgramCache::MemoryProgramCache(egl::BlobCache &blobCache)
-    : mBlobCache(blobCache), mIssuedWarnings(0)
+    : mBlobCache(blobCache),
+      mIssuedWarnings(0),
+      mLastSerializedSize(0),
+      mCompressionEnabled(false),
+      mWriteBackScheduled(false)
 {}
 
-MemoryProgramCache::~MemoryProgramCache() {}
+MemoryProgramCache::~MemoryProgramCache()
+{
+    // The write-back task refers to this object.
+    if (mWriteBackEvent)
+    {
+        mWriteBackEvent->wait();
+    }
+}
 
 void MemoryProgramCache::ComputeHash(const Context *context,
                                      const Program *program,
                                      egl::BlobCache::Key *hashOut)
 {
-    // Compute the program hash. Start with the shader hashes and resource strings.
+    // Compute the program hash. Start with the shader hashes, which cover the resource strings.
     HashStream hashStream;
     for (ShaderType shaderType : AllShaderTypes())
     {
@@ -112,7 +158,8 @@ void MemoryProgramCache::ComputeHash(const Context *context,
 
     // Add some ANGLE metadata and Context properties, such as version and back-end.
     hashStream << ANGLE_COMMIT_HASH << context->getClientMajorVersion()
-               << context->getClientMinorVersion() << context->getString(GL_RENDERER);
+               << context->getClientMinorVersion()
+               << reinterpret_cast<const char *>(context->getString(GL_RENDERER));
 
     // Hash pre-link program properties.
     hashStream << program->getAttributeBindings() << program->getUniformLocationBindings()
@@ -122,10 +169,7 @@ void MemoryProgramCache::ComputeHash(const Context *context,
                << program->getState().getOutputLocations()
                << program->getState().getSecondaryOutputLocations();
 
-    // Call the secure SHA hashing function.
-    const std::string &programKey = hashStream.str();
-    angle::base::SHA1HashBytes(reinterpret_cast<const unsigned char *>(programKey.c_str()),
-                               programKey.length(), hashOut->data());
+    hashStream.getDigest(hashOut);
 }
 
 angle::Result MemoryProgramCache::getProgram(const Context *context,
@@ -142,6 +186,16 @@ angle::Result MemoryProgramCache::getProgram(const Context *context,
     egl::BlobCache::Value binaryProgram;
     if (get(context, *hashOut, &binaryProgram))
     {
+        // Binaries stored with compression disabled, or still queued for write-back, are not
+        // compressed.
+        angle::MemoryBuffer uncompressedProgram;
+        if (angle::DecompressBlob(binaryProgram.data(), binaryProgram.size(),
+                                  &uncompressedProgram))
+        {
+            binaryProgram =
+                egl::BlobCache::Value(uncompressedProgram.data(), uncompressedProgram.size());
+        }
+
         angle::Result result =
             program->loadBinary(context, GL_PROGRAM_BINARY_ANGLE, binaryProgram.data(),
                                 static_cast<int>(binaryProgram.size()));
@@ -172,18 +226,54 @@ bool MemoryProgramCache::get(const Context *context,
                              const egl::BlobCache::Key &programHash,
                              egl::BlobCache::Value *programOut)
 {
+    {
+        // A program that is still queued for write-back is not in the application's cache yet.
+        // Copy it out, since the write-back may free it as soon as the lock is released.
+        std::lock_guard<std::mutex> lock(mPendingMutex);
+        const angle::MemoryBuffer *pendingProgram = nullptr;
+        auto iter                                 = mPendingPrograms.find(programHash);
+        if (iter != mPendingPrograms.end())
+        {
+            pendingProgram = &iter->second;
+        }
+        else
+        {
+            iter = mWritingPrograms.find(programHash);
+            if (iter != mWritingPrograms.end())
+            {
+                pendingProgram = &iter->second;
+            }
+        }
+
+        if (pendingProgram)
+        {
+            angle::MemoryBuffer *scratchMemory;
+            if (!context->getScratchBuffer()->get(pendingProgram->size(), &scratchMemory))
+            {
+                return false;
+            }
+            memcpy(scratchMemory->data(), pendingProgram->data(), pendingProgram->size());
+            *programOut = egl::BlobCache::Value(scratchMemory->data(), pendingProgram->size());
+            return true;
+        }
+    }
+
     return mBlobCache.get(context->getScratchBuffer(), programHash, programOut);
 }
 
 bool MemoryProgramCache::getAt(size_t index,
-                               const egl::BlobCache::Key **hashOut,
-                               egl::BlobCache::Value *programOut)
+                               egl::BlobCache::Key *hashOut,
+                               angle::MemoryBuffer *programOut)
 {
     return mBlobCache.getAt(index, hashOut, programOut);
 }
 
 void MemoryProgramCache::remove(const egl::BlobCache::Key &programHash)
 {
+    {
+        std::lock_guard<std::mutex> lock(mPendingMutex);
+        mPendingPrograms.erase(programHash);
+    }
     mBlobCache.remove(programHash);
 }
 
@@ -197,19 +287,108 @@ void MemoryProgramCache::putProgram(const egl::BlobCache::Key &programHash,
         return;
     }
 
+    // Programs of one application tend to have similar binary sizes, so the last size is a good
+    // estimate to pre-size the serialization stream.
     angle::MemoryBuffer serializedProgram;
-    program->serialize(context, &serializedProgram);
+    program->serialize(context, &serializedProgram, mLastSerializedSize);
+    mLastSerializedSize = serializedProgram.size();
 
     ANGLE_HISTOGRAM_COUNTS("GPU.ANGLE.ProgramCache.ProgramBinarySizeBytes",
                            static_cast<int>(serializedProgram.size()));
 
+    // Storing in the application's blob cache may also mean writing to disk, so that is queued for
+    // the worker threads, which compress the binary as well.  Programs linked close together are
+    // written in one batch off the GL thread.
+    const bool writeBack = mBlobCache.areBlobCacheFuncsSet();
+    if (!writeBack && !compressProgram(&serializedProgram))
+    {
+        return;
+    }
+
     // TODO(syoussefi): to be removed.  Compatibility for Chrome until it supports
     // EGL_ANDROID_blob_cache. http://anglebug.com/2516
     auto *platform = ANGLEPlatformCurrent();
     platform->cacheProgram(platform, programHash, serializedProgram.size(),
                            serializedProgram.data());
 
-    mBlobCache.put(programHash, std::move(serializedProgram));
+    if (!writeBack)
+    {
+        mBlobCache.put(programHash, std::move(serializedProgram));
+        return;
+    }
+
+    bool postWriteBack = false;
+    {
+        std::lock_guard<std::mutex> lock(mPendingMutex);
+        mPendingPrograms[programHash] = std::move(serializedProgram);
+        postWriteBack                 = !mWriteBackScheduled;
+        mWriteBackScheduled           = true;
+    }
+
+    if (postWriteBack)
+    {
+        // Without parallel compile, the pool runs the task right away on this thread.
+        std::shared_ptr<angle::WaitableEvent> writeBackEvent =
+            angle::WorkerThreadPool::PostWorkerTask(context->getWorkerThreadPool(),
+                                                    std::make_shared<WriteBackTask>(this),
+                                                    angle::WorkerTaskPriority::Background);
+        if (!writeBackEvent)
+        {
+            writeBackPendingPrograms();
+            return;
+        }
+        mWriteBackEvent = writeBackEvent;
+    }
+}
+
+void MemoryProgramCache::writeBackPendingPrograms()
+{
+    std::lock_guard<std::mutex> writeBackLock(mWriteBackMutex);
+
+    {
+        std::lock_guard<std::mutex> lock(mPendingMutex);
+        ASSERT(mWritingPrograms.empty());
+        mWritingPrograms.swap(mPendingPrograms);
+        mWriteBackScheduled = false;
+    }
+
+    // The batch is only read from here on, so get() can keep looking it up meanwhile.
+    for (const auto &program : mWritingPrograms)
+    {
+        if (!mCompressionEnabled)
+        {
+            mBlobCache.putApplication(program.first, program.second);
+            continue;
+        }
+
+        angle::MemoryBuffer compressedProgram;
+        if (angle::CompressBlob(program.second.data(), program.second.size(),
+                                &compressedProgram))
+        {
+            mBlobCache.putApplication(program.first, compressedProgram);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mPendingMutex);
+    mWritingPrograms.clear();
+}
+
+bool MemoryProgramCache::compressProgram(angle::MemoryBuffer *program) const
+{
+    if (!mCompressionEnabled)
+    {
+        return true;
+    }
+
+    angle::MemoryBuffer compressedProgram;
+    if (!angle::CompressBlob(program->data(), program->size(), &compressedProgram))
+    {
+        ERR() << "Failed to allocate memory for compressing program binary";
+        return false;
+    }
+
+    *program = std::move(compressedProgram);
+    return true;
 }
 
 void MemoryProgramCache::updateProgram(const Context *context, const Program *program)
@@ -234,10 +413,24 @@ void MemoryProgramCache::putBinary(const egl::BlobCache::Key &programHash,
 
 void MemoryProgramCache::clear()
 {
+    {
+        std::lock_guard<std::mutex> lock(mPendingMutex);
+        mPendingPrograms.clear();
+    }
     mBlobCache.clear();
     mIssuedWarnings = 0;
 }
 
+void MemoryProgramCache::flush()
+{
+    if (mWriteBackEvent)
+    {
+        mWriteBackEvent->wait();
+        mWriteBackEvent.reset();
+    }
+    ASSERT(mPendingPrograms.empty() && mWritingPrograms.empty());
+}
+
 void MemoryProgramCache::resize(size_t maxCacheSizeBytes)
 {
     mBlobCache.resize(maxCacheSizeBytes);
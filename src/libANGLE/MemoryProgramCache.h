@@ -11,11 +11,19 @@
 #define LIBANGLE_MEMORY_PROGRAM_CACHE_H_
 
 #include <array>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "common/MemoryBuffer.h"
 #include "libANGLE/BlobCache.h"
 #include "libANGLE/Error.h"
 
+namespace angle
+{
+class WaitableEvent;
+}  // namespace angle
+
 namespace gl
 {
 class Context;
@@ -38,14 +46,13 @@ class MemoryProgramCache final : angle::NonCopyable
              egl::BlobCache::Value *programOut);
 
     // For querying the contents of the cache.
-    bool getAt(size_t index,
-               const egl::BlobCache::Key **hashOut,
-               egl::BlobCache::Value *programOut);
+    bool getAt(size_t index, egl::BlobCache::Key *hashOut, angle::MemoryBuffer *programOut);
 
     // Evict a program from the binary cache.
     void remove(const egl::BlobCache::Key &programHash);
 
-    // Helper method that serializes a program.
+    // Helper method that serializes a program.  If the application provides blob cache functions,
+    // the binary is handed to them later on a worker thread; see flush().
     void putProgram(const egl::BlobCache::Key &programHash,
                     const Context *context,
                     const Program *program);
@@ -57,8 +64,8 @@ class MemoryProgramCache final : angle::NonCopyable
     // EGL_ANDROID_blob_cache. http://anglebug.com/2516
     void putBinary(const egl::BlobCache::Key &programHash, const uint8_t *binary, size_t length);
 
-    // Check the cache, and deserialize and load the program if found. Evict existing hash if load
-    // fails.
+    // Check the cache, and deserialize and load the program if found. Compressed binaries are
+    // decompressed first. Evict existing hash if load fails.
     angle::Result getProgram(const Context *context,
                              Program *program,
                              egl::BlobCache::Key *hashOut);
@@ -66,6 +73,14 @@ class MemoryProgramCache final : angle::NonCopyable
     // Empty the cache.
     void clear();
 
+    // Whether programs are compressed before they are stored. Programs stored either way can be
+    // loaded.
+    void setCompressionEnabled(bool enabled) { mCompressionEnabled = enabled; }
+
+    // Waits until all the programs queued by putProgram are stored in the application's blob
+    // cache.  Must be called before the blob cache functions change.
+    void flush();
+
     // Resize the cache. Discards current contents.
     void resize(size_t maxCacheSizeBytes);
 
@@ -82,8 +97,35 @@ class MemoryProgramCache final : angle::NonCopyable
     size_t maxSize() const;
 
   private:
+    class WriteBackTask;
+
+    // Hands the queued programs to the application's blob cache in one batch.
+    void writeBackPendingPrograms();
+
+    // Compresses |program| in place if compression is enabled. Returns false on failure.
+    bool compressProgram(angle::MemoryBuffer *program) const;
+
     egl::BlobCache &mBlobCache;
     unsigned int mIssuedWarnings;
+
+    // Size of the last program put in the cache, used to pre-size the next serialization.
+    size_t mLastSerializedSize;
+
+    bool mCompressionEnabled;
+
+    // Programs waiting to be stored in the application's blob cache.  Storing the same program
+    // again before the write-back runs replaces the queued binary, so only the last one is written.
+    // |mWritingPrograms| is the batch being written, which is still visible to get() until done.
+    // Both are guarded by |mPendingMutex|.
+    using PendingProgramMap = std::unordered_map<egl::BlobCache::Key, angle::MemoryBuffer>;
+    std::mutex mPendingMutex;
+    PendingProgramMap mPendingPrograms;
+    PendingProgramMap mWritingPrograms;
+    bool mWriteBackScheduled;
+
+    // Serializes the write-back batches, so waiting on the last posted one waits on all of them.
+    std::mutex mWriteBackMutex;
+    std::shared_ptr<angle::WaitableEvent> mWriteBackEvent;
 };
 
 }  // namespace gl
@@ -763,6 +763,27 @@ size_t CountUniqueBlocks(const std::vector<InterfaceBlock> &blocks)
     }
     return count;
 }
+
+// Records the time spent in one phase of Program::link as a histogram sample in microseconds.
+class ScopedLinkPhaseTimer final : angle::NonCopyable
+{
+  public:
+    explicit ScopedLinkPhaseTimer(const char *histogramName)
+        : mHistogramName(histogramName),
+          mStartTime(ANGLEPlatformCurrent()->currentTime(ANGLEPlatformCurrent()))
+    {}
+
+    ~ScopedLinkPhaseTimer()
+    {
+        auto *platform = ANGLEPlatformCurrent();
+        double delta   = platform->currentTime(platform) - mStartTime;
+        ANGLE_HISTOGRAM_COUNTS(mHistogramName, static_cast<int>(delta * 1000000.0));
+    }
+
+  private:
+    const char *mHistogramName;
+    double mStartTime;
+};
 }  // anonymous namespace
 
 // Saves the linking context for later use in resolveLink().
@@ -1239,7 +1260,8 @@ Program::Program(rx::GLImplFactory *factory, ShaderProgramManager *manager, Shad
       mDeleteStatus(false),
       mRefCount(0),
       mResourceManager(manager),
-      mHandle(handle)
+      mHandle(handle),
+      mLastSerializedSize(0)
 {
     ASSERT(mProgram);
 
@@ -1253,6 +1275,11 @@ Program::~Program()
 
 void Program::onDestroy(const Context *context)
 {
+    // Nobody can observe the result of a link that is still pending, so don't start it.
+    if (mLinkingState)
+    {
+        mLinkingState->linkEvent->cancel();
+    }
     resolveLink(context);
     for (ShaderType shaderType : AllShaderTypes())
     {
@@ -1593,8 +1620,14 @@ angle::Result Program::link(const Context *context)
             return angle::Result::Continue;
         }
 
-        if (!resources->varyingPacking.collectAndPackUserVaryings(
-                mInfoLog, mergedVaryings, mState.getTransformFeedbackVaryingNames()))
+        bool packed = false;
+        {
+            ScopedLinkPhaseTimer timer("GPU.ANGLE.ProgramLink.VaryingPackingUS");
+            packed = resources->varyingPacking.collectAndPackUserVaryings(
+                mInfoLog, mergedVaryings, mState.getTransformFeedbackVaryingNames(),
+                mResourceManager->getVaryingPackingCache());
+        }
+        if (!packed)
         {
             return angle::Result::Continue;
         }
@@ -1860,6 +1893,8 @@ void Program::unlink()
     mState.mCachedBaseVertex                  = 0;
     mState.mCachedBaseInstance                = 0;
 
+    mUniformLocationLookup.reset();
+
     mValidated = false;
 
     mLinked = false;
@@ -2575,7 +2610,82 @@ const BufferVariable &Program::getBufferVariableByIndex(GLuint index) const
 GLint Program::getUniformLocation(const std::string &name) const
 {
     ASSERT(mLinkResolved);
-    return GetVariableLocation(mState.mUniforms, mState.mUniformLocations, name);
+
+    if (!mUniformLocationLookup)
+    {
+        buildUniformLocationLookup();
+    }
+
+    // Matches GetVariableLocation: the string is either the name of an active uniform, the base
+    // name of an active array, or the name of an active array element. If both of the first and
+    // last cases match, the lowest location wins.
+    GLint location = -1;
+    auto nameIter  = mUniformLocationLookup->byName.find(name);
+    if (nameIter != mUniformLocationLookup->byName.end())
+    {
+        location = nameIter->second;
+    }
+
+    size_t nameLengthWithoutArrayIndex;
+    unsigned int arrayIndex = ParseArrayIndex(name, &nameLengthWithoutArrayIndex);
+    if (arrayIndex != GL_INVALID_INDEX)
+    {
+        auto arrayIter = mUniformLocationLookup->arrayElements.find(
+            name.substr(0u, nameLengthWithoutArrayIndex));
+        if (arrayIter != mUniformLocationLookup->arrayElements.end() &&
+            arrayIndex < arrayIter->second.size() && arrayIter->second[arrayIndex] != -1)
+        {
+            GLint elementLocation = arrayIter->second[arrayIndex];
+            location = (location == -1 ? elementLocation : std::min(location, elementLocation));
+        }
+    }
+
+    return location;
+}
+
+void Program::buildUniformLocationLookup() const
+{
+    ASSERT(mLinkResolved);
+    mUniformLocationLookup.reset(new UniformLocationLookup());
+
+    for (size_t location = 0u; location < mState.mUniformLocations.size(); ++location)
+    {
+        const VariableLocation &variableLocation = mState.mUniformLocations[location];
+        if (!variableLocation.used())
+        {
+            continue;
+        }
+
+        const LinkedUniform &variable = mState.mUniforms[variableLocation.index];
+        const GLint glLocation        = static_cast<GLint>(location);
+
+        // Array names end with "[0]". Locations are visited in order so the first one is kept.
+        const bool isArray = variable.isArray() && variable.name.length() >= 3u;
+        const std::string baseName =
+            isArray ? variable.name.substr(0u, variable.name.length() - 3u) : std::string();
+
+        if (variableLocation.arrayIndex == 0)
+        {
+            mUniformLocationLookup->byName.emplace(variable.name, glLocation);
+            if (isArray)
+            {
+                mUniformLocationLookup->byName.emplace(baseName, glLocation);
+            }
+        }
+
+        if (isArray)
+        {
+            std::vector<GLint> &elements = mUniformLocationLookup->arrayElements[baseName];
+            if (elements.size() <= variableLocation.arrayIndex)
+            {
+                elements.resize(variableLocation.arrayIndex + 1, -1);
+            }
+            if (elements[variableLocation.arrayIndex] == -1)
+            {
+                elements[variableLocation.arrayIndex] = glLocation;
+            }
+        }
+    }
 }
 
 GLuint Program::getUniformIndex(const std::string &name) const
@@ -3122,6 +3232,8 @@ GLenum Program::getTransformFeedbackBufferMode() const
 
 bool Program::linkValidateShaders(InfoLog &infoLog)
 {
+    ScopedLinkPhaseTimer timer("GPU.ANGLE.ProgramLink.ValidateShadersUS");
+
     Shader *vertexShader   = mState.mAttachedShaders[ShaderType::Vertex];
     Shader *fragmentShader = mState.mAttachedShaders[ShaderType::Fragment];
     Shader *computeShader  = mState.mAttachedShaders[ShaderType::Compute];
@@ -3339,6 +3451,8 @@ void Program::setBaseInstanceUniform(GLuint baseInstance)
 
 bool Program::linkVaryings(InfoLog &infoLog) const
 {
+    ScopedLinkPhaseTimer timer("GPU.ANGLE.ProgramLink.VaryingsUS");
+
     Shader *previousShader = nullptr;
     for (ShaderType shaderType : kAllGraphicsShaderTypes)
     {
@@ -3486,6 +3600,8 @@ bool Program::linkUniforms(const Caps &caps,
                            GLuint *combinedImageUniformsCount,
                            std::vector<UnusedUniform> *unusedUniforms)
 {
+    ScopedLinkPhaseTimer timer("GPU.ANGLE.ProgramLink.UniformsUS");
+
     UniformLinker linker(mState);
     if (!linker.link(caps, infoLog, uniformLocationBindings))
     {
@@ -3777,6 +3893,8 @@ bool Program::linkInterfaceBlocks(const Caps &caps,
                                   InfoLog &infoLog,
                                   GLuint *combinedShaderStorageBlocksCount)
 {
+    ScopedLinkPhaseTimer timer("GPU.ANGLE.ProgramLink.InterfaceBlocksUS");
+
     ASSERT(combinedShaderStorageBlocksCount);
 
     GLuint combinedUniformBlocksCount                                         = 0u;
@@ -4680,7 +4798,8 @@ void Program::setUniformValuesFromBindingQualifiers()
         const auto &samplerUniform = mState.mUniforms[samplerIndex];
         if (samplerUniform.binding != -1)
         {
-            GLint location = getUniformLocation(samplerUniform.name);
+            GLint location =
+                GetVariableLocation(mState.mUniforms, mState.mUniformLocations, samplerUniform.name);
             ASSERT(location != -1);
             std::vector<GLint> boundTextureUnits;
             for (unsigned int elementIndex = 0;
@@ -4944,9 +5063,12 @@ angle::Result Program::syncState(const Context *context)
     return angle::Result::Continue;
 }
 
-void Program::serialize(const Context *context, angle::MemoryBuffer *binaryOut) const
+void Program::serialize(const Context *context,
+                        angle::MemoryBuffer *binaryOut,
+                        size_t sizeHint) const
 {
     BinaryOutputStream stream;
+    stream.reserve(std::max(sizeHint, mLastSerializedSize));
 
     stream.writeBytes(reinterpret_cast<const unsigned char *>(ANGLE_COMMIT_HASH),
                       ANGLE_COMMIT_HASH_SIZE);
@@ -5130,6 +5252,8 @@ void Program::serialize(const Context *context, angle::MemoryBuffer *binaryOut)
 
     mProgram->save(context, &stream);
 
+    mLastSerializedSize = stream.length();
+
     ASSERT(binaryOut);
     binaryOut->resize(stream.length());
     memcpy(binaryOut->data(), stream.data(), stream.length());
@@ -5387,15 +5511,20 @@ void Program::postResolveLink(const gl::Context *context)
     mState.updateActiveSamplers();
     mState.updateActiveImages();
 
+    // Look the builtins up directly so the query lookup table is only built if the application
+    // asks for uniform locations.
     if (context->getExtensions().multiDraw)
     {
-        mState.mDrawIDLocation = getUniformLocation("gl_DrawID");
+        mState.mDrawIDLocation =
+            GetVariableLocation(mState.mUniforms, mState.mUniformLocations, "gl_DrawID");
     }
 
     if (context->getExtensions().baseVertexBaseInstance)
     {
-        mState.mBaseVertexLocation   = getUniformLocation("gl_BaseVertex");
-        mState.mBaseInstanceLocation = getUniformLocation("gl_BaseInstance");
+        mState.mBaseVertexLocation =
+            GetVariableLocation(mState.mUniforms, mState.mUniformLocations, "gl_BaseVertex");
+        mState.mBaseInstanceLocation =
+            GetVariableLocation(mState.mUniforms, mState.mUniformLocations, "gl_BaseInstance");
     }
 }
 
@@ -18,6 +18,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "common/Optional.h"
@@ -967,7 +968,11 @@ class Program final : angle::NonCopyable, public LabeledObject
     ANGLE_INLINE bool hasAnyDirtyBit() const { return mDirtyBits.any(); }
 
     // Writes a program's binary to the output memory buffer.
-    void serialize(const Context *context, angle::MemoryBuffer *binaryOut) const;
+    // |sizeHint| is the expected binary size, e.g. from another program, used to pre-size the
+    // output stream.
+    void serialize(const Context *context,
+                   angle::MemoryBuffer *binaryOut,
+                   size_t sizeHint = 0) const;
 
   private:
     struct LinkingState;
@@ -1108,6 +1113,22 @@ class Program final : angle::NonCopyable, public LabeledObject
     // Cache for sampler validation
     Optional<bool> mCachedValidateSamplersResult;
 
+    // Name lookup for glGetUniformLocation. Only state needed for drawing is built at link time;
+    // this table is built on the first query and dropped when the program is relinked.
+    struct UniformLocationLookup
+    {
+        // Uniform names, and the base names of arrays, to their first location.
+        std::unordered_map<std::string, GLint> byName;
+        // Array base names to the location of each array element, or -1 if inactive.
+        std::unordered_map<std::string, std::vector<GLint>> arrayElements;
+    };
+    void buildUniformLocationLookup() const;
+    mutable std::unique_ptr<UniformLocationLookup> mUniformLocationLookup;
+
+    // Size of the last serialized binary. glGetProgramBinary serializes twice, once to get the
+    // length and once to write the binary.
+    mutable size_t mLastSerializedSize;
+
     DirtyBits mDirtyBits;
 };
 }  // namespace gl
@@ -168,6 +168,7 @@ void ShaderProgramManager::reset(const Context *context)
         deleteShader(context, {mShaders.begin()->first});
     }
     mShaders.clear();
+    mVaryingPackingCache.clear();
 }
 
 ShaderProgramID ShaderProgramManager::createShader(rx::GLImplFactory *factory,
@@ -16,6 +16,7 @@
 #include "libANGLE/HandleAllocator.h"
 #include "libANGLE/HandleRangeAllocator.h"
 #include "libANGLE/ResourceMap.h"
+#include "libANGLE/VaryingPacking.h"
 
 namespace rx
 {
@@ -155,6 +156,9 @@ class ShaderProgramManager : public ResourceManagerBase<HandleAllocator>
         return mPrograms.query(handle);
     }
 
+    // Varying packing results shared by all programs linked in this share group.
+    VaryingPackingCache *getVaryingPackingCache() { return &mVaryingPackingCache; }
+
   protected:
     ~ShaderProgramManager() override;
 
@@ -168,6 +172,7 @@ class ShaderProgramManager : public ResourceManagerBase<HandleAllocator>
 
     ResourceMap<Shader, ShaderProgramID> mShaders;
     ResourceMap<Program, ShaderProgramID> mPrograms;
+    VaryingPackingCache mVaryingPackingCache;
 };
 
 class TextureManager
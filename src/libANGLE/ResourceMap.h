@@ -4,8 +4,8 @@
 // found in the LICENSE file.
 //
 // ResourceMap:
-//   An optimized resource map which packs the first set of allocated objects into a
-//   flat array, and then falls back to an unordered map for the higher handle values.
+//   An optimized resource map which packs allocated objects into a flat, paged array, and then
+//   falls back to an unordered map for very high (sparse) handle values.
 //
 
 #ifndef LIBANGLE_RESOURCE_MAP_H_
@@ -28,7 +28,12 @@ class ResourceMap final : angle::NonCopyable
         GLuint handle = GetIDValue(id);
         if (handle < mFlatResourcesSize)
         {
-            ResourceType *value = mFlatResources[handle];
+            ResourceType **page = mFlatPages[handle >> kPageShift];
+            if (page == nullptr)
+            {
+                return nullptr;
+            }
+            ResourceType *value = page[handle & kPageMask];
             return (value == InvalidPointer() ? nullptr : value);
         }
         auto it = mHashedResources.find(handle);
@@ -83,40 +88,47 @@ class ResourceMap final : angle::NonCopyable
     friend class Iterator;
 
     GLuint nextNonNullResource(size_t flatIndex) const;
+    ResourceType *getFlatResource(size_t flatIndex) const;
+    ResourceType **ensureFlatPage(GLuint handle);
 
     // constexpr methods cannot contain reinterpret_cast, so we need a static method.
     static ResourceType *InvalidPointer();
     static constexpr intptr_t kInvalidPointer = static_cast<intptr_t>(-1);
 
-    // Start with 32 maximum elements in the map, which can grow.
-    static constexpr size_t kInitialFlatResourcesSize = 0x20;
+    // The flat table is split into fixed-size pages so that growing it never moves existing
+    // elements. Pages are allocated lazily, which keeps sparse handle ranges cheap. A page holds
+    // 512 elements, i.e. 4kB with 64-bit pointers.
+    static constexpr GLuint kPageShift = 9;
+    static constexpr GLuint kPageSize  = 1u << kPageShift;
+    static constexpr GLuint kPageMask  = kPageSize - 1;
 
-    // Experimental testing suggests that 16k is a reasonable upper limit.
-    static constexpr size_t kFlatResourcesLimit = 0x4000;
+    // Handle values above this limit are usually user-chosen names that are far apart, so they go
+    // into the hash map. Handles generated by the HandleAllocator are dense and stay well below.
+    static constexpr size_t kFlatResourcesLimit = 0x1000000;
 
     // Size of one map element.
     static constexpr size_t kElementSize = sizeof(ResourceType *);
 
+    // Number of handles covered by mFlatPages, always a multiple of kPageSize.
     size_t mFlatResourcesSize;
-    ResourceType **mFlatResources;
+    std::vector<ResourceType **> mFlatPages;
 
     // A map of GL objects indexed by object ID.
     HashMap mHashedResources;
 };
 
 template <typename ResourceType, typename IDType>
-ResourceMap<ResourceType, IDType>::ResourceMap()
-    : mFlatResourcesSize(kInitialFlatResourcesSize),
-      mFlatResources(new ResourceType *[kInitialFlatResourcesSize])
-{
-    memset(mFlatResources, kInvalidPointer, mFlatResourcesSize * kElementSize);
-}
+ResourceMap<ResourceType, IDType>::ResourceMap() : mFlatResourcesSize(0)
+{}
 
 template <typename ResourceType, typename IDType>
 ResourceMap<ResourceType, IDType>::~ResourceMap()
 {
     ASSERT(empty());
-    delete[] mFlatResources;
+    for (ResourceType **page : mFlatPages)
+    {
+        delete[] page;
+    }
 }
 
 template <typename ResourceType, typename IDType>
@@ -125,7 +137,7 @@ ANGLE_INLINE bool ResourceMap<ResourceType, IDType>::contains(IDType id) const
     GLuint handle = GetIDValue(id);
     if (handle < mFlatResourcesSize)
     {
-        return (mFlatResources[handle] != InvalidPointer());
+        return (getFlatResource(handle) != InvalidPointer());
     }
     return (mHashedResources.find(handle) != mHashedResources.end());
 }
@@ -136,11 +148,12 @@ bool ResourceMap<ResourceType, IDType>::erase(IDType id, ResourceType **resource
     GLuint handle = GetIDValue(id);
     if (handle < mFlatResourcesSize)
     {
-        auto &value = mFlatResources[handle];
-        if (value == InvalidPointer())
+        ResourceType **page = mFlatPages[handle >> kPageShift];
+        if (page == nullptr || page[handle & kPageMask] == InvalidPointer())
         {
             return false;
         }
+        auto &value  = page[handle & kPageMask];
         *resourceOut = value;
         value        = InvalidPointer();
     }
@@ -163,26 +176,8 @@ void ResourceMap<ResourceType, IDType>::assign(IDType id, ResourceType *resource
     GLuint handle = GetIDValue(id);
     if (handle < kFlatResourcesLimit)
     {
-        if (handle >= mFlatResourcesSize)
-        {
-            // Use power-of-two.
-            size_t newSize = mFlatResourcesSize;
-            while (newSize <= handle)
-            {
-                newSize *= 2;
-            }
-
-            ResourceType **oldResources = mFlatResources;
-
-            mFlatResources = new ResourceType *[newSize];
-            memset(&mFlatResources[mFlatResourcesSize], kInvalidPointer,
-                   (newSize - mFlatResourcesSize) * kElementSize);
-            memcpy(mFlatResources, oldResources, mFlatResourcesSize * kElementSize);
-            mFlatResourcesSize = newSize;
-            delete[] oldResources;
-        }
-        ASSERT(mFlatResourcesSize > handle);
-        mFlatResources[handle] = resource;
+        ResourceType **page      = ensureFlatPage(handle);
+        page[handle & kPageMask] = resource;
     }
     else
     {
@@ -205,17 +200,21 @@ typename ResourceMap<ResourceType, IDType>::Iterator ResourceMap<ResourceType, I
 
 template <typename ResourceType, typename IDType>
 typename ResourceMap<ResourceType, IDType>::Iterator ResourceMap<ResourceType, IDType>::find(
-    IDType handle) const
+    IDType id) const
 {
+    GLuint handle = GetIDValue(id);
     if (handle < mFlatResourcesSize)
     {
-        return (mFlatResources[handle] != InvalidPointer()
-                    ? Iterator(handle, mHashedResources.begin())
+        return (getFlatResource(handle) != InvalidPointer()
+                    ? Iterator(*this, handle, mHashedResources.begin())
                     : end());
     }
     else
     {
-        return mHashedResources.find(handle);
+        auto it = mHashedResources.find(handle);
+        return (it != mHashedResources.end()
+                    ? Iterator(*this, static_cast<GLuint>(mFlatResourcesSize), it)
+                    : end());
     }
 }
 
@@ -228,24 +227,69 @@ bool ResourceMap<ResourceType, IDType>::empty() const
 template <typename ResourceType, typename IDType>
 void ResourceMap<ResourceType, IDType>::clear()
 {
-    memset(mFlatResources, kInvalidPointer, kInitialFlatResourcesSize * kElementSize);
-    mFlatResourcesSize = kInitialFlatResourcesSize;
+    for (ResourceType **page : mFlatPages)
+    {
+        delete[] page;
+    }
+    mFlatPages.clear();
+    mFlatResourcesSize = 0;
     mHashedResources.clear();
 }
 
 template <typename ResourceType, typename IDType>
 GLuint ResourceMap<ResourceType, IDType>::nextNonNullResource(size_t flatIndex) const
 {
-    for (size_t index = flatIndex; index < mFlatResourcesSize; index++)
+    size_t index = flatIndex;
+    while (index < mFlatResourcesSize)
     {
-        if (mFlatResources[index] != nullptr && mFlatResources[index] != InvalidPointer())
+        ResourceType **page = mFlatPages[index >> kPageShift];
+        if (page == nullptr)
+        {
+            // Skip over the whole unallocated page.
+            index = (index | kPageMask) + 1;
+            continue;
+        }
+
+        ResourceType *value = page[index & kPageMask];
+        if (value != nullptr && value != InvalidPointer())
         {
             return static_cast<GLuint>(index);
         }
+        index++;
     }
     return static_cast<GLuint>(mFlatResourcesSize);
 }
 
+template <typename ResourceType, typename IDType>
+ANGLE_INLINE ResourceType *ResourceMap<ResourceType, IDType>::getFlatResource(
+    size_t flatIndex) const
+{
+    ASSERT(flatIndex < mFlatResourcesSize);
+    ResourceType **page = mFlatPages[flatIndex >> kPageShift];
+    return (page == nullptr ? InvalidPointer() : page[flatIndex & kPageMask]);
+}
+
+template <typename ResourceType, typename IDType>
+ResourceType **ResourceMap<ResourceType, IDType>::ensureFlatPage(GLuint handle)
+{
+    ASSERT(handle < kFlatResourcesLimit);
+    size_t pageIndex = handle >> kPageShift;
+    if (pageIndex >= mFlatPages.size())
+    {
+        // Growing only appends page pointers, existing pages are never copied.
+        mFlatPages.resize(pageIndex + 1, nullptr);
+        mFlatResourcesSize = mFlatPages.size() << kPageShift;
+    }
+
+    ResourceType **&page = mFlatPages[pageIndex];
+    if (page == nullptr)
+    {
+        page = new ResourceType *[kPageSize];
+        memset(page, kInvalidPointer, kPageSize * kElementSize);
+    }
+    return page;
+}
+
 template <typename ResourceType, typename IDType>
 // static
 ResourceType *ResourceMap<ResourceType, IDType>::InvalidPointer()
@@ -311,7 +355,7 @@ void ResourceMap<ResourceType, IDType>::Iterator::updateValue()
     if (mFlatIndex < static_cast<GLuint>(mOrigin.mFlatResourcesSize))
     {
         mValue.first  = mFlatIndex;
-        mValue.second = mOrigin.mFlatResources[mFlatIndex];
+        mValue.second = mOrigin.getFlatResource(mFlatIndex);
     }
     else if (mHashIndex != mOrigin.mHashedResources.end())
     {
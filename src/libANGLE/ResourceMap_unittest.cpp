@@ -133,4 +133,46 @@ TEST(ResourceMapTest, QueryUnassigned)
     ASSERT_FALSE(resourceMap.contains(100));
     ASSERT_EQ(nullptr, resourceMap.query(100));
 }
+// Tests assigning handles far apart, which spans several pages and the hashed fallback.
+TEST(ResourceMapTest, SparseHandles)
+{
+    ResourceMap<size_t, GLuint> resourceMap;
+    std::vector<size_t> objects = {1, 0x3000, 0x4001, 0x100000, 0xFFFFFF, 0x1000000, 0xFFFFFFF0};
+
+    for (size_t &object : objects)
+    {
+        resourceMap.assign(static_cast<GLuint>(object), &object);
+    }
+
+    // Handles that were never assigned, including ones in pages that are allocated.
+    ASSERT_FALSE(resourceMap.contains(2));
+    ASSERT_EQ(nullptr, resourceMap.query(0x2000));
+    ASSERT_EQ(nullptr, resourceMap.query(0x4002));
+    ASSERT_EQ(nullptr, resourceMap.query(0x1000001));
+
+    size_t iterated = 0;
+    for (const auto &indexAndResource : resourceMap)
+    {
+        ASSERT_EQ(indexAndResource.first, *indexAndResource.second);
+        iterated++;
+    }
+    ASSERT_EQ(objects.size(), iterated);
+
+    for (size_t &object : objects)
+    {
+        GLuint handle = static_cast<GLuint>(object);
+        ASSERT_TRUE(resourceMap.contains(handle));
+        ASSERT_EQ(&object, resourceMap.query(handle));
+        ASSERT_NE(resourceMap.end(), resourceMap.find(handle));
+    }
+
+    for (size_t object : objects)
+    {
+        size_t *found = nullptr;
+        ASSERT_TRUE(resourceMap.erase(static_cast<GLuint>(object), &found));
+        ASSERT_EQ(object, *found);
+    }
+
+    ASSERT_TRUE(resourceMap.empty());
+}
 }  // anonymous namespace
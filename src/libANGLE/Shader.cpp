@@ -20,6 +20,7 @@
 #include "libANGLE/Constants.h"
 #include "libANGLE/Context.h"
 #include "libANGLE/ResourceManager.h"
+#include "libANGLE/histogram_macros.h"
 #include "libANGLE/renderer/GLImplFactory.h"
 #include "libANGLE/renderer/ShaderImpl.h"
 #include "platform/FrontendFeatures.h"
@@ -143,6 +144,7 @@ Shader::Shader(ShaderProgramManager *manager,
       mCurrentMaxComputeWorkGroupInvocations(0u)
 {
     ASSERT(mImplementation);
+    mShaderHash.fill(0);
 }
 
 void Shader::onDestroy(const gl::Context *context)
@@ -357,6 +359,15 @@ void Shader::compile(const Context *context)
     ASSERT(compilerHandle);
     mCompilerResourcesString = compilerInstance.getBuiltinResourcesString();
 
+    // Hash the source once here rather than on every link that looks up the program cache.
+    size_t sourceLength = mState.mSource.length();
+    angle::base::SecureHashAlgorithm sha1;
+    sha1.Update(&sourceLength, sizeof(sourceLength));
+    sha1.Update(mState.mSource.data(), sourceLength);
+    sha1.Update(mCompilerResourcesString.data(), mCompilerResourcesString.length());
+    sha1.Final();
+    memcpy(mShaderHash.data(), sha1.Digest(), mShaderHash.size());
+
     mCompilingState.reset(new CompilingState());
     mCompilingState->shCompilerInstance = std::move(compilerInstance);
     mCompilingState->compileEvent =
@@ -393,6 +404,14 @@ void Shader::resolveCompile()
 
     mState.mTranslatedSource = sh::GetObjectCode(compilerHandle);
 
+    size_t sizeReduction = sh::GetObjectCodeSizeReduction(compilerHandle);
+    if (sizeReduction > 0)
+    {
+        size_t unminifiedSize = mState.mTranslatedSource.size() + sizeReduction;
+        ANGLE_HISTOGRAM_PERCENTAGE("GPU.ANGLE.TranslatedShaderMinifiedPercent",
+                                   static_cast<int>(sizeReduction * 100 / unminifiedSize));
+    }
+
 #if !defined(NDEBUG)
     // Prefix translated shader with commented out un-translated shader.
     // Useful in diagnostics tools which capture the shader source.
@@ -12,12 +12,14 @@
 #ifndef LIBANGLE_SHADER_H_
 #define LIBANGLE_SHADER_H_
 
+#include <array>
 #include <list>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include <GLSLANG/ShaderLang.h>
+#include <anglebase/sha1.h>
 #include "angle_gl.h"
 
 #include "common/Optional.h"
@@ -189,6 +191,11 @@ class Shader final : angle::NonCopyable, public LabeledObject
 
     const std::string &getCompilerResourcesString() const;
 
+    // Hash of the source and compiler resources of the last compile, which identifies the
+    // compiled shader in the program cache key.
+    using Hash = std::array<uint8_t, angle::base::kSHA1Length>;
+    const Hash &getShaderHash() const { return mShaderHash; }
+
   private:
     struct CompilingState;
 
@@ -213,6 +220,7 @@ class Shader final : angle::NonCopyable, public LabeledObject
     BindingPointer<Compiler> mBoundCompiler;
     std::unique_ptr<CompilingState> mCompilingState;
     std::string mCompilerResourcesString;
+    Hash mShaderHash;
 
     ShaderProgramManager *mResourceManager;
 
@@ -107,15 +107,34 @@ class SizedMRUCache final : angle::NonCopyable
 
         while (mCurrentSize > limit)
         {
-            ASSERT(!mStore.empty());
-            auto iter = mStore.rbegin();
-            mCurrentSize -= iter->second.size;
-            mStore.Erase(iter);
+            evictLeastRecentlyUsed();
         }
 
         return (initialSize - mCurrentSize);
     }
 
+    // Returns the value that would be evicted next, without marking it as used.
+    bool peekLeastRecentlyUsed(const Value **valueOut) const
+    {
+        if (mStore.empty())
+        {
+            return false;
+        }
+        *valueOut = &mStore.rbegin()->second.value;
+        return true;
+    }
+
+    // Evicts the least recently used value and returns its size.
+    size_t evictLeastRecentlyUsed()
+    {
+        ASSERT(!mStore.empty());
+        auto iter   = mStore.rbegin();
+        size_t size = iter->second.size;
+        mCurrentSize -= size;
+        mStore.Erase(iter);
+        return size;
+    }
+
     size_t maxSize() const { return mMaximumTotalSize; }
 
   private:
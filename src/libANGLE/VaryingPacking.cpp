@@ -53,6 +53,14 @@ bool ComparePackedVarying(const PackedVarying &x, const PackedVarying &y)
     return gl::CompareShaderVar(*px, *py);
 }
 
+// Upper bound on the number of distinct interfaces remembered by VaryingPackingCache.
+constexpr size_t kMaxVaryingPackingCacheEntries = 256;
+
+void AppendKeyValue(std::string *key, uint32_t value)
+{
+    key->append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
 }  // anonymous namespace
 
 // Implementation of VaryingPacking
@@ -280,7 +288,8 @@ void VaryingPacking::insert(unsigned int registerRow,
 
 bool VaryingPacking::collectAndPackUserVaryings(gl::InfoLog &infoLog,
                                                 const ProgramMergedVaryings &mergedVaryings,
-                                                const std::vector<std::string> &tfVaryings)
+                                                const std::vector<std::string> &tfVaryings,
+                                                VaryingPackingCache *cache)
 {
     std::set<std::string> uniqueFullNames;
     mPackedVaryings.clear();
@@ -399,7 +408,22 @@ bool VaryingPacking::collectAndPackUserVaryings(gl::InfoLog &infoLog,
 
     std::sort(mPackedVaryings.begin(), mPackedVaryings.end(), ComparePackedVarying);
 
-    return packUserVaryings(infoLog, mPackedVaryings);
+    if (cache && cache->restore(this))
+    {
+        return true;
+    }
+
+    if (!packUserVaryings(infoLog, mPackedVaryings))
+    {
+        return false;
+    }
+
+    if (cache)
+    {
+        cache->store(*this);
+    }
+
+    return true;
 }
 
 // See comment on packVarying.
@@ -430,4 +454,100 @@ bool VaryingPacking::packUserVaryings(gl::InfoLog &infoLog,
 
     return true;
 }
+
+// Implementation of VaryingPackingCache
+VaryingPackingCache::Entry::Entry() = default;
+
+VaryingPackingCache::Entry::Entry(Entry &&other) = default;
+
+VaryingPackingCache::Entry::~Entry() = default;
+
+VaryingPackingCache::VaryingPackingCache() = default;
+
+VaryingPackingCache::~VaryingPackingCache() = default;
+
+// static
+std::string VaryingPackingCache::MakeKey(const VaryingPacking &varyingPacking)
+{
+    // Only the properties read by packVarying and insert are part of the key. Names do not affect
+    // the register assignment once the varyings are sorted.
+    std::string key;
+    key.reserve((2 + varyingPacking.mPackedVaryings.size() * 4) * sizeof(uint32_t));
+
+    AppendKeyValue(&key, static_cast<uint32_t>(varyingPacking.mRegisterMap.size()));
+    AppendKeyValue(&key, static_cast<uint32_t>(varyingPacking.mPackMode));
+
+    for (const PackedVarying &packedVarying : varyingPacking.mPackedVaryings)
+    {
+        const sh::ShaderVariable &varying = *packedVarying.varying;
+        AppendKeyValue(&key, varying.type);
+        AppendKeyValue(&key, varying.getBasicTypeElementCount());
+        AppendKeyValue(&key, packedVarying.arrayIndex);
+        AppendKeyValue(&key, varying.isBuiltIn() ? 1u : 0u);
+    }
+
+    return key;
+}
+
+bool VaryingPackingCache::restore(VaryingPacking *varyingPacking) const
+{
+    ASSERT(varyingPacking->mRegisterList.empty());
+
+    auto iter = mEntries.find(MakeKey(*varyingPacking));
+    if (iter == mEntries.end())
+    {
+        return false;
+    }
+
+    const Entry &entry = iter->second;
+    ASSERT(entry.registerMap.size() == varyingPacking->mRegisterMap.size());
+    varyingPacking->mRegisterMap = entry.registerMap;
+
+    const std::vector<PackedVarying> &packedVaryings = varyingPacking->mPackedVaryings;
+    varyingPacking->mRegisterList.resize(entry.registerList.size());
+    for (size_t index = 0; index < entry.registerList.size(); ++index)
+    {
+        const CachedRegister &cached        = entry.registerList[index];
+        PackedVaryingRegister &registerInfo = varyingPacking->mRegisterList[index];
+        registerInfo.packedVarying          = &packedVaryings[cached.packedVaryingIndex];
+        registerInfo.varyingArrayIndex      = cached.varyingArrayIndex;
+        registerInfo.varyingRowIndex        = cached.varyingRowIndex;
+        registerInfo.registerRow            = cached.registerRow;
+        registerInfo.registerColumn         = cached.registerColumn;
+    }
+
+    return true;
+}
+
+void VaryingPackingCache::store(const VaryingPacking &varyingPacking)
+{
+    if (mEntries.size() >= kMaxVaryingPackingCacheEntries)
+    {
+        mEntries.clear();
+    }
+
+    Entry entry;
+    entry.registerMap = varyingPacking.mRegisterMap;
+    entry.registerList.reserve(varyingPacking.mRegisterList.size());
+
+    const PackedVarying *firstPackedVarying = varyingPacking.mPackedVaryings.data();
+    for (const PackedVaryingRegister &registerInfo : varyingPacking.mRegisterList)
+    {
+        CachedRegister cached;
+        cached.packedVaryingIndex =
+            static_cast<size_t>(registerInfo.packedVarying - firstPackedVarying);
+        cached.varyingArrayIndex  = registerInfo.varyingArrayIndex;
+        cached.varyingRowIndex    = registerInfo.varyingRowIndex;
+        cached.registerRow        = registerInfo.registerRow;
+        cached.registerColumn     = registerInfo.registerColumn;
+        entry.registerList.push_back(cached);
+    }
+
+    mEntries.emplace(MakeKey(varyingPacking), std::move(entry));
+}
+
+void VaryingPackingCache::clear()
+{
+    mEntries.clear();
+}
 }  // namespace gl
@@ -18,11 +18,13 @@
 #include "common/angleutils.h"
 
 #include <map>
+#include <unordered_map>
 
 namespace gl
 {
 class InfoLog;
 struct ProgramVaryingRef;
+class VaryingPackingCache;
 
 using ProgramMergedVaryings = std::map<std::string, ProgramVaryingRef>;
 
@@ -154,9 +156,11 @@ class VaryingPacking final : angle::NonCopyable
 
     bool packUserVaryings(gl::InfoLog &infoLog, const std::vector<PackedVarying> &packedVaryings);
 
+    // If |cache| is non-null, the register assignment is looked up in and recorded to it.
     bool collectAndPackUserVaryings(gl::InfoLog &infoLog,
                                     const ProgramMergedVaryings &mergedVaryings,
-                                    const std::vector<std::string> &tfVaryings);
+                                    const std::vector<std::string> &tfVaryings,
+                                    VaryingPackingCache *cache);
 
     struct Register
     {
@@ -183,6 +187,8 @@ class VaryingPacking final : angle::NonCopyable
     }
 
   private:
+    friend class VaryingPackingCache;
+
     bool packVarying(const PackedVarying &packedVarying);
     bool isFree(unsigned int registerRow,
                 unsigned int registerColumn,
@@ -200,6 +206,48 @@ class VaryingPacking final : angle::NonCopyable
     PackMode mPackMode;
 };
 
+// Remembers the register assignment of previously packed varyings. The packing algorithm only
+// depends on the shape of each packed varying and the order they are packed in, so programs that
+// link the same shader interface can reuse the result instead of running the algorithm again.
+class VaryingPackingCache final : angle::NonCopyable
+{
+  public:
+    VaryingPackingCache();
+    ~VaryingPackingCache();
+
+    // Restores the packing of |varyingPacking| from the cache. Returns false on a cache miss.
+    bool restore(VaryingPacking *varyingPacking) const;
+    // Records the successful packing of |varyingPacking|.
+    void store(const VaryingPacking &varyingPacking);
+
+    void clear();
+    size_t size() const { return mEntries.size(); }
+
+  private:
+    struct CachedRegister
+    {
+        size_t packedVaryingIndex;
+        unsigned int varyingArrayIndex;
+        unsigned int varyingRowIndex;
+        unsigned int registerRow;
+        unsigned int registerColumn;
+    };
+
+    struct Entry
+    {
+        Entry();
+        Entry(Entry &&other);
+        ~Entry();
+
+        std::vector<VaryingPacking::Register> registerMap;
+        std::vector<CachedRegister> registerList;
+    };
+
+    static std::string MakeKey(const VaryingPacking &varyingPacking);
+
+    std::unordered_map<std::string, Entry> mEntries;
+};
+
 }  // namespace gl
 
 #endif  // LIBANGLE_VARYINGPACKING_H_
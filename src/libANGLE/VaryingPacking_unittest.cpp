@@ -163,6 +163,69 @@ TEST_P(VaryingPackingTest, MaxPlusOneMat2VaryingsFailsWebGL)
     ASSERT_FALSE(packVaryingsStrict(kMaxVaryings, varyings));
 }
 
+// Tests that programs with the same interface shape reuse the cached packing, and that the
+// restored register list refers to the varyings of the program being linked.
+TEST_P(VaryingPackingTest, CachedPackingMatchesFullPacking)
+{
+    std::vector<sh::ShaderVariable> firstVaryings = MakeVaryings(GL_FLOAT_VEC2, kMaxVaryings, 0);
+    AddVaryings(&firstVaryings, GL_FLOAT, kMaxVaryings, 0);
+
+    // Same types with different names.
+    std::vector<sh::ShaderVariable> secondVaryings = firstVaryings;
+    for (sh::ShaderVariable &varying : secondVaryings)
+    {
+        varying.name       = "renamed_" + varying.name;
+        varying.mappedName = varying.name;
+    }
+
+    auto makeMergedVaryings = [](const std::vector<sh::ShaderVariable> &varyings) {
+        ProgramMergedVaryings mergedVaryings;
+        for (const sh::ShaderVariable &varying : varyings)
+        {
+            mergedVaryings[varying.name].frontShader = &varying;
+            mergedVaryings[varying.name].backShader  = &varying;
+        }
+        return mergedVaryings;
+    };
+
+    VaryingPackingCache cache;
+    InfoLog infoLog;
+    std::vector<std::string> transformFeedbackVaryings;
+
+    VaryingPacking uncachedPacking(kMaxVaryings, PackMode::ANGLE_RELAXED);
+    ASSERT_TRUE(uncachedPacking.collectAndPackUserVaryings(
+        infoLog, makeMergedVaryings(secondVaryings), transformFeedbackVaryings, nullptr));
+
+    VaryingPacking firstPacking(kMaxVaryings, PackMode::ANGLE_RELAXED);
+    ASSERT_TRUE(firstPacking.collectAndPackUserVaryings(
+        infoLog, makeMergedVaryings(firstVaryings), transformFeedbackVaryings, &cache));
+    EXPECT_EQ(1u, cache.size());
+
+    VaryingPacking secondPacking(kMaxVaryings, PackMode::ANGLE_RELAXED);
+    ASSERT_TRUE(secondPacking.collectAndPackUserVaryings(
+        infoLog, makeMergedVaryings(secondVaryings), transformFeedbackVaryings, &cache));
+    EXPECT_EQ(1u, cache.size());
+
+    const auto &expected = uncachedPacking.getRegisterList();
+    const auto &actual   = secondPacking.getRegisterList();
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t index = 0; index < expected.size(); ++index)
+    {
+        EXPECT_EQ(expected[index].registerRow, actual[index].registerRow);
+        EXPECT_EQ(expected[index].registerColumn, actual[index].registerColumn);
+        EXPECT_EQ(expected[index].varyingArrayIndex, actual[index].varyingArrayIndex);
+        EXPECT_EQ(expected[index].varyingRowIndex, actual[index].varyingRowIndex);
+        EXPECT_EQ(expected[index].packedVarying->fullName(),
+                  actual[index].packedVarying->fullName());
+    }
+
+    // A different pack mode must not hit the cached entry.
+    VaryingPacking strictPacking(kMaxVaryings, PackMode::WEBGL_STRICT);
+    ASSERT_TRUE(strictPacking.collectAndPackUserVaryings(
+        infoLog, makeMergedVaryings(firstVaryings), transformFeedbackVaryings, &cache));
+    EXPECT_EQ(2u, cache.size());
+}
+
 // Makes separate tests for different values of kMaxVaryings.
 INSTANTIATE_TEST_SUITE_P(, VaryingPackingTest, ::testing::Values(1, 4, 8));
 
@@ -629,6 +629,16 @@ void VertexArray::setDependentDirtyBit(bool contentsChanged, angle::SubjectIndex
 {
     DirtyBitType dirtyBit = getDirtyBitFromIndex(contentsChanged, index);
     ASSERT(!mDirtyBitsGuard.valid() || mDirtyBitsGuard.value().test(dirtyBit));
+
+    // Coalesce repeated contents updates. A buffer shared by many vertex arrays can be updated
+    // many times between two draws. If the data dirty bit is still pending the Context has already
+    // been notified since the last sync and a pure contents change cannot affect the cached vertex
+    // element limits.
+    if (contentsChanged && mDirtyBits.test(dirtyBit))
+    {
+        return;
+    }
+
     mDirtyBits.set(dirtyBit);
     onStateChange(angle::SubjectMessage::ContentsChanged);
 }
@@ -11,10 +11,10 @@
 #include "libANGLE/WorkerThread.h"
 
 #if (ANGLE_STD_ASYNC_WORKERS == ANGLE_ENABLED)
+#    include <algorithm>
 #    include <condition_variable>
-#    include <future>
+#    include <deque>
 #    include <mutex>
-#    include <queue>
 #    include <thread>
 #endif  // (ANGLE_STD_ASYNC_WORKERS == ANGLE_ENABLED)
 
@@ -24,6 +24,11 @@ namespace angle
 WaitableEvent::WaitableEvent()  = default;
 WaitableEvent::~WaitableEvent() = default;
 
+bool WaitableEvent::cancel()
+{
+    return false;
+}
+
 void WaitableEventDone::wait() {}
 
 bool WaitableEventDone::isReady()
@@ -54,14 +59,16 @@ bool SingleThreadedWaitableEvent::isReady()
 class SingleThreadedWorkerPool final : public WorkerThreadPool
 {
   public:
-    std::shared_ptr<WaitableEvent> postWorkerTask(std::shared_ptr<Closure> task) override;
+    std::shared_ptr<WaitableEvent> postWorkerTask(std::shared_ptr<Closure> task,
+                                                  WorkerTaskPriority priority) override;
     void setMaxThreads(size_t maxThreads) override;
     bool isAsync() override;
 };
 
 // SingleThreadedWorkerPool implementation.
 std::shared_ptr<WaitableEvent> SingleThreadedWorkerPool::postWorkerTask(
-    std::shared_ptr<Closure> task)
+    std::shared_ptr<Closure> task,
+    WorkerTaskPriority priority)
 {
     (*task)();
     return std::make_shared<SingleThreadedWaitableEvent>();
@@ -75,99 +82,236 @@ bool SingleThreadedWorkerPool::isAsync()
 }
 
 #if (ANGLE_STD_ASYNC_WORKERS == ANGLE_ENABLED)
-class AsyncWaitableEvent final : public WaitableEvent
+// A task queued in the AsyncWorkerPool. It is shared between the worker running it and the
+// AsyncWaitableEvent returned to the caller. Workers never hold the event itself, since it keeps
+// the pool alive and the last reference must not be dropped on a worker thread.
+class AsyncTask final : angle::NonCopyable
 {
   public:
-    AsyncWaitableEvent() : mIsPending(true) {}
-    ~AsyncWaitableEvent() override = default;
+    AsyncTask(std::shared_ptr<Closure> closure) : mClosure(closure), mState(State::Pending) {}
 
-    void wait() override;
-    bool isReady() override;
+    // Runs the closure unless the task was cancelled.
+    void run();
+
+    void wait();
+    bool isReady();
+    bool cancel();
 
   private:
-    friend class AsyncWorkerPool;
-    void setFuture(std::future<void> &&future);
+    enum class State
+    {
+        Pending,
+        Running,
+        Done,
+        Cancelled,
+    };
 
-    // To block wait() when the task is stil in queue to be run.
-    // Also to protect the concurrent accesses from both main thread and
-    // background threads to the member fields.
-    std::mutex mMutex;
+    std::shared_ptr<Closure> mClosure;
 
-    bool mIsPending;
+    // Protects the state, which is accessed from both the main thread and the worker.
+    std::mutex mMutex;
     std::condition_variable mCondition;
-    std::future<void> mFuture;
+    State mState;
 };
 
-void AsyncWaitableEvent::setFuture(std::future<void> &&future)
+void AsyncTask::run()
 {
-    mFuture = std::move(future);
-}
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mState == State::Cancelled)
+        {
+            return;
+        }
+        ASSERT(mState == State::Pending);
+        mState = State::Running;
+    }
+
+    (*mClosure)();
 
-void AsyncWaitableEvent::wait()
-{
     {
-        std::unique_lock<std::mutex> lock(mMutex);
-        mCondition.wait(lock, [this] { return !mIsPending; });
+        std::lock_guard<std::mutex> lock(mMutex);
+        mState = State::Done;
     }
+    mCondition.notify_all();
+}
 
-    ASSERT(mFuture.valid());
-    mFuture.wait();
+void AsyncTask::wait()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.wait(lock, [this] { return mState == State::Done || mState == State::Cancelled; });
 }
 
-bool AsyncWaitableEvent::isReady()
+bool AsyncTask::isReady()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mState == State::Done || mState == State::Cancelled;
+}
+
+bool AsyncTask::cancel()
 {
     std::lock_guard<std::mutex> lock(mMutex);
-    if (mIsPending)
+    if (mState == State::Pending)
     {
-        return false;
+        mState = State::Cancelled;
     }
-    ASSERT(mFuture.valid());
-    return mFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    return mState == State::Cancelled;
 }
 
+class AsyncWaitableEvent final : public WaitableEvent
+{
+  public:
+    AsyncWaitableEvent(std::shared_ptr<AsyncTask> task) : mTask(task) {}
+    ~AsyncWaitableEvent() override = default;
+
+    void wait() override;
+    bool isReady() override;
+    bool cancel() override;
+
+  private:
+    std::shared_ptr<AsyncTask> mTask;
+};
+
+void AsyncWaitableEvent::wait()
+{
+    mTask->wait();
+}
+
+bool AsyncWaitableEvent::isReady()
+{
+    return mTask->isReady();
+}
+
+bool AsyncWaitableEvent::cancel()
+{
+    return mTask->cancel();
+}
+
+// A pool of persistent worker threads. Each worker has its own queues, one per priority. Tasks are
+// spread over the workers round-robin, and a worker whose queues are empty steals from the others.
 class AsyncWorkerPool final : public WorkerThreadPool
 {
   public:
-    AsyncWorkerPool(size_t maxThreads) : mMaxThreads(maxThreads), mRunningThreads(0) {}
-    ~AsyncWorkerPool() override = default;
+    AsyncWorkerPool(size_t maxThreads);
+    ~AsyncWorkerPool() override;
 
-    std::shared_ptr<WaitableEvent> postWorkerTask(std::shared_ptr<Closure> task) override;
+    std::shared_ptr<WaitableEvent> postWorkerTask(std::shared_ptr<Closure> task,
+                                                  WorkerTaskPriority priority) override;
     void setMaxThreads(size_t maxThreads) override;
     bool isAsync() override;
 
   private:
-    void checkToRunPendingTasks();
+    using TaskQueue = std::deque<std::shared_ptr<AsyncTask>>;
 
-    // To protect the concurrent accesses from both main thread and background
-    // threads to the member fields.
+    struct Worker
+    {
+        // Protects the queues, which are accessed by the posting thread and all the workers.
+        std::mutex mutex;
+        std::array<TaskQueue, static_cast<size_t>(WorkerTaskPriority::EnumCount)> queues;
+        std::thread thread;
+
+        // Each worker sleeps on its own condition, so a posted task only wakes a worker that is
+        // allowed to run it. Both are protected by the pool's mutex.
+        std::condition_variable condition;
+        bool idle = false;
+    };
+
+    void threadLoop(size_t workerIndex);
+    std::shared_ptr<AsyncTask> popTask(size_t workerIndex);
+    void notifyAllWorkers();
+
+    // The workers are allocated up front so threads can index them without locking. Their threads
+    // are started on demand.
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+
+    // Protects the fields below.
     std::mutex mMutex;
-
     size_t mMaxThreads;
-    size_t mRunningThreads;
-    std::queue<std::pair<std::shared_ptr<AsyncWaitableEvent>, std::shared_ptr<Closure>>> mTaskQueue;
+    size_t mNextWorker;
+    // Tasks in the worker queues that no worker has claimed yet.
+    size_t mPendingTaskCount;
+    bool mTerminate;
 };
 
 // AsyncWorkerPool implementation.
-std::shared_ptr<WaitableEvent> AsyncWorkerPool::postWorkerTask(std::shared_ptr<Closure> task)
+AsyncWorkerPool::AsyncWorkerPool(size_t maxThreads)
+    : mMaxThreads(0), mNextWorker(0), mPendingTaskCount(0), mTerminate(false)
+{
+    size_t workerCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    for (size_t index = 0; index < workerCount; ++index)
+    {
+        mWorkers.emplace_back(new Worker());
+    }
+    setMaxThreads(maxThreads);
+}
+
+AsyncWorkerPool::~AsyncWorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTerminate = true;
+        notifyAllWorkers();
+    }
+
+    for (std::unique_ptr<Worker> &worker : mWorkers)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+}
+
+std::shared_ptr<WaitableEvent> AsyncWorkerPool::postWorkerTask(std::shared_ptr<Closure> task,
+                                                               WorkerTaskPriority priority)
 {
     ASSERT(mMaxThreads > 0);
 
-    auto waitable = std::make_shared<AsyncWaitableEvent>();
+    auto asyncTask = std::make_shared<AsyncTask>(task);
+
     {
         std::lock_guard<std::mutex> lock(mMutex);
-        mTaskQueue.push(std::make_pair(waitable, task));
+        size_t workerIndex = mNextWorker++ % mMaxThreads;
+        Worker *worker     = mWorkers[workerIndex].get();
+        if (!worker->thread.joinable())
+        {
+            worker->thread = std::thread(&AsyncWorkerPool::threadLoop, this, workerIndex);
+        }
+
+        {
+            std::lock_guard<std::mutex> workerLock(worker->mutex);
+            worker->queues[static_cast<size_t>(priority)].push_back(asyncTask);
+        }
+        ++mPendingTaskCount;
+
+        // Wake the worker the task was queued on, or else another idle one under the limit. If all
+        // of them are busy, the first to finish takes the task. Workers above the limit are left
+        // asleep, since they wouldn't run it.
+        for (size_t offset = 0; offset < mMaxThreads; ++offset)
+        {
+            Worker *idleWorker = mWorkers[(workerIndex + offset) % mMaxThreads].get();
+            if (idleWorker->idle)
+            {
+                idleWorker->idle = false;
+                idleWorker->condition.notify_one();
+                break;
+            }
+        }
     }
-    checkToRunPendingTasks();
-    return waitable;
+
+    return std::make_shared<AsyncWaitableEvent>(asyncTask);
 }
 
 void AsyncWorkerPool::setMaxThreads(size_t maxThreads)
 {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (maxThreads == 0xFFFFFFFF)
     {
-        std::lock_guard<std::mutex> lock(mMutex);
-        mMaxThreads = (maxThreads == 0xFFFFFFFF ? std::thread::hardware_concurrency() : maxThreads);
+        maxThreads = std::thread::hardware_concurrency();
     }
-    checkToRunPendingTasks();
+    // Workers beyond the limit stay idle; the tasks already queued on them are stolen by the
+    // active workers.
+    mMaxThreads = std::max<size_t>(std::min(maxThreads, mWorkers.size()), 1);
+    notifyAllWorkers();
 }
 
 bool AsyncWorkerPool::isAsync()
@@ -175,35 +319,80 @@ bool AsyncWorkerPool::isAsync()
     return true;
 }
 
-void AsyncWorkerPool::checkToRunPendingTasks()
+void AsyncWorkerPool::notifyAllWorkers()
 {
-    std::lock_guard<std::mutex> lock(mMutex);
-    while (mRunningThreads < mMaxThreads && !mTaskQueue.empty())
+    for (std::unique_ptr<Worker> &worker : mWorkers)
     {
-        auto task = mTaskQueue.front();
-        mTaskQueue.pop();
-        auto waitable = task.first;
-        auto closure  = task.second;
+        worker->idle = false;
+        worker->condition.notify_one();
+    }
+}
 
-        auto future = std::async(std::launch::async, [closure, this] {
-            (*closure)();
+void AsyncWorkerPool::threadLoop(size_t workerIndex)
+{
+    Worker *worker = mWorkers[workerIndex].get();
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (!mTerminate && (mPendingTaskCount == 0 || workerIndex >= mMaxThreads))
+            {
+                worker->idle = true;
+                worker->condition.wait(lock);
+            }
+            worker->idle = false;
+            if (mTerminate)
             {
-                std::lock_guard<std::mutex> lock(mMutex);
-                ASSERT(mRunningThreads != 0);
-                --mRunningThreads;
+                return;
             }
-            checkToRunPendingTasks();
-        });
+            --mPendingTaskCount;
+        }
 
-        ++mRunningThreads;
+        // The pending count guarantees a task is queued for this worker, but another worker may
+        // steal it from under us while the queues are scanned, so retry until one is found.
+        std::shared_ptr<AsyncTask> task;
+        while (!task)
+        {
+            task = popTask(workerIndex);
+        }
+        task->run();
+    }
+}
 
+std::shared_ptr<AsyncTask> AsyncWorkerPool::popTask(size_t workerIndex)
+{
+    const size_t workerCount = mWorkers.size();
+    for (size_t priority = 0; priority < static_cast<size_t>(WorkerTaskPriority::EnumCount);
+         ++priority)
+    {
+        // Take from the front of our own queue, and steal from the back of the others.
+        for (size_t offset = 0; offset < workerCount; ++offset)
         {
-            std::lock_guard<std::mutex> waitableLock(waitable->mMutex);
-            waitable->mIsPending = false;
-            waitable->setFuture(std::move(future));
+            Worker *worker   = mWorkers[(workerIndex + offset) % workerCount].get();
+            TaskQueue &queue = worker->queues[priority];
+
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            if (queue.empty())
+            {
+                continue;
+            }
+
+            std::shared_ptr<AsyncTask> task;
+            if (offset == 0)
+            {
+                task = std::move(queue.front());
+                queue.pop_front();
+            }
+            else
+            {
+                task = std::move(queue.back());
+                queue.pop_back();
+            }
+            return task;
         }
-        waitable->mCondition.notify_all();
     }
+
+    return nullptr;
 }
 #endif  // (ANGLE_STD_ASYNC_WORKERS == ANGLE_ENABLED)
 
@@ -229,9 +418,10 @@ std::shared_ptr<WorkerThreadPool> WorkerThreadPool::Create(bool multithreaded)
 // static
 std::shared_ptr<WaitableEvent> WorkerThreadPool::PostWorkerTask(
     std::shared_ptr<WorkerThreadPool> pool,
-    std::shared_ptr<Closure> task)
+    std::shared_ptr<Closure> task,
+    WorkerTaskPriority priority)
 {
-    std::shared_ptr<WaitableEvent> event = pool->postWorkerTask(task);
+    std::shared_ptr<WaitableEvent> event = pool->postWorkerTask(task, priority);
     if (event.get())
     {
         event->setWorkerThreadPool(pool);
@@ -31,6 +31,20 @@ class Closure
     virtual void operator()() = 0;
 };
 
+// Workers start pending tasks with a higher priority first. Texture uploads block the calling
+// thread right away, linking blocks the application sooner than compiling does, and background
+// work such as cache write-back is never waited on.
+enum class WorkerTaskPriority
+{
+    Upload,
+    Link,
+    Compile,
+    Background,
+
+    InvalidEnum,
+    EnumCount = InvalidEnum,
+};
+
 // An event that we can wait on, useful for joining worker threads.
 class WaitableEvent : angle::NonCopyable
 {
@@ -43,6 +57,11 @@ class WaitableEvent : angle::NonCopyable
 
     // Peeks whether the event is ready. If ready, wait() will not block.
     virtual bool isReady() = 0;
+
+    // Drops the task if it has not started running yet. Returns true if the task will never run,
+    // in which case the event is ready immediately.
+    virtual bool cancel();
+
     void setWorkerThreadPool(std::shared_ptr<WorkerThreadPool> pool) { mPool = pool; }
 
     template <size_t Count>
@@ -76,8 +95,10 @@ class WorkerThreadPool : angle::NonCopyable
     virtual ~WorkerThreadPool();
 
     static std::shared_ptr<WorkerThreadPool> Create(bool multithreaded);
-    static std::shared_ptr<WaitableEvent> PostWorkerTask(std::shared_ptr<WorkerThreadPool> pool,
-                                                         std::shared_ptr<Closure> task);
+    static std::shared_ptr<WaitableEvent> PostWorkerTask(
+        std::shared_ptr<WorkerThreadPool> pool,
+        std::shared_ptr<Closure> task,
+        WorkerTaskPriority priority = WorkerTaskPriority::Compile);
 
     virtual void setMaxThreads(size_t maxThreads) = 0;
 
@@ -86,7 +107,8 @@ class WorkerThreadPool : angle::NonCopyable
   private:
     // Returns an event to wait on for the task to finish.
     // If the pool fails to create the task, returns null.
-    virtual std::shared_ptr<WaitableEvent> postWorkerTask(std::shared_ptr<Closure> task) = 0;
+    virtual std::shared_ptr<WaitableEvent> postWorkerTask(std::shared_ptr<Closure> task,
+                                                          WorkerTaskPriority priority) = 0;
 };
 
 }  // namespace angle
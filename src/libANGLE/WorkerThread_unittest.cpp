@@ -8,6 +8,9 @@
 
 #include <gtest/gtest.h>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 #include "libANGLE/WorkerThread.h"
 
@@ -49,4 +52,189 @@ TEST(WorkerPoolTest, SimpleTask)
     }
 }
 
+// A task that blocks its worker until released, so tests can control when queued tasks start.
+class BlockingTask : public Closure
+{
+  public:
+    void operator()() override
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mStarted = true;
+        mCondition.notify_all();
+        mCondition.wait(lock, [this] { return mReleased; });
+    }
+
+    void waitUntilStarted()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [this] { return mStarted; });
+    }
+
+    void release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mReleased = true;
+        }
+        mCondition.notify_all();
+    }
+
+  private:
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mStarted  = false;
+    bool mReleased = false;
+};
+
+// Records the order in which tasks ran.
+class OrderedTask : public Closure
+{
+  public:
+    OrderedTask(std::vector<int> *order, int id) : mOrder(order), mId(id) {}
+    void operator()() override { mOrder->push_back(mId); }
+
+  private:
+    std::vector<int> *mOrder;
+    int mId;
+};
+
+// Tests that many small tasks all run on the persistent worker threads.
+TEST(WorkerPoolTest, ManyTasks)
+{
+    class CountingTask : public Closure
+    {
+      public:
+        CountingTask(std::atomic<int> *count) : mCount(count) {}
+        void operator()() override { ++(*mCount); }
+
+      private:
+        std::atomic<int> *mCount;
+    };
+
+    constexpr int kTaskCount = 1000;
+
+    std::array<std::shared_ptr<WorkerThreadPool>, 2> pools = {
+        {WorkerThreadPool::Create(false), WorkerThreadPool::Create(true)}};
+    for (auto &pool : pools)
+    {
+        std::atomic<int> count(0);
+        std::vector<std::shared_ptr<WaitableEvent>> waitables;
+        for (int index = 0; index < kTaskCount; ++index)
+        {
+            waitables.push_back(
+                WorkerThreadPool::PostWorkerTask(pool, std::make_shared<CountingTask>(&count)));
+        }
+
+        for (auto &waitable : waitables)
+        {
+            waitable->wait();
+            EXPECT_TRUE(waitable->isReady());
+        }
+        EXPECT_EQ(kTaskCount, count.load());
+    }
+}
+
+// Tests that queued tasks start in priority order.
+TEST(WorkerPoolTest, Priority)
+{
+    std::shared_ptr<WorkerThreadPool> pool = WorkerThreadPool::Create(true);
+    if (!pool->isAsync())
+    {
+        return;
+    }
+    pool->setMaxThreads(1);
+
+    // Occupy the only worker so the following tasks queue up behind it.
+    auto blockingTask  = std::make_shared<BlockingTask>();
+    auto blockingEvent = WorkerThreadPool::PostWorkerTask(pool, blockingTask);
+    blockingTask->waitUntilStarted();
+
+    std::vector<int> order;
+    std::array<std::shared_ptr<WaitableEvent>, 3> waitables = {
+        {WorkerThreadPool::PostWorkerTask(pool, std::make_shared<OrderedTask>(&order, 2),
+                                          WorkerTaskPriority::Background),
+         WorkerThreadPool::PostWorkerTask(pool, std::make_shared<OrderedTask>(&order, 1),
+                                          WorkerTaskPriority::Compile),
+         WorkerThreadPool::PostWorkerTask(pool, std::make_shared<OrderedTask>(&order, 0),
+                                          WorkerTaskPriority::Link)}};
+
+    blockingTask->release();
+    blockingEvent->wait();
+    WaitableEvent::WaitMany(&waitables);
+
+    EXPECT_EQ((std::vector<int>{0, 1, 2}), order);
+}
+
+// Tests that a task cancelled before it starts never runs, and that a running task can't be
+// cancelled.
+TEST(WorkerPoolTest, Cancel)
+{
+    std::shared_ptr<WorkerThreadPool> pool = WorkerThreadPool::Create(true);
+    if (!pool->isAsync())
+    {
+        return;
+    }
+    pool->setMaxThreads(1);
+
+    auto blockingTask  = std::make_shared<BlockingTask>();
+    auto blockingEvent = WorkerThreadPool::PostWorkerTask(pool, blockingTask);
+    blockingTask->waitUntilStarted();
+
+    std::vector<int> order;
+    auto cancelledEvent =
+        WorkerThreadPool::PostWorkerTask(pool, std::make_shared<OrderedTask>(&order, 0));
+    auto keptEvent =
+        WorkerThreadPool::PostWorkerTask(pool, std::make_shared<OrderedTask>(&order, 1));
+
+    EXPECT_FALSE(blockingEvent->cancel());
+    EXPECT_TRUE(cancelledEvent->cancel());
+    EXPECT_TRUE(cancelledEvent->isReady());
+
+    blockingTask->release();
+    blockingEvent->wait();
+    cancelledEvent->wait();
+    keptEvent->wait();
+
+    EXPECT_EQ((std::vector<int>{1}), order);
+}
+
+// Tests that tasks still run after the thread limit is lowered while the workers are idle. The
+// workers above the limit can't take them, so they must not be the ones woken up.
+TEST(WorkerPoolTest, LowerMaxThreadsWhileIdle)
+{
+    class TestTask : public Closure
+    {
+      public:
+        void operator()() override { fired = true; }
+
+        bool fired = false;
+    };
+
+    std::shared_ptr<WorkerThreadPool> pool = WorkerThreadPool::Create(true);
+    if (!pool->isAsync())
+    {
+        return;
+    }
+
+    // Start the workers and let them go idle.
+    std::vector<std::shared_ptr<WaitableEvent>> waitables;
+    for (int index = 0; index < 16; ++index)
+    {
+        waitables.push_back(WorkerThreadPool::PostWorkerTask(pool, std::make_shared<TestTask>()));
+    }
+    for (auto &waitable : waitables)
+    {
+        waitable->wait();
+    }
+
+    pool->setMaxThreads(1);
+
+    for (int index = 0; index < 100; ++index)
+    {
+        auto task = std::make_shared<TestTask>();
+        WorkerThreadPool::PostWorkerTask(pool, task)->wait();
+        EXPECT_TRUE(task->fired);
+    }
+}
+
 }  // anonymous namespace
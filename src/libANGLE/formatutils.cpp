@@ -28,6 +28,82 @@ namespace
 using InternalFormatInfoMap =
     std::unordered_map<GLenum, std::unordered_map<GLenum, InternalFormat>>;
 
+// The format infos are queried several times per texture and renderbuffer call, so the map they
+// are built in is flattened for lookups. The infos of each internal format are stored next to
+// each other, and found through an open addressing hash table. Each internal format has at most
+// a handful of types, which are searched linearly.
+class InternalFormatInfoTable final : angle::NonCopyable
+{
+  public:
+    explicit InternalFormatInfoTable(const InternalFormatInfoMap &map);
+
+    // Returns the infos of |internalFormat|, or nullptr if it's unknown.
+    const InternalFormat *find(GLenum internalFormat, size_t *countOut) const
+    {
+        for (size_t index = Hash(internalFormat);; index = (index + 1) % kEntryCount)
+        {
+            const Entry &entry = mEntries[index];
+            if (entry.infoCount == 0)
+            {
+                return nullptr;
+            }
+            if (entry.internalFormat == internalFormat)
+            {
+                *countOut = entry.infoCount;
+                return &mInfos[entry.firstInfo];
+            }
+        }
+    }
+
+    const std::vector<InternalFormat> &getAllInfos() const { return mInfos; }
+
+  private:
+    struct Entry
+    {
+        GLenum internalFormat;
+        uint16_t firstInfo;
+        uint16_t infoCount;
+    };
+
+    // Keeps the table at most a quarter full, so lookups rarely need more than one probe.
+    static constexpr size_t kEntryCountLog2 = 10;
+    static constexpr size_t kEntryCount     = 1 << kEntryCountLog2;
+
+    static size_t Hash(GLenum internalFormat)
+    {
+        // Fibonacci hashing. Internal formats are clustered, so the high bits are used.
+        return (static_cast<uint32_t>(internalFormat) * 0x9E3779B9u) >> (32 - kEntryCountLog2);
+    }
+
+    std::vector<InternalFormat> mInfos;
+    std::array<Entry, kEntryCount> mEntries;
+};
+
+InternalFormatInfoTable::InternalFormatInfoTable(const InternalFormatInfoMap &map)
+{
+    ASSERT(map.size() * 4 <= kEntryCount);
+
+    mEntries.fill({GL_NONE, 0, 0});
+    for (const auto &internalFormat : map)
+    {
+        size_t index = Hash(internalFormat.first);
+        while (mEntries[index].infoCount != 0)
+        {
+            index = (index + 1) % kEntryCount;
+        }
+
+        Entry &entry         = mEntries[index];
+        entry.internalFormat = internalFormat.first;
+        entry.firstInfo      = static_cast<uint16_t>(mInfos.size());
+        entry.infoCount      = static_cast<uint16_t>(internalFormat.second.size());
+
+        for (const auto &type : internalFormat.second)
+        {
+            mInfos.push_back(type.second);
+        }
+    }
+}
+
 bool CheckedMathResult(const CheckedNumeric<GLuint> &value, GLuint *resultOut)
 {
     if (!value.IsValid())
@@ -1070,29 +1146,26 @@ static InternalFormatInfoMap BuildInternalFormatInfoMap()
     return map;
 }
 
-static const InternalFormatInfoMap &GetInternalFormatMap()
+static const InternalFormatInfoTable &GetInternalFormatTable()
 {
-    static const angle::base::NoDestructor<InternalFormatInfoMap> formatMap(
+    static const angle::base::NoDestructor<InternalFormatInfoTable> formatTable(
         BuildInternalFormatInfoMap());
-    return *formatMap;
+    return *formatTable;
 }
 
 static FormatSet BuildAllSizedInternalFormatSet()
 {
     FormatSet result;
 
-    for (const auto &internalFormat : GetInternalFormatMap())
+    for (const InternalFormat &formatInfo : GetInternalFormatTable().getAllInfos())
     {
-        for (const auto &type : internalFormat.second)
+        if (formatInfo.sized)
         {
-            if (type.second.sized)
-            {
-                // TODO(jmadill): Fix this hack.
-                if (internalFormat.first == GL_BGR565_ANGLEX)
-                    continue;
+            // TODO(jmadill): Fix this hack.
+            if (formatInfo.internalFormat == GL_BGR565_ANGLEX)
+                continue;
 
-                result.insert(internalFormat.first);
-            }
+            result.insert(formatInfo.internalFormat);
         }
     }
 
@@ -1157,48 +1230,43 @@ uint32_t GetPackedTypeInfo(GLenum type)
 const InternalFormat &GetSizedInternalFormatInfo(GLenum internalFormat)
 {
     static const InternalFormat defaultInternalFormat;
-    const InternalFormatInfoMap &formatMap = GetInternalFormatMap();
-    auto iter                              = formatMap.find(internalFormat);
+    size_t typeCount                  = 0;
+    const InternalFormat *formatInfos = GetInternalFormatTable().find(internalFormat, &typeCount);
 
     // Sized internal formats only have one type per entry
-    if (iter == formatMap.end() || iter->second.size() != 1)
-    {
-        return defaultInternalFormat;
-    }
-
-    const InternalFormat &internalFormatInfo = iter->second.begin()->second;
-    if (!internalFormatInfo.sized)
+    if (formatInfos == nullptr || typeCount != 1 || !formatInfos[0].sized)
     {
         return defaultInternalFormat;
     }
 
-    return internalFormatInfo;
+    return formatInfos[0];
 }
 
 const InternalFormat &GetInternalFormatInfo(GLenum internalFormat, GLenum type)
 {
     static const InternalFormat defaultInternalFormat;
-    const InternalFormatInfoMap &formatMap = GetInternalFormatMap();
-
-    auto internalFormatIter = formatMap.find(internalFormat);
-    if (internalFormatIter == formatMap.end())
+    size_t typeCount                  = 0;
+    const InternalFormat *formatInfos = GetInternalFormatTable().find(internalFormat, &typeCount);
+    if (formatInfos == nullptr)
     {
         return defaultInternalFormat;
     }
 
     // If the internal format is sized, simply return it without the type check.
-    if (internalFormatIter->second.size() == 1 && internalFormatIter->second.begin()->second.sized)
+    if (typeCount == 1 && formatInfos[0].sized)
     {
-        return internalFormatIter->second.begin()->second;
+        return formatInfos[0];
     }
 
-    auto typeIter = internalFormatIter->second.find(type);
-    if (typeIter == internalFormatIter->second.end())
+    for (size_t typeIndex = 0; typeIndex < typeCount; ++typeIndex)
     {
-        return defaultInternalFormat;
+        if (formatInfos[typeIndex].type == type)
+        {
+            return formatInfos[typeIndex];
+        }
     }
 
-    return typeIter->second;
+    return defaultInternalFormat;
 }
 
 GLuint InternalFormat::computePixelBytes(GLenum formatType) const
@@ -2486,8 +2554,9 @@ size_t GetVertexFormatSize(angle::FormatID vertexFormatID)
 
 bool ValidES3InternalFormat(GLenum internalFormat)
 {
-    const InternalFormatInfoMap &formatMap = GetInternalFormatMap();
-    return internalFormat != GL_NONE && formatMap.find(internalFormat) != formatMap.end();
+    size_t typeCount = 0;
+    return internalFormat != GL_NONE &&
+           GetInternalFormatTable().find(internalFormat, &typeCount) != nullptr;
 }
 
 VertexFormat::VertexFormat(GLenum typeIn,
@@ -45,6 +45,9 @@ class LinkEvent : angle::NonCopyable
     virtual angle::Result wait(const gl::Context *context) = 0;
     // Peeks whether the linking is still ongoing.
     virtual bool isLinking() = 0;
+    // Called when the program is deleted before the link was resolved. Linking work that has not
+    // started yet may be dropped, in which case wait() does not report success.
+    virtual void cancel() {}
 };
 
 // Wraps an already done linking.
@@ -916,7 +916,8 @@ class ProgramD3D::LoadBinaryLinkEvent final : public LinkEvent
                         gl::BinaryInputStream *stream,
                         gl::InfoLog &infoLog)
         : mTask(std::make_shared<ProgramD3D::LoadBinaryTask>(program, stream, infoLog)),
-          mWaitableEvent(angle::WorkerThreadPool::PostWorkerTask(workerPool, mTask))
+          mWaitableEvent(
+              angle::WorkerThreadPool::PostWorkerTask(workerPool, mTask, WorkerTaskPriority::Link))
     {}
 
     angle::Result wait(const gl::Context *context) override
@@ -1760,12 +1761,12 @@ class ProgramD3D::GraphicsProgramLinkEvent final : public LinkEvent
           mVertexTask(vertexTask),
           mPixelTask(pixelTask),
           mGeometryTask(geometryTask),
-          mWaitEvents({{std::shared_ptr<WaitableEvent>(
-                            angle::WorkerThreadPool::PostWorkerTask(workerPool, mVertexTask)),
-                        std::shared_ptr<WaitableEvent>(
-                            angle::WorkerThreadPool::PostWorkerTask(workerPool, mPixelTask)),
-                        std::shared_ptr<WaitableEvent>(
-                            angle::WorkerThreadPool::PostWorkerTask(workerPool, mGeometryTask))}}),
+          mWaitEvents({{std::shared_ptr<WaitableEvent>(angle::WorkerThreadPool::PostWorkerTask(
+                            workerPool, mVertexTask, WorkerTaskPriority::Link)),
+                        std::shared_ptr<WaitableEvent>(angle::WorkerThreadPool::PostWorkerTask(
+                            workerPool, mPixelTask, WorkerTaskPriority::Link)),
+                        std::shared_ptr<WaitableEvent>(angle::WorkerThreadPool::PostWorkerTask(
+                            workerPool, mGeometryTask, WorkerTaskPriority::Link))}}),
           mUseGS(useGS),
           mVertexShader(vertexShader),
           mFragmentShader(fragmentShader)
@@ -1937,8 +1938,8 @@ std::unique_ptr<LinkEvent> ProgramD3D::compileComputeExecutable(const gl::Contex
     }
     else
     {
-        waitableEvent =
-            WorkerThreadPool::PostWorkerTask(context->getWorkerThreadPool(), computeTask);
+        waitableEvent = WorkerThreadPool::PostWorkerTask(context->getWorkerThreadPool(),
+                                                         computeTask, WorkerTaskPriority::Link);
     }
 
     return std::make_unique<ComputeProgramLinkEvent>(infoLog, computeTask, waitableEvent);
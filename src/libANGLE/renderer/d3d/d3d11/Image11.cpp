@@ -298,9 +298,10 @@ angle::Result Image11::loadData(const gl::Context *context,
     uint8_t *offsetMappedData = (static_cast<uint8_t *>(mappedImage.pData) +
                                  (area.y * mappedImage.RowPitch + area.x * outputPixelSize +
                                   area.z * mappedImage.DepthPitch));
-    loadFunction(area.width, area.height, area.depth,
-                 static_cast<const uint8_t *>(input) + inputSkipBytes, inputRowPitch,
-                 inputDepthPitch, offsetMappedData, mappedImage.RowPitch, mappedImage.DepthPitch);
+    LoadImageParallel(context->getWorkerThreadPool(), loadFunction, area.width, area.height,
+                      area.depth, static_cast<const uint8_t *>(input) + inputSkipBytes,
+                      inputRowPitch, inputDepthPitch, offsetMappedData, mappedImage.RowPitch,
+                      mappedImage.DepthPitch);
 
     unmap();
 
@@ -146,63 +146,65 @@ void SetTriangleFanIndices(GLuint *destPtr, size_t numTris)
     }
 }
 
-void GetLineLoopIndices(const void *indices,
-                        gl::DrawElementsType indexType,
-                        GLuint count,
-                        bool usePrimitiveRestartFixedIndex,
-                        std::vector<GLuint> *bufferOut)
+// The most indices GetLineLoopIndices() writes.
+GLuint GetLineLoopIndexCountUpperBound(gl::DrawElementsType indexType,
+                                       GLuint count,
+                                       bool usePrimitiveRestartFixedIndex)
 {
     if (indexType != gl::DrawElementsType::InvalidEnum && usePrimitiveRestartFixedIndex)
     {
-        size_t indexCount = GetLineLoopWithRestartIndexCount(indexType, count,
-                                                             static_cast<const uint8_t *>(indices));
-        bufferOut->resize(indexCount);
+        return GetLineLoopWithRestartIndexCountUpperBound(count);
+    }
+
+    // For non-primitive-restart draws, the index count is static.
+    return count + 1;
+}
+
+// Writes the indices of a line loop to dest and returns how many were written.
+GLuint GetLineLoopIndices(const void *indices,
+                          gl::DrawElementsType indexType,
+                          GLuint count,
+                          bool usePrimitiveRestartFixedIndex,
+                          GLuint *dest)
+{
+    if (indexType != gl::DrawElementsType::InvalidEnum && usePrimitiveRestartFixedIndex)
+    {
+        const uint8_t *srcPtr = static_cast<const uint8_t *>(indices);
+        uint8_t *outPtr       = reinterpret_cast<uint8_t *>(dest);
         switch (indexType)
         {
             case gl::DrawElementsType::UnsignedByte:
-                CopyLineLoopIndicesWithRestart<GLubyte, GLuint>(
-                    count, static_cast<const uint8_t *>(indices),
-                    reinterpret_cast<uint8_t *>(bufferOut->data()));
-                break;
+                return CopyLineLoopIndicesWithRestart<GLubyte, GLuint>(count, srcPtr, outPtr);
             case gl::DrawElementsType::UnsignedShort:
-                CopyLineLoopIndicesWithRestart<GLushort, GLuint>(
-                    count, static_cast<const uint8_t *>(indices),
-                    reinterpret_cast<uint8_t *>(bufferOut->data()));
-                break;
+                return CopyLineLoopIndicesWithRestart<GLushort, GLuint>(count, srcPtr, outPtr);
             case gl::DrawElementsType::UnsignedInt:
-                CopyLineLoopIndicesWithRestart<GLuint, GLuint>(
-                    count, static_cast<const uint8_t *>(indices),
-                    reinterpret_cast<uint8_t *>(bufferOut->data()));
-                break;
+                return CopyLineLoopIndicesWithRestart<GLuint, GLuint>(count, srcPtr, outPtr);
             default:
                 UNREACHABLE();
-                break;
+                return 0;
         }
-        return;
     }
 
-    // For non-primitive-restart draws, the index count is static.
-    bufferOut->resize(static_cast<size_t>(count) + 1);
-
     switch (indexType)
     {
         // Non-indexed draw
         case gl::DrawElementsType::InvalidEnum:
-            SetLineLoopIndices(&(*bufferOut)[0], count);
+            SetLineLoopIndices(dest, count);
             break;
         case gl::DrawElementsType::UnsignedByte:
-            CopyLineLoopIndices<GLubyte>(indices, &(*bufferOut)[0], count);
+            CopyLineLoopIndices<GLubyte>(indices, dest, count);
             break;
         case gl::DrawElementsType::UnsignedShort:
-            CopyLineLoopIndices<GLushort>(indices, &(*bufferOut)[0], count);
+            CopyLineLoopIndices<GLushort>(indices, dest, count);
             break;
         case gl::DrawElementsType::UnsignedInt:
-            CopyLineLoopIndices<GLuint>(indices, &(*bufferOut)[0], count);
+            CopyLineLoopIndices<GLuint>(indices, dest, count);
             break;
         default:
             UNREACHABLE();
             break;
     }
+    return count + 1;
 }
 
 template <typename T>
@@ -218,100 +220,116 @@ void CopyTriangleFanIndices(const void *indices, GLuint *destPtr, size_t numTris
     }
 }
 
+// Writes the triangle list of a triangle fan with primitive restart to destPtr, and returns how
+// many indices were written.
 template <typename T>
-void CopyTriangleFanIndicesWithRestart(const void *indices,
-                                       GLuint indexCount,
-                                       gl::DrawElementsType indexType,
-                                       std::vector<GLuint> *bufferOut)
+GLuint CopyTriangleFanIndicesWithRestart(const void *indices,
+                                         GLuint indexCount,
+                                         gl::DrawElementsType indexType,
+                                         GLuint *destPtr)
 {
     GLuint restartIndex    = gl::GetPrimitiveRestartIndex(indexType);
     GLuint d3dRestartIndex = gl::GetPrimitiveRestartIndex(gl::DrawElementsType::UnsignedInt);
     const T *srcPtr        = static_cast<const T *>(indices);
-    Optional<GLuint> vertexA;
-    Optional<GLuint> vertexB;
-
-    bufferOut->clear();
+    GLuint *destStart      = destPtr;
 
-    for (size_t indexIdx = 0; indexIdx < indexCount; ++indexIdx)
+    size_t indexIdx = 0;
+    while (indexIdx < indexCount)
     {
-        GLuint value = static_cast<GLuint>(srcPtr[indexIdx]);
-
-        if (value == restartIndex)
+        // Each fan turns into a run of triangles sharing its first vertex, which are written
+        // without testing the indices for restarts again.
+        size_t fanStart = indexIdx;
+        while (indexIdx < indexCount && static_cast<GLuint>(srcPtr[indexIdx]) != restartIndex)
         {
-            bufferOut->push_back(d3dRestartIndex);
-            vertexA.reset();
-            vertexB.reset();
+            ++indexIdx;
         }
-        else
+
+        size_t fanLength = indexIdx - fanStart;
+        if (fanLength >= 3)
         {
-            if (!vertexA.valid())
-            {
-                vertexA = value;
-            }
-            else if (!vertexB.valid())
-            {
-                vertexB = value;
-            }
-            else
+            GLuint vertexA = static_cast<GLuint>(srcPtr[fanStart]);
+            for (size_t vertex = fanStart + 2; vertex < indexIdx; ++vertex)
             {
-                bufferOut->push_back(vertexA.value());
-                bufferOut->push_back(vertexB.value());
-                bufferOut->push_back(value);
-                vertexB = value;
+                destPtr[0] = vertexA;
+                destPtr[1] = static_cast<GLuint>(srcPtr[vertex - 1]);
+                destPtr[2] = static_cast<GLuint>(srcPtr[vertex]);
+                destPtr += 3;
             }
         }
+
+        if (indexIdx < indexCount)
+        {
+            *(destPtr++) = d3dRestartIndex;
+            ++indexIdx;
+        }
     }
+
+    return static_cast<GLuint>(destPtr - destStart);
+}
+
+// The most indices GetTriFanIndices() writes.
+GLuint GetTriFanIndexCountUpperBound(gl::DrawElementsType indexType,
+                                     GLuint count,
+                                     bool usePrimitiveRestartFixedIndex)
+{
+    if (indexType != gl::DrawElementsType::InvalidEnum && usePrimitiveRestartFixedIndex)
+    {
+        // Each index adds at most one triangle, and each restart index one index.
+        return count * 3;
+    }
+
+    // For non-primitive-restart draws, the index count is static.
+    return (count - 2) * 3;
 }
 
-void GetTriFanIndices(const void *indices,
-                      gl::DrawElementsType indexType,
-                      GLuint count,
-                      bool usePrimitiveRestartFixedIndex,
-                      std::vector<GLuint> *bufferOut)
+// Writes the triangle list of a triangle fan to destPtr and returns how many indices were written.
+GLuint GetTriFanIndices(const void *indices,
+                        gl::DrawElementsType indexType,
+                        GLuint count,
+                        bool usePrimitiveRestartFixedIndex,
+                        GLuint *destPtr)
 {
     if (indexType != gl::DrawElementsType::InvalidEnum && usePrimitiveRestartFixedIndex)
     {
         switch (indexType)
         {
             case gl::DrawElementsType::UnsignedByte:
-                CopyTriangleFanIndicesWithRestart<GLubyte>(indices, count, indexType, bufferOut);
-                break;
+                return CopyTriangleFanIndicesWithRestart<GLubyte>(indices, count, indexType,
+                                                                  destPtr);
             case gl::DrawElementsType::UnsignedShort:
-                CopyTriangleFanIndicesWithRestart<GLushort>(indices, count, indexType, bufferOut);
-                break;
+                return CopyTriangleFanIndicesWithRestart<GLushort>(indices, count, indexType,
+                                                                   destPtr);
             case gl::DrawElementsType::UnsignedInt:
-                CopyTriangleFanIndicesWithRestart<GLuint>(indices, count, indexType, bufferOut);
-                break;
+                return CopyTriangleFanIndicesWithRestart<GLuint>(indices, count, indexType,
+                                                                 destPtr);
             default:
                 UNREACHABLE();
-                break;
+                return 0;
         }
-        return;
     }
 
-    // For non-primitive-restart draws, the index count is static.
     GLuint numTris = count - 2;
-    bufferOut->resize(numTris * 3);
 
     switch (indexType)
     {
         // Non-indexed draw
         case gl::DrawElementsType::InvalidEnum:
-            SetTriangleFanIndices(&(*bufferOut)[0], numTris);
+            SetTriangleFanIndices(destPtr, numTris);
             break;
         case gl::DrawElementsType::UnsignedByte:
-            CopyTriangleFanIndices<GLubyte>(indices, &(*bufferOut)[0], numTris);
+            CopyTriangleFanIndices<GLubyte>(indices, destPtr, numTris);
             break;
         case gl::DrawElementsType::UnsignedShort:
-            CopyTriangleFanIndices<GLushort>(indices, &(*bufferOut)[0], numTris);
+            CopyTriangleFanIndices<GLushort>(indices, destPtr, numTris);
             break;
         case gl::DrawElementsType::UnsignedInt:
-            CopyTriangleFanIndices<GLuint>(indices, &(*bufferOut)[0], numTris);
+            CopyTriangleFanIndices<GLuint>(indices, destPtr, numTris);
             break;
         default:
             UNREACHABLE();
             break;
     }
+    return numTris * 3;
 }
 
 bool IsArrayRTV(ID3D11RenderTargetView *rtv)
@@ -1729,19 +1747,19 @@ angle::Result Renderer11::drawLineLoop(const gl::Context *context,
                                                   gl::DrawElementsType::UnsignedInt));
     }
 
-    // Checked by Renderer11::applyPrimitiveType
-    bool indexCheck = static_cast<unsigned int>(count) + 1 >
+    // Checked by Renderer11::applyPrimitiveType. Primitive restart can add half as many indices.
+    bool indexCheck = static_cast<uint64_t>(count) + count / 2 + 1 >
                       (std::numeric_limits<unsigned int>::max() / sizeof(unsigned int));
     ANGLE_CHECK(GetImplAs<Context11>(context), !indexCheck,
                 "Failed to create a 32-bit looping index buffer for "
                 "GL_LINE_LOOP, too many indices required.",
                 GL_OUT_OF_MEMORY);
 
-    GetLineLoopIndices(indices, type, static_cast<GLuint>(count),
-                       glState.isPrimitiveRestartEnabled(), &mScratchIndexDataBuffer);
-
+    // The indices are converted straight into the index buffer, which is mapped with enough space
+    // for the largest possible result.
+    bool primitiveRestart = glState.isPrimitiveRestartEnabled();
     unsigned int spaceNeeded =
-        static_cast<unsigned int>(sizeof(GLuint) * mScratchIndexDataBuffer.size());
+        sizeof(GLuint) * GetLineLoopIndexCountUpperBound(type, count, primitiveRestart);
     ANGLE_TRY(
         mLineLoopIB->reserveBufferSpace(context, spaceNeeded, gl::DrawElementsType::UnsignedInt));
 
@@ -1749,9 +1767,8 @@ angle::Result Renderer11::drawLineLoop(const gl::Context *context,
     unsigned int offset;
     ANGLE_TRY(mLineLoopIB->mapBuffer(context, spaceNeeded, &mappedMemory, &offset));
 
-    // Copy over the converted index data.
-    memcpy(mappedMemory, &mScratchIndexDataBuffer[0],
-           sizeof(GLuint) * mScratchIndexDataBuffer.size());
+    GLuint convertedIndexCount = GetLineLoopIndices(indices, type, count, primitiveRestart,
+                                                    static_cast<GLuint *>(mappedMemory));
 
     ANGLE_TRY(mLineLoopIB->unmapBuffer(context));
 
@@ -1761,7 +1778,7 @@ angle::Result Renderer11::drawLineLoop(const gl::Context *context,
 
     mStateManager.setIndexBuffer(d3dIndexBuffer.get(), indexFormat, offset);
 
-    UINT indexCount = static_cast<UINT>(mScratchIndexDataBuffer.size());
+    UINT indexCount = static_cast<UINT>(convertedIndexCount);
 
     if (instances > 0)
     {
@@ -1810,20 +1827,18 @@ angle::Result Renderer11::drawTriangleFan(const gl::Context *context,
     // Checked by Renderer11::applyPrimitiveType
     ASSERT(count >= 3);
 
-    const GLuint numTris = count - 2;
-
     bool indexCheck =
-        (numTris > std::numeric_limits<unsigned int>::max() / (sizeof(unsigned int) * 3));
+        (count > std::numeric_limits<unsigned int>::max() / (sizeof(unsigned int) * 3));
     ANGLE_CHECK(GetImplAs<Context11>(context), !indexCheck,
-                "Failed to create a scratch index buffer for GL_TRIANGLE_FAN, "
+                "Failed to create an index buffer for GL_TRIANGLE_FAN, "
                 "too many indices required.",
                 GL_OUT_OF_MEMORY);
 
-    GetTriFanIndices(indexPointer, type, count, glState.isPrimitiveRestartEnabled(),
-                     &mScratchIndexDataBuffer);
-
+    // The indices are converted straight into the index buffer, which is mapped with enough space
+    // for the largest possible result.
+    bool primitiveRestart = glState.isPrimitiveRestartEnabled();
     const unsigned int spaceNeeded =
-        static_cast<unsigned int>(mScratchIndexDataBuffer.size() * sizeof(unsigned int));
+        GetTriFanIndexCountUpperBound(type, count, primitiveRestart) * sizeof(unsigned int);
     ANGLE_TRY(mTriangleFanIB->reserveBufferSpace(context, spaceNeeded,
                                                  gl::DrawElementsType::UnsignedInt));
 
@@ -1831,7 +1846,8 @@ angle::Result Renderer11::drawTriangleFan(const gl::Context *context,
     unsigned int offset;
     ANGLE_TRY(mTriangleFanIB->mapBuffer(context, spaceNeeded, &mappedMemory, &offset));
 
-    memcpy(mappedMemory, &mScratchIndexDataBuffer[0], spaceNeeded);
+    GLuint convertedIndexCount = GetTriFanIndices(indexPointer, type, count, primitiveRestart,
+                                                  static_cast<GLuint *>(mappedMemory));
 
     ANGLE_TRY(mTriangleFanIB->unmapBuffer(context));
 
@@ -1841,7 +1857,7 @@ angle::Result Renderer11::drawTriangleFan(const gl::Context *context,
 
     mStateManager.setIndexBuffer(d3dIndexBuffer.get(), indexFormat, offset);
 
-    UINT indexCount = static_cast<UINT>(mScratchIndexDataBuffer.size());
+    UINT indexCount = static_cast<UINT>(convertedIndexCount);
 
     if (instances > 0)
     {
@@ -614,8 +614,6 @@ class Renderer11 : public RendererD3D
     IDXGIFactory *mDxgiFactory;
     ID3D11Debug *mDebug;
 
-    std::vector<GLuint> mScratchIndexDataBuffer;
-
     angle::ScratchBuffer mScratchMemoryBuffer;
 
     DebugAnnotator11 mAnnotator;
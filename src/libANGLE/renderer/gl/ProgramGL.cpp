@@ -192,22 +192,31 @@ class ProgramGL::LinkEventGL final : public LinkEvent
                 PostLinkImplFunctor &&functor)
         : mLinkTask(linkTask),
           mWaitableEvent(std::shared_ptr<angle::WaitableEvent>(
-              angle::WorkerThreadPool::PostWorkerTask(workerPool, mLinkTask))),
-          mPostLinkImplFunctor(functor)
+              angle::WorkerThreadPool::PostWorkerTask(workerPool, mLinkTask,
+                                                      angle::WorkerTaskPriority::Link))),
+          mPostLinkImplFunctor(functor),
+          mCancelled(false)
     {}
 
     angle::Result wait(const gl::Context *context) override
     {
         mWaitableEvent->wait();
+        if (mCancelled)
+        {
+            return angle::Result::Incomplete;
+        }
         return mPostLinkImplFunctor(mLinkTask->fallbackToMainContext(), mLinkTask->getInfoLog());
     }
 
     bool isLinking() override { return !mWaitableEvent->isReady(); }
 
+    void cancel() override { mCancelled = mWaitableEvent->cancel(); }
+
   private:
     std::shared_ptr<ProgramGL::LinkTask> mLinkTask;
     std::shared_ptr<angle::WaitableEvent> mWaitableEvent;
     PostLinkImplFunctor mPostLinkImplFunctor;
+    bool mCancelled;
 };
 
 std::unique_ptr<LinkEvent> ProgramGL::link(const gl::Context *context,
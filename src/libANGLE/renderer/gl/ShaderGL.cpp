@@ -343,6 +343,11 @@ std::shared_ptr<WaitableCompileEvent> ShaderGL::compile(const gl::Context *conte
         additionalOptions |= SH_UNFOLD_SHORT_CIRCUIT;
     }
 
+    if (features.minifyTranslatedShaders.enabled)
+    {
+        additionalOptions |= SH_MINIFY_OUTPUT;
+    }
+
     options |= additionalOptions;
 
     auto workerThreadPool = context->getWorkerThreadPool();
@@ -1583,6 +1583,8 @@ void InitializeFeatures(const FunctionsGL *functions, angle::FeaturesGL *feature
     ANGLE_FEATURE_CONDITION(features, rgbDXT1TexturesSampleZeroAlpha, IsApple())
 
     ANGLE_FEATURE_CONDITION(features, unfoldShortCircuits, IsApple())
+
+    ANGLE_FEATURE_CONDITION(features, minifyTranslatedShaders, false)
 }
 
 void InitializeFrontendFeatures(const FunctionsGL *functions, angle::FrontendFeatures *features)
@@ -20,14 +20,23 @@ ANGLE_DISABLE_EXTRA_SEMI_WARNING
 
 ANGLE_REENABLE_EXTRA_SEMI_WARNING
 
+#include <anglebase/no_destructor.h>
+#include <anglebase/sha1.h>
 #include <array>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
 #include <numeric>
 
 #include "common/FixedVector.h"
 #include "common/string_utils.h"
 #include "common/utilities.h"
+#include "common/version.h"
+#include "libANGLE/BlobCache.h"
 #include "libANGLE/Caps.h"
 #include "libANGLE/ProgramLinkedResources.h"
+#include "libANGLE/SizedMRUCache.h"
+#include "libANGLE/WorkerThread.h"
 
 #define ANGLE_GLSLANG_CHECK(CALLBACK, TEST, ERR) \
     do                                           \
@@ -936,63 +945,243 @@ constexpr gl::ShaderMap<EShLanguage> kShLanguageMap = {
     {gl::ShaderType::Compute, EShLangCompute},
 };
 
-angle::Result GetShaderSpirvCode(GlslangErrorCallback callback,
-                                 const gl::Caps &glCaps,
-                                 const gl::ShaderMap<std::string> &shaderSources,
-                                 gl::ShaderMap<std::vector<uint32_t>> *shaderCodeOut)
+// Bounds the memory used by the in-memory SPIR-V cache.
+constexpr size_t kSpirvCacheMaxSize = 16 * 1024 * 1024;
+
+class SpirvCache final : angle::NonCopyable
 {
-    // Enable SPIR-V and Vulkan rules when parsing GLSL
-    EShMessages messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+  public:
+    SpirvCache() : mCache(kSpirvCacheMaxSize) {}
 
-    TBuiltInResource builtInResources(glslang::DefaultTBuiltInResource);
-    GetBuiltInResourcesFromCaps(glCaps, &builtInResources);
+    bool get(const egl::BlobCache::Key &key, std::vector<uint32_t> *spirvOut)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
 
-    glslang::TShader vertexShader(EShLangVertex);
-    glslang::TShader fragmentShader(EShLangFragment);
-    glslang::TShader geometryShader(EShLangGeometry);
-    glslang::TShader computeShader(EShLangCompute);
+        const std::vector<uint32_t> *spirv = nullptr;
+        if (!mCache.get(key, &spirv))
+        {
+            return false;
+        }
 
-    gl::ShaderMap<glslang::TShader *> shaders = {
-        {gl::ShaderType::Vertex, &vertexShader},
-        {gl::ShaderType::Fragment, &fragmentShader},
-        {gl::ShaderType::Geometry, &geometryShader},
-        {gl::ShaderType::Compute, &computeShader},
-    };
-    glslang::TProgram program;
+        *spirvOut = *spirv;
+        return true;
+    }
 
-    for (const gl::ShaderType shaderType : gl::AllShaderTypes())
+    void put(const egl::BlobCache::Key &key, const std::vector<uint32_t> &spirv)
     {
-        if (shaderSources[shaderType].empty())
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        std::vector<uint32_t> spirvCopy(spirv);
+        mCache.put(key, std::move(spirvCopy), spirv.size() * sizeof(uint32_t));
+    }
+
+  private:
+    std::mutex mMutex;
+    angle::SizedMRUCache<egl::BlobCache::Key, std::vector<uint32_t>> mCache;
+};
+
+// Shared by all displays. Programs may be linked on worker threads, hence the lock.
+SpirvCache *GetSpirvCache()
+{
+    static angle::base::NoDestructor<SpirvCache> cache;
+    return cache.get();
+}
+
+void ComputeSpirvKey(gl::ShaderType shaderType,
+                     const std::string &source,
+                     const TBuiltInResource &builtInResources,
+                     egl::BlobCache::Key *keyOut)
+{
+    std::string hashString = "ANGLE SPIR-V: ";
+    hashString += ANGLE_COMMIT_HASH;
+    hashString += static_cast<char>(shaderType);
+
+    // The limits at the end of TBuiltInResource never change. Hashing the integer resources
+    // only also keeps any trailing padding out of the key.
+    hashString.append(reinterpret_cast<const char *>(&builtInResources),
+                      offsetof(TBuiltInResource, limits));
+    hashString += source;
+
+    angle::base::SHA1HashBytes(reinterpret_cast<const unsigned char *>(hashString.c_str()),
+                               hashString.length(), keyOut->data());
+}
+
+bool LoadCachedSpirv(const egl::BlobCache::Key &key,
+                     egl::BlobCache *blobCache,
+                     angle::ScratchBuffer *scratchBuffer,
+                     std::vector<uint32_t> *spirvOut)
+{
+    if (GetSpirvCache()->get(key, spirvOut))
+    {
+        return true;
+    }
+
+    if (!blobCache || !blobCache->areBlobCacheFuncsSet())
+    {
+        return false;
+    }
+
+    egl::BlobCache::Value value;
+    if (!blobCache->get(scratchBuffer, key, &value) || value.size() == 0 ||
+        value.size() % sizeof(uint32_t) != 0)
+    {
+        return false;
+    }
+
+    spirvOut->resize(value.size() / sizeof(uint32_t));
+    memcpy(spirvOut->data(), value.data(), value.size());
+
+    GetSpirvCache()->put(key, *spirvOut);
+    return true;
+}
+
+void StoreSpirv(const egl::BlobCache::Key &key,
+                const std::vector<uint32_t> &spirv,
+                egl::BlobCache *blobCache)
+{
+    GetSpirvCache()->put(key, spirv);
+
+    if (!blobCache || !blobCache->areBlobCacheFuncsSet())
+    {
+        return;
+    }
+
+    angle::MemoryBuffer spirvBlob;
+    if (!spirvBlob.resize(spirv.size() * sizeof(uint32_t)))
+    {
+        return;
+    }
+    memcpy(spirvBlob.data(), spirv.data(), spirvBlob.size());
+    blobCache->put(key, std::move(spirvBlob));
+}
+
+// Parses one shader stage and generates its SPIR-V. Every stage gets its own glslang::TShader
+// and glslang::TProgram so stages can be compiled on separate threads. The interface between
+// stages has already been validated by the front-end when the program was linked.
+class CompileStageTask final : public angle::Closure
+{
+  public:
+    CompileStageTask(const TBuiltInResource &builtInResources,
+                     gl::ShaderType shaderType,
+                     const std::string &source)
+        : mBuiltInResources(builtInResources),
+          mShaderType(shaderType),
+          mSource(source),
+          mSucceeded(false)
+    {}
+
+    void operator()() override
+    {
+        // Enable SPIR-V and Vulkan rules when parsing GLSL
+        EShMessages messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules);
+
+        glslang::TShader shader(kShLanguageMap[mShaderType]);
+        glslang::TProgram program;
+
+        const char *shaderString = mSource.c_str();
+        int shaderLength         = static_cast<int>(mSource.size());
+
+        shader.setStringsWithLengths(&shaderString, &shaderLength, 1);
+        shader.setEntryPoint("main");
+
+        if (!shader.parse(&mBuiltInResources, 450, ECoreProfile, false, false, messages))
         {
-            continue;
+            ERR() << "Internal error parsing Vulkan shader corresponding to " << mShaderType
+                  << ":\n"
+                  << shader.getInfoLog() << "\n"
+                  << shader.getInfoDebugLog() << "\n";
+            return;
+        }
+
+        program.addShader(&shader);
+        if (!program.link(messages))
+        {
+            ERR() << "Internal error linking Vulkan shader corresponding to " << mShaderType
+                  << ":\n"
+                  << program.getInfoLog() << "\n";
+            return;
         }
 
-        const char *shaderString = shaderSources[shaderType].c_str();
-        int shaderLength         = static_cast<int>(shaderSources[shaderType].size());
+        glslang::GlslangToSpv(*program.getIntermediate(kShLanguageMap[mShaderType]), mSpirv);
+        mSucceeded = true;
+    }
+
+    bool succeeded() const { return mSucceeded; }
+    std::vector<uint32_t> &getSpirv() { return mSpirv; }
+
+  private:
+    const TBuiltInResource &mBuiltInResources;
+    gl::ShaderType mShaderType;
+    const std::string &mSource;
+
+    bool mSucceeded;
+    std::vector<uint32_t> mSpirv;
+};
+
+angle::Result CompileShaders(GlslangErrorCallback callback,
+                             const TBuiltInResource &builtInResources,
+                             const gl::ShaderMap<std::string> &shaderSources,
+                             gl::ShaderBitSet shadersToCompile,
+                             std::shared_ptr<angle::WorkerThreadPool> workerPool,
+                             gl::ShaderMap<std::vector<uint32_t>> *shaderCodeOut)
+{
+    gl::ShaderMap<std::shared_ptr<CompileStageTask>> tasks;
+    gl::ShaderMap<std::shared_ptr<angle::WaitableEvent>> events;
 
-        glslang::TShader *shader = shaders[shaderType];
-        shader->setStringsWithLengths(&shaderString, &shaderLength, 1);
-        shader->setEntryPoint("main");
+    // The first stage is compiled on this thread while the workers take the rest.
+    const gl::ShaderType firstShaderType = *shadersToCompile.begin();
+    const bool postToWorkers             = workerPool && workerPool->isAsync();
 
-        bool result = shader->parse(&builtInResources, 450, ECoreProfile, false, false, messages);
-        if (!result)
+    for (const gl::ShaderType shaderType : shadersToCompile)
+    {
+        tasks[shaderType] = std::make_shared<CompileStageTask>(builtInResources, shaderType,
+                                                               shaderSources[shaderType]);
+        if (postToWorkers && shaderType != firstShaderType)
         {
-            ERR() << "Internal error parsing Vulkan shader corresponding to " << shaderType << ":\n"
-                  << shader->getInfoLog() << "\n"
-                  << shader->getInfoDebugLog() << "\n";
-            ANGLE_GLSLANG_CHECK(callback, false, GlslangError::InvalidShader);
+            events[shaderType] = angle::WorkerThreadPool::PostWorkerTask(
+                workerPool, tasks[shaderType], angle::WorkerTaskPriority::Link);
         }
+    }
 
-        program.addShader(shader);
+    for (const gl::ShaderType shaderType : shadersToCompile)
+    {
+        // Tasks that haven't started are run here instead. This also avoids waiting on tasks
+        // queued behind the caller when it is running on a worker itself.
+        std::shared_ptr<angle::WaitableEvent> &event = events[shaderType];
+        if (!event || event->cancel())
+        {
+            (*tasks[shaderType])();
+        }
+        else
+        {
+            event->wait();
+        }
     }
 
-    bool linkResult = program.link(messages);
-    if (!linkResult)
+    for (const gl::ShaderType shaderType : shadersToCompile)
     {
-        ERR() << "Internal error linking Vulkan shaders:\n" << program.getInfoLog() << "\n";
-        ANGLE_GLSLANG_CHECK(callback, false, GlslangError::InvalidShader);
+        ANGLE_GLSLANG_CHECK(callback, tasks[shaderType]->succeeded(),
+                            GlslangError::InvalidShader);
+        (*shaderCodeOut)[shaderType] = std::move(tasks[shaderType]->getSpirv());
     }
 
+    return angle::Result::Continue;
+}
+
+angle::Result GetShaderSpirvCode(GlslangErrorCallback callback,
+                                 const gl::Caps &glCaps,
+                                 const gl::ShaderMap<std::string> &shaderSources,
+                                 egl::BlobCache *blobCache,
+                                 angle::ScratchBuffer *scratchBuffer,
+                                 std::shared_ptr<angle::WorkerThreadPool> workerPool,
+                                 gl::ShaderMap<std::vector<uint32_t>> *shaderCodeOut)
+{
+    TBuiltInResource builtInResources(glslang::DefaultTBuiltInResource);
+    GetBuiltInResourcesFromCaps(glCaps, &builtInResources);
+
+    gl::ShaderMap<egl::BlobCache::Key> spirvKeys;
+    gl::ShaderBitSet shadersToCompile;
+
     for (const gl::ShaderType shaderType : gl::AllShaderTypes())
     {
         if (shaderSources[shaderType].empty())
@@ -1000,8 +1189,26 @@ angle::Result GetShaderSpirvCode(GlslangErrorCallback callback,
             continue;
         }
 
-        glslang::TIntermediate *intermediate = program.getIntermediate(kShLanguageMap[shaderType]);
-        glslang::GlslangToSpv(*intermediate, (*shaderCodeOut)[shaderType]);
+        ComputeSpirvKey(shaderType, shaderSources[shaderType], builtInResources,
+                        &spirvKeys[shaderType]);
+        if (!LoadCachedSpirv(spirvKeys[shaderType], blobCache, scratchBuffer,
+                             &(*shaderCodeOut)[shaderType]))
+        {
+            shadersToCompile.set(shaderType);
+        }
+    }
+
+    if (shadersToCompile.none())
+    {
+        return angle::Result::Continue;
+    }
+
+    ANGLE_TRY(CompileShaders(callback, builtInResources, shaderSources, shadersToCompile,
+                             workerPool, shaderCodeOut));
+
+    for (const gl::ShaderType shaderType : shadersToCompile)
+    {
+        StoreSpirv(spirvKeys[shaderType], (*shaderCodeOut)[shaderType], blobCache);
     }
 
     return angle::Result::Continue;
@@ -1128,6 +1335,9 @@ angle::Result GlslangGetShaderSpirvCode(GlslangErrorCallback callback,
                                         bool enableLineRasterEmulation,
                                         bool enableXfbEmulation,
                                         const gl::ShaderMap<std::string> &shaderSources,
+                                        egl::BlobCache *blobCache,
+                                        angle::ScratchBuffer *scratchBuffer,
+                                        std::shared_ptr<angle::WorkerThreadPool> workerPool,
                                         gl::ShaderMap<std::vector<uint32_t>> *shaderCodeOut)
 {
     if (enableLineRasterEmulation || enableXfbEmulation)
@@ -1158,11 +1368,13 @@ angle::Result GlslangGetShaderSpirvCode(GlslangErrorCallback callback,
                                 GlslangError::InvalidShader);
         }
 
-        return GetShaderSpirvCode(callback, glCaps, patchedSources, shaderCodeOut);
+        return GetShaderSpirvCode(callback, glCaps, patchedSources, blobCache, scratchBuffer,
+                                  workerPool, shaderCodeOut);
     }
     else
     {
-        return GetShaderSpirvCode(callback, glCaps, shaderSources, shaderCodeOut);
+        return GetShaderSpirvCode(callback, glCaps, shaderSources, blobCache, scratchBuffer,
+                                  workerPool, shaderCodeOut);
     }
 }
 }  // namespace rx
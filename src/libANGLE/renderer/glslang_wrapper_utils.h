@@ -13,6 +13,17 @@
 
 #include "libANGLE/renderer/ProgramImpl.h"
 
+namespace angle
+{
+class ScratchBuffer;
+class WorkerThreadPool;
+}  // namespace angle
+
+namespace egl
+{
+class BlobCache;
+}  // namespace egl
+
 namespace rx
 {
 enum class GlslangError
@@ -51,11 +62,19 @@ void GlslangGetShaderSource(const GlslangSourceOptions &options,
                             const gl::ProgramLinkedResources &resources,
                             gl::ShaderMap<std::string> *shaderSourcesOut);
 
+// The SPIR-V of each shader stage is cached in memory by the hash of the stage's final source. If
+// the application has set blob cache callbacks, |blobCache| is also used to keep it across runs.
+// |blobCache| and |scratchBuffer| are nullable, and must only be used under the global lock.
+// Stages that miss the cache are compiled in parallel on |workerPool| when it's non-null and
+// asynchronous.
 angle::Result GlslangGetShaderSpirvCode(GlslangErrorCallback callback,
                                         const gl::Caps &glCaps,
                                         bool enableLineRasterEmulation,
                                         bool enableXfbEmulation,
                                         const gl::ShaderMap<std::string> &shaderSources,
+                                        egl::BlobCache *blobCache,
+                                        angle::ScratchBuffer *scratchBuffer,
+                                        std::shared_ptr<angle::WorkerThreadPool> workerPool,
                                         gl::ShaderMap<std::vector<uint32_t>> *shaderCodesOut);
 
 }  // namespace rx
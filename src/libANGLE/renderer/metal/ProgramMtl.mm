@@ -346,7 +346,8 @@ angle::Result ProgramMtl::linkImpl(const gl::Context *glContext,
     gl::ShaderMap<std::vector<uint32_t>> shaderCodes;
     std::vector<uint32_t> xfbOnlyVsCode;
     ANGLE_TRY(mtl::GlslangGetShaderSpirvCode(contextMtl, contextMtl->getCaps(), mState, false,
-                                             shaderSources, &shaderCodes, &xfbOnlyVsCode));
+                                             shaderSources, glContext->getWorkerThreadPool(),
+                                             &shaderCodes, &xfbOnlyVsCode));
 
     // Convert spirv code to MSL
     ANGLE_TRY(mtl::SpirvCodeToMsl(contextMtl, mState, &shaderCodes, &xfbOnlyVsCode,
@@ -54,6 +54,7 @@ angle::Result GlslangGetShaderSpirvCode(
     const gl::ProgramState &programState,
     bool enableLineRasterEmulation,
     const gl::ShaderMap<std::string> &shaderSources,
+    std::shared_ptr<angle::WorkerThreadPool> workerPool,
     gl::ShaderMap<std::vector<uint32_t>> *shaderCodeOut,
     std::vector<uint32_t> *xfbOnlyShaderCodeOut /** nullable */);
 
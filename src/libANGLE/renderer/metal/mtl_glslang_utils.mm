@@ -1186,13 +1186,15 @@ angle::Result GlslangGetShaderSpirvCode(ErrorHandler *context,
                                         const gl::ProgramState &programState,
                                         bool enableLineRasterEmulation,
                                         const gl::ShaderMap<std::string> &shaderSources,
+                                        std::shared_ptr<angle::WorkerThreadPool> workerPool,
                                         gl::ShaderMap<std::vector<uint32_t>> *shaderCodeOut,
                                         std::vector<uint32_t> *xfbOnlyShaderCodeOut /** nullable */)
 {
     // Normal version without XFB emulation
     ANGLE_TRY(rx::GlslangGetShaderSpirvCode(
         [context](GlslangError error) { return HandleError(context, error); }, glCaps,
-        enableLineRasterEmulation, /* enableXfbEmulation */ false, shaderSources, shaderCodeOut));
+        enableLineRasterEmulation, /* enableXfbEmulation */ false, shaderSources,
+        /* blobCache */ nullptr, /* scratchBuffer */ nullptr, workerPool, shaderCodeOut));
 
     // Metal doesn't allow vertex shader to write to both buffers and stage output. So need a
     // special version with only XFB emulation.
@@ -1205,7 +1207,7 @@ angle::Result GlslangGetShaderSpirvCode(ErrorHandler *context,
         ANGLE_TRY(rx::GlslangGetShaderSpirvCode(
             [context](GlslangError error) { return HandleError(context, error); }, glCaps,
             enableLineRasterEmulation, /* enableXfbEmulation */ true, vsOnlySrcMap,
-            &vsOnlyCodeMap));
+            /* blobCache */ nullptr, /* scratchBuffer */ nullptr, workerPool, &vsOnlyCodeMap));
         *xfbOnlyShaderCodeOut = std::move(vsOnlyCodeMap[gl::ShaderType::Vertex]);
     }
 
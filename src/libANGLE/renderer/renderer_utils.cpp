@@ -9,12 +9,14 @@
 
 #include "libANGLE/renderer/renderer_utils.h"
 
+#include "anglebase/no_destructor.h"
 #include "image_util/copyimage.h"
 #include "image_util/imageformats.h"
 
 #include "libANGLE/AttributeMap.h"
 #include "libANGLE/Context.h"
 #include "libANGLE/Display.h"
+#include "libANGLE/WorkerThread.h"
 #include "libANGLE/formatutils.h"
 #include "libANGLE/renderer/ContextImpl.h"
 #include "libANGLE/renderer/Format.h"
@@ -22,6 +24,10 @@
 #include "platform/Feature.h"
 
 #include <string.h>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <vector>
 #include "common/utilities.h"
 
 namespace rx
@@ -101,6 +107,406 @@ void WriteFloatColor(const gl::ColorF &color,
     colorWriteFunction(reinterpret_cast<const uint8_t *>(&color), destPixelData);
 }
 
+// CopyImageCHROMIUM has row kernels for the formats that are commonly copied, which inline the
+// reads, the alpha conversion and the writes. They do the same math as the ReadColor and
+// WriteColor functions of these formats, so the results are bit-exact with the generic path.
+//
+// Copies between 8-bit normalized formats don't convert to float at all. Converting such a
+// channel to float and back gives the same value, and the alpha conversions are looked up in
+// tables computed with the float math.
+struct RGBA8Pixel
+{
+    static constexpr size_t kPixelBytes = 4;
+    static constexpr bool kIsUnorm8     = true;
+
+    static void Read(const uint8_t *source, gl::ColorF *color)
+    {
+        color->red   = gl::normalizedToFloat(source[0]);
+        color->green = gl::normalizedToFloat(source[1]);
+        color->blue  = gl::normalizedToFloat(source[2]);
+        color->alpha = gl::normalizedToFloat(source[3]);
+    }
+
+    static void Write(const gl::ColorF &color, uint8_t *dest)
+    {
+        dest[0] = gl::floatToNormalized<uint8_t>(color.red);
+        dest[1] = gl::floatToNormalized<uint8_t>(color.green);
+        dest[2] = gl::floatToNormalized<uint8_t>(color.blue);
+        dest[3] = gl::floatToNormalized<uint8_t>(color.alpha);
+    }
+
+    static void ReadUnorm8(const uint8_t *source, uint8_t *rgba)
+    {
+        rgba[0] = source[0];
+        rgba[1] = source[1];
+        rgba[2] = source[2];
+        rgba[3] = source[3];
+    }
+
+    static void WriteUnorm8(const uint8_t *rgba, uint8_t *dest)
+    {
+        dest[0] = rgba[0];
+        dest[1] = rgba[1];
+        dest[2] = rgba[2];
+        dest[3] = rgba[3];
+    }
+};
+
+struct BGRA8Pixel
+{
+    static constexpr size_t kPixelBytes = 4;
+    static constexpr bool kIsUnorm8     = true;
+
+    static void Read(const uint8_t *source, gl::ColorF *color)
+    {
+        color->red   = gl::normalizedToFloat(source[2]);
+        color->green = gl::normalizedToFloat(source[1]);
+        color->blue  = gl::normalizedToFloat(source[0]);
+        color->alpha = gl::normalizedToFloat(source[3]);
+    }
+
+    static void Write(const gl::ColorF &color, uint8_t *dest)
+    {
+        dest[0] = gl::floatToNormalized<uint8_t>(color.blue);
+        dest[1] = gl::floatToNormalized<uint8_t>(color.green);
+        dest[2] = gl::floatToNormalized<uint8_t>(color.red);
+        dest[3] = gl::floatToNormalized<uint8_t>(color.alpha);
+    }
+
+    static void ReadUnorm8(const uint8_t *source, uint8_t *rgba)
+    {
+        rgba[0] = source[2];
+        rgba[1] = source[1];
+        rgba[2] = source[0];
+        rgba[3] = source[3];
+    }
+
+    static void WriteUnorm8(const uint8_t *rgba, uint8_t *dest)
+    {
+        dest[0] = rgba[2];
+        dest[1] = rgba[1];
+        dest[2] = rgba[0];
+        dest[3] = rgba[3];
+    }
+};
+
+struct RGB565Pixel
+{
+    static constexpr size_t kPixelBytes = 2;
+    static constexpr bool kIsUnorm8     = false;
+
+    static void Read(const uint8_t *source, gl::ColorF *color)
+    {
+        uint16_t rgb;
+        memcpy(&rgb, source, sizeof(rgb));
+        color->red   = gl::normalizedToFloat<5>(gl::getShiftedData<5, 11>(rgb));
+        color->green = gl::normalizedToFloat<6>(gl::getShiftedData<6, 5>(rgb));
+        color->blue  = gl::normalizedToFloat<5>(gl::getShiftedData<5, 0>(rgb));
+        color->alpha = 1.0f;
+    }
+
+    static void Write(const gl::ColorF &color, uint8_t *dest)
+    {
+        uint16_t rgb = gl::shiftData<5, 11>(gl::floatToNormalized<5, uint16_t>(color.red)) |
+                       gl::shiftData<6, 5>(gl::floatToNormalized<6, uint16_t>(color.green)) |
+                       gl::shiftData<5, 0>(gl::floatToNormalized<5, uint16_t>(color.blue));
+        memcpy(dest, &rgb, sizeof(rgb));
+    }
+};
+
+struct R8Pixel
+{
+    static constexpr size_t kPixelBytes = 1;
+    static constexpr bool kIsUnorm8     = true;
+
+    static void Read(const uint8_t *source, gl::ColorF *color)
+    {
+        color->red   = gl::normalizedToFloat(source[0]);
+        color->green = 0.0f;
+        color->blue  = 0.0f;
+        color->alpha = 1.0f;
+    }
+
+    static void Write(const gl::ColorF &color, uint8_t *dest)
+    {
+        dest[0] = gl::floatToNormalized<uint8_t>(color.red);
+    }
+
+    static void ReadUnorm8(const uint8_t *source, uint8_t *rgba)
+    {
+        rgba[0] = source[0];
+        rgba[1] = 0;
+        rgba[2] = 0;
+        rgba[3] = 255;
+    }
+
+    static void WriteUnorm8(const uint8_t *rgba, uint8_t *dest) { dest[0] = rgba[0]; }
+};
+
+struct RG8Pixel
+{
+    static constexpr size_t kPixelBytes = 2;
+    static constexpr bool kIsUnorm8     = true;
+
+    static void Read(const uint8_t *source, gl::ColorF *color)
+    {
+        color->red   = gl::normalizedToFloat(source[0]);
+        color->green = gl::normalizedToFloat(source[1]);
+        color->blue  = 0.0f;
+        color->alpha = 1.0f;
+    }
+
+    static void Write(const gl::ColorF &color, uint8_t *dest)
+    {
+        dest[0] = gl::floatToNormalized<uint8_t>(color.red);
+        dest[1] = gl::floatToNormalized<uint8_t>(color.green);
+    }
+
+    static void ReadUnorm8(const uint8_t *source, uint8_t *rgba)
+    {
+        rgba[0] = source[0];
+        rgba[1] = source[1];
+        rgba[2] = 0;
+        rgba[3] = 255;
+    }
+
+    static void WriteUnorm8(const uint8_t *rgba, uint8_t *dest)
+    {
+        dest[0] = rgba[0];
+        dest[1] = rgba[1];
+    }
+};
+
+enum class AlphaConversion
+{
+    Copy,
+    Premultiply,
+    Unmultiply,
+};
+
+// The channel clipping of the destination format, applied without branching so the row kernels
+// don't need a variant per destination format. Clipped channels are set to 0 or 1, which is
+// exact both as a float multiply-add, since the colors are finite, and as 8-bit masks.
+struct ChannelClip
+{
+    gl::ColorF scale;
+    gl::ColorF bias;
+    uint8_t mask[4];
+    uint8_t maskBias[4];
+};
+
+ChannelClip GetChannelClip(GLenum destUnsizedFormat)
+{
+    switch (destUnsizedFormat)
+    {
+        case GL_RED:
+            return {{1.0f, 0.0f, 0.0f, 0.0f},
+                    {0.0f, 0.0f, 0.0f, 1.0f},
+                    {0xFF, 0, 0, 0},
+                    {0, 0, 0, 0xFF}};
+        case GL_RG:
+            return {{1.0f, 1.0f, 0.0f, 0.0f},
+                    {0.0f, 0.0f, 0.0f, 1.0f},
+                    {0xFF, 0xFF, 0, 0},
+                    {0, 0, 0, 0xFF}};
+        case GL_RGB:
+        case GL_LUMINANCE:
+            return {{1.0f, 1.0f, 1.0f, 0.0f},
+                    {0.0f, 0.0f, 0.0f, 1.0f},
+                    {0xFF, 0xFF, 0xFF, 0},
+                    {0, 0, 0, 0xFF}};
+        case GL_ALPHA:
+            return {{0.0f, 0.0f, 0.0f, 1.0f},
+                    {0.0f, 0.0f, 0.0f, 0.0f},
+                    {0, 0, 0, 0xFF},
+                    {0, 0, 0, 0}};
+        default:
+            return {{1.0f, 1.0f, 1.0f, 1.0f},
+                    {0.0f, 0.0f, 0.0f, 0.0f},
+                    {0xFF, 0xFF, 0xFF, 0xFF},
+                    {0, 0, 0, 0}};
+    }
+}
+
+// Results of the alpha conversion of an 8-bit channel, indexed by alpha * 256 + channel.
+using AlphaConversionTable = std::array<uint8_t, 256 * 256>;
+
+AlphaConversionTable BuildAlphaConversionTable(void (*conversionFunction)(gl::ColorF *))
+{
+    AlphaConversionTable table;
+    for (int alpha = 0; alpha < 256; ++alpha)
+    {
+        for (int channel = 0; channel < 256; ++channel)
+        {
+            gl::ColorF color(gl::normalizedToFloat(static_cast<uint8_t>(channel)), 0.0f, 0.0f,
+                             gl::normalizedToFloat(static_cast<uint8_t>(alpha)));
+            conversionFunction(&color);
+            table[alpha * 256 + channel] = gl::floatToNormalized<uint8_t>(color.red);
+        }
+    }
+    return table;
+}
+
+template <AlphaConversion kAlphaConversion>
+const uint8_t *GetAlphaConversionTable()
+{
+    static const angle::base::NoDestructor<AlphaConversionTable> table(BuildAlphaConversionTable(
+        kAlphaConversion == AlphaConversion::Premultiply ? PremultiplyAlpha : UnmultiplyAlpha));
+    return table->data();
+}
+
+template <typename SourcePixel, typename DestPixel, AlphaConversion kAlphaConversion>
+void CopyRowCHROMIUM(const uint8_t *source, uint8_t *dest, size_t width, const ChannelClip &clip)
+{
+    for (size_t x = 0; x < width; ++x)
+    {
+        gl::ColorF color;
+        SourcePixel::Read(source + x * SourcePixel::kPixelBytes, &color);
+
+        if (kAlphaConversion == AlphaConversion::Premultiply)
+        {
+            PremultiplyAlpha(&color);
+        }
+        else if (kAlphaConversion == AlphaConversion::Unmultiply)
+        {
+            UnmultiplyAlpha(&color);
+        }
+
+        color.red   = color.red * clip.scale.red + clip.bias.red;
+        color.green = color.green * clip.scale.green + clip.bias.green;
+        color.blue  = color.blue * clip.scale.blue + clip.bias.blue;
+        color.alpha = color.alpha * clip.scale.alpha + clip.bias.alpha;
+
+        DestPixel::Write(color, dest + x * DestPixel::kPixelBytes);
+    }
+}
+
+template <typename SourcePixel, typename DestPixel, AlphaConversion kAlphaConversion>
+void CopyRowUnorm8CHROMIUM(const uint8_t *source,
+                           uint8_t *dest,
+                           size_t width,
+                           const ChannelClip &clip)
+{
+    const uint8_t *alphaConversionTable = kAlphaConversion == AlphaConversion::Copy
+                                              ? nullptr
+                                              : GetAlphaConversionTable<kAlphaConversion>();
+
+    for (size_t x = 0; x < width; ++x)
+    {
+        uint8_t rgba[4];
+        SourcePixel::ReadUnorm8(source + x * SourcePixel::kPixelBytes, rgba);
+
+        if (kAlphaConversion != AlphaConversion::Copy)
+        {
+            const uint8_t *alphaRow = alphaConversionTable + rgba[3] * 256;
+            rgba[0]                 = alphaRow[rgba[0]];
+            rgba[1]                 = alphaRow[rgba[1]];
+            rgba[2]                 = alphaRow[rgba[2]];
+        }
+
+        for (size_t channel = 0; channel < 4; ++channel)
+        {
+            rgba[channel] = (rgba[channel] & clip.mask[channel]) | clip.maskBias[channel];
+        }
+
+        DestPixel::WriteUnorm8(rgba, dest + x * DestPixel::kPixelBytes);
+    }
+}
+
+using CopyRowFunction = void (*)(const uint8_t *source,
+                                 uint8_t *dest,
+                                 size_t width,
+                                 const ChannelClip &clip);
+
+template <typename SourcePixel, typename DestPixel, AlphaConversion kAlphaConversion>
+CopyRowFunction GetCopyRowFunction(std::true_type isUnorm8)
+{
+    return CopyRowUnorm8CHROMIUM<SourcePixel, DestPixel, kAlphaConversion>;
+}
+
+template <typename SourcePixel, typename DestPixel, AlphaConversion kAlphaConversion>
+CopyRowFunction GetCopyRowFunction(std::false_type isUnorm8)
+{
+    return CopyRowCHROMIUM<SourcePixel, DestPixel, kAlphaConversion>;
+}
+
+template <typename SourcePixel, typename DestPixel>
+CopyRowFunction GetCopyRowFunction(AlphaConversion alphaConversion)
+{
+    using IsUnorm8 =
+        std::integral_constant<bool, SourcePixel::kIsUnorm8 && DestPixel::kIsUnorm8>;
+
+    switch (alphaConversion)
+    {
+        case AlphaConversion::Copy:
+            return GetCopyRowFunction<SourcePixel, DestPixel, AlphaConversion::Copy>(IsUnorm8());
+        case AlphaConversion::Premultiply:
+            return GetCopyRowFunction<SourcePixel, DestPixel, AlphaConversion::Premultiply>(
+                IsUnorm8());
+        case AlphaConversion::Unmultiply:
+            return GetCopyRowFunction<SourcePixel, DestPixel, AlphaConversion::Unmultiply>(
+                IsUnorm8());
+        default:
+            UNREACHABLE();
+            return nullptr;
+    }
+}
+
+template <typename SourcePixel>
+CopyRowFunction GetCopyRowFunction(PixelWriteFunction pixelWriteFunction,
+                                   AlphaConversion alphaConversion)
+{
+    if (pixelWriteFunction == angle::WriteColor<angle::R8G8B8A8, GLfloat>)
+    {
+        return GetCopyRowFunction<SourcePixel, RGBA8Pixel>(alphaConversion);
+    }
+    if (pixelWriteFunction == angle::WriteColor<angle::B8G8R8A8, GLfloat>)
+    {
+        return GetCopyRowFunction<SourcePixel, BGRA8Pixel>(alphaConversion);
+    }
+    if (pixelWriteFunction == angle::WriteColor<angle::R5G6B5, GLfloat>)
+    {
+        return GetCopyRowFunction<SourcePixel, RGB565Pixel>(alphaConversion);
+    }
+    if (pixelWriteFunction == angle::WriteColor<angle::R8, GLfloat>)
+    {
+        return GetCopyRowFunction<SourcePixel, R8Pixel>(alphaConversion);
+    }
+    if (pixelWriteFunction == angle::WriteColor<angle::R8G8, GLfloat>)
+    {
+        return GetCopyRowFunction<SourcePixel, RG8Pixel>(alphaConversion);
+    }
+    return nullptr;
+}
+
+// Returns nullptr if there is no row kernel for the formats.
+CopyRowFunction GetCopyRowFunction(PixelReadFunction pixelReadFunction,
+                                   PixelWriteFunction pixelWriteFunction,
+                                   AlphaConversion alphaConversion)
+{
+    if (pixelReadFunction == angle::ReadColor<angle::R8G8B8A8, GLfloat>)
+    {
+        return GetCopyRowFunction<RGBA8Pixel>(pixelWriteFunction, alphaConversion);
+    }
+    if (pixelReadFunction == angle::ReadColor<angle::B8G8R8A8, GLfloat>)
+    {
+        return GetCopyRowFunction<BGRA8Pixel>(pixelWriteFunction, alphaConversion);
+    }
+    if (pixelReadFunction == angle::ReadColor<angle::R5G6B5, GLfloat>)
+    {
+        return GetCopyRowFunction<RGB565Pixel>(pixelWriteFunction, alphaConversion);
+    }
+    if (pixelReadFunction == angle::ReadColor<angle::R8, GLfloat>)
+    {
+        return GetCopyRowFunction<R8Pixel>(pixelWriteFunction, alphaConversion);
+    }
+    if (pixelReadFunction == angle::ReadColor<angle::R8G8, GLfloat>)
+    {
+        return GetCopyRowFunction<RG8Pixel>(pixelWriteFunction, alphaConversion);
+    }
+    return nullptr;
+}
+
 template <int cols, int rows, bool IsColumnMajor>
 inline int GetFlattenedIndex(int col, int row)
 {
@@ -187,6 +593,89 @@ void SetFloatUniformMatrixFast(unsigned int arrayElementOffset,
     memcpy(targetData, valueData, matrixSize * count);
 }
 
+// Loads of images smaller than this are not split, as waking up the workers costs more than the
+// conversion itself.
+constexpr size_t kMinParallelLoadBytes = 4 * 1024 * 1024;
+// The bands are small enough for the threads to balance their work, but large enough to amortize
+// claiming them.
+constexpr size_t kLoadBandBytes = 512 * 1024;
+constexpr size_t kMaxLoadBands  = 64;
+// The calling thread loads bands too, so at most this many workers help it.
+constexpr size_t kMaxLoadHelperTasks = 7;
+
+// The bands of rows of an image being loaded in parallel. The calling thread and the workers claim
+// bands until none are left, so a worker that starts late does not delay the load.
+class ParallelImageLoad final : angle::NonCopyable
+{
+  public:
+    ParallelImageLoad(LoadImageFunction loadFunction,
+                      size_t width,
+                      size_t height,
+                      size_t depth,
+                      const uint8_t *input,
+                      size_t inputRowPitch,
+                      size_t inputDepthPitch,
+                      uint8_t *output,
+                      size_t outputRowPitch,
+                      size_t outputDepthPitch,
+                      size_t bandCount)
+        : mLoadFunction(loadFunction),
+          mWidth(width),
+          mHeight(height),
+          mDepth(depth),
+          mInput(input),
+          mInputRowPitch(inputRowPitch),
+          mInputDepthPitch(inputDepthPitch),
+          mOutput(output),
+          mOutputRowPitch(outputRowPitch),
+          mOutputDepthPitch(outputDepthPitch),
+          mRowsPerBand((height + bandCount - 1) / bandCount),
+          mBandCount((height + mRowsPerBand - 1) / mRowsPerBand),
+          mNextBand(0)
+    {}
+
+    size_t getBandCount() const { return mBandCount; }
+
+    void loadRemainingBands()
+    {
+        size_t band;
+        while ((band = mNextBand.fetch_add(1, std::memory_order_relaxed)) < mBandCount)
+        {
+            size_t y          = band * mRowsPerBand;
+            size_t bandHeight = std::min(mRowsPerBand, mHeight - y);
+            mLoadFunction(mWidth, bandHeight, mDepth, mInput + y * mInputRowPitch, mInputRowPitch,
+                          mInputDepthPitch, mOutput + y * mOutputRowPitch, mOutputRowPitch,
+                          mOutputDepthPitch);
+        }
+    }
+
+  private:
+    LoadImageFunction mLoadFunction;
+    size_t mWidth;
+    size_t mHeight;
+    size_t mDepth;
+    const uint8_t *mInput;
+    size_t mInputRowPitch;
+    size_t mInputDepthPitch;
+    uint8_t *mOutput;
+    size_t mOutputRowPitch;
+    size_t mOutputDepthPitch;
+    size_t mRowsPerBand;
+    size_t mBandCount;
+    std::atomic<size_t> mNextBand;
+};
+
+class ParallelImageLoadTask final : public angle::Closure
+{
+  public:
+    ParallelImageLoadTask(ParallelImageLoad *load) : mLoad(load) {}
+
+    void operator()() override { mLoad->loadRemainingBands(); }
+
+  private:
+    ParallelImageLoad *mLoad;
+};
+
 }  // anonymous namespace
 
 PackPixelsParams::PackPixelsParams()
@@ -328,6 +817,59 @@ bool ShouldUseVirtualizedContexts(const egl::AttributeMap &attribs, bool default
     }
 }
 
+void LoadImageParallel(const std::shared_ptr<angle::WorkerThreadPool> &workerPool,
+                       LoadImageFunction loadFunction,
+                       size_t width,
+                       size_t height,
+                       size_t depth,
+                       const uint8_t *input,
+                       size_t inputRowPitch,
+                       size_t inputDepthPitch,
+                       uint8_t *output,
+                       size_t outputRowPitch,
+                       size_t outputDepthPitch)
+{
+    size_t outputBytes = outputRowPitch * height * depth;
+    if (!workerPool || !workerPool->isAsync() || height < 2 ||
+        outputBytes < kMinParallelLoadBytes)
+    {
+        loadFunction(width, height, depth, input, inputRowPitch, inputDepthPitch, output,
+                     outputRowPitch, outputDepthPitch);
+        return;
+    }
+
+    size_t bandCount = std::min({outputBytes / kLoadBandBytes, kMaxLoadBands, height});
+    ParallelImageLoad load(loadFunction, width, height, depth, input, inputRowPitch,
+                           inputDepthPitch, output, outputRowPitch, outputDepthPitch, bandCount);
+
+    // The load blocks the calling thread, so the helpers are scheduled before any other work.
+    size_t helperCount = std::min(load.getBandCount() - 1, kMaxLoadHelperTasks);
+    std::vector<std::shared_ptr<angle::WaitableEvent>> helperEvents;
+    helperEvents.reserve(helperCount);
+    for (size_t helperIndex = 0; helperIndex < helperCount; ++helperIndex)
+    {
+        std::shared_ptr<angle::WaitableEvent> event = angle::WorkerThreadPool::PostWorkerTask(
+            workerPool, std::make_shared<ParallelImageLoadTask>(&load),
+            angle::WorkerTaskPriority::Upload);
+        if (event)
+        {
+            helperEvents.push_back(event);
+        }
+    }
+
+    load.loadRemainingBands();
+
+    // All the bands are claimed at this point. Helpers that haven't started are dropped, and the
+    // ones still loading their last band are waited on, so the output is complete on return.
+    for (std::shared_ptr<angle::WaitableEvent> &event : helperEvents)
+    {
+        if (!event->cancel())
+        {
+            event->wait();
+        }
+    }
+}
+
 void CopyImageCHROMIUM(const uint8_t *sourceData,
                        size_t sourceRowPitch,
                        size_t sourcePixelBytes,
@@ -347,20 +889,43 @@ void CopyImageCHROMIUM(const uint8_t *sourceData,
                        bool unpackPremultiplyAlpha,
                        bool unpackUnmultiplyAlpha)
 {
+    AlphaConversion alphaConversion       = AlphaConversion::Copy;
     using ConversionFunction              = void (*)(gl::ColorF *);
     ConversionFunction conversionFunction = CopyColor;
     if (unpackPremultiplyAlpha != unpackUnmultiplyAlpha)
     {
         if (unpackPremultiplyAlpha)
         {
+            alphaConversion    = AlphaConversion::Premultiply;
             conversionFunction = PremultiplyAlpha;
         }
         else
         {
+            alphaConversion    = AlphaConversion::Unmultiply;
             conversionFunction = UnmultiplyAlpha;
         }
     }
 
+    // Unsigned integer destinations are written through ColorUI, which the row kernels don't do.
+    CopyRowFunction copyRowFunction =
+        (destComponentType == GL_UNSIGNED_INT)
+            ? nullptr
+            : GetCopyRowFunction(pixelReadFunction, pixelWriteFunction, alphaConversion);
+    if (copyRowFunction != nullptr)
+    {
+        const ChannelClip clip = GetChannelClip(destUnsizedFormat);
+        for (size_t z = 0; z < depth; z++)
+        {
+            for (size_t y = 0; y < height; y++)
+            {
+                size_t destY = unpackFlipY ? (height - 1 - y) : y;
+                copyRowFunction(sourceData + y * sourceRowPitch + z * sourceDepthPitch,
+                                destData + destY * destRowPitch + z * destDepthPitch, width, clip);
+            }
+        }
+        return;
+    }
+
     auto clipChannelsFunction = ClipChannelsNoOp;
     switch (destUnsizedFormat)
     {
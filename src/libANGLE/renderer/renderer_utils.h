@@ -11,10 +11,14 @@
 #define LIBANGLE_RENDERER_RENDERER_UTILS_H_
 
 #include <cstdint>
+#include <cstring>
 
+#include <algorithm>
 #include <atomic>
 #include <limits>
 #include <map>
+#include <memory>
+#include <type_traits>
 
 #include "common/angleutils.h"
 #include "common/utilities.h"
@@ -25,6 +29,7 @@ namespace angle
 struct FeatureSetBase;
 struct Format;
 enum class FormatID;
+class WorkerThreadPool;
 }  // namespace angle
 
 namespace gl
@@ -210,6 +215,21 @@ struct LoadImageFunctionInfo
 
 using LoadFunctionMap = LoadImageFunctionInfo (*)(GLenum);
 
+// Calls the load function of an uncompressed format. Large images are split into bands of rows,
+// which the worker threads load together with the calling thread. Returns once the whole image is
+// loaded.
+void LoadImageParallel(const std::shared_ptr<angle::WorkerThreadPool> &workerPool,
+                       LoadImageFunction loadFunction,
+                       size_t width,
+                       size_t height,
+                       size_t depth,
+                       const uint8_t *input,
+                       size_t inputRowPitch,
+                       size_t inputDepthPitch,
+                       uint8_t *output,
+                       size_t outputRowPitch,
+                       size_t outputDepthPitch);
+
 bool ShouldUseDebugLayers(const egl::AttributeMap &attribs);
 bool ShouldUseVirtualizedContexts(const egl::AttributeMap &attribs, bool defaultValue);
 
@@ -316,90 +336,67 @@ gl::Rectangle ClipRectToScissor(const gl::State &glState, const gl::Rectangle &r
 void OverrideFeaturesWithDisplayState(angle::FeatureSetBase *features,
                                       const egl::DisplayState &state);
 
-template <typename In>
-uint32_t LineLoopRestartIndexCountHelper(GLsizei indexCount, const uint8_t *srcPtr)
+// The most indices CopyLineLoopIndicesWithRestart() writes for indexCount input indices. A loop of
+// a single vertex takes three indices once it's closed and restarted, and the last loop isn't
+// followed by a restart.
+inline uint32_t GetLineLoopWithRestartIndexCountUpperBound(GLsizei indexCount)
 {
-    constexpr In restartIndex = gl::GetPrimitiveRestartIndexFromType<In>();
-    const In *inIndices       = reinterpret_cast<const In *>(srcPtr);
-    uint32_t numIndices       = 0;
-    // See CopyLineLoopIndicesWithRestart() below for more info on how
-    // numIndices is calculated.
-    GLsizei loopStartIndex = 0;
-    for (GLsizei curIndex = 0; curIndex < indexCount; curIndex++)
-    {
-        In vertex = inIndices[curIndex];
-        if (vertex != restartIndex)
-        {
-            numIndices++;
-        }
-        else
-        {
-            if (curIndex > loopStartIndex)
-            {
-                numIndices += 2;
-            }
-            loopStartIndex = curIndex + 1;
-        }
-    }
-    if (indexCount > loopStartIndex)
-    {
-        numIndices++;
-    }
-    return numIndices;
+    uint32_t count = static_cast<uint32_t>(indexCount);
+    return count + count / 2 + 1;
 }
 
-inline uint32_t GetLineLoopWithRestartIndexCount(gl::DrawElementsType glIndexType,
-                                                 GLsizei indexCount,
-                                                 const uint8_t *srcPtr)
-{
-    switch (glIndexType)
-    {
-        case gl::DrawElementsType::UnsignedByte:
-            return LineLoopRestartIndexCountHelper<uint8_t>(indexCount, srcPtr);
-        case gl::DrawElementsType::UnsignedShort:
-            return LineLoopRestartIndexCountHelper<uint16_t>(indexCount, srcPtr);
-        case gl::DrawElementsType::UnsignedInt:
-            return LineLoopRestartIndexCountHelper<uint32_t>(indexCount, srcPtr);
-        default:
-            UNREACHABLE();
-            return 0;
-    }
-}
-
-// Writes the line-strip vertices for a line loop to outPtr,
-// where outLimit is calculated as in GetPrimitiveRestartIndexCount.
+// Writes the line-strip vertices for a line loop to outPtr, and returns how many were written.
+// Each non-empty loop is closed with its first vertex, followed by a restart if a restart index
+// ended it. outPtr must have room for GetLineLoopWithRestartIndexCountUpperBound() indices.
 template <typename In, typename Out>
-void CopyLineLoopIndicesWithRestart(GLsizei indexCount, const uint8_t *srcPtr, uint8_t *outPtr)
+uint32_t CopyLineLoopIndicesWithRestart(GLsizei indexCount, const uint8_t *srcPtr, uint8_t *outPtr)
 {
     constexpr In restartIndex     = gl::GetPrimitiveRestartIndexFromType<In>();
     constexpr Out outRestartIndex = gl::GetPrimitiveRestartIndexFromType<Out>();
     const In *inIndices           = reinterpret_cast<const In *>(srcPtr);
+    const In *inEnd               = inIndices + indexCount;
     Out *outIndices               = reinterpret_cast<Out *>(outPtr);
-    GLsizei loopStartIndex        = 0;
-    for (GLsizei curIndex = 0; curIndex < indexCount; curIndex++)
+    Out *outStart                 = outIndices;
+
+    const In *loopStart = inIndices;
+    while (loopStart < inEnd)
     {
-        In vertex = inIndices[curIndex];
-        if (vertex != restartIndex)
-        {
-            *(outIndices++) = static_cast<Out>(vertex);
-        }
-        else
+        // Loops are usually long, so they are copied in bulk instead of testing each index on the
+        // way.
+        const In *loopEnd = std::find(loopStart, inEnd, restartIndex);
+        size_t loopLength = loopEnd - loopStart;
+        if (loopLength > 0)
         {
-            if (curIndex > loopStartIndex)
+            if (std::is_same<In, Out>::value)
+            {
+                memcpy(outIndices, loopStart, loopLength * sizeof(In));
+            }
+            else
+            {
+                for (size_t index = 0; index < loopLength; ++index)
+                {
+                    outIndices[index] = static_cast<Out>(loopStart[index]);
+                }
+            }
+            outIndices += loopLength;
+
+            // Close the loop.
+            *(outIndices++) = static_cast<Out>(*loopStart);
+            if (loopEnd != inEnd)
             {
-                // Emit an extra vertex only if the loop is not empty.
-                *(outIndices++) = inIndices[loopStartIndex];
                 // Then restart the strip.
                 *(outIndices++) = outRestartIndex;
             }
-            loopStartIndex = curIndex + 1;
         }
+
+        if (loopEnd == inEnd)
+        {
+            break;
+        }
+        loopStart = loopEnd + 1;
     }
-    if (indexCount > loopStartIndex)
-    {
-        // Close the last loop if not empty.
-        *(outIndices++) = inIndices[loopStartIndex];
-    }
+
+    return static_cast<uint32_t>(outIndices - outStart);
 }
 }  // namespace rx
 
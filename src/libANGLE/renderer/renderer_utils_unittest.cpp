@@ -0,0 +1,305 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// renderer_utils_unittest:
+//   Tests for the helper methods shared by the back-ends.
+//
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/Color.h"
+#include "image_util/loadimage.h"
+#include "libANGLE/WorkerThread.h"
+#include "libANGLE/formatutils.h"
+#include "libANGLE/renderer/Format.h"
+#include "libANGLE/renderer/renderer_utils.h"
+
+namespace rx
+{
+namespace
+{
+// The per-pixel implementation of CopyImageCHROMIUM, which the row kernels must match exactly.
+void CopyImageCHROMIUMReference(const uint8_t *sourceData,
+                                size_t sourceRowPitch,
+                                size_t sourcePixelBytes,
+                                PixelReadFunction pixelReadFunction,
+                                uint8_t *destData,
+                                size_t destRowPitch,
+                                size_t destPixelBytes,
+                                PixelWriteFunction pixelWriteFunction,
+                                GLenum destUnsizedFormat,
+                                size_t width,
+                                size_t height,
+                                bool unpackFlipY,
+                                bool unpackPremultiplyAlpha,
+                                bool unpackUnmultiplyAlpha)
+{
+    for (size_t y = 0; y < height; y++)
+    {
+        for (size_t x = 0; x < width; x++)
+        {
+            gl::ColorF color;
+            pixelReadFunction(sourceData + y * sourceRowPitch + x * sourcePixelBytes,
+                              reinterpret_cast<uint8_t *>(&color));
+
+            if (unpackPremultiplyAlpha && !unpackUnmultiplyAlpha)
+            {
+                color.red *= color.alpha;
+                color.green *= color.alpha;
+                color.blue *= color.alpha;
+            }
+            else if (unpackUnmultiplyAlpha && !unpackPremultiplyAlpha && color.alpha != 0.0f)
+            {
+                float invAlpha = 1.0f / color.alpha;
+                color.red *= invAlpha;
+                color.green *= invAlpha;
+                color.blue *= invAlpha;
+            }
+
+            switch (destUnsizedFormat)
+            {
+                case GL_RED:
+                    color.green = 0.0f;
+                    color.blue  = 0.0f;
+                    color.alpha = 1.0f;
+                    break;
+                case GL_RG:
+                    color.blue  = 0.0f;
+                    color.alpha = 1.0f;
+                    break;
+                case GL_RGB:
+                case GL_LUMINANCE:
+                    color.alpha = 1.0f;
+                    break;
+                case GL_ALPHA:
+                    color.red   = 0.0f;
+                    color.green = 0.0f;
+                    color.blue  = 0.0f;
+                    break;
+            }
+
+            size_t destY = unpackFlipY ? (height - 1 - y) : y;
+            pixelWriteFunction(reinterpret_cast<const uint8_t *>(&color),
+                               destData + destY * destRowPitch + x * destPixelBytes);
+        }
+    }
+}
+
+// Test that CopyImageCHROMIUM gives the same results as the per-pixel implementation for all
+// formats with row kernels, including colors that are not valid premultiplied colors.
+TEST(RendererUtilsTest, CopyImageCHROMIUMMatchesReference)
+{
+    constexpr angle::FormatID kFormats[] = {
+        angle::FormatID::R8G8B8A8_UNORM, angle::FormatID::B8G8R8A8_UNORM,
+        angle::FormatID::R5G6B5_UNORM,   angle::FormatID::R8_UNORM,
+        angle::FormatID::R8G8_UNORM,     angle::FormatID::R8G8B8A8_UNORM_SRGB,
+    };
+    constexpr GLenum kDestUnsizedFormats[] = {GL_RGBA, GL_RGB, GL_RG, GL_RED, GL_ALPHA};
+
+    constexpr size_t kWidth  = 37;
+    constexpr size_t kHeight = 5;
+
+    // Pseudo-random bytes, sized for the largest source row pitch.
+    std::vector<uint8_t> sourceData((kWidth * 4 + 3) * kHeight);
+    uint32_t seed = 1;
+    for (uint8_t &value : sourceData)
+    {
+        seed  = seed * 1664525u + 1013904223u;
+        value = static_cast<uint8_t>(seed >> 24);
+    }
+
+    for (angle::FormatID sourceFormatID : kFormats)
+    {
+        const angle::Format &sourceFormat = angle::Format::Get(sourceFormatID);
+        size_t sourceRowPitch             = kWidth * sourceFormat.pixelBytes + 3;
+
+        for (angle::FormatID destFormatID : kFormats)
+        {
+            const angle::Format &destFormat = angle::Format::Get(destFormatID);
+            size_t destRowPitch             = kWidth * destFormat.pixelBytes + 1;
+
+            for (GLenum destUnsizedFormat : kDestUnsizedFormats)
+            {
+                for (int flags = 0; flags < 8; ++flags)
+                {
+                    bool flipY       = (flags & 1) != 0;
+                    bool premultiply = (flags & 2) != 0;
+                    bool unmultiply  = (flags & 4) != 0;
+
+                    std::vector<uint8_t> expected(destRowPitch * kHeight, 0);
+                    std::vector<uint8_t> actual(destRowPitch * kHeight, 0);
+
+                    CopyImageCHROMIUMReference(
+                        sourceData.data(), sourceRowPitch, sourceFormat.pixelBytes,
+                        sourceFormat.pixelReadFunction, expected.data(), destRowPitch,
+                        destFormat.pixelBytes, destFormat.pixelWriteFunction, destUnsizedFormat,
+                        kWidth, kHeight, flipY, premultiply, unmultiply);
+                    CopyImageCHROMIUM(sourceData.data(), sourceRowPitch, sourceFormat.pixelBytes,
+                                      0, sourceFormat.pixelReadFunction, actual.data(),
+                                      destRowPitch, destFormat.pixelBytes, 0,
+                                      destFormat.pixelWriteFunction, destUnsizedFormat,
+                                      GL_UNSIGNED_NORMALIZED, kWidth, kHeight, 1, flipY,
+                                      premultiply, unmultiply);
+
+                    EXPECT_EQ(expected, actual)
+                        << "source " << static_cast<int>(sourceFormatID) << " dest "
+                        << static_cast<int>(destFormatID) << " unsized format 0x" << std::hex
+                        << destUnsizedFormat << std::dec << " flags " << flags;
+                }
+            }
+        }
+    }
+}
+
+// Test that each slice of a 3D copy is copied.
+TEST(RendererUtilsTest, CopyImageCHROMIUMDepth)
+{
+    const angle::Format &format = angle::Format::Get(angle::FormatID::R8G8B8A8_UNORM);
+
+    constexpr size_t kWidth  = 4;
+    constexpr size_t kHeight = 2;
+    constexpr size_t kDepth  = 3;
+    constexpr size_t kPitch  = kWidth * 4;
+    constexpr size_t kSlice  = kPitch * kHeight;
+
+    std::vector<uint8_t> sourceData(kSlice * kDepth);
+    for (size_t index = 0; index < sourceData.size(); ++index)
+    {
+        sourceData[index] = static_cast<uint8_t>(index);
+    }
+
+    std::vector<uint8_t> destData(sourceData.size(), 0);
+    CopyImageCHROMIUM(sourceData.data(), kPitch, 4, kSlice, format.pixelReadFunction,
+                      destData.data(), kPitch, 4, kSlice, format.pixelWriteFunction, GL_RGBA,
+                      GL_UNSIGNED_NORMALIZED, kWidth, kHeight, kDepth, false, false, false);
+    EXPECT_EQ(sourceData, destData);
+}
+
+// The two-pass line loop conversion that CopyLineLoopIndicesWithRestart replaced.
+template <typename In, typename Out>
+std::vector<Out> LineLoopWithRestartReference(const std::vector<In> &indices)
+{
+    constexpr In restartIndex     = gl::GetPrimitiveRestartIndexFromType<In>();
+    constexpr Out outRestartIndex = gl::GetPrimitiveRestartIndexFromType<Out>();
+
+    std::vector<Out> out;
+    size_t loopStartIndex = 0;
+    for (size_t curIndex = 0; curIndex < indices.size(); curIndex++)
+    {
+        if (indices[curIndex] != restartIndex)
+        {
+            out.push_back(static_cast<Out>(indices[curIndex]));
+        }
+        else
+        {
+            if (curIndex > loopStartIndex)
+            {
+                out.push_back(static_cast<Out>(indices[loopStartIndex]));
+                out.push_back(outRestartIndex);
+            }
+            loopStartIndex = curIndex + 1;
+        }
+    }
+    if (indices.size() > loopStartIndex)
+    {
+        out.push_back(static_cast<Out>(indices[loopStartIndex]));
+    }
+    return out;
+}
+
+template <typename In, typename Out>
+void TestCopyLineLoopIndicesWithRestart()
+{
+    constexpr In restartIndex = gl::GetPrimitiveRestartIndexFromType<In>();
+
+    // A few fixed edge cases, then pseudo-random index sequences: 100 of length 0 to 11 where
+    // about a quarter of the indices are restarts, and 100 of 400 to 499 indices with rare
+    // restarts.
+    std::vector<std::vector<In>> cases = {{}, {restartIndex}, {1}, {1, restartIndex}};
+    uint32_t seed                      = 1;
+    for (int caseIndex = 0; caseIndex < 200; ++caseIndex)
+    {
+        std::vector<In> indices;
+        size_t length = caseIndex < 100 ? caseIndex % 12 : 300 + caseIndex;
+        for (size_t index = 0; index < length; ++index)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            bool restart = caseIndex < 100 ? (seed >> 30) == 0 : (seed >> 24) == 0;
+            indices.push_back(restart ? restartIndex : static_cast<In>((seed >> 8) % 200));
+        }
+        cases.push_back(indices);
+    }
+
+    for (const std::vector<In> &indices : cases)
+    {
+        GLsizei indexCount = static_cast<GLsizei>(indices.size());
+        std::vector<Out> expected = LineLoopWithRestartReference<In, Out>(indices);
+        std::vector<Out> actual(GetLineLoopWithRestartIndexCountUpperBound(indexCount));
+
+        uint32_t actualCount = CopyLineLoopIndicesWithRestart<In, Out>(
+            indexCount, reinterpret_cast<const uint8_t *>(indices.data()),
+            reinterpret_cast<uint8_t *>(actual.data()));
+        ASSERT_LE(actualCount, actual.size());
+        actual.resize(actualCount);
+
+        EXPECT_EQ(expected, actual);
+    }
+}
+
+// Test that the line loop conversion with primitive restart matches the two-pass conversion it
+// replaced, and stays within its upper bound.
+TEST(RendererUtilsTest, CopyLineLoopIndicesWithRestart)
+{
+    TestCopyLineLoopIndicesWithRestart<uint8_t, uint16_t>();
+    TestCopyLineLoopIndicesWithRestart<uint16_t, uint16_t>();
+    TestCopyLineLoopIndicesWithRestart<uint8_t, uint32_t>();
+    TestCopyLineLoopIndicesWithRestart<uint16_t, uint32_t>();
+    TestCopyLineLoopIndicesWithRestart<uint32_t, uint32_t>();
+}
+
+// Test that loading an image in bands on the workers gives the same result as loading it at once,
+// for image sizes that don't split into equal bands.
+TEST(RendererUtilsTest, LoadImageParallel)
+{
+    constexpr LoadImageFunction kLoadFunction = angle::LoadToNative3To4<uint8_t, 0xFF>;
+    constexpr size_t kSizes[][3]              = {{1021, 1027, 1}, {4, 300000, 1}, {513, 67, 31}};
+
+    std::shared_ptr<angle::WorkerThreadPool> pools[] = {angle::WorkerThreadPool::Create(false),
+                                                        angle::WorkerThreadPool::Create(true)};
+    for (const std::shared_ptr<angle::WorkerThreadPool> &pool : pools)
+    {
+        for (const auto &size : kSizes)
+        {
+            size_t width  = size[0];
+            size_t height = size[1];
+            size_t depth  = size[2];
+
+            size_t inputRowPitch    = width * 3 + 1;
+            size_t inputDepthPitch  = inputRowPitch * height;
+            size_t outputRowPitch   = width * 4;
+            size_t outputDepthPitch = outputRowPitch * height;
+
+            std::vector<uint8_t> input(inputDepthPitch * depth);
+            for (size_t index = 0; index < input.size(); ++index)
+            {
+                input[index] = static_cast<uint8_t>(index * 13);
+            }
+
+            std::vector<uint8_t> expected(outputDepthPitch * depth, 0);
+            std::vector<uint8_t> actual(outputDepthPitch * depth, 0);
+            kLoadFunction(width, height, depth, input.data(), inputRowPitch, inputDepthPitch,
+                          expected.data(), outputRowPitch, outputDepthPitch);
+            LoadImageParallel(pool, kLoadFunction, width, height, depth, input.data(),
+                              inputRowPitch, inputDepthPitch, actual.data(), outputRowPitch,
+                              outputDepthPitch);
+
+            EXPECT_EQ(expected, actual) << width << "x" << height << "x" << depth;
+        }
+    }
+}
+}  // anonymous namespace
+}  // namespace rx
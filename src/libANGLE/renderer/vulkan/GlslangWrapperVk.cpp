@@ -10,6 +10,8 @@
 
 #include "libANGLE/renderer/glslang_wrapper_utils.h"
 #include "libANGLE/renderer/vulkan/ContextVk.h"
+#include "libANGLE/renderer/vulkan/DisplayVk.h"
+#include "libANGLE/renderer/vulkan/RendererVk.h"
 #include "libANGLE/renderer/vulkan/vk_cache_utils.h"
 
 namespace rx
@@ -49,10 +51,16 @@ angle::Result GlslangWrapperVk::GetShaderCode(vk::Context *context,
                                               const gl::Caps &glCaps,
                                               bool enableLineRasterEmulation,
                                               const gl::ShaderMap<std::string> &shaderSources,
+                                              std::shared_ptr<angle::WorkerThreadPool> workerPool,
                                               gl::ShaderMap<std::vector<uint32_t>> *shaderCodeOut)
 {
+    // SPIR-V is also kept in the display's blob cache, so that it survives across runs along with
+    // the program binaries that only contain the GLSL sources.
+    DisplayVk *displayVk = vk::GetImpl(context->getRenderer()->getDisplay());
+
     return GlslangGetShaderSpirvCode(
         [context](GlslangError error) { return ErrorHandler(context, error); }, glCaps,
-        enableLineRasterEmulation, /* enableXfbEmulation */ true, shaderSources, shaderCodeOut);
+        enableLineRasterEmulation, /* enableXfbEmulation */ true, shaderSources,
+        displayVk->getBlobCache(), displayVk->getScratchBuffer(), workerPool, shaderCodeOut);
 }
 }  // namespace rx
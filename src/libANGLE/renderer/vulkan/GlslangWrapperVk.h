@@ -9,6 +9,7 @@
 #ifndef LIBANGLE_RENDERER_VULKAN_GLSLANG_WRAPPER_H_
 #define LIBANGLE_RENDERER_VULKAN_GLSLANG_WRAPPER_H_
 
+#include "libANGLE/WorkerThread.h"
 #include "libANGLE/renderer/ProgramImpl.h"
 #include "libANGLE/renderer/vulkan/vk_utils.h"
 
@@ -28,6 +29,7 @@ class GlslangWrapperVk
                                        const gl::Caps &glCaps,
                                        bool enableLineRasterEmulation,
                                        const gl::ShaderMap<std::string> &shaderSources,
+                                       std::shared_ptr<angle::WorkerThreadPool> workerPool,
                                        gl::ShaderMap<std::vector<uint32_t>> *shaderCodesOut);
 };
 }  // namespace rx
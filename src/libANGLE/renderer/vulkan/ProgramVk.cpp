@@ -364,15 +364,18 @@ ProgramVk::ShaderInfo::ShaderInfo() {}
 
 ProgramVk::ShaderInfo::~ShaderInfo() = default;
 
-angle::Result ProgramVk::ShaderInfo::initShaders(ContextVk *contextVk,
-                                                 const gl::ShaderMap<std::string> &shaderSources,
-                                                 bool enableLineRasterEmulation)
+angle::Result ProgramVk::ShaderInfo::initShaders(
+    ContextVk *contextVk,
+    const gl::ShaderMap<std::string> &shaderSources,
+    bool enableLineRasterEmulation,
+    std::shared_ptr<angle::WorkerThreadPool> workerPool)
 {
     ASSERT(!valid());
 
     gl::ShaderMap<std::vector<uint32_t>> shaderCodes;
-    ANGLE_TRY(GlslangWrapperVk::GetShaderCode(
-        contextVk, contextVk->getCaps(), enableLineRasterEmulation, shaderSources, &shaderCodes));
+    ANGLE_TRY(GlslangWrapperVk::GetShaderCode(contextVk, contextVk->getCaps(),
+                                              enableLineRasterEmulation, shaderSources,
+                                              workerPool, &shaderCodes));
 
     for (const gl::ShaderType shaderType : gl::AllShaderTypes())
     {
@@ -482,6 +485,7 @@ std::unique_ptr<rx::LinkEvent> ProgramVk::load(const gl::Context *context,
                                                gl::InfoLog &infoLog)
 {
     ContextVk *contextVk = vk::GetImpl(context);
+    mWorkerThreadPool    = context->getWorkerThreadPool();
     gl::ShaderMap<size_t> requiredBufferSize;
     requiredBufferSize.fill(0);
 
@@ -562,6 +566,7 @@ std::unique_ptr<LinkEvent> ProgramVk::link(const gl::Context *context,
                                            gl::InfoLog &infoLog)
 {
     ContextVk *contextVk = vk::GetImpl(context);
+    mWorkerThreadPool    = context->getWorkerThreadPool();
     // Link resources before calling GetShaderSource to make sure they are ready for the set/binding
     // assignment done in that function.
     linkResources(resources);
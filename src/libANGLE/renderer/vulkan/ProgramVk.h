@@ -13,6 +13,7 @@
 #include <array>
 
 #include "common/utilities.h"
+#include "libANGLE/WorkerThread.h"
 #include "libANGLE/renderer/ProgramImpl.h"
 #include "libANGLE/renderer/vulkan/ContextVk.h"
 #include "libANGLE/renderer/vulkan/RendererVk.h"
@@ -219,8 +220,8 @@ class ProgramVk : public ProgramImpl
     {
         if (!shaderInfo->valid())
         {
-            ANGLE_TRY(
-                shaderInfo->initShaders(contextVk, mShaderSources, enableLineRasterEmulation));
+            ANGLE_TRY(shaderInfo->initShaders(contextVk, mShaderSources, enableLineRasterEmulation,
+                                              mWorkerThreadPool));
         }
 
         ASSERT(shaderInfo->valid());
@@ -303,7 +304,8 @@ class ProgramVk : public ProgramImpl
 
         angle::Result initShaders(ContextVk *contextVk,
                                   const gl::ShaderMap<std::string> &shaderSources,
-                                  bool enableLineRasterEmulation);
+                                  bool enableLineRasterEmulation,
+                                  std::shared_ptr<angle::WorkerThreadPool> workerPool);
         void release(ContextVk *contextVk);
 
         ANGLE_INLINE bool valid() const
@@ -325,6 +327,10 @@ class ProgramVk : public ProgramImpl
     // We keep the translated linked shader sources to use with shader draw call patching.
     gl::ShaderMap<std::string> mShaderSources;
 
+    // The pool of the context that linked or loaded the program. Shaders are only compiled to
+    // SPIR-V at draw time, where the stages are compiled in parallel on this pool.
+    std::shared_ptr<angle::WorkerThreadPool> mWorkerThreadPool;
+
     // In their descriptor set, uniform buffers are placed first, then storage buffers, then atomic
     // counter buffers and then images.  These cached values contain the offsets where storage
     // buffer, atomic counter buffer and image bindings start.
@@ -93,6 +93,7 @@ class RendererVk : angle::NonCopyable
         return mPhysicalDeviceFeatures;
     }
     VkDevice getDevice() const { return mDevice; }
+    egl::Display *getDisplay() const { return mDisplay; }
 
     angle::Result selectPresentQueueForSurface(DisplayVk *displayVk,
                                                VkSurfaceKHR surface,
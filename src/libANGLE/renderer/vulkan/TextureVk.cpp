@@ -299,7 +299,8 @@ angle::Result TextureVk::setSubImageImpl(const gl::Context *context,
 
         ANGLE_TRY(mImage->stageSubresourceUpdate(
             contextVk, getNativeImageIndex(index), gl::Extents(area.width, area.height, area.depth),
-            gl::Offset(area.x, area.y, area.z), formatInfo, unpack, type, source, vkFormat));
+            gl::Offset(area.x, area.y, area.z), formatInfo, unpack, type, source, vkFormat,
+            context->getWorkerThreadPool()));
 
         unpackBufferVk->unmapImpl(contextVk);
 
@@ -309,7 +310,8 @@ angle::Result TextureVk::setSubImageImpl(const gl::Context *context,
     {
         ANGLE_TRY(mImage->stageSubresourceUpdate(
             contextVk, getNativeImageIndex(index), gl::Extents(area.width, area.height, area.depth),
-            gl::Offset(area.x, area.y, area.z), formatInfo, unpack, type, pixels, vkFormat));
+            gl::Offset(area.x, area.y, area.z), formatInfo, unpack, type, pixels, vkFormat,
+            context->getWorkerThreadPool()));
         onStagingBufferChange();
     }
 
@@ -116,8 +116,7 @@ VertexArrayVk::VertexArrayVk(ContextVk *contextVk, const gl::VertexArrayState &s
       mCurrentArrayBuffers{},
       mCurrentElementArrayBufferOffset(0),
       mCurrentElementArrayBuffer(nullptr),
-      mLineLoopHelper(contextVk->getRenderer()),
-      mDirtyLineLoopTranslation(true)
+      mLineLoopHelper(contextVk->getRenderer())
 {
     RendererVk *renderer = contextVk->getRenderer();
 
@@ -414,7 +413,7 @@ angle::Result VertexArrayVk::syncState(const gl::Context *context,
                 mLineLoopBufferFirstIndex.reset();
                 mLineLoopBufferLastIndex.reset();
                 contextVk->setIndexBufferDirty();
-                mDirtyLineLoopTranslation = true;
+                mLineLoopHelper.invalidateElementArrayConversions();
                 break;
             }
 
@@ -422,7 +421,7 @@ angle::Result VertexArrayVk::syncState(const gl::Context *context,
                 mLineLoopBufferFirstIndex.reset();
                 mLineLoopBufferLastIndex.reset();
                 contextVk->setIndexBufferDirty();
-                mDirtyLineLoopTranslation = true;
+                mLineLoopHelper.invalidateElementArrayConversions();
                 break;
 
 #define ANGLE_VERTEX_DIRTY_ATTRIB_FUNC(INDEX)                                                 \
@@ -724,26 +723,24 @@ angle::Result VertexArrayVk::handleLineLoop(ContextVk *contextVk,
     if (indexTypeOrInvalid != gl::DrawElementsType::InvalidEnum)
     {
         // Handle GL_LINE_LOOP drawElements.
-        if (mDirtyLineLoopTranslation)
-        {
-            gl::Buffer *elementArrayBuffer = mState.getElementArrayBuffer();
+        gl::Buffer *elementArrayBuffer = mState.getElementArrayBuffer();
 
-            if (!elementArrayBuffer)
-            {
-                ANGLE_TRY(mLineLoopHelper.streamIndices(
-                    contextVk, indexTypeOrInvalid, vertexOrIndexCount,
-                    reinterpret_cast<const uint8_t *>(indices), &mCurrentElementArrayBuffer,
-                    &mCurrentElementArrayBufferOffset, indexCountOut));
-            }
-            else
-            {
-                // When using an element array buffer, 'indices' is an offset to the first element.
-                intptr_t offset                = reinterpret_cast<intptr_t>(indices);
-                BufferVk *elementArrayBufferVk = vk::GetImpl(elementArrayBuffer);
-                ANGLE_TRY(mLineLoopHelper.getIndexBufferForElementArrayBuffer(
-                    contextVk, elementArrayBufferVk, indexTypeOrInvalid, vertexOrIndexCount, offset,
-                    &mCurrentElementArrayBuffer, &mCurrentElementArrayBufferOffset, indexCountOut));
-            }
+        if (!elementArrayBuffer)
+        {
+            ANGLE_TRY(mLineLoopHelper.streamIndices(
+                contextVk, indexTypeOrInvalid, vertexOrIndexCount,
+                reinterpret_cast<const uint8_t *>(indices), &mCurrentElementArrayBuffer,
+                &mCurrentElementArrayBufferOffset, indexCountOut));
+        }
+        else
+        {
+            // When using an element array buffer, 'indices' is an offset to the first element.
+            // Conversions of the same range are reused until the buffer's contents change.
+            intptr_t offset                = reinterpret_cast<intptr_t>(indices);
+            BufferVk *elementArrayBufferVk = vk::GetImpl(elementArrayBuffer);
+            ANGLE_TRY(mLineLoopHelper.getIndexBufferForElementArrayBuffer(
+                contextVk, elementArrayBufferVk, indexTypeOrInvalid, vertexOrIndexCount, offset,
+                &mCurrentElementArrayBuffer, &mCurrentElementArrayBufferOffset, indexCountOut));
         }
 
         // If we've had a drawArrays call with a line loop before, we want to make sure this is
@@ -238,24 +238,22 @@ VkImageCreateFlags GetImageCreateFlags(gl::TextureType textureType)
     }
 }
 
-void HandlePrimitiveRestart(gl::DrawElementsType glIndexType,
-                            GLsizei indexCount,
-                            const uint8_t *srcPtr,
-                            uint8_t *outPtr)
+uint32_t HandlePrimitiveRestart(gl::DrawElementsType glIndexType,
+                                GLsizei indexCount,
+                                const uint8_t *srcPtr,
+                                uint8_t *outPtr)
 {
     switch (glIndexType)
     {
         case gl::DrawElementsType::UnsignedByte:
-            CopyLineLoopIndicesWithRestart<uint8_t, uint16_t>(indexCount, srcPtr, outPtr);
-            break;
+            return CopyLineLoopIndicesWithRestart<uint8_t, uint16_t>(indexCount, srcPtr, outPtr);
         case gl::DrawElementsType::UnsignedShort:
-            CopyLineLoopIndicesWithRestart<uint16_t, uint16_t>(indexCount, srcPtr, outPtr);
-            break;
+            return CopyLineLoopIndicesWithRestart<uint16_t, uint16_t>(indexCount, srcPtr, outPtr);
         case gl::DrawElementsType::UnsignedInt:
-            CopyLineLoopIndicesWithRestart<uint32_t, uint32_t>(indexCount, srcPtr, outPtr);
-            break;
+            return CopyLineLoopIndicesWithRestart<uint32_t, uint32_t>(indexCount, srcPtr, outPtr);
         default:
             UNREACHABLE();
+            return 0;
     }
 }
 }  // anonymous namespace
@@ -1062,7 +1060,7 @@ void SemaphoreHelper::deinit()
 }
 
 // LineLoopHelper implementation.
-LineLoopHelper::LineLoopHelper(RendererVk *renderer)
+LineLoopHelper::LineLoopHelper(RendererVk *renderer) : mNextElementArrayConversion(0)
 {
     // We need to use an alignment of the maximum size we're going to allocate, which is
     // VK_INDEX_TYPE_UINT32. When we switch from a drawElement to a drawArray call, the allocations
@@ -1087,9 +1085,8 @@ angle::Result LineLoopHelper::getIndexBufferForDrawArrays(ContextVk *contextVk,
     size_t allocateBytes = sizeof(uint32_t) * (static_cast<size_t>(clampedVertexCount) + 1);
 
     mDynamicIndexBuffer.releaseInFlightBuffers(contextVk);
-    ANGLE_TRY(mDynamicIndexBuffer.allocate(contextVk, allocateBytes,
-                                           reinterpret_cast<uint8_t **>(&indices), nullptr,
-                                           offsetOut, nullptr));
+    ANGLE_TRY(allocateIndices(contextVk, allocateBytes, reinterpret_cast<uint8_t **>(&indices),
+                              offsetOut));
     *bufferOut = mDynamicIndexBuffer.getCurrentBuffer();
 
     // Note: there could be an overflow in this addition.
@@ -1117,6 +1114,83 @@ angle::Result LineLoopHelper::getIndexBufferForElementArrayBuffer(ContextVk *con
                                                                   vk::BufferHelper **bufferOut,
                                                                   VkDeviceSize *bufferOffsetOut,
                                                                   uint32_t *indexCountOut)
+{
+    // Storage buffer, atomic counter and transform feedback writes don't mark the buffer's contents
+    // as changed, so cached conversions could be stale.
+    if (elementArrayBufferVk->getBuffer().isWrittenByShaders())
+    {
+        return convertElementArrayBuffer(contextVk, elementArrayBufferVk, glIndexType, indexCount,
+                                         elementArrayOffset, bufferOut, bufferOffsetOut,
+                                         indexCountOut);
+    }
+
+    bool primitiveRestart = contextVk->getState().isPrimitiveRestartEnabled();
+
+    for (const ElementArrayConversion &conversion : mElementArrayConversions)
+    {
+        if (conversion.indexType == glIndexType && conversion.indexCount == indexCount &&
+            conversion.offset == elementArrayOffset &&
+            conversion.primitiveRestart == primitiveRestart)
+        {
+            *bufferOut       = mDynamicIndexBuffer.getCurrentBuffer();
+            *bufferOffsetOut = conversion.bufferOffset;
+            *indexCountOut   = conversion.convertedIndexCount;
+            return angle::Result::Continue;
+        }
+    }
+
+    ANGLE_TRY(convertElementArrayBuffer(contextVk, elementArrayBufferVk, glIndexType, indexCount,
+                                        elementArrayOffset, bufferOut, bufferOffsetOut,
+                                        indexCountOut));
+
+    ElementArrayConversion conversion = {glIndexType,      indexCount,       elementArrayOffset,
+                                         primitiveRestart, *bufferOffsetOut, *indexCountOut};
+    if (mElementArrayConversions.size() < mElementArrayConversions.max_size())
+    {
+        mElementArrayConversions.push_back(conversion);
+    }
+    else
+    {
+        mElementArrayConversions[mNextElementArrayConversion] = conversion;
+        mNextElementArrayConversion =
+            (mNextElementArrayConversion + 1) % mElementArrayConversions.max_size();
+    }
+
+    return angle::Result::Continue;
+}
+
+void LineLoopHelper::invalidateElementArrayConversions()
+{
+    mElementArrayConversions.clear();
+    mNextElementArrayConversion = 0;
+}
+
+angle::Result LineLoopHelper::allocateIndices(ContextVk *contextVk,
+                                              size_t sizeInBytes,
+                                              uint8_t **ptrOut,
+                                              VkDeviceSize *offsetOut)
+{
+    bool newBufferAllocated = false;
+    ANGLE_TRY(mDynamicIndexBuffer.allocate(contextVk, sizeInBytes, ptrOut, nullptr, offsetOut,
+                                           &newBufferAllocated));
+
+    // The conversions are only kept in the current buffer, as the others can be reused.
+    if (newBufferAllocated)
+    {
+        invalidateElementArrayConversions();
+    }
+
+    return angle::Result::Continue;
+}
+
+angle::Result LineLoopHelper::convertElementArrayBuffer(ContextVk *contextVk,
+                                                        BufferVk *elementArrayBufferVk,
+                                                        gl::DrawElementsType glIndexType,
+                                                        int indexCount,
+                                                        intptr_t elementArrayOffset,
+                                                        vk::BufferHelper **bufferOut,
+                                                        VkDeviceSize *bufferOffsetOut,
+                                                        uint32_t *indexCountOut)
 {
     if (glIndexType == gl::DrawElementsType::UnsignedByte ||
         contextVk->getState().isPrimitiveRestartEnabled())
@@ -1142,9 +1216,8 @@ angle::Result LineLoopHelper::getIndexBufferForElementArrayBuffer(ContextVk *con
     size_t allocateBytes = unitSize * (indexCount + 1) + 1;
 
     mDynamicIndexBuffer.releaseInFlightBuffers(contextVk);
-    ANGLE_TRY(mDynamicIndexBuffer.allocate(contextVk, allocateBytes,
-                                           reinterpret_cast<uint8_t **>(&indices), nullptr,
-                                           bufferOffsetOut, nullptr));
+    ANGLE_TRY(allocateIndices(contextVk, allocateBytes, reinterpret_cast<uint8_t **>(&indices),
+                              bufferOffsetOut));
     *bufferOut = mDynamicIndexBuffer.getCurrentBuffer();
 
     VkDeviceSize sourceOffset                  = static_cast<VkDeviceSize>(elementArrayOffset);
@@ -1175,21 +1248,22 @@ angle::Result LineLoopHelper::streamIndices(ContextVk *contextVk,
     uint8_t *indices = nullptr;
 
     auto unitSize = (indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t));
+
+    // With primitive restart, the indices are converted in a single pass into enough space for
+    // the worst case, and the count is only known afterwards.
     uint32_t numOutIndices = indexCount + 1;
     if (contextVk->getState().isPrimitiveRestartEnabled())
     {
-        numOutIndices = GetLineLoopWithRestartIndexCount(glIndexType, indexCount, srcPtr);
+        numOutIndices = GetLineLoopWithRestartIndexCountUpperBound(indexCount);
     }
-    *indexCountOut       = numOutIndices;
     size_t allocateBytes = unitSize * numOutIndices;
-    ANGLE_TRY(mDynamicIndexBuffer.allocate(contextVk, allocateBytes,
-                                           reinterpret_cast<uint8_t **>(&indices), nullptr,
-                                           bufferOffsetOut, nullptr));
+    ANGLE_TRY(allocateIndices(contextVk, allocateBytes, reinterpret_cast<uint8_t **>(&indices),
+                              bufferOffsetOut));
     *bufferOut = mDynamicIndexBuffer.getCurrentBuffer();
 
     if (contextVk->getState().isPrimitiveRestartEnabled())
     {
-        HandlePrimitiveRestart(glIndexType, indexCount, srcPtr, indices);
+        numOutIndices = HandlePrimitiveRestart(glIndexType, indexCount, srcPtr, indices);
     }
     else
     {
@@ -1212,6 +1286,8 @@ angle::Result LineLoopHelper::streamIndices(ContextVk *contextVk,
         }
     }
 
+    *indexCountOut = numOutIndices;
+
     ANGLE_TRY(mDynamicIndexBuffer.flush(contextVk));
     return angle::Result::Continue;
 }
@@ -1248,8 +1324,7 @@ angle::Result LineLoopHelper::streamIndicesIndirect(ContextVk *contextVk,
     mDynamicIndexBuffer.releaseInFlightBuffers(contextVk);
     mDynamicIndirectBuffer.releaseInFlightBuffers(contextVk);
 
-    ANGLE_TRY(mDynamicIndexBuffer.allocate(contextVk, allocateBytes, nullptr, nullptr,
-                                           indexBufferOffsetOut, nullptr));
+    ANGLE_TRY(allocateIndices(contextVk, allocateBytes, nullptr, indexBufferOffsetOut));
     *indexBufferOut = mDynamicIndexBuffer.getCurrentBuffer();
 
     ANGLE_TRY(mDynamicIndirectBuffer.allocate(contextVk, sizeof(VkDrawIndexedIndirectCommand),
@@ -1275,12 +1350,14 @@ angle::Result LineLoopHelper::streamIndicesIndirect(ContextVk *contextVk,
 
 void LineLoopHelper::release(ContextVk *contextVk)
 {
+    invalidateElementArrayConversions();
     mDynamicIndexBuffer.release(contextVk->getRenderer());
     mDynamicIndirectBuffer.release(contextVk->getRenderer());
 }
 
 void LineLoopHelper::destroy(VkDevice device)
 {
+    invalidateElementArrayConversions();
     mDynamicIndexBuffer.destroy(device);
     mDynamicIndirectBuffer.destroy(device);
 }
@@ -1300,7 +1377,8 @@ BufferHelper::BufferHelper()
       mMappedMemory(nullptr),
       mViewFormat(nullptr),
       mCurrentWriteAccess(0),
-      mCurrentReadAccess(0)
+      mCurrentReadAccess(0),
+      mWrittenByShaders(false)
 {}
 
 BufferHelper::~BufferHelper() = default;
@@ -1371,6 +1449,11 @@ void BufferHelper::onWriteAccess(ContextVk *contextVk,
         addGlobalMemoryBarrier(barrierSrc, barrierDst, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
     }
 
+    if ((writeAccessType & VK_ACCESS_SHADER_WRITE_BIT) != 0)
+    {
+        mWrittenByShaders = true;
+    }
+
     bool hostVisible = mMemoryPropertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
     if (hostVisible && writeAccessType != VK_ACCESS_HOST_WRITE_BIT)
     {
@@ -2101,15 +2184,17 @@ void ImageHelper::removeStagedUpdates(ContextVk *contextVk, const gl::ImageIndex
     }
 }
 
-angle::Result ImageHelper::stageSubresourceUpdate(ContextVk *contextVk,
-                                                  const gl::ImageIndex &index,
-                                                  const gl::Extents &glExtents,
-                                                  const gl::Offset &offset,
-                                                  const gl::InternalFormat &formatInfo,
-                                                  const gl::PixelUnpackState &unpack,
-                                                  GLenum type,
-                                                  const uint8_t *pixels,
-                                                  const vk::Format &vkFormat)
+angle::Result ImageHelper::stageSubresourceUpdate(
+    ContextVk *contextVk,
+    const gl::ImageIndex &index,
+    const gl::Extents &glExtents,
+    const gl::Offset &offset,
+    const gl::InternalFormat &formatInfo,
+    const gl::PixelUnpackState &unpack,
+    GLenum type,
+    const uint8_t *pixels,
+    const vk::Format &vkFormat,
+    const std::shared_ptr<angle::WorkerThreadPool> &workerPool)
 {
     GLuint inputRowPitch = 0;
     ANGLE_VK_CHECK_MATH(contextVk,
@@ -2235,9 +2320,18 @@ angle::Result ImageHelper::stageSubresourceUpdate(ContextVk *contextVk,
 
     const uint8_t *source = pixels + static_cast<ptrdiff_t>(inputSkipBytes);
 
-    loadFunctionInfo.loadFunction(glExtents.width, glExtents.height, glExtents.depth, source,
-                                  inputRowPitch, inputDepthPitch, stagingPointer, outputRowPitch,
-                                  outputDepthPitch);
+    if (formatInfo.compressed || storageFormat.isBlock)
+    {
+        loadFunctionInfo.loadFunction(glExtents.width, glExtents.height, glExtents.depth, source,
+                                      inputRowPitch, inputDepthPitch, stagingPointer,
+                                      outputRowPitch, outputDepthPitch);
+    }
+    else
+    {
+        LoadImageParallel(workerPool, loadFunctionInfo.loadFunction, glExtents.width,
+                          glExtents.height, glExtents.depth, source, inputRowPitch,
+                          inputDepthPitch, stagingPointer, outputRowPitch, outputDepthPitch);
+    }
 
     VkBufferImageCopy copy         = {};
     VkImageAspectFlags aspectFlags = GetFormatAspectFlags(vkFormat.imageFormat());
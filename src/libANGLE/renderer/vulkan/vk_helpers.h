@@ -12,6 +12,11 @@
 #include "libANGLE/renderer/vulkan/CommandGraph.h"
 #include "libANGLE/renderer/vulkan/vk_utils.h"
 
+namespace angle
+{
+class WorkerThreadPool;
+}  // namespace angle
+
 namespace gl
 {
 class ImageIndex;
@@ -432,14 +437,48 @@ class LineLoopHelper final : angle::NonCopyable
                                         vk::BufferHelper **indirectBufferOut,
                                         VkDeviceSize *indirectBufferOffsetOut);
 
+    // Called when the element array buffer or its contents change.
+    void invalidateElementArrayConversions();
+
     void release(ContextVk *contextVk);
     void destroy(VkDevice device);
 
     static void Draw(uint32_t count, CommandBuffer *commandBuffer);
 
   private:
+    angle::Result allocateIndices(ContextVk *contextVk,
+                                  size_t sizeInBytes,
+                                  uint8_t **ptrOut,
+                                  VkDeviceSize *offsetOut);
+    angle::Result convertElementArrayBuffer(ContextVk *contextVk,
+                                            BufferVk *elementArrayBufferVk,
+                                            gl::DrawElementsType glIndexType,
+                                            int indexCount,
+                                            intptr_t elementArrayOffset,
+                                            BufferHelper **bufferOut,
+                                            VkDeviceSize *bufferOffsetOut,
+                                            uint32_t *indexCountOut);
+
     DynamicBuffer mDynamicIndexBuffer;
     DynamicBuffer mDynamicIndirectBuffer;
+
+    // Line loops converted from the element array buffer, so that drawing the same static loop
+    // again doesn't convert it again. They are dropped when the buffer's contents change, and when
+    // the dynamic index buffer moves on to a new buffer, after which their indices may be reused.
+    // Buffers that shaders write are always converted again.
+    struct ElementArrayConversion
+    {
+        gl::DrawElementsType indexType;
+        int indexCount;
+        intptr_t offset;
+        bool primitiveRestart;
+        VkDeviceSize bufferOffset;
+        uint32_t convertedIndexCount;
+    };
+    static constexpr size_t kMaxElementArrayConversions = 4;
+    angle::FixedVector<ElementArrayConversion, kMaxElementArrayConversions>
+        mElementArrayConversions;
+    size_t mNextElementArrayConversion;
 };
 
 class FramebufferHelper;
@@ -507,6 +546,10 @@ class BufferHelper final : public CommandGraphResource
     // graph resource to create a dependency to.
     void onExternalWrite(VkAccessFlags writeAccessType) { mCurrentWriteAccess |= writeAccessType; }
 
+    // Whether the buffer was ever bound for shader writes, e.g. as a storage buffer.  The front-end
+    // isn't told when shaders change the buffer, so data derived from it can't be cached.
+    bool isWrittenByShaders() const { return mWrittenByShaders; }
+
     // Also implicitly sets up the correct barriers.
     angle::Result copyFromBuffer(ContextVk *contextVk,
                                  const Buffer &buffer,
@@ -592,6 +635,8 @@ class BufferHelper final : public CommandGraphResource
     // For memory barriers.
     VkFlags mCurrentWriteAccess;
     VkFlags mCurrentReadAccess;
+
+    bool mWrittenByShaders;
 };
 
 // Imagine an image going through a few layout transitions:
@@ -769,15 +814,17 @@ class ImageHelper final : public CommandGraphResource
     // Data staging
     void removeStagedUpdates(ContextVk *contextVk, const gl::ImageIndex &index);
 
-    angle::Result stageSubresourceUpdate(ContextVk *contextVk,
-                                         const gl::ImageIndex &index,
-                                         const gl::Extents &glExtents,
-                                         const gl::Offset &offset,
-                                         const gl::InternalFormat &formatInfo,
-                                         const gl::PixelUnpackState &unpack,
-                                         GLenum type,
-                                         const uint8_t *pixels,
-                                         const Format &vkFormat);
+    angle::Result stageSubresourceUpdate(
+        ContextVk *contextVk,
+        const gl::ImageIndex &index,
+        const gl::Extents &glExtents,
+        const gl::Offset &offset,
+        const gl::InternalFormat &formatInfo,
+        const gl::PixelUnpackState &unpack,
+        GLenum type,
+        const uint8_t *pixels,
+        const Format &vkFormat,
+        const std::shared_ptr<angle::WorkerThreadPool> &workerPool);
 
     angle::Result stageSubresourceUpdateAndGetData(ContextVk *contextVk,
                                                    size_t allocationSize,
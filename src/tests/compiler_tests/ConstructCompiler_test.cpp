@@ -4,7 +4,7 @@
 // found in the LICENSE file.
 //
 // ConstructCompiler_test.cpp
-//   Test the sh::ConstructCompiler interface with different parameters.
+//   Test the sh::ConstructCompiler and sh::UpdateResources interfaces with different parameters.
 //
 
 #include "GLSLANG/ShaderLang.h"
@@ -43,3 +43,110 @@ TEST(ConstructCompilerTest, InvalidMaxDualSourceDrawBuffers)
                                               SH_GLSL_COMPATIBILITY_OUTPUT, &resources);
     ASSERT_EQ(nullptr, compiler);
 }
+
+namespace
+{
+constexpr char kDerivativesShader[] = R"(#extension GL_OES_standard_derivatives : require
+precision mediump float;
+varying float v;
+void main()
+{
+    gl_FragColor = vec4(dFdx(v));
+})";
+
+constexpr char kDrawBuffersShader[] = R"(#version 300 es
+precision mediump float;
+out vec4 color;
+void main()
+{
+    float a[gl_MaxDrawBuffers == 8 ? 1 : -1];
+    color = vec4(a[0]);
+})";
+}  // anonymous namespace
+
+// Test that an extension can be enabled by updating the resources.
+TEST(ConstructCompilerTest, UpdateResourcesEnablesExtension)
+{
+    ShBuiltInResources resources;
+    sh::InitBuiltInResources(&resources);
+    ShHandle compiler = sh::ConstructCompiler(GL_FRAGMENT_SHADER, SH_WEBGL_SPEC,
+                                              SH_GLSL_COMPATIBILITY_OUTPUT, &resources);
+    ASSERT_NE(nullptr, compiler);
+
+    const char *shaderStrings[] = {kDerivativesShader};
+    EXPECT_FALSE(sh::Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE));
+
+    resources.OES_standard_derivatives = 1;
+    ASSERT_TRUE(sh::UpdateResources(compiler, &resources));
+    EXPECT_TRUE(sh::Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE));
+    EXPECT_NE(std::string::npos,
+              sh::GetBuiltInResourcesString(compiler).find(":OES_standard_derivatives:1"));
+
+    sh::Destruct(compiler);
+}
+
+// Test that the built-in constants follow the updated resources.
+TEST(ConstructCompilerTest, UpdateResourcesChangesBuiltInConstants)
+{
+    ShBuiltInResources resources;
+    sh::InitBuiltInResources(&resources);
+    ShHandle compiler = sh::ConstructCompiler(GL_FRAGMENT_SHADER, SH_WEBGL2_SPEC,
+                                              SH_GLSL_COMPATIBILITY_OUTPUT, &resources);
+    ASSERT_NE(nullptr, compiler);
+
+    const char *shaderStrings[] = {kDrawBuffersShader};
+    EXPECT_FALSE(sh::Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE));
+
+    resources.MaxDrawBuffers = 8;
+    ASSERT_TRUE(sh::UpdateResources(compiler, &resources));
+    EXPECT_TRUE(sh::Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE));
+
+    // Updating with the same resources keeps the compiler working.
+    ASSERT_TRUE(sh::UpdateResources(compiler, &resources));
+    EXPECT_TRUE(sh::Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE));
+
+    sh::Destruct(compiler);
+}
+
+// Test that invalid resources are rejected and the compiler keeps the old ones.
+TEST(ConstructCompilerTest, UpdateResourcesInvalidMaxDrawBuffers)
+{
+    ShBuiltInResources resources;
+    sh::InitBuiltInResources(&resources);
+    resources.OES_standard_derivatives = 1;
+    ShHandle compiler = sh::ConstructCompiler(GL_FRAGMENT_SHADER, SH_WEBGL_SPEC,
+                                              SH_GLSL_COMPATIBILITY_OUTPUT, &resources);
+    ASSERT_NE(nullptr, compiler);
+
+    ShBuiltInResources invalidResources = resources;
+    invalidResources.MaxDrawBuffers     = 0;
+    EXPECT_FALSE(sh::UpdateResources(compiler, &invalidResources));
+
+    const char *shaderStrings[] = {kDerivativesShader};
+    EXPECT_TRUE(sh::Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE));
+
+    sh::Destruct(compiler);
+}
+
+// Test that an extension that depends on a compile option is available again once the option is
+// set, after a compilation without it.
+TEST(ConstructCompilerTest, ReuseWithDifferentCompileOptions)
+{
+    ShBuiltInResources resources;
+    sh::InitBuiltInResources(&resources);
+    resources.ANGLE_multi_draw = 1;
+    ShHandle compiler = sh::ConstructCompiler(GL_VERTEX_SHADER, SH_WEBGL_SPEC,
+                                              SH_GLSL_COMPATIBILITY_OUTPUT, &resources);
+    ASSERT_NE(nullptr, compiler);
+
+    const char *shaderStrings[] = {
+        "#extension GL_ANGLE_multi_draw : require\n"
+        "void main() {\n"
+        "   gl_Position = vec4(float(gl_DrawID), 0.0, 0.0, 1.0);\n"
+        "}\n"};
+    EXPECT_FALSE(sh::Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE));
+    EXPECT_TRUE(sh::Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE | SH_EMULATE_GL_DRAW_ID));
+    EXPECT_FALSE(sh::Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE));
+
+    sh::Destruct(compiler);
+}
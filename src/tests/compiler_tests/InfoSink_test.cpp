@@ -0,0 +1,119 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// InfoSink_test.cpp:
+//   Tests that TInfoSinkBase formats numbers the same way as a classic locale stream, which is
+//   what the translator output used to be generated with.
+
+#include <limits>
+
+#include "compiler/translator/InfoSink.h"
+#include "gtest/gtest.h"
+
+using namespace sh;
+
+namespace
+{
+template <typename T>
+std::string StreamFormat(T value)
+{
+    std::ostringstream stream = sh::InitializeStream<std::ostringstream>();
+    stream << value;
+    return stream.str();
+}
+
+std::string StreamFormatFloat(float value)
+{
+    std::ostringstream stream = sh::InitializeStream<std::ostringstream>();
+    if (fractionalPart(value) == 0.0f)
+    {
+        stream.precision(1);
+        stream << std::showpoint << std::fixed << value;
+    }
+    else
+    {
+        stream.precision(8);
+        stream << value;
+    }
+    return stream.str();
+}
+
+template <typename T>
+std::string SinkFormat(T value)
+{
+    TInfoSinkBase sink;
+    sink << value;
+    return sink.str();
+}
+
+template <typename T>
+void CheckIntegerFormatting()
+{
+    const T values[] = {
+        0, 1, 9, 10, 99, 100, 12345, std::numeric_limits<T>::max(), std::numeric_limits<T>::min(),
+        static_cast<T>(std::numeric_limits<T>::max() / 10),
+    };
+
+    for (T value : values)
+    {
+        EXPECT_EQ(StreamFormat(value), SinkFormat(value));
+        EXPECT_EQ(StreamFormat(static_cast<T>(value - 1)), SinkFormat(static_cast<T>(value - 1)));
+    }
+}
+}  // anonymous namespace
+
+// Test that integers of all widths are formatted like the stream formats them.
+TEST(InfoSinkTest, Integers)
+{
+    CheckIntegerFormatting<int>();
+    CheckIntegerFormatting<unsigned int>();
+    CheckIntegerFormatting<long>();
+    CheckIntegerFormatting<unsigned long>();
+    CheckIntegerFormatting<long long>();
+    CheckIntegerFormatting<unsigned long long>();
+}
+
+// Test that floats keep their decimal point and precision.
+TEST(InfoSinkTest, Floats)
+{
+    const float values[] = {
+        0.0f,
+        -0.0f,
+        1.0f,
+        -2.0f,
+        0.5f,
+        0.1f,
+        1.0f / 3.0f,
+        123456.789f,
+        1e-5f,
+        1e10f,
+        3.0e38f,
+        std::numeric_limits<float>::min(),
+        std::numeric_limits<float>::max(),
+        std::numeric_limits<float>::denorm_min(),
+        std::numeric_limits<float>::epsilon(),
+        std::numeric_limits<float>::infinity(),
+        -std::numeric_limits<float>::infinity(),
+    };
+
+    for (float value : values)
+    {
+        EXPECT_EQ(StreamFormatFloat(value), SinkFormat(value));
+        EXPECT_EQ(StreamFormatFloat(-value), SinkFormat(-value));
+    }
+
+    EXPECT_EQ("1.0", SinkFormat(1.0f));
+    EXPECT_EQ("0.1", SinkFormat(0.1f));
+}
+
+// Test that other types still go through the stream.
+TEST(InfoSinkTest, OtherTypes)
+{
+    EXPECT_EQ(StreamFormat(0.25), SinkFormat(0.25));
+    EXPECT_EQ("true", SinkFormat(true));
+    EXPECT_EQ("x", SinkFormat('x'));
+    EXPECT_EQ(StreamFormat(static_cast<unsigned short>(65535)),
+              SinkFormat(static_cast<unsigned short>(65535)));
+}
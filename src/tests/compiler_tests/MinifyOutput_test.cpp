@@ -0,0 +1,118 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// MinifyOutput_test.cpp:
+//   Tests shader compilation with SH_MINIFY_OUTPUT.
+
+#include "GLSLANG/ShaderLang.h"
+#include "angle_gl.h"
+#include "gtest/gtest.h"
+#include "tests/test_utils/compiler_test.h"
+
+using namespace sh;
+
+namespace
+{
+
+constexpr char kShader[] = R"(#version 300 es
+precision highp float;
+uniform float a, b, c;
+out vec4 color;
+
+float addAndScale(float value, float scale)
+{
+    float scaledValue = value * scale;
+    return scaledValue + value;
+}
+
+void main()
+{
+    // This comment is removed.
+    float x = addAndScale(a, b);
+    color = vec4(a + b * c, (a + b) * c, a - (b - c), a - b - c);
+    color += vec4(x - -a, b > c ? a : -b, 0, 1);
+})";
+
+class MinifyOutputTest : public MatchOutputCodeTest
+{
+  public:
+    MinifyOutputTest() : MatchOutputCodeTest(GL_FRAGMENT_SHADER, SH_MINIFY_OUTPUT, SH_ESSL_OUTPUT)
+    {
+        addOutputType(SH_GLSL_COMPATIBILITY_OUTPUT);
+    }
+};
+
+// Test that functions, parameters and local variables get short names, and that the interface of
+// the shader keeps its names.
+TEST_F(MinifyOutputTest, ShortNames)
+{
+    compile(kShader);
+    ASSERT_TRUE(notFoundInCode("addAndScale"));
+    ASSERT_TRUE(notFoundInCode("scaledValue"));
+    ASSERT_TRUE(notFoundInCode("_uvalue"));
+    ASSERT_TRUE(foundInCode("_m0("));
+    ASSERT_TRUE(foundInCode("_ucolor"));
+    ASSERT_TRUE(foundInCode("void main(){"));
+}
+
+// Test that only the parentheses that operator precedence requires are kept.
+TEST_F(MinifyOutputTest, Parentheses)
+{
+    compile(kShader);
+    ASSERT_TRUE(foundInCode("vec4(_ua+_ub*_uc,(_ua+_ub)*_uc,_ua-(_ub-_uc),_ua-_ub-_uc)"));
+    ASSERT_TRUE(foundInCode("_ub>_uc?_ua:-_ub"));
+}
+
+// Test that whitespace is kept where removing it would merge tokens.
+TEST_F(MinifyOutputTest, Whitespace)
+{
+    compile(kShader);
+    ASSERT_TRUE(foundInCode("_m3=_m1*_m2;\n"));
+    ASSERT_TRUE(foundInCode("- -_ua"));
+    ASSERT_TRUE(notFoundInCode("comment"));
+    ASSERT_TRUE(notFoundInCode("  "));
+}
+
+// Test that preprocessor directives are kept on lines of their own.
+TEST_F(MinifyOutputTest, Directives)
+{
+    getResources()->OES_standard_derivatives = 1;
+
+    const std::string &shaderString =
+        R"(#extension GL_OES_standard_derivatives : enable
+        precision mediump float;
+        varying float v;
+        void main()
+        {
+            gl_FragColor = vec4(dFdx(v));
+        })";
+    compile(shaderString);
+    ASSERT_TRUE(foundInESSLCode("#extension GL_OES_standard_derivatives : enable\n"));
+}
+
+// Test that the number of bytes saved is reported.
+TEST(MinifyOutputSizeTest, SizeReduction)
+{
+    ShBuiltInResources resources;
+    InitBuiltInResources(&resources);
+
+    ShHandle compiler =
+        ConstructCompiler(GL_FRAGMENT_SHADER, SH_GLES3_SPEC, SH_ESSL_OUTPUT, &resources);
+    ASSERT_NE(nullptr, compiler);
+
+    const char *shaderStrings[] = {kShader};
+    ASSERT_TRUE(Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE));
+    EXPECT_EQ(0u, GetObjectCodeSizeReduction(compiler));
+    size_t unminifiedSize = GetObjectCode(compiler).size();
+
+    ASSERT_TRUE(Compile(compiler, shaderStrings, 1, SH_OBJECT_CODE | SH_MINIFY_OUTPUT));
+    EXPECT_GT(GetObjectCodeSizeReduction(compiler), 0u);
+    EXPECT_EQ(unminifiedSize,
+              GetObjectCode(compiler).size() + GetObjectCodeSizeReduction(compiler));
+
+    Destruct(compiler);
+}
+
+}  // anonymous namespace
@@ -6,7 +6,11 @@
 // EGLBlobCacheTest:
 //   Unit tests for the EGL_ANDROID_blob_cache extension.
 
+#include <chrono>
+#include <condition_variable>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "common/angleutils.h"
@@ -30,11 +34,64 @@ enum class CacheOpResult
 
 namespace
 {
+// Programs are written back to the cache on a worker thread, so the cache state is locked.
+std::mutex gApplicationCacheMutex;
+std::condition_variable gApplicationCacheCondition;
 std::map<std::vector<uint8_t>, std::vector<uint8_t>> gApplicationCache;
 CacheOpResult gLastCacheOpResult = CacheOpResult::VALUE_NOT_SET;
+size_t gSetBlobCount             = 0;
+size_t gGetBlobCount             = 0;
+
+// See ScopedWriteBackHold.
+std::thread::id gTestThreadId;
+bool gHoldWriteBack        = false;
+bool gWriteBackHeld        = false;
+bool gSynchronousWriteBack = false;
+
+void ResetApplicationCache()
+{
+    std::lock_guard<std::mutex> lock(gApplicationCacheMutex);
+    gApplicationCache.clear();
+    gLastCacheOpResult = CacheOpResult::VALUE_NOT_SET;
+    gSetBlobCount      = 0;
+    gGetBlobCount      = 0;
+}
+
+size_t GetSetBlobCount()
+{
+    std::lock_guard<std::mutex> lock(gApplicationCacheMutex);
+    return gSetBlobCount;
+}
+
+size_t GetGetBlobCount()
+{
+    std::lock_guard<std::mutex> lock(gApplicationCacheMutex);
+    return gGetBlobCount;
+}
+
+size_t GetApplicationCacheEntryCount()
+{
+    std::lock_guard<std::mutex> lock(gApplicationCacheMutex);
+    return gApplicationCache.size();
+}
 
 void SetBlob(const void *key, EGLsizeiANDROID keySize, const void *value, EGLsizeiANDROID valueSize)
 {
+    std::unique_lock<std::mutex> lock(gApplicationCacheMutex);
+    if (gHoldWriteBack)
+    {
+        if (std::this_thread::get_id() == gTestThreadId)
+        {
+            gSynchronousWriteBack = true;
+        }
+        else
+        {
+            gWriteBackHeld = true;
+            gApplicationCacheCondition.notify_all();
+            gApplicationCacheCondition.wait(lock, [] { return !gHoldWriteBack; });
+        }
+    }
+
     std::vector<uint8_t> keyVec(keySize);
     memcpy(keyVec.data(), key, keySize);
 
@@ -44,6 +101,8 @@ void SetBlob(const void *key, EGLsizeiANDROID keySize, const void *value, EGLsiz
     gApplicationCache[keyVec] = valueVec;
 
     gLastCacheOpResult = CacheOpResult::SET_SUCCESS;
+    ++gSetBlobCount;
+    gApplicationCacheCondition.notify_all();
 }
 
 EGLsizeiANDROID GetBlob(const void *key,
@@ -51,6 +110,9 @@ EGLsizeiANDROID GetBlob(const void *key,
                         void *value,
                         EGLsizeiANDROID valueSize)
 {
+    std::lock_guard<std::mutex> lock(gApplicationCacheMutex);
+    ++gGetBlobCount;
+
     std::vector<uint8_t> keyVec(keySize);
     memcpy(keyVec.data(), key, keySize);
 
@@ -73,6 +135,77 @@ EGLsizeiANDROID GetBlob(const void *key,
 
     return entry->second.size();
 }
+
+// Blocks the write-back of programs to the application's cache, so that tests can link while
+// programs are still queued.  The write-back is released on destruction, since terminating the
+// display waits for it.
+class ScopedWriteBackHold final : angle::NonCopyable
+{
+  public:
+    ScopedWriteBackHold()
+    {
+        std::lock_guard<std::mutex> lock(gApplicationCacheMutex);
+        gTestThreadId         = std::this_thread::get_id();
+        gHoldWriteBack        = true;
+        gWriteBackHeld        = false;
+        gSynchronousWriteBack = false;
+    }
+
+    ~ScopedWriteBackHold() { release(); }
+
+    // Waits until the write-back of a linked program is blocked.  Returns false if the program was
+    // written to the cache synchronously instead, which happens without parallel shader compile.
+    bool waitUntilHeld()
+    {
+        std::unique_lock<std::mutex> lock(gApplicationCacheMutex);
+        gApplicationCacheCondition.wait(lock,
+                                        [] { return gWriteBackHeld || gSynchronousWriteBack; });
+        return gWriteBackHeld;
+    }
+
+    void release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(gApplicationCacheMutex);
+            gHoldWriteBack = false;
+        }
+        gApplicationCacheCondition.notify_all();
+    }
+};
+
+constexpr char kHeldVertexShaderSrc[] = R"(attribute vec4 aTest;
+void main()
+{
+    gl_Position = aTest;
+})";
+
+constexpr char kHeldFragmentShaderSrc[] = R"(precision mediump float;
+void main()
+{
+    gl_FragColor = vec4(1.0, 0.0, 0.0, 1.0);
+})";
+
+constexpr char kQueuedVertexShaderSrc[] = R"(attribute vec4 aTest;
+varying vec4 vTest;
+void main()
+{
+    vTest       = aTest;
+    gl_Position = aTest;
+})";
+
+constexpr char kQueuedFragmentShaderSrc[] = R"(precision mediump float;
+varying vec4 vTest;
+void main()
+{
+    gl_FragColor = vTest;
+})";
+
+constexpr char kQueuedFragmentShaderSrc2[] = R"(precision mediump float;
+varying vec4 vTest;
+void main()
+{
+    gl_FragColor = vTest.wzyx;
+})";
 }  // anonymous namespace
 
 class EGLBlobCacheTest : public ANGLETest
@@ -82,6 +215,7 @@ class EGLBlobCacheTest : public ANGLETest
     {
         // Force disply caching off. Blob cache functions require it.
         forceNewDisplay();
+        ResetApplicationCache();
     }
 
     void testSetUp() override
@@ -95,6 +229,21 @@ class EGLBlobCacheTest : public ANGLETest
         return (getClientMajorVersion() >= 3 || IsGLExtensionEnabled("GL_OES_get_program_binary"));
     }
 
+    // Linked programs may be written to the application's cache on a worker thread.  Terminating
+    // the display waits for them, so recreate it to check the cache, and set the functions again.
+    void flushBlobCache()
+    {
+        recreateTestFixture();
+        eglSetBlobCacheFuncsANDROID(getEGLWindow()->getDisplay(), SetBlob, GetBlob);
+        ASSERT_EGL_SUCCESS();
+    }
+
+    // A blocked write-back occupies a worker thread, so at least one more is needed to compile.
+    bool canHoldWriteBack()
+    {
+        return programBinaryAvailable() && std::thread::hardware_concurrency() > 1;
+    }
+
     bool mHasBlobCache;
 };
 
@@ -146,6 +295,7 @@ void main()
     {
         GLuint program = CompileProgram(kVertexShaderSrc, kFragmentShaderSrc);
         ASSERT_NE(0u, program);
+        flushBlobCache();
         EXPECT_EQ(CacheOpResult::SET_SUCCESS, gLastCacheOpResult);
         gLastCacheOpResult = CacheOpResult::VALUE_NOT_SET;
 
@@ -158,6 +308,7 @@ void main()
         // Compile another shader, which should create a new entry
         program = CompileProgram(kVertexShaderSrc2, kFragmentShaderSrc2);
         ASSERT_NE(0u, program);
+        flushBlobCache();
         EXPECT_EQ(CacheOpResult::SET_SUCCESS, gLastCacheOpResult);
         gLastCacheOpResult = CacheOpResult::VALUE_NOT_SET;
 
@@ -169,6 +320,115 @@ void main()
     }
 }
 
+// Tests that linking a program again while it is still queued for write-back loads the queued
+// binary instead of asking the application.
+TEST_P(EGLBlobCacheTest, RelinkQueuedProgram)
+{
+    ANGLE_SKIP_TEST_IF(!mHasBlobCache || !canHoldWriteBack());
+
+    eglSetBlobCacheFuncsANDROID(getEGLWindow()->getDisplay(), SetBlob, GetBlob);
+    ASSERT_EGL_SUCCESS();
+
+    {
+        // Block the write-back on a first program, so the next one stays queued.
+        ScopedWriteBackHold hold;
+        GLuint heldProgram = CompileProgram(kHeldVertexShaderSrc, kHeldFragmentShaderSrc);
+        ASSERT_NE(0u, heldProgram);
+        ANGLE_SKIP_TEST_IF(!hold.waitUntilHeld());
+
+        GLuint program = CompileProgram(kQueuedVertexShaderSrc, kQueuedFragmentShaderSrc);
+        ASSERT_NE(0u, program);
+        size_t getBlobCount = GetGetBlobCount();
+
+        program = CompileProgram(kQueuedVertexShaderSrc, kQueuedFragmentShaderSrc);
+        ASSERT_NE(0u, program);
+        EXPECT_EQ(getBlobCount, GetGetBlobCount());
+        EXPECT_EQ(0u, GetSetBlobCount());
+    }
+
+    // Each program is written once, since the relink didn't store anything.
+    flushBlobCache();
+    EXPECT_EQ(2u, GetSetBlobCount());
+    EXPECT_EQ(2u, GetApplicationCacheEntryCount());
+}
+
+// Tests that a program updated several times before its write-back is written only once.
+// updateProgram is used by D3D11 when a draw recompiles the program for new vertex formats.
+TEST_P(EGLBlobCacheTest, UpdatedProgramWrittenOnce)
+{
+    ANGLE_SKIP_TEST_IF(!mHasBlobCache || !canHoldWriteBack() || !IsD3D11());
+
+    eglSetBlobCacheFuncsANDROID(getEGLWindow()->getDisplay(), SetBlob, GetBlob);
+    ASSERT_EGL_SUCCESS();
+
+    {
+        ScopedWriteBackHold hold;
+        GLuint heldProgram = CompileProgram(kHeldVertexShaderSrc, kHeldFragmentShaderSrc);
+        ASSERT_NE(0u, heldProgram);
+        ANGLE_SKIP_TEST_IF(!hold.waitUntilHeld());
+
+        GLProgram program;
+        program.makeRaster(kQueuedVertexShaderSrc, kQueuedFragmentShaderSrc);
+        ASSERT_TRUE(program.valid());
+        glUseProgram(program);
+
+        GLint location = glGetAttribLocation(program, "aTest");
+        ASSERT_NE(-1, location);
+        glEnableVertexAttribArray(location);
+
+        std::vector<GLfloat> vertexData(12, 0.0f);
+        GLBuffer buffer;
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, vertexData.size() * sizeof(GLfloat), vertexData.data(),
+                     GL_STATIC_DRAW);
+
+        // Unnormalized integer attributes are converted in the vertex shader, so each integer
+        // format recompiles the program and updates its cache entry.
+        for (GLenum type : {GL_FLOAT, GL_UNSIGNED_BYTE, GL_SHORT})
+        {
+            glVertexAttribPointer(location, 4, type, GL_FALSE, 0, nullptr);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+        ASSERT_GL_NO_ERROR();
+        EXPECT_EQ(0u, GetSetBlobCount());
+    }
+
+    flushBlobCache();
+    EXPECT_EQ(2u, GetSetBlobCount());
+    EXPECT_EQ(2u, GetApplicationCacheEntryCount());
+}
+
+// Tests that programs still queued for write-back when the display is terminated are stored.
+TEST_P(EGLBlobCacheTest, PendingProgramsWrittenOnTerminate)
+{
+    ANGLE_SKIP_TEST_IF(!mHasBlobCache || !canHoldWriteBack());
+
+    eglSetBlobCacheFuncsANDROID(getEGLWindow()->getDisplay(), SetBlob, GetBlob);
+    ASSERT_EGL_SUCCESS();
+
+    ScopedWriteBackHold hold;
+    GLuint heldProgram = CompileProgram(kHeldVertexShaderSrc, kHeldFragmentShaderSrc);
+    ASSERT_NE(0u, heldProgram);
+    ANGLE_SKIP_TEST_IF(!hold.waitUntilHeld());
+
+    GLuint program = CompileProgram(kQueuedVertexShaderSrc, kQueuedFragmentShaderSrc);
+    ASSERT_NE(0u, program);
+    program = CompileProgram(kQueuedVertexShaderSrc, kQueuedFragmentShaderSrc2);
+    ASSERT_NE(0u, program);
+    EXPECT_EQ(0u, GetSetBlobCount());
+
+    // Let the write-back go once the display is being terminated, which has to wait for it.
+    std::thread releaseThread([&hold] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        hold.release();
+    });
+    recreateTestFixture();
+    releaseThread.join();
+
+    EXPECT_EQ(3u, GetSetBlobCount());
+    EXPECT_EQ(3u, GetApplicationCacheEntryCount());
+}
+
 // Tests error conditions of the APIs.
 TEST_P(EGLBlobCacheTest, NegativeAPI)
 {
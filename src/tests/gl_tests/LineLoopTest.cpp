@@ -468,6 +468,78 @@ TEST_P(LineLoopIndirectTest, UShortIndexIndirectBuffer)
     runTest(GL_UNSIGNED_SHORT, reinterpret_cast<const void *>(indices), sizeof(indices), 1);
 }
 
+// Tests that a line loop drawn from an index buffer that a compute shader rewrote uses the new
+// indices, even though the same range was converted before.
+TEST_P(LineLoopIndirectTest, IndexBufferWrittenByComputeShader)
+{
+    constexpr char kCS[] = R"(#version 310 es
+layout(local_size_x = 1) in;
+layout(std430, binding = 0) buffer Indices
+{
+    uint indices[6];
+};
+void main()
+{
+    indices[0] = 0u;
+    indices[1] = 7u;
+    indices[2] = 6u;
+    indices[3] = 9u;
+    indices[4] = 8u;
+    indices[5] = 0u;
+})";
+
+    static const GLfloat loopPositions[] = {0.0f,  0.0f, 0.0f, 0.0f, 0.0f, 0.0f,  0.0f,
+                                            0.0f,  0.0f, 0.0f, 0.0f, 0.0f, -0.5f, -0.5f,
+                                            -0.5f, 0.5f, 0.5f, 0.5f, 0.5f, -0.5f};
+
+    static const GLfloat stripPositions[] = {-0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f, 0.5f, -0.5f};
+    static const GLubyte stripIndices[]   = {1, 0, 3, 2, 1};
+
+    // All of these indices are at the origin, so the first loop draws nothing.
+    static const GLuint indices[] = {0, 1, 2, 3, 4, 5};
+    const void *firstIndex       = reinterpret_cast<const void *>(sizeof(GLuint));
+
+    ANGLE_GL_COMPUTE_PROGRAM(computeProgram, kCS);
+
+    GLVertexArray vertexArray;
+    glBindVertexArray(vertexArray);
+
+    GLBuffer vertexBuffer;
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(loopPositions), loopPositions, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(mPositionLocation);
+    glVertexAttribPointer(mPositionLocation, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    GLBuffer indexBuffer;
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+    glUseProgram(mProgram);
+    glUniform4f(mColorLocation, 0.0f, 0.0f, 1.0f, 1.0f);
+    glDrawElements(GL_LINE_LOOP, 4, GL_UNSIGNED_INT, firstIndex);
+    ASSERT_GL_NO_ERROR();
+
+    glUseProgram(computeProgram);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, indexBuffer);
+    glDispatchCompute(1, 1, 1);
+    glMemoryBarrier(GL_ELEMENT_ARRAY_BARRIER_BIT);
+    ASSERT_GL_NO_ERROR();
+
+    glClear(GL_COLOR_BUFFER_BIT);
+    glUseProgram(mProgram);
+    glDrawElements(GL_LINE_LOOP, 4, GL_UNSIGNED_INT, firstIndex);
+    ASSERT_GL_NO_ERROR();
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glEnableVertexAttribArray(mPositionLocation);
+    glVertexAttribPointer(mPositionLocation, 2, GL_FLOAT, GL_FALSE, 0, stripPositions);
+    glUniform4f(mColorLocation, 0, 1, 0, 1);
+    glDrawElements(GL_LINE_STRIP, 5, GL_UNSIGNED_BYTE, stripIndices);
+
+    checkPixels();
+}
+
 // Use this to select which configurations (e.g. which renderer, which GLES major version) these
 // tests should be run against.
 ANGLE_INSTANTIATE_TEST(LineLoopTest,
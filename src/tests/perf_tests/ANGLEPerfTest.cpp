@@ -12,6 +12,7 @@
 #include "ANGLEPerfTestArgs.h"
 #include "common/platform.h"
 #include "common/system_utils.h"
+#include "common/trace_recorder.h"
 #include "third_party/perf/perf_test.h"
 #include "third_party/trace_event/trace_event.h"
 #include "util/shader_utils.h"
@@ -19,12 +20,9 @@
 
 #include <cassert>
 #include <cmath>
-#include <fstream>
 #include <iostream>
 #include <sstream>
 
-#include <json/json.h>
-
 #if defined(ANGLE_USE_UTIL_LOADER) && defined(ANGLE_PLATFORM_WINDOWS)
 #    include "util/windows/WGLWindow.h"
 #endif  // defined(ANGLE_USE_UTIL_LOADER) &&defined(ANGLE_PLATFORM_WINDOWS)
@@ -33,23 +31,14 @@ using namespace angle;
 
 namespace
 {
-constexpr size_t kInitialTraceEventBufferSize = 50000;
-constexpr double kMicroSecondsPerSecond       = 1e6;
-constexpr double kNanoSecondsPerSecond        = 1e9;
-constexpr double kCalibrationRunTimeSeconds   = 1.0;
-constexpr double kMaximumRunTimeSeconds       = 10.0;
-constexpr unsigned int kNumTrials             = 3;
-
-struct TraceCategory
-{
-    unsigned char enabled;
-    const char *name;
-};
+constexpr double kMicroSecondsPerSecond     = 1e6;
+constexpr double kNanoSecondsPerSecond      = 1e9;
+constexpr double kCalibrationRunTimeSeconds = 1.0;
+constexpr double kMaximumRunTimeSeconds     = 10.0;
+constexpr unsigned int kNumTrials           = 3;
 
-constexpr TraceCategory gTraceCategories[2] = {
-    {1, "gpu.angle"},
-    {1, "gpu.angle.gpu"},
-};
+// Categories recorded with --enable-trace.
+constexpr char kTraceCategories[] = "gpu.angle,gpu.angle.gpu";
 
 void EmptyPlatformMethod(angle::PlatformMethods *, const char *) {}
 
@@ -71,37 +60,16 @@ angle::TraceEventHandle AddPerfTraceEvent(angle::PlatformMethods *platform,
                                           const unsigned long long *argValues,
                                           unsigned char flags)
 {
-    if (!gEnableTrace)
-        return 0;
-
-    // Discover the category name based on categoryEnabledFlag.  This flag comes from the first
-    // parameter of TraceCategory, and corresponds to one of the entries in gTraceCategories.
-    static_assert(offsetof(TraceCategory, enabled) == 0,
-                  "|enabled| must be the first field of the TraceCategory class.");
-    const TraceCategory *category = reinterpret_cast<const TraceCategory *>(categoryEnabledFlag);
-
-    ANGLERenderTest *renderTest     = static_cast<ANGLERenderTest *>(platform->context);
-    std::vector<TraceEvent> &buffer = renderTest->getTraceEventBuffer();
-    buffer.emplace_back(phase, category->name, name, timestamp);
-    return buffer.size();
+    // Events from ANGLE go to the same recorder as the test's own events. ANGLE caches the
+    // category flags, so they are only non-zero while the recorder is running.
+    TraceRecorder::Get()->addEvent(phase, categoryEnabledFlag, name, timestamp);
+    return 0;
 }
 
 const unsigned char *GetPerfTraceCategoryEnabled(angle::PlatformMethods *platform,
                                                  const char *categoryName)
 {
-    if (gEnableTrace)
-    {
-        for (const TraceCategory &category : gTraceCategories)
-        {
-            if (strcmp(category.name, categoryName) == 0)
-            {
-                return &category.enabled;
-            }
-        }
-    }
-
-    constexpr static unsigned char kZero = 0;
-    return &kZero;
+    return TraceRecorder::Get()->getCategoryEnabledFlag(categoryName);
 }
 
 void UpdateTraceEventDuration(angle::PlatformMethods *platform,
@@ -119,43 +87,6 @@ double MonotonicallyIncreasingTime(angle::PlatformMethods *platform)
     static double origin = angle::GetCurrentTime();
     return angle::GetCurrentTime() - origin;
 }
-
-void DumpTraceEventsToJSONFile(const std::vector<TraceEvent> &traceEvents,
-                               const char *outputFileName)
-{
-    Json::Value eventsValue(Json::arrayValue);
-
-    for (const TraceEvent &traceEvent : traceEvents)
-    {
-        Json::Value value(Json::objectValue);
-
-        std::stringstream phaseName;
-        phaseName << traceEvent.phase;
-
-        const auto microseconds =
-            static_cast<Json::LargestInt>(traceEvent.timestamp * 1000.0 * 1000.0);
-
-        value["name"] = traceEvent.name;
-        value["cat"]  = traceEvent.categoryName;
-        value["ph"]   = phaseName.str();
-        value["ts"]   = microseconds;
-        value["pid"]  = "ANGLE";
-        value["tid"]  = strcmp(traceEvent.categoryName, "gpu.angle.gpu") == 0 ? "GPU" : "CPU";
-
-        eventsValue.append(value);
-    }
-
-    Json::Value root(Json::objectValue);
-    root["traceEvents"] = eventsValue;
-
-    std::ofstream outFile;
-    outFile.open(outputFileName);
-
-    Json::StyledWriter styledWrite;
-    outFile << styledWrite.write(root);
-
-    outFile.close();
-}
 }  // anonymous namespace
 
 ANGLEPerfTest::ANGLEPerfTest(const std::string &name,
@@ -386,9 +317,6 @@ ANGLERenderTest::ANGLERenderTest(const std::string &name, const RenderTestParams
         const_cast<RenderTestParams &>(testParams).iterationsPerStep = 1;
     }
 
-    // Try to ensure we don't trigger allocation during execution.
-    mTraceEventBuffer.reserve(kInitialTraceEventBufferSize);
-
     switch (testParams.driver)
     {
         case angle::GLESDriverType::AngleEGL:
@@ -448,6 +376,12 @@ void ANGLERenderTest::SetUp()
         return;
     }
 
+    // Start before initializing the display so that ANGLE's startup is included in the trace.
+    if (gEnableTrace)
+    {
+        TraceRecorder::Get()->start(gTraceFile, kTraceCategories);
+    }
+
     mPlatformMethods.overrideWorkaroundsD3D      = OverrideWorkaroundsD3D;
     mPlatformMethods.logError                    = EmptyPlatformMethod;
     mPlatformMethods.logWarning                  = EmptyPlatformMethod;
@@ -523,10 +457,10 @@ void ANGLERenderTest::TearDown()
         mOSWindow = nullptr;
     }
 
-    // Dump trace events to json file.
+    // Writes out the remaining trace events.
     if (gEnableTrace)
     {
-        DumpTraceEventsToJSONFile(mTraceEventBuffer, gTraceFile);
+        TraceRecorder::Get()->stop();
     }
 
     ANGLEPerfTest::TearDown();
@@ -534,18 +468,22 @@ void ANGLERenderTest::TearDown()
 
 void ANGLERenderTest::beginInternalTraceEvent(const char *name)
 {
-    if (gEnableTrace)
+    static const unsigned char *categoryEnabled =
+        TraceRecorder::Get()->getCategoryEnabledFlag("gpu.angle");
+    if (*categoryEnabled)
     {
-        mTraceEventBuffer.emplace_back(TRACE_EVENT_PHASE_BEGIN, gTraceCategories[0].name, name,
+        TraceRecorder::Get()->addEvent(TRACE_EVENT_PHASE_BEGIN, categoryEnabled, name,
                                        MonotonicallyIncreasingTime(&mPlatformMethods));
     }
 }
 
 void ANGLERenderTest::endInternalTraceEvent(const char *name)
 {
-    if (gEnableTrace)
+    static const unsigned char *categoryEnabled =
+        TraceRecorder::Get()->getCategoryEnabledFlag("gpu.angle");
+    if (*categoryEnabled)
     {
-        mTraceEventBuffer.emplace_back(TRACE_EVENT_PHASE_END, gTraceCategories[0].name, name,
+        TraceRecorder::Get()->addEvent(TRACE_EVENT_PHASE_END, categoryEnabled, name,
                                        MonotonicallyIncreasingTime(&mPlatformMethods));
     }
 }
@@ -659,7 +597,3 @@ void ANGLERenderTest::setRobustResourceInit(bool enabled)
     mConfigParams.robustResourceInit = enabled;
 }
 
-std::vector<TraceEvent> &ANGLERenderTest::getTraceEventBuffer()
-{
-    return mTraceEventBuffer;
-}
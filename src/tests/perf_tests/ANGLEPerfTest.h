@@ -36,23 +36,6 @@ class Event;
         ASSERT_EQ(static_cast<GLenum>(expected), static_cast<GLenum>(actual))
 #endif  // !defined(ASSERT_GLENUM_EQ)
 
-// These are trace events according to Google's "Trace Event Format".
-// See https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
-// Only a subset of the properties are implemented.
-struct TraceEvent final
-{
-    TraceEvent() {}
-
-    TraceEvent(char phaseIn, const char *categoryNameIn, const char *nameIn, double timestampIn)
-        : phase(phaseIn), categoryName(categoryNameIn), name(nameIn), timestamp(timestampIn)
-    {}
-
-    char phase               = 0;
-    const char *categoryName = nullptr;
-    const char *name         = nullptr;
-    double timestamp         = 0;
-};
-
 class ANGLEPerfTest : public testing::Test, angle::NonCopyable
 {
   public:
@@ -131,8 +114,6 @@ class ANGLERenderTest : public ANGLEPerfTest
 
     OSWindow *getWindow();
 
-    std::vector<TraceEvent> &getTraceEventBuffer();
-
     virtual void overrideWorkaroundsD3D(angle::FeaturesD3D *featuresD3D) {}
 
   protected:
@@ -165,9 +146,6 @@ class ANGLERenderTest : public ANGLEPerfTest
 
     GLuint mTimestampQuery;
 
-    // Trace event record that can be output.
-    std::vector<TraceEvent> mTraceEventBuffer;
-
     // Handle to the entry point binding library.
     std::unique_ptr<angle::Library> mEntryPointsLib;
 };
@@ -15,8 +15,9 @@ namespace angle
 {
 bool gCalibration = false;
 Optional<unsigned int> gStepsToRunOverride;
-bool gEnableTrace      = false;
-const char *gTraceFile = "ANGLETrace.json";
+bool gEnableTrace            = false;
+const char *gTraceFile       = "ANGLETrace.json";
+const char *gShaderCorpusDir = nullptr;
 }  // namespace angle
 
 using namespace angle;
@@ -55,6 +56,12 @@ void ANGLEProcessPerfTestArgs(int *argc, char **argv)
             // Skip an additional argument.
             argIndex++;
         }
+        else if (strcmp("--shader-corpus", argv[argIndex]) == 0 && argIndex < *argc - 1)
+        {
+            gShaderCorpusDir = argv[argIndex + 1];
+            // Skip an additional argument.
+            argIndex++;
+        }
         else
         {
             argv[argcOutCount++] = argv[argIndex];
@@ -18,6 +18,7 @@ extern bool gCalibration;
 extern Optional<unsigned int> gStepsToRunOverride;
 extern bool gEnableTrace;
 extern const char *gTraceFile;
+extern const char *gShaderCorpusDir;
 
 inline bool OneFrame()
 {
@@ -0,0 +1,106 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// BlobCachePerf:
+//   Stress test for the blob cache. Several threads look up keys from a set that doesn't fit in
+//   the cache and store the ones they miss, like contexts on different threads loading programs.
+//
+
+#include "ANGLEPerfTest.h"
+
+#include <thread>
+#include <vector>
+
+#include "libANGLE/BlobCache.h"
+
+using namespace angle;
+
+namespace
+{
+constexpr size_t kOpsPerThread = 1024;
+constexpr size_t kKeyCount     = 512;
+constexpr size_t kBlobSize     = 4096;
+// Room for half of the keys, so some lookups miss and evict.
+constexpr size_t kCacheSize = kKeyCount * kBlobSize / 2;
+
+class BlobCachePerfTest : public ANGLEPerfTest, public ::testing::WithParamInterface<unsigned int>
+{
+  public:
+    BlobCachePerfTest();
+
+    void step() override;
+
+  private:
+    void runThread(unsigned int threadIndex);
+
+    egl::BlobCache mBlobCache;
+    std::vector<egl::BlobCache::Key> mKeys;
+};
+
+std::string ThreadCountSuffix(unsigned int threadCount)
+{
+    return "_" + std::to_string(threadCount) + "_threads";
+}
+
+BlobCachePerfTest::BlobCachePerfTest()
+    : ANGLEPerfTest("BlobCachePerf", "", ThreadCountSuffix(GetParam()), kOpsPerThread),
+      mBlobCache(kCacheSize),
+      mKeys(kKeyCount)
+{
+    for (size_t keyIndex = 0; keyIndex < kKeyCount; ++keyIndex)
+    {
+        angle::base::SHA1HashBytes(reinterpret_cast<const unsigned char *>(&keyIndex),
+                                   sizeof(keyIndex), mKeys[keyIndex].data());
+    }
+}
+
+void BlobCachePerfTest::step()
+{
+    std::vector<std::thread> threads;
+    for (unsigned int threadIndex = 0; threadIndex < GetParam(); ++threadIndex)
+    {
+        threads.emplace_back(&BlobCachePerfTest::runThread, this, threadIndex);
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void BlobCachePerfTest::runThread(unsigned int threadIndex)
+{
+    ScratchBuffer scratchBuffer(1);
+    uint32_t randomState = threadIndex + 1;
+
+    for (size_t op = 0; op < kOpsPerThread; ++op)
+    {
+        // Squaring a uniform value favors the keys with low indices.
+        randomState    = randomState * 1664525u + 1013904223u;
+        double uniform = static_cast<double>(randomState >> 8) / static_cast<double>(1 << 24);
+        const egl::BlobCache::Key &key = mKeys[static_cast<size_t>(uniform * uniform * kKeyCount)];
+
+        egl::BlobCache::Value value;
+        if (mBlobCache.get(&scratchBuffer, key, &value))
+        {
+            continue;
+        }
+
+        MemoryBuffer blob;
+        if (blob.resize(kBlobSize))
+        {
+            blob.fill(key[0]);
+            mBlobCache.populate(key, std::move(blob), egl::BlobCache::CacheSource::Memory);
+        }
+    }
+}
+
+TEST_P(BlobCachePerfTest, Run)
+{
+    run();
+}
+
+INSTANTIATE_TEST_SUITE_P(, BlobCachePerfTest, ::testing::Values(1u, 2u, 4u, 8u));
+
+}  // anonymous namespace
@@ -0,0 +1,605 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// CompilerCorpusPerfTest:
+//   Performance test for the shader translator with a corpus of shaders. Each step compiles the
+//   whole corpus, split over one or more threads. Every thread always compiles the same shaders
+//   with its own compiler instances, so the results don't depend on scheduling.
+//
+//   The corpus is the directory given with --shader-corpus. All .vert, .frag, .comp and .geom
+//   files in it are used, in alphabetical order. A small built-in corpus is used otherwise.
+//
+//   Besides the wall time per shader, the test reports the time spent in the preprocessor, the
+//   parser, the AST passes and the output, and the peak pool memory used by a single compile.
+//
+
+#include "ANGLEPerfTest.h"
+#include "ANGLEPerfTestArgs.h"
+
+#include <algorithm>
+#include <map>
+#include <thread>
+
+#if defined(ANGLE_PLATFORM_WINDOWS)
+#    include <windows.h>
+#else
+#    include <dirent.h>
+#endif
+
+#include "GLSLANG/ShaderLang.h"
+#include "common/string_utils.h"
+#include "compiler/preprocessor/DiagnosticsBase.h"
+#include "compiler/preprocessor/DirectiveHandlerBase.h"
+#include "compiler/preprocessor/Preprocessor.h"
+#include "compiler/preprocessor/Token.h"
+#include "compiler/translator/Compiler.h"
+#include "compiler/translator/InitializeGlobals.h"
+#include "compiler/translator/PoolAlloc.h"
+
+namespace
+{
+
+struct BuiltInShader
+{
+    const char *name;
+    sh::GLenum type;
+    const char *source;
+};
+
+const BuiltInShader kBuiltInCorpus[] = {
+    {"SpriteESSL100.vert", GL_VERTEX_SHADER, R"(attribute vec4 aPosition;
+attribute vec2 aTexCoord;
+attribute vec4 aColor;
+uniform mat4 uModelViewProjection;
+uniform vec4 uTexRect;
+varying vec2 vTexCoord;
+varying vec4 vColor;
+void main()
+{
+    vTexCoord   = uTexRect.xy + aTexCoord * uTexRect.zw;
+    vColor      = aColor;
+    gl_Position = uModelViewProjection * aPosition;
+})"},
+    {"BlurESSL100.frag", GL_FRAGMENT_SHADER, R"(precision mediump float;
+uniform sampler2D uTexture;
+uniform vec2 uDirection;
+uniform float uWeights[8];
+varying vec2 vTexCoord;
+varying vec4 vColor;
+void main()
+{
+    vec4 sum = texture2D(uTexture, vTexCoord) * uWeights[0];
+    for (int i = 1; i < 8; ++i)
+    {
+        vec2 offset = uDirection * float(i);
+        sum += texture2D(uTexture, vTexCoord + offset) * uWeights[i];
+        sum += texture2D(uTexture, vTexCoord - offset) * uWeights[i];
+    }
+    gl_FragColor = sum * vColor;
+})"},
+    {"InstancedESSL300.vert", GL_VERTEX_SHADER, R"(#version 300 es
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in mat4 aInstanceTransform;
+layout(std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    vec3 eyePosition;
+};
+out vec3 vNormal;
+out vec3 vViewDirection;
+void main()
+{
+    vec4 worldPosition = aInstanceTransform * vec4(aPosition, 1.0);
+    vNormal            = mat3(aInstanceTransform) * aNormal;
+    vViewDirection     = eyePosition - worldPosition.xyz;
+    gl_Position        = projection * view * worldPosition;
+})"},
+    {"DeferredESSL300.frag", GL_FRAGMENT_SHADER, R"(#version 300 es
+precision highp float;
+struct Material
+{
+    vec3 albedo;
+    float roughness;
+    int model;
+};
+uniform Material uMaterial;
+in vec3 vNormal;
+in vec3 vViewDirection;
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec4 outNormal;
+void main()
+{
+    vec3 normal  = normalize(vNormal);
+    float facing = max(dot(normal, normalize(vViewDirection)), 0.0);
+    vec3 albedo;
+    switch (uMaterial.model)
+    {
+        case 0:
+            albedo = uMaterial.albedo;
+            break;
+        case 1:
+            albedo = uMaterial.albedo * facing;
+            break;
+        default:
+            albedo = mix(uMaterial.albedo, vec3(1.0), pow(1.0 - facing, 5.0));
+            break;
+    }
+    outAlbedo = vec4(albedo, uMaterial.roughness);
+    outNormal = vec4(normal * 0.5 + 0.5, 1.0);
+})"},
+    {"ReduceESSL310.comp", GL_COMPUTE_SHADER, R"(#version 310 es
+layout(local_size_x = 64) in;
+layout(std430, binding = 0) readonly buffer Input
+{
+    float values[];
+};
+layout(std430, binding = 1) writeonly buffer Output
+{
+    float sums[];
+};
+shared float partialSums[64];
+void main()
+{
+    uint index               = gl_LocalInvocationIndex;
+    partialSums[index]       = values[gl_GlobalInvocationID.x];
+    for (uint stride = 32u; stride > 0u; stride >>= 1u)
+    {
+        barrier();
+        if (index < stride)
+        {
+            partialSums[index] += partialSums[index + stride];
+        }
+    }
+    if (index == 0u)
+    {
+        sums[gl_WorkGroupID.x] = partialSums[0];
+    }
+})"},
+};
+
+struct CorpusShader
+{
+    std::string name;
+    sh::GLenum type;
+    std::string source;
+};
+
+bool GetShaderTypeFromFileName(const std::string &fileName, sh::GLenum *typeOut)
+{
+    const std::pair<const char *, sh::GLenum> kExtensions[] = {
+        {".vert", GL_VERTEX_SHADER},
+        {".frag", GL_FRAGMENT_SHADER},
+        {".comp", GL_COMPUTE_SHADER},
+        {".geom", GL_GEOMETRY_SHADER_EXT},
+    };
+
+    for (const auto &extension : kExtensions)
+    {
+        if (angle::EndsWith(fileName, extension.first))
+        {
+            *typeOut = extension.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> ListDirectory(const std::string &directory)
+{
+    std::vector<std::string> fileNames;
+
+#if defined(ANGLE_PLATFORM_WINDOWS)
+    WIN32_FIND_DATAA findData;
+    HANDLE findHandle = FindFirstFileA((directory + "\\*").c_str(), &findData);
+    if (findHandle != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+            {
+                fileNames.push_back(findData.cFileName);
+            }
+        } while (FindNextFileA(findHandle, &findData));
+        FindClose(findHandle);
+    }
+#else
+    DIR *dir = opendir(directory.c_str());
+    if (dir)
+    {
+        while (dirent *entry = readdir(dir))
+        {
+            fileNames.push_back(entry->d_name);
+        }
+        closedir(dir);
+    }
+#endif
+
+    // The order of directory entries is unspecified.
+    std::sort(fileNames.begin(), fileNames.end());
+    return fileNames;
+}
+
+std::vector<CorpusShader> LoadCorpus()
+{
+    std::vector<CorpusShader> corpus;
+
+    if (angle::gShaderCorpusDir == nullptr)
+    {
+        for (const BuiltInShader &shader : kBuiltInCorpus)
+        {
+            corpus.push_back({shader.name, shader.type, shader.source});
+        }
+        return corpus;
+    }
+
+    for (const std::string &fileName : ListDirectory(angle::gShaderCorpusDir))
+    {
+        CorpusShader shader;
+        if (!GetShaderTypeFromFileName(fileName, &shader.type))
+        {
+            continue;
+        }
+
+        std::string path = std::string(angle::gShaderCorpusDir) + "/" + fileName;
+        if (!angle::ReadFileToString(path, &shader.source))
+        {
+            std::cerr << "Could not read shader " << path << std::endl;
+            continue;
+        }
+
+        shader.name = fileName;
+        corpus.push_back(std::move(shader));
+    }
+    return corpus;
+}
+
+const std::vector<CorpusShader> &GetCorpus()
+{
+    static const std::vector<CorpusShader> corpus = LoadCorpus();
+    return corpus;
+}
+
+class NullDiagnostics : public angle::pp::Diagnostics
+{
+  protected:
+    void print(ID id, const angle::pp::SourceLocation &loc, const std::string &text) override {}
+};
+
+class NullDirectiveHandler : public angle::pp::DirectiveHandler
+{
+  public:
+    void handleError(const angle::pp::SourceLocation &loc, const std::string &msg) override {}
+    void handlePragma(const angle::pp::SourceLocation &loc,
+                      const std::string &name,
+                      const std::string &value,
+                      bool stdgl) override
+    {}
+    void handleExtension(const angle::pp::SourceLocation &loc,
+                         const std::string &name,
+                         const std::string &behavior) override
+    {}
+    void handleVersion(const angle::pp::SourceLocation &loc,
+                       int version,
+                       ShShaderSpec spec) override
+    {}
+};
+
+// Preprocessing is driven by the parser, so the translator can't time it separately. It's
+// measured by running the preprocessor on its own instead.
+double MeasurePreprocessTime(const std::vector<CorpusShader> &corpus)
+{
+    constexpr int kNumIterations = 10;
+
+    NullDiagnostics diagnostics;
+    NullDirectiveHandler directiveHandler;
+
+    Timer timer;
+    timer.start();
+    for (int iteration = 0; iteration < kNumIterations; ++iteration)
+    {
+        for (const CorpusShader &shader : corpus)
+        {
+            angle::pp::Preprocessor preprocessor(&diagnostics, &directiveHandler,
+                                                 angle::pp::PreprocessorSettings(SH_GLES3_1_SPEC));
+            const char *shaderStrings[] = {shader.source.c_str()};
+            preprocessor.init(1, shaderStrings, nullptr);
+
+            angle::pp::Token token;
+            do
+            {
+                preprocessor.lex(&token);
+            } while (token.type != angle::pp::Token::LAST);
+        }
+    }
+    timer.stop();
+
+    return timer.getElapsedTime() / (kNumIterations * corpus.size());
+}
+
+constexpr unsigned int kThreadCounts[] = {1, 2, 4, 8};
+
+struct CompilerCorpusPerfParameters
+{
+    CompilerCorpusPerfParameters(ShShaderOutput output, unsigned int threadCount)
+        : output(output), threadCount(threadCount)
+    {
+        switch (output)
+        {
+            case SH_HLSL_4_1_OUTPUT:
+                testId = "HLSL_4_1";
+                break;
+            case SH_GLSL_450_CORE_OUTPUT:
+                testId = "GLSL_4_50";
+                break;
+            case SH_GLSL_VULKAN_OUTPUT:
+                testId = "GLSL_VULKAN";
+                break;
+            case SH_ESSL_OUTPUT:
+                testId = "ESSL";
+                break;
+            default:
+                UNREACHABLE();
+                testId = "unk";
+                break;
+        }
+        testId += "_" + std::to_string(threadCount) + "_threads";
+    }
+
+    ShShaderOutput output;
+    unsigned int threadCount;
+    std::string testId;
+};
+
+std::ostream &operator<<(std::ostream &stream, const CompilerCorpusPerfParameters &p)
+{
+    stream << p.testId;
+    return stream;
+}
+
+bool IsPlatformAvailable(const CompilerCorpusPerfParameters &param)
+{
+    // The translators that are not built in can't be constructed.
+    angle::PoolAllocator allocator;
+    InitializePoolIndex();
+    allocator.push();
+    SetGlobalPoolAllocator(&allocator);
+    sh::TCompiler *translator =
+        sh::ConstructCompiler(GL_FRAGMENT_SHADER, SH_GLES3_1_SPEC, param.output);
+    bool success = translator != nullptr;
+    SafeDelete(translator);
+    SetGlobalPoolAllocator(nullptr);
+    allocator.pop();
+    FreePoolIndex();
+    return success;
+}
+
+class CompilerCorpusPerfTest : public ANGLEPerfTest,
+                               public ::testing::WithParamInterface<CompilerCorpusPerfParameters>
+{
+  public:
+    CompilerCorpusPerfTest();
+
+    void step() override;
+
+    void SetUp() override;
+    void TearDown() override;
+
+  private:
+    // The state of one compiling thread.
+    struct Worker
+    {
+        std::vector<const CorpusShader *> shaders;
+        std::map<sh::GLenum, sh::TCompiler *> translators;
+
+        size_t compileCount     = 0;
+        size_t failureCount     = 0;
+        size_t peakCompileBytes = 0;
+        sh::CompilePhaseTimes phaseTimes;
+    };
+
+    static void CompileShaders(Worker *worker);
+
+    ShBuiltInResources mResources;
+    angle::PoolAllocator mAllocator;
+    std::vector<Worker> mWorkers;
+    double mPreprocessTime;
+};
+
+CompilerCorpusPerfTest::CompilerCorpusPerfTest()
+    : ANGLEPerfTest("CompilerCorpusPerf",
+                    "",
+                    GetParam().testId,
+                    static_cast<unsigned int>(std::max<size_t>(GetCorpus().size(), 1))),
+      mPreprocessTime(0.0)
+{
+    mReporter->RegisterFyiMetric(".preprocess_time", "us");
+    mReporter->RegisterFyiMetric(".parse_time", "us");
+    mReporter->RegisterFyiMetric(".ast_passes_time", "us");
+    mReporter->RegisterFyiMetric(".output_time", "us");
+    mReporter->RegisterFyiMetric(".peak_compile_memory", "bytes");
+    mReporter->RegisterFyiMetric(".compile_failures", "count");
+}
+
+void CompilerCorpusPerfTest::SetUp()
+{
+    ANGLEPerfTest::SetUp();
+
+    const std::vector<CorpusShader> &corpus = GetCorpus();
+    if (corpus.empty())
+    {
+        std::cout << "No shaders found in " << angle::gShaderCorpusDir << ". Skipping test."
+                  << std::endl;
+        mSkipTest = true;
+        return;
+    }
+
+    InitializePoolIndex();
+    mAllocator.push();
+    SetGlobalPoolAllocator(&mAllocator);
+
+    // Enable what real world shaders commonly use.
+    sh::InitBuiltInResources(&mResources);
+    mResources.FragmentPrecisionHigh        = 1;
+    mResources.MaxDrawBuffers               = 8;
+    mResources.OES_standard_derivatives     = 1;
+    mResources.OES_EGL_image_external       = 1;
+    mResources.OES_EGL_image_external_essl3 = 1;
+    mResources.OES_texture_3D               = 1;
+    mResources.EXT_draw_buffers             = 1;
+    mResources.EXT_frag_depth               = 1;
+    mResources.EXT_shader_texture_lod       = 1;
+    mResources.EXT_geometry_shader          = 1;
+
+    const CompilerCorpusPerfParameters &params = GetParam();
+
+    mWorkers.resize(params.threadCount);
+    for (size_t shaderIndex = 0; shaderIndex < corpus.size(); ++shaderIndex)
+    {
+        mWorkers[shaderIndex % mWorkers.size()].shaders.push_back(&corpus[shaderIndex]);
+    }
+
+    for (Worker &worker : mWorkers)
+    {
+        for (const CorpusShader *shader : worker.shaders)
+        {
+            sh::TCompiler *&translator = worker.translators[shader->type];
+            if (translator != nullptr)
+            {
+                continue;
+            }
+
+            translator = sh::ConstructCompiler(shader->type, SH_GLES3_1_SPEC, params.output);
+            ASSERT(translator);
+            translator->Init(mResources);
+            translator->setMeasurePhaseTimes(true);
+        }
+    }
+
+    mPreprocessTime = MeasurePreprocessTime(corpus);
+}
+
+void CompilerCorpusPerfTest::TearDown()
+{
+    if (!mWorkers.empty())
+    {
+        size_t compileCount     = 0;
+        size_t failureCount     = 0;
+        size_t peakCompileBytes = 0;
+        sh::CompilePhaseTimes phaseTimes;
+
+        for (Worker &worker : mWorkers)
+        {
+            compileCount += worker.compileCount;
+            failureCount += worker.failureCount;
+            peakCompileBytes = std::max(peakCompileBytes, worker.peakCompileBytes);
+            phaseTimes.parse += worker.phaseTimes.parse;
+            phaseTimes.astPasses += worker.phaseTimes.astPasses;
+            phaseTimes.output += worker.phaseTimes.output;
+
+            for (auto &translator : worker.translators)
+            {
+                SafeDelete(translator.second);
+            }
+        }
+
+        if (compileCount > 0)
+        {
+            double secondsToMicroseconds = 1e6 / static_cast<double>(compileCount);
+            mReporter->AddResult(".preprocess_time", mPreprocessTime * 1e6);
+            mReporter->AddResult(".parse_time", phaseTimes.parse * secondsToMicroseconds);
+            mReporter->AddResult(".ast_passes_time", phaseTimes.astPasses * secondsToMicroseconds);
+            mReporter->AddResult(".output_time", phaseTimes.output * secondsToMicroseconds);
+            mReporter->AddResult(".peak_compile_memory", peakCompileBytes);
+            // Every shader is compiled the same number of times.
+            mReporter->AddResult(".compile_failures",
+                                 failureCount * GetCorpus().size() / compileCount);
+        }
+
+        mWorkers.clear();
+
+        SetGlobalPoolAllocator(nullptr);
+        mAllocator.pop();
+
+        FreePoolIndex();
+    }
+
+    ANGLEPerfTest::TearDown();
+}
+
+// static
+void CompilerCorpusPerfTest::CompileShaders(Worker *worker)
+{
+    constexpr ShCompileOptions kCompileOptions =
+        SH_OBJECT_CODE | SH_VARIABLES | SH_INITIALIZE_UNINITIALIZED_LOCALS |
+        SH_INIT_OUTPUT_VARIABLES;
+
+    for (const CorpusShader *shader : worker->shaders)
+    {
+        sh::TCompiler *translator             = worker->translators[shader->type];
+        const angle::PoolAllocator &allocator = translator->getAllocator();
+        const char *shaderStrings[]           = {shader->source.c_str()};
+
+        // The pool only grows during a compile, so what was allocated is also the peak.
+        size_t totalBytes = allocator.getTotalBytes();
+        if (!translator->compile(shaderStrings, 1, kCompileOptions))
+        {
+            ++worker->failureCount;
+        }
+        worker->peakCompileBytes =
+            std::max(worker->peakCompileBytes, allocator.getTotalBytes() - totalBytes);
+
+        const sh::CompilePhaseTimes &phaseTimes = translator->getPhaseTimes();
+        worker->phaseTimes.parse += phaseTimes.parse;
+        worker->phaseTimes.astPasses += phaseTimes.astPasses;
+        worker->phaseTimes.output += phaseTimes.output;
+        ++worker->compileCount;
+    }
+}
+
+void CompilerCorpusPerfTest::step()
+{
+    if (mWorkers.size() == 1)
+    {
+        CompileShaders(&mWorkers[0]);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    for (Worker &worker : mWorkers)
+    {
+        threads.emplace_back(CompileShaders, &worker);
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+TEST_P(CompilerCorpusPerfTest, Run)
+{
+    run();
+}
+
+ANGLE_INSTANTIATE_TEST(CompilerCorpusPerfTest,
+                       CompilerCorpusPerfParameters(SH_ESSL_OUTPUT, kThreadCounts[0]),
+                       CompilerCorpusPerfParameters(SH_ESSL_OUTPUT, kThreadCounts[1]),
+                       CompilerCorpusPerfParameters(SH_ESSL_OUTPUT, kThreadCounts[2]),
+                       CompilerCorpusPerfParameters(SH_ESSL_OUTPUT, kThreadCounts[3]),
+                       CompilerCorpusPerfParameters(SH_GLSL_450_CORE_OUTPUT, kThreadCounts[0]),
+                       CompilerCorpusPerfParameters(SH_GLSL_450_CORE_OUTPUT, kThreadCounts[1]),
+                       CompilerCorpusPerfParameters(SH_GLSL_450_CORE_OUTPUT, kThreadCounts[2]),
+                       CompilerCorpusPerfParameters(SH_GLSL_450_CORE_OUTPUT, kThreadCounts[3]),
+                       CompilerCorpusPerfParameters(SH_GLSL_VULKAN_OUTPUT, kThreadCounts[0]),
+                       CompilerCorpusPerfParameters(SH_GLSL_VULKAN_OUTPUT, kThreadCounts[1]),
+                       CompilerCorpusPerfParameters(SH_GLSL_VULKAN_OUTPUT, kThreadCounts[2]),
+                       CompilerCorpusPerfParameters(SH_GLSL_VULKAN_OUTPUT, kThreadCounts[3]),
+                       CompilerCorpusPerfParameters(SH_HLSL_4_1_OUTPUT, kThreadCounts[0]),
+                       CompilerCorpusPerfParameters(SH_HLSL_4_1_OUTPUT, kThreadCounts[1]),
+                       CompilerCorpusPerfParameters(SH_HLSL_4_1_OUTPUT, kThreadCounts[2]),
+                       CompilerCorpusPerfParameters(SH_HLSL_4_1_OUTPUT, kThreadCounts[3]));
+
+}  // anonymous namespace
@@ -7,10 +7,15 @@
 //   Performance test for the shader translator. The test initializes the compiler once and then
 //   compiles the same shader repeatedly. There are different variations of the tests using
 //   different shaders.
+//   CompilerInstancePerfTest compiles many small shaders with one compiler instance, which is
+//   either reused as is, updated with new resources or reconstructed, and reports the number of
+//   pool allocations per compile.
 //
 
 #include "ANGLEPerfTest.h"
 
+#include <sstream>
+
 #include "GLSLANG/ShaderLang.h"
 #include "compiler/translator/Compiler.h"
 #include "compiler/translator/InitializeGlobals.h"
@@ -162,8 +167,59 @@ void main()
 
 const char *kTrickyESSL300Id = "TrickyESSL300";
 
+// This shader spends most of its time in the preprocessor: a table of object-like macros and
+// deeply nested function-like macro invocations.
+const char *kPreprocessorHeavyESSL300FragSource = R"(#version 300 es
+precision highp float;
+uniform vec4 uParams[8];
+out vec4 outColor;
+
+#define PARAMETER_TABLE_ENTRY_0 uParams[0]
+#define PARAMETER_TABLE_ENTRY_1 uParams[1]
+#define PARAMETER_TABLE_ENTRY_2 uParams[2]
+#define PARAMETER_TABLE_ENTRY_3 uParams[3]
+#define PARAMETER_TABLE_ENTRY_4 uParams[4]
+#define PARAMETER_TABLE_ENTRY_5 uParams[5]
+#define PARAMETER_TABLE_ENTRY_6 uParams[6]
+#define PARAMETER_TABLE_ENTRY_7 uParams[7]
+#define CONSTANT_SCALE_FACTOR_LOW 0.25
+#define CONSTANT_SCALE_FACTOR_MID 0.5
+#define CONSTANT_SCALE_FACTOR_HIGH 0.75
+#define CONSTANT_SCALE_FACTOR_FULL 1.0
+
+#define ADD(a, b) ((a) + (b))
+#define SUB(a, b) ((a) - (b))
+#define MUL(a, b) ((a) * (b))
+#define MAD(a, b, c) ADD(MUL(a, b), c)
+#define LERP(a, b, t) MAD(SUB(b, a), t, a)
+#define SQUARE(x) MUL(x, x)
+#define SMOOTH(t) MUL(SQUARE(t), SUB(3.0, MUL(2.0, t)))
+#define SMOOTH_LERP(a, b, t) LERP(a, b, SMOOTH(t))
+#define BLEND2(a, b, t) SMOOTH_LERP(a, b, clamp(t, 0.0, 1.0))
+#define BLEND4(a, b, c, d, t) BLEND2(BLEND2(a, b, t), BLEND2(c, d, t), SQUARE(t))
+#define BLEND8(a, b, c, d, e, f, g, h, t) BLEND2(BLEND4(a, b, c, d, t), BLEND4(e, f, g, h, t), t)
+
+#define TABLE_BLEND(t) BLEND8(PARAMETER_TABLE_ENTRY_0, PARAMETER_TABLE_ENTRY_1, \
+                              PARAMETER_TABLE_ENTRY_2, PARAMETER_TABLE_ENTRY_3, \
+                              PARAMETER_TABLE_ENTRY_4, PARAMETER_TABLE_ENTRY_5, \
+                              PARAMETER_TABLE_ENTRY_6, PARAMETER_TABLE_ENTRY_7, t)
+
+void main()
+{
+    vec4 low  = TABLE_BLEND(CONSTANT_SCALE_FACTOR_LOW);
+    vec4 mid  = TABLE_BLEND(CONSTANT_SCALE_FACTOR_MID);
+    vec4 high = TABLE_BLEND(CONSTANT_SCALE_FACTOR_HIGH);
+    vec4 full = TABLE_BLEND(CONSTANT_SCALE_FACTOR_FULL);
+    outColor  = BLEND4(low, mid, high, full, SMOOTH(CONSTANT_SCALE_FACTOR_MID));
+})";
+
+const char *kPreprocessorHeavyESSL300Id = "PreprocessorHeavyESSL300";
+
 constexpr int kNumIterationsPerStep = 4;
 
+// The number of distinct small shaders compiled in each step of CompilerInstancePerfTest.
+constexpr int kNumSmallShaders = 16;
+
 struct CompilerParameters
 {
     CompilerParameters() { output = SH_HLSL_4_1_OUTPUT; }
@@ -327,21 +383,221 @@ TEST_P(CompilerPerfTest, Run)
     run();
 }
 
+enum class InstanceUsage
+{
+    // Compile all shaders with the same instance.
+    Reuse,
+    // Update the resources of the instance before the shaders are compiled, as happens when an
+    // extension is enabled.
+    UpdateResources,
+    // Construct a new instance before the shaders are compiled.
+    Reconstruct,
+};
+
+struct CompilerInstancePerfParameters final : public CompilerParameters
+{
+    CompilerInstancePerfParameters(ShShaderOutput output, InstanceUsage usage)
+        : CompilerParameters(output), usage(usage)
+    {
+        switch (usage)
+        {
+            case InstanceUsage::Reuse:
+                testId = "Reuse";
+                break;
+            case InstanceUsage::UpdateResources:
+                testId = "UpdateResources";
+                break;
+            case InstanceUsage::Reconstruct:
+                testId = "Reconstruct";
+                break;
+        }
+        testId += "_";
+        testId += CompilerParameters::str();
+    }
+
+    InstanceUsage usage;
+    std::string testId;
+};
+
+std::ostream &operator<<(std::ostream &stream, const CompilerInstancePerfParameters &p)
+{
+    stream << p.testId;
+    return stream;
+}
+
+class CompilerInstancePerfTest : public ANGLEPerfTest,
+                                 public ::testing::WithParamInterface<CompilerInstancePerfParameters>
+{
+  public:
+    CompilerInstancePerfTest();
+
+    void step() override;
+
+    void SetUp() override;
+    void TearDown() override;
+
+  private:
+    void createTranslator();
+    void destroyTranslator();
+
+    std::vector<std::string> mShaders;
+
+    ShBuiltInResources mResources;
+    angle::PoolAllocator mAllocator;
+    sh::TCompiler *mTranslator;
+
+    size_t mCompileCount;
+    size_t mAllocationCount;
+    size_t mPageAllocationCount;
+};
+
+CompilerInstancePerfTest::CompilerInstancePerfTest()
+    : ANGLEPerfTest("CompilerInstancePerf", "", GetParam().testId, kNumSmallShaders),
+      mTranslator(nullptr),
+      mCompileCount(0),
+      mAllocationCount(0),
+      mPageAllocationCount(0)
+{
+    mReporter->RegisterFyiMetric(".allocations_per_compile", "count");
+    mReporter->RegisterFyiMetric(".page_allocations_per_compile", "count");
+}
+
+void CompilerInstancePerfTest::SetUp()
+{
+    ANGLEPerfTest::SetUp();
+
+    InitializePoolIndex();
+    mAllocator.push();
+    SetGlobalPoolAllocator(&mAllocator);
+
+    sh::InitBuiltInResources(&mResources);
+    mResources.FragmentPrecisionHigh = true;
+
+    for (int shaderIndex = 0; shaderIndex < kNumSmallShaders; ++shaderIndex)
+    {
+        std::stringstream shader;
+        shader << "precision mediump float;\n"
+               << "uniform vec4 uColor" << shaderIndex << ";\n"
+               << "varying vec2 vTexCoord;\n"
+               << "void main()\n"
+               << "{\n"
+               << "    gl_FragColor = uColor" << shaderIndex << " * vec4(vTexCoord, "
+               << shaderIndex << ".0, 1.0);\n"
+               << "}\n";
+        mShaders.push_back(shader.str());
+    }
+
+    createTranslator();
+}
+
+void CompilerInstancePerfTest::TearDown()
+{
+    destroyTranslator();
+
+    if (mCompileCount > 0)
+    {
+        double compileCount = static_cast<double>(mCompileCount);
+        mReporter->AddResult(".allocations_per_compile", mAllocationCount / compileCount);
+        mReporter->AddResult(".page_allocations_per_compile", mPageAllocationCount / compileCount);
+    }
+
+    SetGlobalPoolAllocator(nullptr);
+    mAllocator.pop();
+
+    FreePoolIndex();
+
+    ANGLEPerfTest::TearDown();
+}
+
+void CompilerInstancePerfTest::createTranslator()
+{
+    mTranslator = sh::ConstructCompiler(GL_FRAGMENT_SHADER, SH_WEBGL2_SPEC, GetParam().output);
+    if (!mTranslator->Init(mResources))
+    {
+        SafeDelete(mTranslator);
+    }
+}
+
+void CompilerInstancePerfTest::destroyTranslator()
+{
+    SafeDelete(mTranslator);
+}
+
+void CompilerInstancePerfTest::step()
+{
+    switch (GetParam().usage)
+    {
+        case InstanceUsage::Reuse:
+            break;
+        case InstanceUsage::UpdateResources:
+            mResources.OES_standard_derivatives = !mResources.OES_standard_derivatives;
+            mTranslator->updateResources(mResources);
+            break;
+        case InstanceUsage::Reconstruct:
+            destroyTranslator();
+            createTranslator();
+            break;
+    }
+
+    ShCompileOptions compileOptions = SH_OBJECT_CODE | SH_VARIABLES |
+                                      SH_INITIALIZE_UNINITIALIZED_LOCALS | SH_INIT_OUTPUT_VARIABLES;
+
+    const angle::PoolAllocator &allocator = mTranslator->getAllocator();
+    size_t allocationCount                = allocator.getNumAllocations();
+    size_t pageAllocationCount            = allocator.getNumPageAllocations();
+
+    for (const std::string &shader : mShaders)
+    {
+        const char *shaderStrings[] = {shader.c_str()};
+        mTranslator->compile(shaderStrings, 1, compileOptions);
+    }
+
+    mCompileCount += mShaders.size();
+    mAllocationCount += allocator.getNumAllocations() - allocationCount;
+    mPageAllocationCount += allocator.getNumPageAllocations() - pageAllocationCount;
+}
+
+TEST_P(CompilerInstancePerfTest, Run)
+{
+    run();
+}
+
 ANGLE_INSTANTIATE_TEST(
     CompilerPerfTest,
     CompilerPerfParameters(SH_HLSL_4_1_OUTPUT, kSimpleESSL100FragSource, kSimpleESSL100Id),
     CompilerPerfParameters(SH_HLSL_4_1_OUTPUT, kSimpleESSL300FragSource, kSimpleESSL300Id),
     CompilerPerfParameters(SH_HLSL_4_1_OUTPUT, kRealWorldESSL100FragSource, kRealWorldESSL100Id),
     CompilerPerfParameters(SH_HLSL_4_1_OUTPUT, kTrickyESSL300FragSource, kTrickyESSL300Id),
+    CompilerPerfParameters(SH_HLSL_4_1_OUTPUT,
+                           kPreprocessorHeavyESSL300FragSource,
+                           kPreprocessorHeavyESSL300Id),
     CompilerPerfParameters(SH_GLSL_450_CORE_OUTPUT, kSimpleESSL100FragSource, kSimpleESSL100Id),
     CompilerPerfParameters(SH_GLSL_450_CORE_OUTPUT, kSimpleESSL300FragSource, kSimpleESSL300Id),
     CompilerPerfParameters(SH_GLSL_450_CORE_OUTPUT,
                            kRealWorldESSL100FragSource,
                            kRealWorldESSL100Id),
     CompilerPerfParameters(SH_GLSL_450_CORE_OUTPUT, kTrickyESSL300FragSource, kTrickyESSL300Id),
+    CompilerPerfParameters(SH_GLSL_450_CORE_OUTPUT,
+                           kPreprocessorHeavyESSL300FragSource,
+                           kPreprocessorHeavyESSL300Id),
     CompilerPerfParameters(SH_ESSL_OUTPUT, kSimpleESSL100FragSource, kSimpleESSL100Id),
     CompilerPerfParameters(SH_ESSL_OUTPUT, kSimpleESSL300FragSource, kSimpleESSL300Id),
     CompilerPerfParameters(SH_ESSL_OUTPUT, kRealWorldESSL100FragSource, kRealWorldESSL100Id),
-    CompilerPerfParameters(SH_ESSL_OUTPUT, kTrickyESSL300FragSource, kTrickyESSL300Id));
+    CompilerPerfParameters(SH_ESSL_OUTPUT, kTrickyESSL300FragSource, kTrickyESSL300Id),
+    CompilerPerfParameters(SH_ESSL_OUTPUT,
+                           kPreprocessorHeavyESSL300FragSource,
+                           kPreprocessorHeavyESSL300Id));
+
+ANGLE_INSTANTIATE_TEST(
+    CompilerInstancePerfTest,
+    CompilerInstancePerfParameters(SH_HLSL_4_1_OUTPUT, InstanceUsage::Reuse),
+    CompilerInstancePerfParameters(SH_HLSL_4_1_OUTPUT, InstanceUsage::UpdateResources),
+    CompilerInstancePerfParameters(SH_HLSL_4_1_OUTPUT, InstanceUsage::Reconstruct),
+    CompilerInstancePerfParameters(SH_GLSL_450_CORE_OUTPUT, InstanceUsage::Reuse),
+    CompilerInstancePerfParameters(SH_GLSL_450_CORE_OUTPUT, InstanceUsage::UpdateResources),
+    CompilerInstancePerfParameters(SH_GLSL_450_CORE_OUTPUT, InstanceUsage::Reconstruct),
+    CompilerInstancePerfParameters(SH_ESSL_OUTPUT, InstanceUsage::Reuse),
+    CompilerInstancePerfParameters(SH_ESSL_OUTPUT, InstanceUsage::UpdateResources),
+    CompilerInstancePerfParameters(SH_ESSL_OUTPUT, InstanceUsage::Reconstruct));
 
 }  // anonymous namespace
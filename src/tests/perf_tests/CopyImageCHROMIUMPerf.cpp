@@ -0,0 +1,109 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// CopyImageCHROMIUMPerf:
+//   Performance test for the CPU conversion of glCopyTextureCHROMIUM, which some back-ends fall
+//   back to.
+//
+
+#include "ANGLEPerfTest.h"
+
+#include <vector>
+
+#include "libANGLE/formatutils.h"
+#include "libANGLE/renderer/Format.h"
+#include "libANGLE/renderer/renderer_utils.h"
+
+namespace
+{
+constexpr size_t kImageSize = 512;
+
+struct CopyImageCHROMIUMParams
+{
+    angle::FormatID sourceFormatID;
+    angle::FormatID destFormatID;
+    bool flipY;
+    bool premultiplyAlpha;
+    bool unmultiplyAlpha;
+    const char *story;
+};
+
+std::ostream &operator<<(std::ostream &os, const CopyImageCHROMIUMParams &params)
+{
+    return os << params.story;
+}
+
+class CopyImageCHROMIUMPerfTest : public ANGLEPerfTest,
+                                  public ::testing::WithParamInterface<CopyImageCHROMIUMParams>
+{
+  public:
+    CopyImageCHROMIUMPerfTest();
+
+    void step() override;
+
+  private:
+    std::vector<uint8_t> mSourceData;
+    std::vector<uint8_t> mDestData;
+};
+
+CopyImageCHROMIUMPerfTest::CopyImageCHROMIUMPerfTest()
+    : ANGLEPerfTest("CopyImageCHROMIUMPerf", "", GetParam().story, 1)
+{
+    const CopyImageCHROMIUMParams &params = GetParam();
+
+    mSourceData.resize(kImageSize * kImageSize *
+                       angle::Format::Get(params.sourceFormatID).pixelBytes);
+    mDestData.resize(kImageSize * kImageSize * angle::Format::Get(params.destFormatID).pixelBytes);
+
+    for (size_t index = 0; index < mSourceData.size(); ++index)
+    {
+        mSourceData[index] = static_cast<uint8_t>(index * 7);
+    }
+}
+
+void CopyImageCHROMIUMPerfTest::step()
+{
+    const CopyImageCHROMIUMParams &params = GetParam();
+    const angle::Format &sourceFormat     = angle::Format::Get(params.sourceFormatID);
+    const angle::Format &destFormat       = angle::Format::Get(params.destFormatID);
+    const gl::InternalFormat &destFormatInfo =
+        gl::GetSizedInternalFormatInfo(destFormat.glInternalFormat);
+
+    rx::CopyImageCHROMIUM(mSourceData.data(), kImageSize * sourceFormat.pixelBytes,
+                          sourceFormat.pixelBytes, 0, sourceFormat.pixelReadFunction,
+                          mDestData.data(), kImageSize * destFormat.pixelBytes,
+                          destFormat.pixelBytes, 0, destFormat.pixelWriteFunction,
+                          destFormatInfo.format, destFormatInfo.componentType, kImageSize,
+                          kImageSize, 1, params.flipY, params.premultiplyAlpha,
+                          params.unmultiplyAlpha);
+}
+
+TEST_P(CopyImageCHROMIUMPerfTest, Run)
+{
+    run();
+}
+
+using angle::FormatID;
+
+const CopyImageCHROMIUMParams kCopyImageCHROMIUMParams[] = {
+    {FormatID::R8G8B8A8_UNORM, FormatID::R8G8B8A8_UNORM, false, false, false, "_rgba8_to_rgba8"},
+    {FormatID::B8G8R8A8_UNORM, FormatID::R8G8B8A8_UNORM, true, false, false,
+     "_bgra8_to_rgba8_flip_y"},
+    {FormatID::R8G8B8A8_UNORM, FormatID::R8G8B8A8_UNORM, false, true, false,
+     "_rgba8_to_rgba8_premultiply"},
+    {FormatID::B8G8R8A8_UNORM, FormatID::B8G8R8A8_UNORM, false, false, true,
+     "_bgra8_to_bgra8_unmultiply"},
+    {FormatID::R8G8B8A8_UNORM, FormatID::R5G6B5_UNORM, false, false, false, "_rgba8_to_rgb565"},
+    {FormatID::R8G8B8A8_UNORM, FormatID::R8_UNORM, false, false, false, "_rgba8_to_r8"},
+    {FormatID::R8G8_UNORM, FormatID::R8G8B8A8_UNORM, false, false, false, "_rg8_to_rgba8"},
+    {FormatID::R16G16B16A16_FLOAT, FormatID::R8G8B8A8_UNORM, false, true, false,
+     "_rgba16f_to_rgba8_premultiply"},
+};
+
+INSTANTIATE_TEST_SUITE_P(,
+                         CopyImageCHROMIUMPerfTest,
+                         ::testing::ValuesIn(kCopyImageCHROMIUMParams),
+                         ::testing::PrintToStringParamName());
+}  // anonymous namespace
@@ -0,0 +1,176 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// DebugMessagePerf:
+//   Performance test for invalid calls, like legacy content that hits the same GL error every
+//   frame. Measures the cost of the error's debug message with and without a consumer for it.
+//
+
+#include "ANGLEPerfTest.h"
+
+#include <sstream>
+
+namespace angle
+{
+constexpr unsigned int kIterationsPerStep = 4;
+constexpr unsigned int kCallsPerIteration = 1024;
+
+enum class DebugOutput
+{
+    // KHR_debug output is disabled, as by default in non-debug contexts.
+    Disabled,
+    // Output is enabled without a callback, so messages go to the message log until it fills up.
+    MessageLog,
+    Callback,
+};
+
+struct DebugMessageParams final : public RenderTestParams
+{
+    DebugMessageParams()
+    {
+        iterationsPerStep = kIterationsPerStep;
+
+        majorVersion = 2;
+        minorVersion = 0;
+        windowWidth  = 64;
+        windowHeight = 64;
+    }
+
+    std::string story() const override;
+
+    DebugOutput debugOutput = DebugOutput::Disabled;
+};
+
+std::ostream &operator<<(std::ostream &os, const DebugMessageParams &params)
+{
+    os << params.backendAndStory().substr(1);
+    return os;
+}
+
+std::string DebugMessageParams::story() const
+{
+    std::stringstream strstr;
+
+    strstr << RenderTestParams::story();
+    switch (debugOutput)
+    {
+        case DebugOutput::Disabled:
+            strstr << "_output_disabled";
+            break;
+        case DebugOutput::MessageLog:
+            strstr << "_message_log";
+            break;
+        case DebugOutput::Callback:
+            strstr << "_callback";
+            break;
+    }
+
+    return strstr.str();
+}
+
+void GL_APIENTRY DebugMessageCallback(GLenum source,
+                                      GLenum type,
+                                      GLuint id,
+                                      GLenum severity,
+                                      GLsizei length,
+                                      const GLchar *message,
+                                      const void *userParam)
+{
+    // Count the messages, so the callback isn't optimized out.
+    size_t *messageCount = static_cast<size_t *>(const_cast<void *>(userParam));
+    (*messageCount)++;
+}
+
+class DebugMessageBenchmark : public ANGLERenderTest,
+                              public ::testing::WithParamInterface<DebugMessageParams>
+{
+  public:
+    DebugMessageBenchmark();
+
+    void initializeBenchmark() override;
+    void destroyBenchmark() override;
+    void drawBenchmark() override;
+
+  private:
+    size_t mMessageCount = 0;
+};
+
+DebugMessageBenchmark::DebugMessageBenchmark() : ANGLERenderTest("DebugMessage", GetParam())
+{
+    addExtensionPrerequisite("GL_KHR_debug");
+}
+
+void DebugMessageBenchmark::initializeBenchmark()
+{
+    const auto &params = GetParam();
+
+    if (params.debugOutput == DebugOutput::Disabled)
+    {
+        glDisable(GL_DEBUG_OUTPUT_KHR);
+    }
+    else
+    {
+        glEnable(GL_DEBUG_OUTPUT_KHR);
+    }
+
+    if (params.debugOutput == DebugOutput::Callback)
+    {
+        glDebugMessageCallbackKHR(DebugMessageCallback, &mMessageCount);
+    }
+
+    ASSERT_GL_NO_ERROR();
+}
+
+void DebugMessageBenchmark::destroyBenchmark()
+{
+    glDebugMessageCallbackKHR(nullptr, nullptr);
+    glDisable(GL_DEBUG_OUTPUT_KHR);
+}
+
+void DebugMessageBenchmark::drawBenchmark()
+{
+    const auto &params = GetParam();
+
+    for (unsigned int iteration = 0; iteration < params.iterationsPerStep; ++iteration)
+    {
+        for (unsigned int call = 0; call < kCallsPerIteration; ++call)
+        {
+            // Not a texture parameter, so every call generates GL_INVALID_ENUM.
+            glTexParameteri(GL_TEXTURE_2D, GL_BLEND, GL_NEAREST);
+        }
+    }
+
+    ASSERT_EQ(static_cast<GLenum>(GL_INVALID_ENUM), glGetError());
+}
+
+DebugMessageParams DebugMessageVulkanNullParams(DebugOutput debugOutput)
+{
+    DebugMessageParams params;
+    params.eglParameters = egl_platform::VULKAN_NULL();
+    params.debugOutput   = debugOutput;
+    return params;
+}
+
+DebugMessageParams DebugMessageOpenGLOrGLESParams(DebugOutput debugOutput)
+{
+    DebugMessageParams params;
+    params.eglParameters = egl_platform::OPENGL_OR_GLES();
+    params.debugOutput   = debugOutput;
+    return params;
+}
+
+TEST_P(DebugMessageBenchmark, Run)
+{
+    run();
+}
+
+ANGLE_INSTANTIATE_TEST(DebugMessageBenchmark,
+                       DebugMessageVulkanNullParams(DebugOutput::Disabled),
+                       DebugMessageVulkanNullParams(DebugOutput::MessageLog),
+                       DebugMessageVulkanNullParams(DebugOutput::Callback),
+                       DebugMessageOpenGLOrGLESParams(DebugOutput::Disabled),
+                       DebugMessageOpenGLOrGLESParams(DebugOutput::Callback));
+
+}  // namespace angle
@@ -0,0 +1,139 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// ErrorProbePerf:
+//   Performance test for glGetError after every call, as content that probes for errors does.
+//   Optionally every other call is invalid, so errors are recorded and popped as well.
+//
+
+#include "ANGLEPerfTest.h"
+
+#include <sstream>
+
+namespace angle
+{
+constexpr unsigned int kIterationsPerStep = 4;
+constexpr unsigned int kCallsPerIteration = 1024;
+
+struct ErrorProbeParams final : public RenderTestParams
+{
+    ErrorProbeParams()
+    {
+        iterationsPerStep = kIterationsPerStep;
+
+        majorVersion = 2;
+        minorVersion = 0;
+        windowWidth  = 64;
+        windowHeight = 64;
+    }
+
+    std::string story() const override;
+
+    bool generateErrors = false;
+};
+
+std::ostream &operator<<(std::ostream &os, const ErrorProbeParams &params)
+{
+    os << params.backendAndStory().substr(1);
+    return os;
+}
+
+std::string ErrorProbeParams::story() const
+{
+    std::stringstream strstr;
+
+    strstr << RenderTestParams::story();
+    strstr << (generateErrors ? "_with_errors" : "_no_errors");
+
+    return strstr.str();
+}
+
+class ErrorProbeBenchmark : public ANGLERenderTest,
+                            public ::testing::WithParamInterface<ErrorProbeParams>
+{
+  public:
+    ErrorProbeBenchmark();
+
+    void initializeBenchmark() override;
+    void destroyBenchmark() override;
+    void drawBenchmark() override;
+
+  private:
+    GLuint mTexture = 0;
+};
+
+ErrorProbeBenchmark::ErrorProbeBenchmark() : ANGLERenderTest("ErrorProbe", GetParam()) {}
+
+void ErrorProbeBenchmark::initializeBenchmark()
+{
+    glGenTextures(1, &mTexture);
+    glBindTexture(GL_TEXTURE_2D, mTexture);
+    ASSERT_GL_NO_ERROR();
+}
+
+void ErrorProbeBenchmark::destroyBenchmark()
+{
+    glDeleteTextures(1, &mTexture);
+}
+
+void ErrorProbeBenchmark::drawBenchmark()
+{
+    const auto &params = GetParam();
+
+    GLenum unexpectedError = GL_NO_ERROR;
+    for (unsigned int iteration = 0; iteration < params.iterationsPerStep; ++iteration)
+    {
+        for (unsigned int call = 0; call < kCallsPerIteration; ++call)
+        {
+            bool invalidCall = params.generateErrors && call % 2 == 1;
+            if (invalidCall)
+            {
+                // Not a texture parameter, so this generates GL_INVALID_ENUM.
+                glTexParameteri(GL_TEXTURE_2D, GL_BLEND, GL_NEAREST);
+            }
+            else
+            {
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            }
+
+            GLenum error = glGetError();
+            if (error != (invalidCall ? GL_INVALID_ENUM : GL_NO_ERROR))
+            {
+                unexpectedError = error;
+            }
+        }
+    }
+
+    ASSERT_EQ(static_cast<GLenum>(GL_NO_ERROR), unexpectedError);
+}
+
+ErrorProbeParams ErrorProbeVulkanNullParams(bool generateErrors)
+{
+    ErrorProbeParams params;
+    params.eglParameters  = egl_platform::VULKAN_NULL();
+    params.generateErrors = generateErrors;
+    return params;
+}
+
+ErrorProbeParams ErrorProbeOpenGLOrGLESParams(bool generateErrors)
+{
+    ErrorProbeParams params;
+    params.eglParameters  = egl_platform::OPENGL_OR_GLES();
+    params.generateErrors = generateErrors;
+    return params;
+}
+
+TEST_P(ErrorProbeBenchmark, Run)
+{
+    run();
+}
+
+ANGLE_INSTANTIATE_TEST(ErrorProbeBenchmark,
+                       ErrorProbeVulkanNullParams(false),
+                       ErrorProbeVulkanNullParams(true),
+                       ErrorProbeOpenGLOrGLESParams(false),
+                       ErrorProbeOpenGLOrGLESParams(true));
+
+}  // namespace angle
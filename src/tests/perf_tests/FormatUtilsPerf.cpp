@@ -0,0 +1,71 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// FormatUtilsPerf:
+//   Performance test for the internal format info queries, which validation calls several times
+//   per texture and renderbuffer call.
+//
+
+#include "ANGLEPerfTest.h"
+#include "libANGLE/formatutils.h"
+
+volatile GLuint gFormatUtilsSink = 0;
+
+namespace
+{
+constexpr unsigned int kIterationsPerStep = 1000;
+
+struct FormatAndType
+{
+    GLenum internalFormat;
+    GLenum type;
+};
+
+// A mix of the sized and unsized formats that applications commonly use.
+constexpr FormatAndType kFormats[] = {
+    {GL_RGBA8, GL_UNSIGNED_BYTE},
+    {GL_RGBA, GL_UNSIGNED_BYTE},
+    {GL_RGB, GL_UNSIGNED_SHORT_5_6_5},
+    {GL_SRGB8_ALPHA8, GL_UNSIGNED_BYTE},
+    {GL_LUMINANCE, GL_UNSIGNED_BYTE},
+    {GL_RGBA16F, GL_HALF_FLOAT},
+    {GL_DEPTH24_STENCIL8, GL_UNSIGNED_INT_24_8},
+    {GL_DEPTH_COMPONENT, GL_UNSIGNED_SHORT},
+    {GL_R8, GL_UNSIGNED_BYTE},
+    {GL_RG16F, GL_HALF_FLOAT},
+    {GL_COMPRESSED_RGBA8_ETC2_EAC, GL_UNSIGNED_BYTE},
+    {GL_RGB10_A2, GL_UNSIGNED_INT_2_10_10_10_REV},
+};
+
+class FormatUtilsPerfTest : public ANGLEPerfTest
+{
+  public:
+    FormatUtilsPerfTest();
+    void step() override;
+};
+
+FormatUtilsPerfTest::FormatUtilsPerfTest()
+    : ANGLEPerfTest("FormatUtilsPerf", "", "_run", kIterationsPerStep)
+{}
+
+void FormatUtilsPerfTest::step()
+{
+    GLuint pixelBytes = 0;
+    for (unsigned int iteration = 0; iteration < kIterationsPerStep; ++iteration)
+    {
+        for (const FormatAndType &format : kFormats)
+        {
+            pixelBytes += gl::GetInternalFormatInfo(format.internalFormat, format.type).pixelBytes;
+            pixelBytes += gl::GetSizedInternalFormatInfo(format.internalFormat).pixelBytes;
+        }
+    }
+    gFormatUtilsSink = pixelBytes;
+}
+
+TEST_F(FormatUtilsPerfTest, Run)
+{
+    run();
+}
+}  // anonymous namespace
@@ -0,0 +1,174 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// GLES1DrawPerf:
+//   Performance test for fixed-function draws emulated by the GLES1 renderer. Optionally cycles
+//   through a set of texturing, lighting, fog and alpha test states between draws.
+//
+
+#include "ANGLEPerfTest.h"
+
+#include <sstream>
+
+#include "test_utils/angle_test_instantiate.h"
+
+namespace angle
+{
+constexpr unsigned int kIterationsPerStep = 64;
+
+struct GLES1DrawParams final : public RenderTestParams
+{
+    GLES1DrawParams()
+    {
+        // Common default params
+        majorVersion      = 1;
+        minorVersion      = 0;
+        windowWidth       = 64;
+        windowHeight      = 64;
+        iterationsPerStep = kIterationsPerStep;
+
+        stateChanges = false;
+    }
+
+    std::string story() const override;
+
+    bool stateChanges;
+};
+
+std::ostream &operator<<(std::ostream &os, const GLES1DrawParams &params)
+{
+    os << params.backendAndStory().substr(1);
+    return os;
+}
+
+std::string GLES1DrawParams::story() const
+{
+    std::stringstream strstr;
+
+    strstr << RenderTestParams::story();
+    strstr << (stateChanges ? "_state_changes" : "_static_state");
+
+    return strstr.str();
+}
+
+class GLES1DrawBenchmark : public ANGLERenderTest,
+                           public ::testing::WithParamInterface<GLES1DrawParams>
+{
+  public:
+    GLES1DrawBenchmark();
+
+    void initializeBenchmark() override;
+    void destroyBenchmark() override;
+    void drawBenchmark() override;
+
+  private:
+    void applyState(unsigned int stateIndex);
+
+    GLuint mTexture = 0;
+};
+
+GLES1DrawBenchmark::GLES1DrawBenchmark() : ANGLERenderTest("GLES1Draw", GetParam()) {}
+
+void GLES1DrawBenchmark::initializeBenchmark()
+{
+    constexpr GLfloat kVertices[] = {
+        -1.0f, -1.0f, 0.0f, 1.0f, -1.0f, 0.0f, -1.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f,
+    };
+    constexpr GLfloat kTexCoords[] = {
+        0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+    };
+    constexpr GLubyte kTextureData[] = {255, 0, 0, 255};
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, kVertices);
+
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(2, GL_FLOAT, 0, kTexCoords);
+
+    glGenTextures(1, &mTexture);
+    glBindTexture(GL_TEXTURE_2D, mTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, kTextureData);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    glEnable(GL_LIGHT0);
+    glFogf(GL_FOG_MODE, GL_LINEAR);
+    glAlphaFunc(GL_GREATER, 0.5f);
+
+    applyState(0);
+
+    ASSERT_GL_NO_ERROR();
+}
+
+void GLES1DrawBenchmark::destroyBenchmark()
+{
+    glDeleteTextures(1, &mTexture);
+}
+
+void GLES1DrawBenchmark::applyState(unsigned int stateIndex)
+{
+    // Each bit toggles one piece of fixed-function state that affects the generated shader.
+    auto setEnabled = [](GLenum cap, bool enabled) {
+        if (enabled)
+        {
+            glEnable(cap);
+        }
+        else
+        {
+            glDisable(cap);
+        }
+    };
+
+    setEnabled(GL_TEXTURE_2D, (stateIndex & 1) != 0);
+    setEnabled(GL_LIGHTING, (stateIndex & 2) != 0);
+    setEnabled(GL_FOG, (stateIndex & 4) != 0);
+    setEnabled(GL_ALPHA_TEST, (stateIndex & 8) != 0);
+}
+
+void GLES1DrawBenchmark::drawBenchmark()
+{
+    const auto &params = GetParam();
+
+    for (unsigned int it = 0; it < params.iterationsPerStep; ++it)
+    {
+        if (params.stateChanges)
+        {
+            applyState(it);
+        }
+
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    }
+
+    ASSERT_GL_NO_ERROR();
+}
+
+GLES1DrawParams GLES1DrawVulkanParams(bool stateChanges)
+{
+    GLES1DrawParams params;
+    params.eglParameters = egl_platform::VULKAN();
+    params.stateChanges  = stateChanges;
+    return params;
+}
+
+GLES1DrawParams GLES1DrawOpenGLOrGLESParams(bool stateChanges)
+{
+    GLES1DrawParams params;
+    params.eglParameters = egl_platform::OPENGL_OR_GLES();
+    params.stateChanges  = stateChanges;
+    return params;
+}
+
+TEST_P(GLES1DrawBenchmark, Run)
+{
+    run();
+}
+
+ANGLE_INSTANTIATE_TEST(GLES1DrawBenchmark,
+                       GLES1DrawOpenGLOrGLESParams(false),
+                       GLES1DrawOpenGLOrGLESParams(true),
+                       GLES1DrawVulkanParams(false),
+                       GLES1DrawVulkanParams(true));
+
+}  // namespace angle
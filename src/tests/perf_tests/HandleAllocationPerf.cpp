@@ -0,0 +1,176 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// HandleAllocationPerf:
+//   Performance test for generating, looking up and deleting large numbers of GL objects.
+//
+
+#include "ANGLEPerfTest.h"
+
+#include <random>
+#include <sstream>
+
+#include "test_utils/angle_test_instantiate.h"
+
+namespace angle
+{
+constexpr unsigned int kIterationsPerStep = 16;
+
+// Number of objects deleted and re-generated every iteration.
+constexpr size_t kChurnCount = 256;
+
+struct HandleAllocationParams final : public RenderTestParams
+{
+    HandleAllocationParams()
+    {
+        // Common default params
+        majorVersion      = 2;
+        minorVersion      = 0;
+        windowWidth       = 64;
+        windowHeight      = 64;
+        iterationsPerStep = kIterationsPerStep;
+
+        numObjects = 1000;
+    }
+
+    std::string story() const override;
+
+    size_t numObjects;
+};
+
+std::ostream &operator<<(std::ostream &os, const HandleAllocationParams &params)
+{
+    os << params.backendAndStory().substr(1);
+    return os;
+}
+
+std::string HandleAllocationParams::story() const
+{
+    std::stringstream strstr;
+
+    strstr << RenderTestParams::story();
+    strstr << "_" << numObjects << "_objects";
+
+    return strstr.str();
+}
+
+class HandleAllocationBenchmark : public ANGLERenderTest,
+                                  public ::testing::WithParamInterface<HandleAllocationParams>
+{
+  public:
+    HandleAllocationBenchmark();
+
+    void initializeBenchmark() override;
+    void destroyBenchmark() override;
+    void drawBenchmark() override;
+
+  private:
+    std::vector<GLuint> mBuffers;
+    std::vector<GLuint> mTextures;
+    std::vector<size_t> mLookupOrder;
+    size_t mChurnOffset = 0;
+};
+
+HandleAllocationBenchmark::HandleAllocationBenchmark()
+    : ANGLERenderTest("HandleAllocation", GetParam())
+{}
+
+void HandleAllocationBenchmark::initializeBenchmark()
+{
+    const auto &params = GetParam();
+
+    mBuffers.resize(params.numObjects, 0);
+    mTextures.resize(params.numObjects, 0);
+
+    glGenBuffers(static_cast<GLsizei>(mBuffers.size()), mBuffers.data());
+    glGenTextures(static_cast<GLsizei>(mTextures.size()), mTextures.data());
+
+    // Binding creates the objects so that the lookups below hit real entries.
+    for (size_t index = 0; index < params.numObjects; ++index)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, mBuffers[index]);
+        glBindTexture(GL_TEXTURE_2D, mTextures[index]);
+    }
+
+    // Use a fixed seed so runs are comparable.
+    mLookupOrder.resize(params.numObjects);
+    std::mt19937 generator(0x1234);
+    std::uniform_int_distribution<size_t> distribution(0, params.numObjects - 1);
+    for (size_t &index : mLookupOrder)
+    {
+        index = distribution(generator);
+    }
+
+    ASSERT_GL_NO_ERROR();
+}
+
+void HandleAllocationBenchmark::destroyBenchmark()
+{
+    glDeleteBuffers(static_cast<GLsizei>(mBuffers.size()), mBuffers.data());
+    glDeleteTextures(static_cast<GLsizei>(mTextures.size()), mTextures.data());
+}
+
+void HandleAllocationBenchmark::drawBenchmark()
+{
+    const auto &params = GetParam();
+
+    const size_t churnCount = std::min(kChurnCount, params.numObjects);
+    const size_t lookups    = std::min<size_t>(params.numObjects, 4096);
+
+    for (unsigned int it = 0; it < params.iterationsPerStep; ++it)
+    {
+        // Random lookups spread over the whole handle range.
+        for (size_t lookup = 0; lookup < lookups; ++lookup)
+        {
+            size_t index = mLookupOrder[(mChurnOffset + lookup) % mLookupOrder.size()];
+            glBindBuffer(GL_ARRAY_BUFFER, mBuffers[index]);
+            glBindTexture(GL_TEXTURE_2D, mTextures[index]);
+        }
+
+        // Delete and re-generate a window of objects so handles get released and reused.
+        size_t first = mChurnOffset % (params.numObjects - churnCount + 1);
+        glDeleteBuffers(static_cast<GLsizei>(churnCount), &mBuffers[first]);
+        glDeleteTextures(static_cast<GLsizei>(churnCount), &mTextures[first]);
+        glGenBuffers(static_cast<GLsizei>(churnCount), &mBuffers[first]);
+        glGenTextures(static_cast<GLsizei>(churnCount), &mTextures[first]);
+
+        mChurnOffset += churnCount;
+    }
+
+    ASSERT_GL_NO_ERROR();
+}
+
+HandleAllocationParams HandleAllocationVulkanParams(size_t numObjects)
+{
+    HandleAllocationParams params;
+    params.eglParameters = egl_platform::VULKAN_NULL();
+    params.numObjects    = numObjects;
+    return params;
+}
+
+HandleAllocationParams HandleAllocationOpenGLOrGLESParams(size_t numObjects)
+{
+    HandleAllocationParams params;
+    params.eglParameters = egl_platform::OPENGL_OR_GLES_NULL();
+    params.numObjects    = numObjects;
+    return params;
+}
+
+TEST_P(HandleAllocationBenchmark, Run)
+{
+    run();
+}
+
+ANGLE_INSTANTIATE_TEST(HandleAllocationBenchmark,
+                       HandleAllocationOpenGLOrGLESParams(1000),
+                       HandleAllocationOpenGLOrGLESParams(10000),
+                       HandleAllocationOpenGLOrGLESParams(100000),
+                       HandleAllocationOpenGLOrGLESParams(1000000),
+                       HandleAllocationVulkanParams(1000),
+                       HandleAllocationVulkanParams(10000),
+                       HandleAllocationVulkanParams(100000),
+                       HandleAllocationVulkanParams(1000000));
+
+}  // namespace angle
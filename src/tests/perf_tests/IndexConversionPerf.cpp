@@ -4,7 +4,8 @@
 // found in the LICENSE file.
 //
 // IndexConversionPerf:
-//   Performance tests for ANGLE index conversion in D3D11.
+//   Performance tests for ANGLE index conversion in D3D11, and line loop and triangle fan
+//   conversion in D3D11 and Vulkan.
 //
 
 #include "ANGLEPerfTest.h"
@@ -27,6 +28,20 @@ struct IndexConversionPerfParams final : public RenderTestParams
             strstr << "_index_range";
         }
 
+        if (mode == GL_LINE_LOOP)
+        {
+            strstr << "_line_loop";
+        }
+        else if (mode == GL_TRIANGLE_FAN)
+        {
+            strstr << "_triangle_fan";
+        }
+
+        if (primitiveRestart)
+        {
+            strstr << "_primitive_restart";
+        }
+
         strstr << RenderTestParams::story();
 
         return strstr.str();
@@ -36,6 +51,11 @@ struct IndexConversionPerfParams final : public RenderTestParams
 
     // A second test, which covers using index ranges with an offset.
     unsigned int indexRangeOffset;
+
+    // The primitives drawn by the conversion test. Line loops and triangle fans are converted to
+    // primitives the back-end supports even when the indices aren't.
+    GLenum mode;
+    bool primitiveRestart;
 };
 
 // Provide a custom gtest parameter name function for IndexConversionPerfParams.
@@ -92,6 +112,11 @@ void IndexConversionPerfTest::initializeBenchmark()
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(0);
 
+    if (params.primitiveRestart)
+    {
+        glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+    }
+
     // Initialize the index buffer
     for (unsigned int triIndex = 0; triIndex < params.numIndexTris; ++triIndex)
     {
@@ -155,7 +180,7 @@ void IndexConversionPerfTest::drawConversion()
 
     for (unsigned int it = 0; it < params.iterationsPerStep; it++)
     {
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(params.numIndexTris * 3 - 1),
+        glDrawElements(params.mode, static_cast<GLsizei>(params.numIndexTris * 3 - 1),
                        GL_UNSIGNED_SHORT, reinterpret_cast<void *>(0));
     }
 
@@ -194,6 +219,20 @@ IndexConversionPerfParams IndexConversionPerfD3D11Params()
     params.iterationsPerStep = 225;
     params.numIndexTris      = 3000;
     params.indexRangeOffset  = 0;
+    params.mode              = GL_TRIANGLES;
+    params.primitiveRestart  = false;
+    return params;
+}
+
+IndexConversionPerfParams PrimitiveConversionPerfParams(const EGLPlatformParameters &platform,
+                                                        GLenum mode,
+                                                        bool primitiveRestart)
+{
+    IndexConversionPerfParams params = IndexConversionPerfD3D11Params();
+    params.eglParameters             = platform;
+    params.majorVersion              = 3;
+    params.mode                      = mode;
+    params.primitiveRestart          = primitiveRestart;
     return params;
 }
 
@@ -208,6 +247,8 @@ IndexConversionPerfParams IndexRangeOffsetPerfD3D11Params()
     params.iterationsPerStep = 16;
     params.numIndexTris      = 50000;
     params.indexRangeOffset  = 64;
+    params.mode              = GL_TRIANGLES;
+    params.primitiveRestart  = false;
     return params;
 }
 
@@ -216,7 +257,14 @@ TEST_P(IndexConversionPerfTest, Run)
     run();
 }
 
-ANGLE_INSTANTIATE_TEST(IndexConversionPerfTest,
-                       IndexConversionPerfD3D11Params(),
-                       IndexRangeOffsetPerfD3D11Params());
+ANGLE_INSTANTIATE_TEST(
+    IndexConversionPerfTest,
+    IndexConversionPerfD3D11Params(),
+    IndexRangeOffsetPerfD3D11Params(),
+    PrimitiveConversionPerfParams(egl_platform::D3D11_NULL(), GL_LINE_LOOP, false),
+    PrimitiveConversionPerfParams(egl_platform::D3D11_NULL(), GL_LINE_LOOP, true),
+    PrimitiveConversionPerfParams(egl_platform::D3D11_NULL(), GL_TRIANGLE_FAN, false),
+    PrimitiveConversionPerfParams(egl_platform::D3D11_NULL(), GL_TRIANGLE_FAN, true),
+    PrimitiveConversionPerfParams(egl_platform::VULKAN_NULL(), GL_LINE_LOOP, false),
+    PrimitiveConversionPerfParams(egl_platform::VULKAN_NULL(), GL_LINE_LOOP, true));
 }  // namespace
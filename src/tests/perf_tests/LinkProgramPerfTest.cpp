@@ -10,6 +10,9 @@
 #include "ANGLEPerfTest.h"
 
 #include <array>
+#include <map>
+#include <mutex>
+#include <vector>
 
 #include "common/vector_utils.h"
 #include "util/shader_utils.h"
@@ -35,6 +38,14 @@ enum class ThreadOption
     Unspecified
 };
 
+enum class CacheOption
+{
+    // Every step links the same sources, so all but the first link hit the program cache.
+    Cached,
+    // Every step uses unique sources, so every link misses the program cache.
+    Uncached,
+};
+
 struct LinkProgramParams final : public RenderTestParams
 {
     LinkProgramParams(TaskOption taskOptionIn, ThreadOption threadOptionIn)
@@ -47,6 +58,13 @@ struct LinkProgramParams final : public RenderTestParams
         windowHeight = 256;
         taskOption   = taskOptionIn;
         threadOption = threadOptionIn;
+        cacheOption  = CacheOption::Cached;
+
+        sharedInterface    = false;
+        largeSource        = false;
+        multiStage         = false;
+        maxCompilerThreads = 0;
+        blobCache          = false;
     }
 
     std::string story() const override
@@ -72,6 +90,31 @@ struct LinkProgramParams final : public RenderTestParams
             strstr << "_multi_thread";
         }
 
+        if (cacheOption == CacheOption::Uncached)
+        {
+            strstr << "_uncached";
+        }
+
+        if (sharedInterface)
+        {
+            strstr << "_shared_interface";
+        }
+
+        if (largeSource)
+        {
+            strstr << "_large_source";
+        }
+
+        if (multiStage)
+        {
+            strstr << "_multi_stage_" << maxCompilerThreads << "_threads";
+        }
+
+        if (blobCache)
+        {
+            strstr << "_blob_cache";
+        }
+
         if (eglParameters.deviceType == EGL_PLATFORM_ANGLE_DEVICE_TYPE_NULL_ANGLE)
         {
             strstr << "_null";
@@ -82,8 +125,129 @@ struct LinkProgramParams final : public RenderTestParams
 
     TaskOption taskOption;
     ThreadOption threadOption;
+    CacheOption cacheOption;
+
+    // Link many different programs that all declare the same set of varyings.
+    bool sharedInterface;
+
+    // Pad the sources to the size of large real world shaders. Cheap to compile, but shows the
+    // cost of hashing the sources for the program cache.
+    bool largeSource;
+
+    // Link programs with large vertex and fragment shaders, using |maxCompilerThreads| compiler
+    // threads. Measures the time until the first draw, since some backends only generate the
+    // final shaders then.
+    bool multiStage;
+    GLuint maxCompilerThreads;
+
+    // Set EGL_ANDROID_blob_cache functions, so every linked program is handed to the application.
+    bool blobCache;
 };
 
+// The application's blob cache.  The set function may be called from ANGLE's worker threads.
+std::mutex gBlobCacheMutex;
+std::map<std::vector<uint8_t>, std::vector<uint8_t>> gBlobCache;
+
+void SetBlob(const void *key, EGLsizeiANDROID keySize, const void *value, EGLsizeiANDROID valueSize)
+{
+    const uint8_t *keyBytes   = static_cast<const uint8_t *>(key);
+    const uint8_t *valueBytes = static_cast<const uint8_t *>(value);
+
+    std::lock_guard<std::mutex> lock(gBlobCacheMutex);
+    gBlobCache[std::vector<uint8_t>(keyBytes, keyBytes + keySize)] =
+        std::vector<uint8_t>(valueBytes, valueBytes + valueSize);
+}
+
+EGLsizeiANDROID GetBlob(const void *key,
+                        EGLsizeiANDROID keySize,
+                        void *value,
+                        EGLsizeiANDROID valueSize)
+{
+    const uint8_t *keyBytes = static_cast<const uint8_t *>(key);
+
+    std::lock_guard<std::mutex> lock(gBlobCacheMutex);
+    auto entry = gBlobCache.find(std::vector<uint8_t>(keyBytes, keyBytes + keySize));
+    if (entry == gBlobCache.end())
+    {
+        return 0;
+    }
+
+    if (entry->second.size() <= static_cast<size_t>(valueSize))
+    {
+        memcpy(value, entry->second.data(), entry->second.size());
+    }
+    return static_cast<EGLsizeiANDROID>(entry->second.size());
+}
+
+// Returns a large shader whose output depends on |seed|, so that no cache can be hit by programs
+// with different seeds.
+std::string MakeMultiStageShader(GLenum shaderType, unsigned int seed)
+{
+    constexpr unsigned int kFunctionCount = 64;
+
+    const bool isVertexShader = shaderType == GL_VERTEX_SHADER;
+
+    std::stringstream strstr;
+    if (isVertexShader)
+    {
+        strstr << "attribute vec2 position;\n";
+    }
+    else
+    {
+        strstr << "precision mediump float;\n";
+    }
+    strstr << "varying vec4 color;\n";
+
+    for (unsigned int index = 0; index < kFunctionCount; ++index)
+    {
+        strstr << "vec4 f" << index << "(vec4 x) {\n"
+               << "    vec4 y = sin(x * " << index + 1 << ".0) + cos(x.yzwx);\n"
+               << "    y = mix(y, x.wzyx, clamp(dot(x, y), 0.0, 1.0));\n"
+               << "    return y * " << seed << ".0 + normalize(x + vec4(1.0));\n"
+               << "}\n";
+    }
+
+    strstr << "void main() {\n";
+    if (isVertexShader)
+    {
+        strstr << "    vec4 x = vec4(position, 0, 1);\n";
+    }
+    else
+    {
+        strstr << "    vec4 x = color;\n";
+    }
+    for (unsigned int index = 0; index < kFunctionCount; ++index)
+    {
+        strstr << "    x = f" << index << "(x);\n";
+    }
+    if (isVertexShader)
+    {
+        strstr << "    color = x;\n"
+               << "    gl_Position = vec4(position, 0, 1);\n";
+    }
+    else
+    {
+        strstr << "    gl_FragColor = x;\n";
+    }
+    strstr << "}\n";
+
+    return strstr.str();
+}
+
+// Returns comment lines adding up to about 64 KB.
+std::string MakeSourcePadding()
+{
+    constexpr size_t kPaddingSize = 64 * 1024;
+
+    std::string padding;
+    padding.reserve(kPaddingSize);
+    while (padding.size() < kPaddingSize)
+    {
+        padding += "// Padding to make the source as large as real world shaders.\n";
+    }
+    return padding;
+}
+
 std::ostream &operator<<(std::ostream &os, const LinkProgramParams &params)
 {
     os << params.backendAndStory().substr(1);
@@ -102,9 +266,31 @@ class LinkProgramBenchmark : public ANGLERenderTest,
 
   protected:
     GLuint mVertexBuffer = 0;
+
+    // Link latency (glLinkProgram until the link status is known) and program binary size, which
+    // approximates the reflection data kept per program.
+    bool mHasProgramBinary              = false;
+    double mTotalLinkTimeSeconds        = 0.0;
+    double mTotalLinkAndDrawTimeSeconds = 0.0;
+    size_t mTotalProgramBinarySize      = 0;
+    size_t mLinkCount                   = 0;
+
+    // Used to make the shader sources unique when the program cache should be missed.
+    unsigned int mSourceIndex = 0;
 };
 
-LinkProgramBenchmark::LinkProgramBenchmark() : ANGLERenderTest("LinkProgram", GetParam()) {}
+LinkProgramBenchmark::LinkProgramBenchmark() : ANGLERenderTest("LinkProgram", GetParam())
+{
+    if (GetParam().taskOption == TaskOption::CompileAndLink)
+    {
+        mReporter->RegisterFyiMetric(".link_time", "us");
+        mReporter->RegisterFyiMetric(".program_binary_size", "bytes");
+    }
+    if (GetParam().multiStage)
+    {
+        mReporter->RegisterFyiMetric(".link_and_draw_time", "us");
+    }
+}
 
 void LinkProgramBenchmark::initializeBenchmark()
 {
@@ -112,6 +298,22 @@ void LinkProgramBenchmark::initializeBenchmark()
     {
         glMaxShaderCompilerThreadsKHR(0);
     }
+    else if (GetParam().multiStage)
+    {
+        glMaxShaderCompilerThreadsKHR(GetParam().maxCompilerThreads);
+    }
+
+    if (GetParam().blobCache)
+    {
+        EGLDisplay display = eglGetCurrentDisplay();
+        if (!CheckExtensionExists(eglQueryString(display, EGL_EXTENSIONS),
+                                  "EGL_ANDROID_blob_cache"))
+        {
+            mSkipTest = true;
+            return;
+        }
+        eglSetBlobCacheFuncsANDROID(display, SetBlob, GetBlob);
+    }
 
     std::array<Vector3, 6> vertices = {{Vector3(-1.0f, 1.0f, 0.5f), Vector3(-1.0f, -1.0f, 0.5f),
                                         Vector3(1.0f, -1.0f, 0.5f), Vector3(-1.0f, 1.0f, 0.5f),
@@ -121,11 +323,36 @@ void LinkProgramBenchmark::initializeBenchmark()
     glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vector3), vertices.data(),
                  GL_STATIC_DRAW);
+
+    mHasProgramBinary = CheckExtensionExists(
+        reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS)), "GL_OES_get_program_binary");
 }
 
 void LinkProgramBenchmark::destroyBenchmark()
 {
     glDeleteBuffers(1, &mVertexBuffer);
+
+    if (GetParam().blobCache)
+    {
+        std::lock_guard<std::mutex> lock(gBlobCacheMutex);
+        gBlobCache.clear();
+    }
+
+    if (mLinkCount > 0)
+    {
+        double linkCount = static_cast<double>(mLinkCount);
+        mReporter->AddResult(".link_time", mTotalLinkTimeSeconds * 1e6 / linkCount);
+        if (mHasProgramBinary)
+        {
+            mReporter->AddResult(".program_binary_size",
+                                 static_cast<size_t>(mTotalProgramBinarySize / mLinkCount));
+        }
+        if (GetParam().multiStage)
+        {
+            mReporter->AddResult(".link_and_draw_time",
+                                 mTotalLinkAndDrawTimeSeconds * 1e6 / linkCount);
+        }
+    }
 }
 
 void LinkProgramBenchmark::drawBenchmark()
@@ -140,8 +367,66 @@ void LinkProgramBenchmark::drawBenchmark()
         "void main() {\n"
         "    gl_FragColor = vec4(1, 0, 0, 1);\n"
         "}";
-    GLuint vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
-    GLuint fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+
+    // Shaders with a larger interface. Every program is unique, but the varyings are always the
+    // same, so the link can reuse the varying packing of the previous programs.
+    static const char *sharedInterfaceVertexShader =
+        "attribute vec2 position;\n"
+        "uniform float scale;\n"
+        "varying vec4 v0;\n"
+        "varying vec3 v1;\n"
+        "varying vec2 v2[2];\n"
+        "varying float v3[3];\n"
+        "varying mat2 v4;\n"
+        "void main() {\n"
+        "    gl_Position = vec4(position, 0, 1);\n"
+        "    v0 = vec4(position * scale, 0, 1);\n"
+        "    v1 = vec3(position, scale);\n"
+        "    v2[0] = position;\n"
+        "    v2[1] = position.yx;\n"
+        "    v3[0] = position.x;\n"
+        "    v3[1] = position.y;\n"
+        "    v3[2] = scale;\n"
+        "    v4 = mat2(scale);\n"
+        "}";
+    static const char *sharedInterfaceFragmentShader =
+        "precision mediump float;\n"
+        "varying vec4 v0;\n"
+        "varying vec3 v1;\n"
+        "varying vec2 v2[2];\n"
+        "varying float v3[3];\n"
+        "varying mat2 v4;\n"
+        "void main() {\n"
+        "    vec2 sum = v2[0] + v2[1] + v4[0] + vec2(v3[0] + v3[1], v3[2]);\n"
+        "    gl_FragColor = v0 + vec4(v1, 1) + vec4(sum, 0, 0);\n"
+        "}";
+
+    const bool sharedInterface = GetParam().sharedInterface;
+    std::string vsSource       = sharedInterface ? sharedInterfaceVertexShader : vertexShader;
+    std::string fsSource       = sharedInterface ? sharedInterfaceFragmentShader : fragmentShader;
+    if (GetParam().multiStage)
+    {
+        vsSource = MakeMultiStageShader(GL_VERTEX_SHADER, mSourceIndex);
+        fsSource = MakeMultiStageShader(GL_FRAGMENT_SHADER, mSourceIndex);
+        mSourceIndex++;
+    }
+    else if (GetParam().cacheOption == CacheOption::Uncached)
+    {
+        // The program cache key hashes the full source, so a unique comment forces a miss.
+        std::string prefix = "// " + std::to_string(mSourceIndex++) + "\n";
+        vsSource           = prefix + vsSource;
+        fsSource           = prefix + fsSource;
+    }
+
+    if (GetParam().largeSource)
+    {
+        static const std::string padding = MakeSourcePadding();
+        vsSource                         = padding + vsSource;
+        fsSource                         = padding + fsSource;
+    }
+
+    GLuint vs = CompileShader(GL_VERTEX_SHADER, vsSource.c_str());
+    GLuint fs = CompileShader(GL_FRAGMENT_SHADER, fsSource.c_str());
 
     ASSERT_NE(0u, vs);
     ASSERT_NE(0u, fs);
@@ -159,7 +444,28 @@ void LinkProgramBenchmark::drawBenchmark()
     glDeleteShader(vs);
     glAttachShader(program, fs);
     glDeleteShader(fs);
+
+    Timer linkAndDrawTimer;
+    linkAndDrawTimer.start();
+
+    Timer linkTimer;
+    linkTimer.start();
     glLinkProgram(program);
+    GLint linkStatus = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+    linkTimer.stop();
+    ASSERT_EQ(GL_TRUE, linkStatus);
+
+    mTotalLinkTimeSeconds += linkTimer.getElapsedTime();
+    mLinkCount++;
+
+    if (mHasProgramBinary)
+    {
+        GLint binaryLength = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &binaryLength);
+        mTotalProgramBinarySize += static_cast<size_t>(binaryLength);
+    }
+
     glUseProgram(program);
 
     GLint positionLoc = glGetAttribLocation(program, "position");
@@ -169,6 +475,13 @@ void LinkProgramBenchmark::drawBenchmark()
     // Draw with the program to ensure the shader gets compiled and used.
     glDrawArrays(GL_TRIANGLES, 0, 6);
 
+    if (GetParam().multiStage)
+    {
+        glFinish();
+        linkAndDrawTimer.stop();
+        mTotalLinkAndDrawTimeSeconds += linkAndDrawTimer.getElapsedTime();
+    }
+
     glDeleteProgram(program);
 }
 
@@ -202,6 +515,50 @@ LinkProgramParams LinkProgramVulkanParams(TaskOption taskOption, ThreadOption th
     return params;
 }
 
+LinkProgramParams Uncached(const LinkProgramParams &input)
+{
+    LinkProgramParams output = input;
+    output.cacheOption       = CacheOption::Uncached;
+    return output;
+}
+
+// Unique programs so the program cache misses, all with the same varyings.
+LinkProgramParams SharedInterface(const LinkProgramParams &input)
+{
+    LinkProgramParams output = Uncached(input);
+    output.sharedInterface   = true;
+    return output;
+}
+
+// The same program every step, with large sources.
+LinkProgramParams LargeSource(const LinkProgramParams &input)
+{
+    LinkProgramParams output = input;
+    output.largeSource       = true;
+    return output;
+}
+
+// Unique programs with large vertex and fragment shaders, linked with the given number of compiler
+// threads.
+LinkProgramParams MultiStage(const LinkProgramParams &input, GLuint maxCompilerThreads)
+{
+    LinkProgramParams output  = Uncached(input);
+    output.threadOption       = ThreadOption::Unspecified;
+    output.multiStage         = true;
+    output.maxCompilerThreads = maxCompilerThreads;
+    return output;
+}
+
+// Unique programs stored in the application's blob cache.  The link time includes handing the
+// binary to the application only with the single thread option, otherwise that happens on a
+// worker thread.
+LinkProgramParams BlobCache(const LinkProgramParams &input)
+{
+    LinkProgramParams output = Uncached(input);
+    output.blobCache         = true;
+    return output;
+}
+
 TEST_P(LinkProgramBenchmark, Run)
 {
     run();
@@ -224,6 +581,29 @@ ANGLE_INSTANTIATE_TEST(
     LinkProgramD3D11Params(TaskOption::CompileAndLink, ThreadOption::SingleThread),
     LinkProgramD3D9Params(TaskOption::CompileAndLink, ThreadOption::SingleThread),
     LinkProgramOpenGLOrGLESParams(TaskOption::CompileAndLink, ThreadOption::SingleThread),
-    LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::SingleThread));
+    LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::SingleThread),
+    Uncached(LinkProgramD3D11Params(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    Uncached(LinkProgramOpenGLOrGLESParams(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    Uncached(LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    SharedInterface(
+        LinkProgramD3D11Params(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    SharedInterface(
+        LinkProgramOpenGLOrGLESParams(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    SharedInterface(
+        LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    LargeSource(LinkProgramD3D11Params(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    LargeSource(
+        LinkProgramOpenGLOrGLESParams(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    LargeSource(LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    BlobCache(LinkProgramD3D11Params(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    BlobCache(LinkProgramD3D11Params(TaskOption::CompileAndLink, ThreadOption::MultiThread)),
+    BlobCache(LinkProgramOpenGLOrGLESParams(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    BlobCache(LinkProgramOpenGLOrGLESParams(TaskOption::CompileAndLink, ThreadOption::MultiThread)),
+    BlobCache(LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::SingleThread)),
+    BlobCache(LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::MultiThread)),
+    MultiStage(LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::Unspecified), 0),
+    MultiStage(LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::Unspecified), 1),
+    MultiStage(LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::Unspecified), 2),
+    MultiStage(LinkProgramVulkanParams(TaskOption::CompileAndLink, ThreadOption::Unspecified), 4));
 
 }  // anonymous namespace
@@ -0,0 +1,179 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// ObserverNotificationPerf:
+//   Performance test for buffer update notifications. Updates a buffer that is bound to many
+//   vertex arrays to measure the cost of the state change fan-out.
+//
+
+#include "ANGLEPerfTest.h"
+
+#include <sstream>
+
+#include "test_utils/angle_test_instantiate.h"
+#include "util/shader_utils.h"
+
+namespace angle
+{
+constexpr unsigned int kIterationsPerStep = 64;
+
+struct ObserverNotificationParams final : public RenderTestParams
+{
+    ObserverNotificationParams()
+    {
+        // Common default params
+        majorVersion      = 3;
+        minorVersion      = 0;
+        windowWidth       = 64;
+        windowHeight      = 64;
+        iterationsPerStep = kIterationsPerStep;
+
+        numVertexArrays = 100;
+        updatesPerDraw  = 1;
+    }
+
+    std::string story() const override;
+
+    size_t numVertexArrays;
+    unsigned int updatesPerDraw;
+};
+
+std::ostream &operator<<(std::ostream &os, const ObserverNotificationParams &params)
+{
+    os << params.backendAndStory().substr(1);
+    return os;
+}
+
+std::string ObserverNotificationParams::story() const
+{
+    std::stringstream strstr;
+
+    strstr << RenderTestParams::story();
+    strstr << "_" << numVertexArrays << "_vaos";
+    strstr << "_" << updatesPerDraw << "_updates";
+
+    return strstr.str();
+}
+
+class ObserverNotificationBenchmark
+    : public ANGLERenderTest,
+      public ::testing::WithParamInterface<ObserverNotificationParams>
+{
+  public:
+    ObserverNotificationBenchmark();
+
+    void initializeBenchmark() override;
+    void destroyBenchmark() override;
+    void drawBenchmark() override;
+
+  private:
+    GLuint mProgram = 0;
+    GLuint mBuffer  = 0;
+    std::vector<GLuint> mVertexArrays;
+    std::vector<float> mUpdateData;
+};
+
+ObserverNotificationBenchmark::ObserverNotificationBenchmark()
+    : ANGLERenderTest("ObserverNotification", GetParam())
+{}
+
+void ObserverNotificationBenchmark::initializeBenchmark()
+{
+    const auto &params = GetParam();
+
+    mProgram = CompileProgram(essl1_shaders::vs::Simple(), essl1_shaders::fs::Red());
+    ASSERT_NE(0u, mProgram);
+    glUseProgram(mProgram);
+
+    GLint positionLocation = glGetAttribLocation(mProgram, essl1_shaders::PositionAttrib());
+    ASSERT_NE(-1, positionLocation);
+
+    mUpdateData.resize(16, 1.0f);
+
+    glGenBuffers(1, &mBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, mBuffer);
+    glBufferData(GL_ARRAY_BUFFER, mUpdateData.size() * sizeof(float), mUpdateData.data(),
+                 GL_DYNAMIC_DRAW);
+
+    // Bind the same buffer to every vertex array so each update notifies all of them.
+    mVertexArrays.resize(params.numVertexArrays, 0);
+    glGenVertexArrays(static_cast<GLsizei>(mVertexArrays.size()), mVertexArrays.data());
+    for (GLuint vertexArray : mVertexArrays)
+    {
+        glBindVertexArray(vertexArray);
+        glEnableVertexAttribArray(positionLocation);
+        glVertexAttribPointer(positionLocation, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+    }
+
+    // Keep one of the vertex arrays bound so the Context is part of the notification chain.
+    glBindVertexArray(mVertexArrays[0]);
+
+    ASSERT_GL_NO_ERROR();
+}
+
+void ObserverNotificationBenchmark::destroyBenchmark()
+{
+    glBindVertexArray(0);
+    glDeleteVertexArrays(static_cast<GLsizei>(mVertexArrays.size()), mVertexArrays.data());
+    glDeleteBuffers(1, &mBuffer);
+    glDeleteProgram(mProgram);
+}
+
+void ObserverNotificationBenchmark::drawBenchmark()
+{
+    const auto &params = GetParam();
+
+    const GLsizeiptr updateSize = static_cast<GLsizeiptr>(mUpdateData.size() * sizeof(float));
+
+    for (unsigned int it = 0; it < params.iterationsPerStep; ++it)
+    {
+        for (unsigned int update = 0; update < params.updatesPerDraw; ++update)
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, updateSize, mUpdateData.data());
+        }
+
+        // Flush the pending vertex array dirty bits like a draw would.
+        glDrawArrays(GL_POINTS, 0, 1);
+    }
+
+    ASSERT_GL_NO_ERROR();
+}
+
+ObserverNotificationParams ObserverNotificationVulkanParams(size_t numVertexArrays,
+                                                           unsigned int updatesPerDraw)
+{
+    ObserverNotificationParams params;
+    params.eglParameters   = egl_platform::VULKAN_NULL();
+    params.numVertexArrays = numVertexArrays;
+    params.updatesPerDraw  = updatesPerDraw;
+    return params;
+}
+
+ObserverNotificationParams ObserverNotificationOpenGLOrGLESParams(size_t numVertexArrays,
+                                                                 unsigned int updatesPerDraw)
+{
+    ObserverNotificationParams params;
+    params.eglParameters   = egl_platform::OPENGL_OR_GLES_NULL();
+    params.numVertexArrays = numVertexArrays;
+    params.updatesPerDraw  = updatesPerDraw;
+    return params;
+}
+
+TEST_P(ObserverNotificationBenchmark, Run)
+{
+    run();
+}
+
+ANGLE_INSTANTIATE_TEST(ObserverNotificationBenchmark,
+                       ObserverNotificationOpenGLOrGLESParams(10, 1),
+                       ObserverNotificationOpenGLOrGLESParams(100, 1),
+                       ObserverNotificationOpenGLOrGLESParams(500, 1),
+                       ObserverNotificationOpenGLOrGLESParams(500, 16),
+                       ObserverNotificationVulkanParams(10, 1),
+                       ObserverNotificationVulkanParams(100, 1),
+                       ObserverNotificationVulkanParams(500, 1),
+                       ObserverNotificationVulkanParams(500, 16));
+
+}  // namespace angle
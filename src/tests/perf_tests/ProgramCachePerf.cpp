@@ -0,0 +1,364 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// ProgramCacheBenchmark:
+//   Performance test for the program cache with a corpus of programs that doesn't fit in the
+//   cache uncompressed. Each step links programs from the corpus, favoring some programs over
+//   others like applications do.
+//
+//   Besides the time per link, the test reports how many links hit the cache and how many bytes
+//   compressing the program binaries saves. Finding whether a link will hit reads the whole cache,
+//   so only .link_time excludes that bookkeeping.
+//
+
+#include "ANGLEPerfTest.h"
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <vector>
+
+#include "util/shader_utils.h"
+
+using namespace angle;
+
+namespace
+{
+constexpr unsigned int kProgramCount = 64;
+constexpr unsigned int kLinksPerStep = 64;
+constexpr size_t kUniformsPerShader  = 24;
+constexpr size_t kFunctionsPerShader = 8;
+constexpr size_t kCacheBudgetPercent = 50;
+
+using ProgramKey = std::vector<uint8_t>;
+
+struct ProgramCacheParams final : public RenderTestParams
+{
+    ProgramCacheParams()
+    {
+        iterationsPerStep = 1;
+
+        majorVersion = 3;
+        minorVersion = 0;
+        windowWidth  = 256;
+        windowHeight = 256;
+    }
+
+    std::string story() const override
+    {
+        std::stringstream strstr;
+        strstr << RenderTestParams::story();
+
+        if (eglParameters.deviceType == EGL_PLATFORM_ANGLE_DEVICE_TYPE_NULL_ANGLE)
+        {
+            strstr << "_null";
+        }
+
+        return strstr.str();
+    }
+};
+
+std::ostream &operator<<(std::ostream &os, const ProgramCacheParams &params)
+{
+    os << params.backendAndStory().substr(1);
+    return os;
+}
+
+// Returns a shader in the style of engine generated shaders, with long and repetitive names.
+// Shaders with different |seed| values differ in their constants, so they never share a cache
+// entry.
+std::string MakeCorpusShader(GLenum shaderType, unsigned int seed)
+{
+    const bool isVertexShader = shaderType == GL_VERTEX_SHADER;
+
+    std::stringstream strstr;
+    strstr << "#version 300 es\n"
+           << "precision highp float;\n";
+    if (isVertexShader)
+    {
+        strstr << "in vec2 position;\n"
+               << "out vec4 vMaterialBlendedSurfaceColor;\n";
+    }
+    else
+    {
+        strstr << "in vec4 vMaterialBlendedSurfaceColor;\n"
+               << "out vec4 fragColor;\n";
+    }
+
+    for (size_t index = 0; index < kUniformsPerShader; ++index)
+    {
+        strstr << "uniform vec4 u" << (isVertexShader ? "Vertex" : "Fragment")
+               << "StageMaterialParameterBlockEntry" << index << ";\n";
+    }
+
+    for (size_t index = 0; index < kFunctionsPerShader; ++index)
+    {
+        strstr << "vec4 applyMaterialLayerTransformation" << index << "(vec4 inputSurfaceColor) {\n"
+               << "    vec4 layerContribution = inputSurfaceColor * " << seed + index + 1
+               << ".0;\n";
+        for (size_t uniform = index; uniform < kUniformsPerShader; uniform += kFunctionsPerShader)
+        {
+            strstr << "    layerContribution += u" << (isVertexShader ? "Vertex" : "Fragment")
+                   << "StageMaterialParameterBlockEntry" << uniform
+                   << " * layerContribution.yzwx;\n";
+        }
+        strstr << "    return layerContribution;\n"
+               << "}\n";
+    }
+
+    strstr << "void main() {\n";
+    strstr << (isVertexShader ? "    vec4 surfaceColor = vec4(position, 0, 1);\n"
+                              : "    vec4 surfaceColor = vMaterialBlendedSurfaceColor;\n");
+    for (size_t index = 0; index < kFunctionsPerShader; ++index)
+    {
+        strstr << "    surfaceColor = applyMaterialLayerTransformation" << index
+               << "(surfaceColor);\n";
+    }
+    if (isVertexShader)
+    {
+        strstr << "    vMaterialBlendedSurfaceColor = surfaceColor;\n"
+               << "    gl_Position = vec4(position, 0, 1);\n";
+    }
+    else
+    {
+        strstr << "    fragColor = surfaceColor;\n";
+    }
+    strstr << "}\n";
+
+    return strstr.str();
+}
+
+class ProgramCacheBenchmark : public ANGLERenderTest,
+                              public ::testing::WithParamInterface<ProgramCacheParams>
+{
+  public:
+    ProgramCacheBenchmark();
+
+    void initializeBenchmark() override;
+    void destroyBenchmark() override;
+    void drawBenchmark() override;
+
+  private:
+    GLuint linkProgram(unsigned int programIndex);
+    bool isProgramCached(unsigned int programIndex);
+    bool findNewCacheEntry(unsigned int knownProgramCount,
+                           ProgramKey *keyOut,
+                           EGLint *binarySizeOut);
+    void queryCacheEntry(EGLint entry, ProgramKey *keyOut, EGLint *binarySizeOut);
+
+    EGLDisplay mDisplay = EGL_NO_DISPLAY;
+
+    std::array<std::string, kProgramCount> mVertexSources;
+    std::array<std::string, kProgramCount> mFragmentSources;
+    std::array<ProgramKey, kProgramCount> mProgramKeys;
+
+    // Sizes of the whole corpus, as returned by glGetProgramBinary and as stored in the cache.
+    size_t mProgramBinaryBytes = 0;
+    size_t mCachedBytes        = 0;
+
+    size_t mLinkCount            = 0;
+    size_t mHitCount             = 0;
+    double mTotalLinkTimeSeconds = 0.0;
+
+    // The cache can only be queried for keys together with binaries.
+    std::vector<uint8_t> mBinaryScratch;
+
+    // Picks the programs to link. Fixed seed, so every run links the same programs.
+    uint32_t mRandomState = 1;
+};
+
+ProgramCacheBenchmark::ProgramCacheBenchmark() : ANGLERenderTest("ProgramCache", GetParam())
+{
+    mReporter->RegisterFyiMetric(".link_time", "us");
+    mReporter->RegisterFyiMetric(".hit_rate", "%");
+    mReporter->RegisterFyiMetric(".program_binary_size", "bytes");
+    mReporter->RegisterFyiMetric(".cached_size", "bytes");
+    mReporter->RegisterFyiMetric(".bytes_saved", "bytes");
+}
+
+void ProgramCacheBenchmark::initializeBenchmark()
+{
+    mDisplay = eglGetCurrentDisplay();
+    if (!CheckExtensionExists(eglQueryString(mDisplay, EGL_EXTENSIONS),
+                              "EGL_ANGLE_program_cache_control"))
+    {
+        mSkipTest = true;
+        return;
+    }
+
+    for (unsigned int programIndex = 0; programIndex < kProgramCount; ++programIndex)
+    {
+        mVertexSources[programIndex]   = MakeCorpusShader(GL_VERTEX_SHADER, programIndex);
+        mFragmentSources[programIndex] = MakeCorpusShader(GL_FRAGMENT_SHADER, programIndex);
+    }
+
+    // Link the corpus once with the default cache size, which fits all of it, to learn the keys
+    // and sizes. Every link stores one new entry.
+    for (unsigned int programIndex = 0; programIndex < kProgramCount; ++programIndex)
+    {
+        GLuint program = linkProgram(programIndex);
+        ASSERT_NE(0u, program);
+
+        GLint binaryLength = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+        mProgramBinaryBytes += static_cast<size_t>(binaryLength);
+        glDeleteProgram(program);
+
+        EGLint binarySize = 0;
+        ASSERT_TRUE(findNewCacheEntry(programIndex, &mProgramKeys[programIndex], &binarySize));
+        ASSERT_EQ(EGL_SUCCESS, eglGetError());
+        mCachedBytes += static_cast<size_t>(binarySize);
+    }
+
+    // Leave room for only part of the corpus, if it was stored uncompressed.
+    eglProgramCacheResizeANGLE(mDisplay,
+                               static_cast<EGLint>(mProgramBinaryBytes * kCacheBudgetPercent / 100),
+                               EGL_PROGRAM_CACHE_RESIZE_ANGLE);
+    ASSERT_EQ(EGL_SUCCESS, eglGetError());
+}
+
+void ProgramCacheBenchmark::destroyBenchmark()
+{
+    if (mLinkCount > 0)
+    {
+        mReporter->AddResult(".link_time",
+                             mTotalLinkTimeSeconds * 1e6 / static_cast<double>(mLinkCount));
+        mReporter->AddResult(".hit_rate", static_cast<double>(mHitCount) * 100.0 /
+                                              static_cast<double>(mLinkCount));
+    }
+    mReporter->AddResult(".program_binary_size", mProgramBinaryBytes);
+    mReporter->AddResult(".cached_size", mCachedBytes);
+    mReporter->AddResult(".bytes_saved", mProgramBinaryBytes - mCachedBytes);
+}
+
+void ProgramCacheBenchmark::drawBenchmark()
+{
+    for (unsigned int link = 0; link < kLinksPerStep; ++link)
+    {
+        // Squaring a uniform value favors the programs with low indices.
+        mRandomState       = mRandomState * 1664525u + 1013904223u;
+        double uniform     = static_cast<double>(mRandomState >> 8) / static_cast<double>(1 << 24);
+        unsigned int index = static_cast<unsigned int>(uniform * uniform * kProgramCount);
+
+        if (isProgramCached(index))
+        {
+            mHitCount++;
+        }
+        mLinkCount++;
+
+        Timer linkTimer;
+        linkTimer.start();
+        GLuint program = linkProgram(index);
+        linkTimer.stop();
+        ASSERT_NE(0u, program);
+        mTotalLinkTimeSeconds += linkTimer.getElapsedTime();
+        glDeleteProgram(program);
+    }
+}
+
+GLuint ProgramCacheBenchmark::linkProgram(unsigned int programIndex)
+{
+    GLuint program = CompileProgram(mVertexSources[programIndex].c_str(),
+                                    mFragmentSources[programIndex].c_str());
+    if (program == 0)
+    {
+        return 0;
+    }
+
+    GLint linkStatus = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+    return linkStatus == GL_TRUE ? program : 0;
+}
+
+bool ProgramCacheBenchmark::isProgramCached(unsigned int programIndex)
+{
+    EGLint entryCount = eglProgramCacheGetAttribANGLE(mDisplay, EGL_PROGRAM_CACHE_SIZE_ANGLE);
+
+    ProgramKey key;
+    for (EGLint entry = 0; entry < entryCount; ++entry)
+    {
+        EGLint binarySize = 0;
+        queryCacheEntry(entry, &key, &binarySize);
+        if (key == mProgramKeys[programIndex])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Finds the entry whose key doesn't belong to any of the first |knownProgramCount| programs. The
+// cache isn't ordered by use, so the program linked last can be at any index.
+bool ProgramCacheBenchmark::findNewCacheEntry(unsigned int knownProgramCount,
+                                              ProgramKey *keyOut,
+                                              EGLint *binarySizeOut)
+{
+    EGLint entryCount = eglProgramCacheGetAttribANGLE(mDisplay, EGL_PROGRAM_CACHE_SIZE_ANGLE);
+
+    for (EGLint entry = 0; entry < entryCount; ++entry)
+    {
+        queryCacheEntry(entry, keyOut, binarySizeOut);
+        auto knownEnd = mProgramKeys.begin() + knownProgramCount;
+        if (std::find(mProgramKeys.begin(), knownEnd, *keyOut) == knownEnd)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ProgramCacheBenchmark::queryCacheEntry(EGLint entry, ProgramKey *keyOut, EGLint *binarySizeOut)
+{
+    EGLint keySize = 0;
+    eglProgramCacheQueryANGLE(mDisplay, entry, nullptr, &keySize, nullptr, binarySizeOut);
+
+    keyOut->resize(keySize);
+    mBinaryScratch.resize(*binarySizeOut);
+    eglProgramCacheQueryANGLE(mDisplay, entry, keyOut->data(), &keySize, mBinaryScratch.data(),
+                              binarySizeOut);
+}
+
+using namespace egl_platform;
+
+ProgramCacheParams ProgramCacheD3D11Params()
+{
+    ProgramCacheParams params;
+    params.eglParameters = D3D11();
+    return params;
+}
+
+ProgramCacheParams ProgramCacheOpenGLOrGLESParams()
+{
+    ProgramCacheParams params;
+    params.eglParameters = OPENGL_OR_GLES();
+    return params;
+}
+
+ProgramCacheParams ProgramCacheVulkanParams()
+{
+    ProgramCacheParams params;
+    params.eglParameters = VULKAN();
+    return params;
+}
+
+ProgramCacheParams ProgramCacheVulkanNullParams()
+{
+    ProgramCacheParams params;
+    params.eglParameters = VULKAN_NULL();
+    return params;
+}
+
+TEST_P(ProgramCacheBenchmark, Run)
+{
+    run();
+}
+
+ANGLE_INSTANTIATE_TEST(ProgramCacheBenchmark,
+                       ProgramCacheD3D11Params(),
+                       ProgramCacheOpenGLOrGLESParams(),
+                       ProgramCacheVulkanParams(),
+                       ProgramCacheVulkanNullParams());
+
+}  // anonymous namespace
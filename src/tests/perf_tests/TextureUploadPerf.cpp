@@ -12,6 +12,7 @@
 #include <iostream>
 #include <random>
 #include <sstream>
+#include <vector>
 
 #include "test_utils/gl_raii.h"
 #include "util/shader_utils.h"
@@ -33,6 +34,8 @@ struct TextureUploadParams final : public RenderTestParams
         subImageSize = 64;
 
         webgl = false;
+
+        workerThreads = 0;
     }
 
     std::string story() const override;
@@ -41,6 +44,9 @@ struct TextureUploadParams final : public RenderTestParams
     GLsizei subImageSize;
 
     bool webgl;
+
+    // The number of worker threads uploads may use. Zero keeps the context's default.
+    GLuint workerThreads;
 };
 
 std::ostream &operator<<(std::ostream &os, const TextureUploadParams &params)
@@ -60,6 +66,11 @@ std::string TextureUploadParams::story() const
         strstr << "_webgl";
     }
 
+    if (workerThreads > 0)
+    {
+        strstr << "_" << baseSize << "_threads" << workerThreads;
+    }
+
     return strstr.str();
 }
 
@@ -109,6 +120,30 @@ class TextureUploadFullMipBenchmark : public TextureUploadBenchmarkBase
     void drawBenchmark() override;
 };
 
+// Uploads RGB8 data, which back-ends without RGB8 support convert to RGBA8 on the CPU.
+class TextureUploadConversionBenchmark : public TextureUploadBenchmarkBase
+{
+  public:
+    TextureUploadConversionBenchmark() : TextureUploadBenchmarkBase("TextureUploadConversion")
+    {
+        addExtensionPrerequisite("GL_KHR_parallel_shader_compile");
+    }
+
+    void initializeBenchmark() override
+    {
+        TextureUploadBenchmarkBase::initializeBenchmark();
+
+        const auto &params = GetParam();
+        glMaxShaderCompilerThreadsKHR(params.workerThreads);
+        mRGBData.resize(params.baseSize * params.baseSize * 3, 0x80);
+    }
+
+    void drawBenchmark() override;
+
+  private:
+    std::vector<uint8_t> mRGBData;
+};
+
 TextureUploadBenchmarkBase::TextureUploadBenchmarkBase(const char *benchmarkName)
     : ANGLERenderTest(benchmarkName, GetParam())
 {
@@ -145,7 +180,12 @@ void TextureUploadBenchmarkBase::initializeBenchmark()
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     ASSERT_TRUE(params.baseSize >= params.subImageSize);
-    mTextureData.resize(params.baseSize * params.baseSize * 4, 0.5);
+    // The conversion benchmark uploads its own RGB8 data, and its largest images would make this
+    // buffer a gigabyte.
+    if (params.workerThreads == 0)
+    {
+        mTextureData.resize(params.baseSize * params.baseSize * 4, 0.5);
+    }
 
     ASSERT_GL_NO_ERROR();
 }
@@ -228,6 +268,25 @@ void TextureUploadFullMipBenchmark::drawBenchmark()
     ASSERT_GL_NO_ERROR();
 }
 
+void TextureUploadConversionBenchmark::drawBenchmark()
+{
+    const auto &params = GetParam();
+
+    startGpuTimer();
+    for (unsigned int iteration = 0; iteration < params.iterationsPerStep; ++iteration)
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, params.baseSize, params.baseSize, 0, GL_RGB,
+                     GL_UNSIGNED_BYTE, mRGBData.data());
+
+        // Perform a draw just so the texture data is flushed.  With the position attributes not
+        // set, a constant default value is used, resulting in a very cheap draw.
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+    }
+    stopGpuTimer();
+
+    ASSERT_GL_NO_ERROR();
+}
+
 TextureUploadParams D3D11Params(bool webglCompat)
 {
     TextureUploadParams params;
@@ -252,6 +311,22 @@ TextureUploadParams VulkanParams(bool webglCompat)
     return params;
 }
 
+std::vector<TextureUploadParams> ConversionSweep(const TextureUploadParams &in)
+{
+    std::vector<TextureUploadParams> sweep;
+    for (GLsizei baseSize : {1024, 4096, 8192})
+    {
+        for (GLuint workerThreads : {1u, 2u, 4u, 8u})
+        {
+            TextureUploadParams params = in;
+            params.baseSize            = baseSize;
+            params.workerThreads       = workerThreads;
+            sweep.push_back(params);
+        }
+    }
+    return sweep;
+}
+
 }  // anonymous namespace
 
 TEST_P(TextureUploadSubImageBenchmark, Run)
@@ -264,6 +339,11 @@ TEST_P(TextureUploadFullMipBenchmark, Run)
     run();
 }
 
+TEST_P(TextureUploadConversionBenchmark, Run)
+{
+    run();
+}
+
 using namespace params;
 
 ANGLE_INSTANTIATE_TEST(TextureUploadSubImageBenchmark,
@@ -283,3 +363,8 @@ ANGLE_INSTANTIATE_TEST(TextureUploadFullMipBenchmark,
                        VulkanParams(false),
                        NullDevice(VulkanParams(false)),
                        VulkanParams(true));
+
+INSTANTIATE_TEST_SUITE_P(,
+                         TextureUploadConversionBenchmark,
+                         testing::ValuesIn(FilterTestParams(ConversionSweep(VulkanParams(false)))),
+                         testing::PrintToStringParamName());
@@ -0,0 +1,72 @@
+//
+// Copyright 2020 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+// WorkerThreadPerf:
+//   Performance test for the worker thread pool. Posts many empty tasks and waits for them, so
+//   the time per iteration is the overhead of scheduling and joining a single task.
+//
+
+#include "ANGLEPerfTest.h"
+
+#include "libANGLE/WorkerThread.h"
+
+using namespace angle;
+
+namespace
+{
+constexpr unsigned int kTasksPerStep = 256;
+
+class EmptyTask : public Closure
+{
+  public:
+    void operator()() override {}
+};
+
+class WorkerThreadPerfTest : public ANGLEPerfTest, public ::testing::WithParamInterface<bool>
+{
+  public:
+    WorkerThreadPerfTest();
+
+    void step() override;
+
+  private:
+    std::shared_ptr<WorkerThreadPool> mPool;
+    std::shared_ptr<EmptyTask> mTask;
+    std::vector<std::shared_ptr<WaitableEvent>> mWaitables;
+};
+
+WorkerThreadPerfTest::WorkerThreadPerfTest()
+    : ANGLEPerfTest("WorkerThreadPerf",
+                    "",
+                    GetParam() ? "_multithreaded" : "_single_threaded",
+                    kTasksPerStep),
+      mPool(WorkerThreadPool::Create(GetParam())),
+      mTask(std::make_shared<EmptyTask>())
+{
+    mWaitables.reserve(kTasksPerStep);
+}
+
+void WorkerThreadPerfTest::step()
+{
+    for (unsigned int index = 0; index < kTasksPerStep; ++index)
+    {
+        mWaitables.push_back(WorkerThreadPool::PostWorkerTask(mPool, mTask));
+    }
+
+    for (std::shared_ptr<WaitableEvent> &waitable : mWaitables)
+    {
+        waitable->wait();
+    }
+    mWaitables.clear();
+}
+
+TEST_P(WorkerThreadPerfTest, Run)
+{
+    run();
+}
+
+INSTANTIATE_TEST_SUITE_P(, WorkerThreadPerfTest, ::testing::Bool());
+
+}  // anonymous namespace
@@ -1113,4 +1113,71 @@ TEST_F(DefineTest, LongMacroInvocationChain)
     preprocess(inputStream.str().c_str(), settings);
 }
 
+// An argument that is used several times in the replacement list is substituted every time.
+TEST_F(DefineTest, FuncRepeatedArgument)
+{
+    const char *input =
+        "#define F(a, b) a b a b b\n"
+        "F(x y, z)\n";
+    const char *expected = "\nx y z x y z z\n";
+
+    preprocess(input, expected);
+}
+
+// Arguments that contain function-like macro invocations are expanded before substitution.
+TEST_F(DefineTest, FuncNestedInvocations)
+{
+    const char *input =
+        "#define ADD(a, b) a + b\n"
+        "#define SQ(x) x * x\n"
+        "SQ(ADD(SQ(1), 2))\n";
+    const char *expected = "\n\n1 * 1 + 2 * 1 * 1 + 2\n";
+
+    preprocess(input, expected);
+}
+
+// A deep chain of function-like macros that wrap their argument.
+TEST_F(DefineTest, FuncDeeplyNestedInvocations)
+{
+    std::stringstream inputStream;
+    std::stringstream expectedStream;
+
+    constexpr int kDepth = 64;
+    inputStream << "#define a0(x) x\n";
+    expectedStream << "\n";
+    for (int i = 1; i < kDepth; ++i)
+    {
+        inputStream << "#define a" << i << "(x) a" << (i - 1) << "((x))\n";
+        expectedStream << "\n";
+    }
+    inputStream << "a" << (kDepth - 1) << "(y)\n";
+    expectedStream << std::string(kDepth - 1, '(') << "y" << std::string(kDepth - 1, ')') << "\n";
+
+    preprocess(inputStream.str().c_str(), expectedStream.str().c_str());
+}
+
+// Many object-like macros are defined and used on the same line.
+TEST_F(DefineTest, ObjLargeDefineTable)
+{
+    std::stringstream inputStream;
+    std::stringstream expectedStream;
+
+    constexpr int kMacroCount = 512;
+    for (int i = 0; i < kMacroCount; ++i)
+    {
+        inputStream << "#define long_macro_name_" << i << " long_replacement_identifier_" << i
+                    << "\n";
+        expectedStream << "\n";
+    }
+    for (int i = 0; i < kMacroCount; ++i)
+    {
+        inputStream << (i == 0 ? "" : " ") << "long_macro_name_" << i;
+        expectedStream << (i == 0 ? "" : " ") << "long_replacement_identifier_" << i;
+    }
+    inputStream << "\n";
+    expectedStream << "\n";
+
+    preprocess(inputStream.str().c_str(), expectedStream.str().c_str());
+}
+
 }  // namespace angle